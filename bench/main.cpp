@@ -0,0 +1,59 @@
+#include <iostream>
+#include <vector>
+
+#include "mortonND_bench.h"
+#include "mortonND_BMI2_bench.h"
+#include "mortonND_LUT_bench.h"
+#include "mortonND_Auto_bench.h"
+#include "mortonND_UInt_bench.h"
+#include "mortonND_Range_bench.h"
+#include "mortonND_Arithmetic_bench.h"
+#include "mortonND_Neighbors_bench.h"
+#include "mortonND_Hilbert_bench.h"
+#include "mortonND_Mixed_bench.h"
+#include "mortonND_Quantize_bench.h"
+#include "mortonND_Sort_bench.h"
+#include "mortonND_External_bench.h"
+#include "mortonND_PointFile_bench.h"
+#include "mortonND_Pack_bench.h"
+#include "mortonND_Array_bench.h"
+#include "mortonND_Swizzle_bench.h"
+#include "mortonND_Matrix_bench.h"
+#include "mortonND_Octree_bench.h"
+#include "mortonND_BVH_bench.h"
+#include "mortonND_LocCode_bench.h"
+#include "mortonND_Nearest_bench.h"
+
+auto bench_methods = std::vector<bench_method>{
+    bench_method(&mortonnd_bmi2::BenchBatch, "BMI2 scalar vs. batch encode/decode throughput."),
+    bench_method(&mortonnd_lut::BenchBatch, "LUT scalar vs. batch encode/decode throughput."),
+    bench_method(&mortonnd_auto::BenchEngines, "Auto (run-time dispatch) batch throughput of each supported engine."),
+    bench_method(&mortonnd_uint::BenchWide, "Wide (> 64-bit) encode/decode throughput of native and UInt codes."),
+    bench_method(&mortonnd_range::BenchQuery, "Box query throughput: full [min, max] scan vs. BIGMIN skips."),
+    bench_method(&mortonnd_range::BenchDecompose, "Box-to-interval decomposition: interval count vs. false positives."),
+    bench_method(&mortonnd_arithmetic::BenchNeighbors, "Neighbor stepping: decode / encode vs. dilated arithmetic."),
+    bench_method(&mortonnd_neighbors::BenchNeighbors, "Batched face / all neighbor generation vs. decode / encode."),
+    bench_method(&mortonnd_hilbert::BenchEncodeDecode, "Hilbert vs. Morton encode/decode throughput."),
+    bench_method(&mortonnd_mixed::BenchEncodeDecode, "Mixed field widths vs. a single width encode/decode throughput."),
+    bench_method(&mortonnd_quantize::BenchQuantize, "Fused quantize + encode / decode + dequantize vs. separate passes."),
+    bench_method(&mortonnd_sort::BenchSort, "Morton sort: EncodeBatch + std::sort vs. fused parallel radix sort."),
+    bench_method(&mortonnd_external::BenchSortFile, "External (out-of-core) file sort per-stage throughput."),
+    bench_method(&mortonnd_pointfile::BenchQuery, "Point file box query latency vs. a full scan."),
+    bench_method(&mortonnd_pack::BenchDecode, "Delta + bit-packed codes: size and decode / lookup throughput vs. raw codes."),
+    bench_method(&mortonnd_array::BenchTraversal, "Z-order array vs. row-major: 3D stencil and column traversals."),
+    bench_method(&mortonnd_swizzle::BenchSwizzle, "Row-major <-> Morton image / volume swizzle bandwidth vs. per-element encoding."),
+    bench_method(&mortonnd_matrix::BenchKernels, "Morton-tiled matrix transpose / multiply-add vs. naive row-major."),
+    bench_method(&mortonnd_octree::BenchBuild, "Linear octree build / balance time and point location throughput."),
+    bench_method(&mortonnd_bvh::BenchBuild, "LBVH build time, in total and per million primitives."),
+    bench_method(&mortonnd_loccode::BenchAncestors, "Locational codes: common ancestor via clz vs. climbing per level."),
+    bench_method(&mortonnd_nearest::BenchNearest, "Exact kNN queries: single vs. batched (Morton-ordered queries, seeded bound).")
+};
+
+int main(int argc, const char *argv[]) {
+    for (auto bench : bench_methods) {
+        std::cout << "[bench]  " << bench.description << std::endl;
+        bench.bench_func();
+    }
+
+    return 0;
+}
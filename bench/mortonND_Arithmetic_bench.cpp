@@ -0,0 +1,49 @@
+#include "mortonND_Arithmetic_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_Arithmetic.h>
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_LUT.h>
+
+void mortonnd_arithmetic::BenchNeighbors() {
+    using MortonND = mortonnd::MortonNDBmi_3D_64;
+    using Arithmetic = mortonnd::MortonNDArithmetic_3D_64;
+    static constexpr auto LutEncoder = mortonnd::MortonNDLutEncoder_3D_64();
+    static constexpr auto LutDecoder = mortonnd::MortonNDLutDecoder_3D_64();
+
+    std::cout << "3D_64 (" << BenchPoints << " codes, +x / +y / +z neighbors of each):" << std::endl;
+
+    const auto codes = RandomValues<uint64_t>(BenchPoints, 63, 0);
+    std::vector<uint64_t> neighbors(BenchPoints * 3);
+
+    PrintThroughput("BMI2 decode, increment, encode", BenchPoints, BestOf([&]() {
+        for (size_t i = 0; i < BenchPoints; i++) {
+            uint64_t x, y, z;
+            std::tie(x, y, z) = MortonND::Decode(codes[i]);
+            neighbors[i * 3] = MortonND::Encode(x + 1, y, z);
+            neighbors[i * 3 + 1] = MortonND::Encode(x, y + 1, z);
+            neighbors[i * 3 + 2] = MortonND::Encode(x, y, z + 1);
+        }
+        DoNotOptimize(neighbors.data());
+    }));
+
+    PrintThroughput("LUT decode, increment, encode", BenchPoints, BestOf([&]() {
+        for (size_t i = 0; i < BenchPoints; i++) {
+            uint64_t x, y, z;
+            std::tie(x, y, z) = LutDecoder.Decode(codes[i]);
+            neighbors[i * 3] = LutEncoder.Encode((x + 1) & LutEncoder.InputMask(), y, z);
+            neighbors[i * 3 + 1] = LutEncoder.Encode(x, (y + 1) & LutEncoder.InputMask(), z);
+            neighbors[i * 3 + 2] = LutEncoder.Encode(x, y, (z + 1) & LutEncoder.InputMask());
+        }
+        DoNotOptimize(neighbors.data());
+    }));
+
+    PrintThroughput("Dilated IncAxis", BenchPoints, BestOf([&]() {
+        for (size_t i = 0; i < BenchPoints; i++) {
+            neighbors[i * 3] = Arithmetic::IncAxis<0>(codes[i]);
+            neighbors[i * 3 + 1] = Arithmetic::IncAxis<1>(codes[i]);
+            neighbors[i * 3 + 2] = Arithmetic::IncAxis<2>(codes[i]);
+        }
+        DoNotOptimize(neighbors.data());
+    }));
+}
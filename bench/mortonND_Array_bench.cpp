@@ -0,0 +1,128 @@
+#include "mortonND_Array_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_Array.h>
+
+#include <tuple>
+#include <vector>
+
+// 2^FieldBits cells per axis of a periodic 3D grid.
+static constexpr size_t FieldBits = 8;
+static constexpr size_t Extent = size_t(1) << FieldBits;
+static constexpr size_t Mask = Extent - 1;
+static constexpr size_t Cells = Extent * Extent * Extent;
+
+// A 7-point Laplacian.
+static inline float Stencil(float center, float x0, float x1, float y0, float y1, float z0, float z1) {
+    return x0 + x1 + y0 + y1 + z0 + z1 - 6.0f * center;
+}
+
+static void BenchRowMajor() {
+    std::vector<float> in(Cells, 1.0f), out(Cells);
+    const auto at = [](size_t x, size_t y, size_t z) { return (x & Mask) + ((y & Mask) << FieldBits) + ((z & Mask) << (2 * FieldBits)); };
+
+    PrintThroughput("Row-major", Cells, BestOf([&]() {
+        for (size_t z = 0; z < Extent; z++) {
+            for (size_t y = 0; y < Extent; y++) {
+                for (size_t x = 0; x < Extent; x++) {
+                    out[at(x, y, z)] = Stencil(in[at(x, y, z)],
+                        in[at(x - 1, y, z)], in[at(x + 1, y, z)],
+                        in[at(x, y - 1, z)], in[at(x, y + 1, z)],
+                        in[at(x, y, z - 1)], in[at(x, y, z + 1)]);
+                }
+            }
+        }
+        DoNotOptimize(out.data());
+    }));
+}
+
+// Visits cells in storage order, decoding each index and re-encoding each neighbor's coordinates.
+template<size_t TileBits>
+static void BenchReencode(const std::string& name) {
+    using Array = mortonnd::MortonNDArray<float, 3, FieldBits, TileBits>;
+    Array in(1.0f), out;
+
+    PrintThroughput(name, Cells, BestOf([&]() {
+        for (uint64_t index = 0; index < in.size(); index++) {
+            uint64_t x, y, z;
+            std::tie(x, y, z) = Array::Coordinates(index);
+            out[index] = Stencil(in[index],
+                in((x - 1) & Mask, y, z), in((x + 1) & Mask, y, z),
+                in(x, (y - 1) & Mask, z), in(x, (y + 1) & Mask, z),
+                in(x, y, (z - 1) & Mask), in(x, y, (z + 1) & Mask));
+        }
+        DoNotOptimize(out.data());
+    }));
+}
+
+// Visits cells in storage order, stepping to each neighbor with dilated arithmetic.
+template<size_t TileBits>
+static void BenchCursor(const std::string& name) {
+    using Array = mortonnd::MortonNDArray<float, 3, FieldBits, TileBits>;
+    Array in(1.0f), out;
+
+    PrintThroughput(name, Cells, BestOf([&]() {
+        for (uint64_t index = 0; index < in.size(); index++) {
+            const typename Array::ConstCursor cell(in.data(), index);
+            out[index] = Stencil(*cell,
+                cell.template Neighbor<0, -1>(), cell.template Neighbor<0, 1>(),
+                cell.template Neighbor<1, -1>(), cell.template Neighbor<1, 1>(),
+                cell.template Neighbor<2, -1>(), cell.template Neighbor<2, 1>());
+        }
+        DoNotOptimize(out.data());
+    }));
+}
+
+// Sums each column along axis 2 (the slowest axis of row-major storage).
+static void BenchColumnsRowMajor() {
+    const std::vector<float> in(Cells, 1.0f);
+    std::vector<float> sums(Extent * Extent);
+
+    PrintThroughput("Row-major", Cells, BestOf([&]() {
+        for (size_t x = 0; x < Extent; x++) {
+            for (size_t y = 0; y < Extent; y++) {
+                float sum = 0;
+                for (size_t z = 0; z < Extent; z++) {
+                    sum += in[x + (y << FieldBits) + (z << (2 * FieldBits))];
+                }
+                sums[x + (y << FieldBits)] = sum;
+            }
+        }
+        DoNotOptimize(sums.data());
+    }));
+}
+
+template<size_t TileBits>
+static void BenchColumnsCursor(const std::string& name) {
+    using Array = mortonnd::MortonNDArray<float, 3, FieldBits, TileBits>;
+    const Array in(1.0f);
+    std::vector<float> sums(Extent * Extent);
+
+    PrintThroughput(name, Cells, BestOf([&]() {
+        for (size_t x = 0; x < Extent; x++) {
+            for (size_t y = 0; y < Extent; y++) {
+                auto cell = in.CursorAt(x, y, 0);
+                float sum = 0;
+                for (size_t z = 0; z < Extent; z++, cell.template Next<2>()) {
+                    sum += *cell;
+                }
+                sums[x + (y << FieldBits)] = sum;
+            }
+        }
+        DoNotOptimize(sums.data());
+    }));
+}
+
+void mortonnd_array::BenchTraversal() {
+    std::cout << "3D 7-point stencil, " << Extent << "^3 floats (periodic):" << std::endl;
+    BenchRowMajor();
+    BenchReencode<0>("Morton, re-encode neighbors");
+    BenchCursor<0>("Morton, dilated neighbor steps");
+    BenchReencode<2>("Morton 4^3 tiles, re-encode neighbors");
+    BenchCursor<2>("Morton 4^3 tiles, dilated neighbor steps");
+
+    std::cout << "Column sums along axis 2, " << Extent << "^3 floats:" << std::endl;
+    BenchColumnsRowMajor();
+    BenchColumnsCursor<0>("Morton, dilated steps");
+    BenchColumnsCursor<2>("Morton 4^3 tiles, dilated steps");
+}
@@ -0,0 +1,50 @@
+#include "mortonND_Auto_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_Auto.h>
+
+template<size_t Fields, size_t FieldBits, size_t ...i>
+void BenchMortonNDAutoEngines(std::index_sequence<i...>) {
+    using MortonND = mortonnd::MortonNDAuto<Fields, FieldBits>;
+    using T = typename MortonND::T;
+    std::cout << Fields << "D, " << FieldBits << " bits per field (" << BenchPoints << " points, selected engine: "
+              << mortonnd::MortonNDEngineName(MortonND::SelectedEngine()) << "):" << std::endl;
+
+    std::vector<T> fields[Fields];
+    for (size_t f = 0; f < Fields; f++) {
+        fields[f] = RandomValues<T>(BenchPoints, FieldBits, f);
+    }
+
+    std::vector<T> codes(BenchPoints);
+    T* out = codes.data();
+
+    for (auto engine : { mortonnd::MortonNDEngine::Magic, mortonnd::MortonNDEngine::Bmi2 }) {
+        if (!MortonND::IsSupported(engine)) {
+            continue;
+        }
+
+        const auto& kernels = MortonND::DispatchFor(engine);
+        const std::string name = mortonnd::MortonNDEngineName(engine);
+
+        PrintThroughput("EncodeBatch (SoA, " + name + ")", BenchPoints, BestOf([&]() {
+            kernels.EncodeSoA({{ fields[i].data()... }}, out, BenchPoints);
+            DoNotOptimize(out[0]);
+        }));
+
+        PrintThroughput("DecodeBatch (SoA, " + name + ")", BenchPoints, BestOf([&]() {
+            kernels.DecodeSoA(out, BenchPoints, {{ fields[i].data()... }});
+            DoNotOptimize(fields[0][0]);
+        }));
+    }
+}
+
+template<size_t Fields, size_t FieldBits>
+void BenchMortonNDAutoEngines() {
+    BenchMortonNDAutoEngines<Fields, FieldBits>(std::make_index_sequence<Fields>{});
+}
+
+void mortonnd_auto::BenchEngines() {
+    BenchMortonNDAutoEngines<2, 32>();
+    BenchMortonNDAutoEngines<3, 21>();
+    BenchMortonNDAutoEngines<3, 10>();
+}
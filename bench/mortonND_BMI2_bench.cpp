@@ -0,0 +1,71 @@
+#include "mortonND_BMI2_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+
+template<size_t Fields, typename T, size_t ...i>
+void BenchMortonNDBmiBatch(std::index_sequence<i...>) {
+    using MortonND = mortonnd::MortonNDBmi<Fields, T>;
+    std::cout << std::numeric_limits<T>::digits << "-bit " << Fields << "D (" << BenchPoints << " points):" << std::endl;
+
+    std::vector<T> fields[Fields];
+    std::vector<T> points(BenchPoints * Fields);
+    for (size_t f = 0; f < Fields; f++) {
+        fields[f] = RandomValues<T>(BenchPoints, MortonND::FieldBits, f);
+        for (size_t n = 0; n < BenchPoints; n++) {
+            points[n * Fields + f] = fields[f][n];
+        }
+    }
+
+    std::vector<T> codes(BenchPoints);
+    T* out = codes.data();
+
+    PrintThroughput("Encode (scalar loop)", BenchPoints, BestOf([&]() {
+        for (size_t n = 0; n < BenchPoints; n++) {
+            out[n] = MortonND::Encode(fields[i][n]...);
+        }
+        DoNotOptimize(out[0]);
+    }));
+
+    PrintThroughput("EncodeBatch (SoA)", BenchPoints, BestOf([&]() {
+        MortonND::EncodeBatch({{ fields[i].data()... }}, out, BenchPoints);
+        DoNotOptimize(out[0]);
+    }));
+
+    PrintThroughput("EncodeBatch (AoS)", BenchPoints, BestOf([&]() {
+        MortonND::EncodeBatch(points.data(), Fields, out, BenchPoints);
+        DoNotOptimize(out[0]);
+    }));
+
+    PrintThroughput("Decode (scalar loop)", BenchPoints, BestOf([&]() {
+        for (size_t n = 0; n < BenchPoints; n++) {
+            std::tie(fields[i][n]...) = MortonND::Decode(out[n]);
+        }
+        DoNotOptimize(fields[0][0]);
+    }));
+
+    PrintThroughput("DecodeBatch (SoA)", BenchPoints, BestOf([&]() {
+        MortonND::DecodeBatch(out, BenchPoints, {{ fields[i].data()... }});
+        DoNotOptimize(fields[0][0]);
+    }));
+
+    PrintThroughput("DecodeBatch (AoS)", BenchPoints, BestOf([&]() {
+        MortonND::DecodeBatch(out, BenchPoints, points.data(), Fields);
+        DoNotOptimize(points[0]);
+    }));
+}
+
+template<size_t Fields, typename T>
+void BenchMortonNDBmiBatch() {
+    BenchMortonNDBmiBatch<Fields, T>(std::make_index_sequence<Fields>{});
+}
+
+void mortonnd_bmi2::BenchBatch() {
+    BenchMortonNDBmiBatch<2, uint64_t>();
+    BenchMortonNDBmiBatch<3, uint64_t>();
+    BenchMortonNDBmiBatch<3, uint32_t>();
+    BenchMortonNDBmiBatch<4, uint64_t>();
+#if defined(__SIZEOF_INT128__)
+    BenchMortonNDBmiBatch<3, __uint128_t>();
+#endif
+}
@@ -0,0 +1,5 @@
+#pragma once
+
+namespace mortonnd_bmi2 {
+void BenchBatch();
+}
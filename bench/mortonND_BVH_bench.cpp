@@ -0,0 +1,46 @@
+#include "mortonND_BVH_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_BVH.h>
+
+#include <string>
+#include <vector>
+
+using Bvh = mortonnd::MortonNDBvh<3, float, uint64_t>;
+
+// Prints the build time per million primitives.
+static void PrintPerMillion(const std::string& name, size_t count, double seconds) {
+    PrintDuration(name + " per 1M primitives", seconds / (double(count) / 1e6));
+}
+
+void mortonnd_bvh::BenchBuild() {
+    const size_t count = BenchPoints / 4;
+    std::cout << "3D_64 (" << count << " random boxes):" << std::endl;
+
+    std::mt19937_64 rng(0);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f), size(0.0f, 1.0f);
+    std::vector<Bvh::Box> boxes(count);
+    for (auto& box : boxes) {
+        for (size_t d = 0; d < 3; d++) {
+            box.min[d] = position(rng);
+            box.max[d] = box.min[d] + size(rng);
+        }
+    }
+
+    const auto engine = mortonnd::MortonNDStatic<mortonnd::MortonNDBmi_3D_64>{};
+
+    const auto single = BestOf([&]() {
+        const Bvh bvh(engine, boxes.data(), count, 1);
+        DoNotOptimize(bvh.Nodes().data());
+    });
+    PrintDuration("Build (1 thread)", single);
+    PrintPerMillion("Build (1 thread)", count, single);
+
+    const auto all = BestOf([&]() {
+        const Bvh bvh(engine, boxes.data(), count);
+        DoNotOptimize(bvh.Nodes().data());
+    });
+    PrintDuration("Build (all threads)", all);
+    PrintPerMillion("Build (all threads)", count, all);
+}
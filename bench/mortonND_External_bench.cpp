@@ -0,0 +1,54 @@
+#include "mortonND_External_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_External.h>
+
+#include <cstdio>
+#include <fstream>
+
+static void PrintStage(const std::string& name, const mortonnd::MortonNDExternalSortStats::Stage& stage) {
+    std::cout << "  " << std::left << std::setw(48) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1)
+              << (stage.Throughput() / 1e6) << " MB/s" << std::endl;
+}
+
+// Sorts a file of 3D records (3 21-bit 'uint64_t' coordinates and a 'uint64_t' ID) with a
+// memory budget of 1/8 of the file's size.
+static void BenchSortFile3D() {
+    using MortonND = mortonnd::MortonNDBmi_3D_64;
+    static const size_t Records = BenchPoints / 4;
+    static const size_t RecordFields = 4;
+
+    const std::string inputPath = "/tmp/mortonnd-external-bench-input";
+    const std::string outputPath = "/tmp/mortonnd-external-bench-output";
+    {
+        const auto values = RandomValues<uint64_t>(Records * RecordFields, 21, 0);
+        std::ofstream input(inputPath, std::ios::binary | std::ios::trunc);
+        input.write(reinterpret_cast<const char*>(values.data()), std::streamsize(values.size() * sizeof(uint64_t)));
+    }
+
+    mortonnd::MortonNDExternalSortOptions options;
+    options.memoryBytes = Records * RecordFields * sizeof(uint64_t) / 8;
+    options.keyBits = 63;
+
+    const auto stats = mortonnd::SortFileByMorton<uint64_t>(inputPath, outputPath, RecordFields * sizeof(uint64_t),
+        [](const unsigned char* records, size_t count, size_t, uint64_t* codes) {
+            MortonND::EncodeBatch(reinterpret_cast<const uint64_t*>(records), RecordFields, codes, count);
+        }, options);
+
+    std::remove(inputPath.c_str());
+    std::remove(outputPath.c_str());
+
+    std::cout << "3D_64 (" << Records << " records, " << stats.runs << " runs):" << std::endl;
+    PrintStage("Read", stats.read);
+    PrintStage("Encode + sort runs", stats.sort);
+    PrintStage("Spill runs", stats.spill);
+    PrintStage("Merge", stats.merge);
+    PrintStage("Write", stats.write);
+    PrintDuration("Total", stats.totalSeconds);
+}
+
+void mortonnd_external::BenchSortFile() {
+    BenchSortFile3D();
+}
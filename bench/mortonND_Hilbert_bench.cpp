@@ -0,0 +1,56 @@
+#include "mortonND_Hilbert_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_Hilbert.h>
+#include <morton-nd/mortonND_Magic.h>
+
+template<size_t Dimensions, typename T, size_t... i>
+static void BenchHilbert(std::index_sequence<i...>) {
+    using Bmi = mortonnd::MortonNDBmi<Dimensions, T>;
+    using Magic = mortonnd::MortonNDMagic<Dimensions, T>;
+    using Hilbert = mortonnd::HilbertND<Dimensions, T>;
+    using HilbertComputed = mortonnd::HilbertND<Dimensions, T, Bmi::FieldBits, false>;
+
+    std::cout << Dimensions << "D_" << std::numeric_limits<T>::digits << " (" << BenchPoints << " points):" << std::endl;
+
+    const std::vector<T> fields[] = { RandomValues<T>(BenchPoints, Bmi::FieldBits, i)... };
+    std::vector<T> codes(BenchPoints);
+
+    const auto encode = [&](const std::string& name, auto func) {
+        PrintThroughput(name, BenchPoints, BestOf([&]() {
+            for (size_t n = 0; n < BenchPoints; n++) {
+                codes[n] = func(fields[i][n]...);
+            }
+            DoNotOptimize(codes.data());
+        }));
+    };
+
+    encode("Encode: Morton (BMI2)", [](auto... f) { return Bmi::Encode(f...); });
+    encode("Encode: Morton (magic bits)", [](auto... f) { return Magic::Encode(f...); });
+    encode("Encode: Hilbert (magic bits + LUT transform)", [](auto... f) { return Hilbert::Encode(f...); });
+    encode("Encode: Hilbert (BMI2 + LUT transform)", [](auto... f) { return Hilbert::FromMorton(Bmi::Encode(f...)); });
+    encode("Encode: Hilbert (BMI2 + computed transform)", [](auto... f) { return HilbertComputed::FromMorton(Bmi::Encode(f...)); });
+
+    T sum = 0;
+    const auto decode = [&](const std::string& name, auto func) {
+        PrintThroughput(name, BenchPoints, BestOf([&]() {
+            sum = 0;
+            for (size_t n = 0; n < BenchPoints; n++) {
+                sum += std::get<0>(func(codes[n]));
+            }
+            DoNotOptimize(sum);
+        }));
+    };
+
+    decode("Decode: Morton (BMI2)", [](T code) { return Bmi::Decode(code); });
+    decode("Decode: Hilbert (LUT transform + magic bits)", [](T code) { return Hilbert::Decode(code); });
+    decode("Decode: Hilbert (LUT transform + BMI2)", [](T code) { return Bmi::Decode(Hilbert::ToMorton(code)); });
+    decode("Decode: Hilbert (computed transform + BMI2)", [](T code) { return Bmi::Decode(HilbertComputed::ToMorton(code)); });
+}
+
+void mortonnd_hilbert::BenchEncodeDecode() {
+    BenchHilbert<2, uint64_t>(std::make_index_sequence<2>{});
+    BenchHilbert<3, uint64_t>(std::make_index_sequence<3>{});
+    BenchHilbert<4, uint64_t>(std::make_index_sequence<4>{});
+}
@@ -0,0 +1,53 @@
+#include "mortonND_LUT_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_LUT.h>
+
+template<typename Encoder, typename Decoder, size_t Fields, size_t FieldBits, size_t ...i>
+void BenchMortonNDLutBatch(const char* name, std::index_sequence<i...>) {
+    static constexpr auto encoder = Encoder();
+    static constexpr auto decoder = Decoder();
+    using T = typename Encoder::type;
+    std::cout << name << " (" << BenchPoints << " points, vector encode = " << Encoder::VectorBatch << "):" << std::endl;
+
+    std::vector<T> fields[Fields];
+    for (size_t f = 0; f < Fields; f++) {
+        fields[f] = RandomValues<T>(BenchPoints, FieldBits, f);
+    }
+
+    std::vector<T> codes(BenchPoints);
+    T* out = codes.data();
+
+    PrintThroughput("Encode (scalar loop)", BenchPoints, BestOf([&]() {
+        for (size_t n = 0; n < BenchPoints; n++) {
+            out[n] = encoder.Encode(fields[i][n]...);
+        }
+        DoNotOptimize(out[0]);
+    }));
+
+    PrintThroughput("EncodeBatch (SoA)", BenchPoints, BestOf([&]() {
+        encoder.EncodeBatch({{ fields[i].data()... }}, out, BenchPoints);
+        DoNotOptimize(out[0]);
+    }));
+
+    PrintThroughput("Decode (scalar loop)", BenchPoints, BestOf([&]() {
+        for (size_t n = 0; n < BenchPoints; n++) {
+            std::tie(fields[i][n]...) = decoder.Decode(out[n]);
+        }
+        DoNotOptimize(fields[0][0]);
+    }));
+
+    PrintThroughput("DecodeBatch (SoA)", BenchPoints, BestOf([&]() {
+        decoder.DecodeBatch(out, BenchPoints, {{ fields[i].data()... }});
+        DoNotOptimize(fields[0][0]);
+    }));
+}
+
+void mortonnd_lut::BenchBatch() {
+    BenchMortonNDLutBatch<mortonnd::MortonNDLutEncoder_3D_64, mortonnd::MortonNDLutDecoder_3D_64, 3, 21>(
+        "MortonNDLut 3D_64", std::make_index_sequence<3>{});
+    BenchMortonNDLutBatch<mortonnd::MortonNDLutEncoder_2D_64, mortonnd::MortonNDLutDecoder_2D_64, 2, 32>(
+        "MortonNDLut 2D_64", std::make_index_sequence<2>{});
+    BenchMortonNDLutBatch<mortonnd::MortonNDLutEncoder_3D_32, mortonnd::MortonNDLutDecoder_3D_32, 3, 10>(
+        "MortonNDLut 3D_32", std::make_index_sequence<3>{});
+}
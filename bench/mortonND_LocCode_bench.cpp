@@ -0,0 +1,71 @@
+#include "mortonND_LocCode_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_LocCode.h>
+
+#include <vector>
+
+using LocCode = mortonnd::MortonNDLocCode<3, uint64_t, true>;
+
+// Random sentinel codes, at random levels.
+static std::vector<uint64_t> RandomCells(size_t count, uint64_t seed) {
+    const auto points = RandomValues<uint64_t>(count, 63, seed);
+    const auto levels = RandomValues<uint64_t>(count, 64, seed + 1);
+
+    std::vector<uint64_t> cells(count);
+    for (size_t n = 0; n < count; n++) {
+        cells[n] = LocCode::FromPoint(points[n], size_t(levels[n] % (LocCode::MaxLevel + 1)));
+    }
+
+    return cells;
+}
+
+// Compares the deepest common ancestor from 'clz' of the XOR against climbing a level at a time.
+void mortonnd_loccode::BenchAncestors() {
+    const auto a = RandomCells(BenchPoints, 0);
+
+    // Half of the pairs share a long prefix.
+    auto b = RandomCells(BenchPoints, 2);
+    for (size_t n = 0; n < BenchPoints; n += 2) {
+        b[n] = a[n] ^ (b[n] & 0xFFF);
+        b[n] = b[n] == 0 ? 1 : b[n];
+    }
+
+    std::cout << "3D_64 sentinel codes (" << BenchPoints << " pairs):" << std::endl;
+
+    PrintThroughput("CommonAncestor (climb per level)", BenchPoints, BestOf([&]() {
+        uint64_t sum = 0;
+        for (size_t n = 0; n < BenchPoints; n++) {
+            auto x = a[n], y = b[n];
+            while (LocCode::Level(x) > LocCode::Level(y)) {
+                x = LocCode::Parent(x);
+            }
+            while (LocCode::Level(y) > LocCode::Level(x)) {
+                y = LocCode::Parent(y);
+            }
+            while (x != y) {
+                x = LocCode::Parent(x);
+                y = LocCode::Parent(y);
+            }
+            sum += x;
+        }
+        DoNotOptimize(sum);
+    }));
+
+    PrintThroughput("CommonAncestor (clz of XOR)", BenchPoints, BestOf([&]() {
+        uint64_t sum = 0;
+        for (size_t n = 0; n < BenchPoints; n++) {
+            sum += LocCode::CommonAncestor(a[n], b[n]);
+        }
+        DoNotOptimize(sum);
+    }));
+
+    PrintThroughput("DescendantRange", BenchPoints, BestOf([&]() {
+        uint64_t sum = 0;
+        for (size_t n = 0; n < BenchPoints; n++) {
+            const auto range = LocCode::DescendantRange(a[n]);
+            sum += range.second - range.first;
+        }
+        DoNotOptimize(sum);
+    }));
+}
@@ -0,0 +1,80 @@
+#include "mortonND_Matrix_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_Matrix.h>
+
+#include <vector>
+
+using Matrix = mortonnd::MortonNDMatrix<float>;
+
+static std::vector<float> RandomFloats(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> values(count);
+    for (auto& value : values) {
+        value = distribution(rng);
+    }
+
+    return values;
+}
+
+static void BenchTranspose(size_t n) {
+    std::cout << "Transpose, " << n << " x " << n << " floats:" << std::endl;
+    const auto rowMajor = RandomFloats(n * n, n);
+    std::vector<float> transposed(n * n);
+
+    PrintThroughput("Row-major (naive)", n * n, BestOf([&]() {
+        for (size_t row = 0; row < n; row++) {
+            for (size_t col = 0; col < n; col++) {
+                transposed[col * n + row] = rowMajor[row * n + col];
+            }
+        }
+        DoNotOptimize(transposed.data());
+    }));
+
+    Matrix matrix;
+    PrintThroughput("FromRowMajor", n * n, BestOf([&]() {
+        matrix = Matrix::FromRowMajor(rowMajor.data(), n, n);
+        DoNotOptimize(matrix.data());
+    }));
+
+    Matrix result(n, n);
+    PrintThroughput("Morton tiles (recursive)", n * n, BestOf([&]() {
+        mortonnd::Transpose(matrix, result);
+        DoNotOptimize(result.data());
+    }));
+}
+
+// Throughput is reported in multiply-adds.
+static void BenchMultiply(size_t n) {
+    std::cout << "Multiply-add, " << n << " x " << n << " floats (M multiply-adds/s):" << std::endl;
+    const auto a = RandomFloats(n * n, 1), b = RandomFloats(n * n, 2);
+    std::vector<float> c(n * n);
+
+    PrintThroughput("Row-major (naive, i-k-j)", n * n * n, BestOf([&]() {
+        for (size_t row = 0; row < n; row++) {
+            for (size_t inner = 0; inner < n; inner++) {
+                const float value = a[row * n + inner];
+                for (size_t col = 0; col < n; col++) {
+                    c[row * n + col] += value * b[inner * n + col];
+                }
+            }
+        }
+        DoNotOptimize(c.data());
+    }));
+
+    const auto ma = Matrix::FromRowMajor(a.data(), n, n), mb = Matrix::FromRowMajor(b.data(), n, n);
+    Matrix mc(n, n);
+    PrintThroughput("Morton tiles (recursive)", n * n * n, BestOf([&]() {
+        mortonnd::MultiplyAdd(ma, mb, mc);
+        DoNotOptimize(mc.data());
+    }));
+}
+
+// Larger sizes (16k, 32k) work the same, but take 1-4 GiB per matrix, and minutes to multiply.
+void mortonnd_matrix::BenchKernels() {
+    BenchTranspose(4096);
+    BenchTranspose(8192);
+    BenchMultiply(1024);
+    BenchMultiply(2048);
+}
@@ -0,0 +1,58 @@
+#include "mortonND_Mixed_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_LUT.h>
+#include <morton-nd/mortonND_Mixed.h>
+
+// Compares 4D 64-bit codes with fields of 20, 20, 12 and 12 bits against a single width of 16 bits.
+template<size_t... i>
+static void BenchMixed(std::index_sequence<i...>) {
+    using Bmi = mortonnd::MortonNDBmi<4, uint64_t>;
+    using BmiMixed = mortonnd::MortonNDBmiMixed<uint64_t, 20, 20, 12, 12>;
+    constexpr auto LutEncoder = mortonnd::MortonNDLutEncoder<4, 16, 8, uint64_t>();
+    constexpr auto LutDecoder = mortonnd::MortonNDLutDecoder<4, 16, 8, uint64_t>();
+    constexpr auto LutMixedEncoder = mortonnd::MortonNDLutMixedEncoder<uint64_t, 8, 20, 20, 12, 12>();
+    constexpr auto LutMixedDecoder = mortonnd::MortonNDLutMixedDecoder<uint64_t, 8, 20, 20, 12, 12>();
+
+    std::cout << "4D_64 (" << BenchPoints << " points):" << std::endl;
+
+    const size_t widths[] = { 20, 20, 12, 12 };
+    const std::vector<uint64_t> uniform[] = { RandomValues<uint64_t>(BenchPoints, 16, i)... };
+    const std::vector<uint64_t> mixed[] = { RandomValues<uint64_t>(BenchPoints, widths[i], i)... };
+    std::vector<uint64_t> codes(BenchPoints);
+
+    const auto encode = [&](const std::string& name, const std::vector<uint64_t> (&fields)[4], auto func) {
+        PrintThroughput(name, BenchPoints, BestOf([&]() {
+            for (size_t n = 0; n < BenchPoints; n++) {
+                codes[n] = func(fields[i][n]...);
+            }
+            DoNotOptimize(codes.data());
+        }));
+    };
+
+    uint64_t sum = 0;
+    const auto decode = [&](const std::string& name, auto func) {
+        PrintThroughput(name, BenchPoints, BestOf([&]() {
+            sum = 0;
+            for (size_t n = 0; n < BenchPoints; n++) {
+                sum += std::get<3>(func(codes[n]));
+            }
+            DoNotOptimize(sum);
+        }));
+    };
+
+    encode("Encode: BMI2 (16, 16, 16, 16)", uniform, [](auto... f) { return Bmi::Encode(f...); });
+    decode("Decode: BMI2 (16, 16, 16, 16)", [](uint64_t code) { return Bmi::Decode(code); });
+    encode("Encode: LUT (16, 16, 16, 16)", uniform, [&](auto... f) { return LutEncoder.Encode(f...); });
+    decode("Decode: LUT (16, 16, 16, 16)", [&](uint64_t code) { return LutDecoder.Decode(code); });
+
+    encode("Encode: BMI2 mixed (20, 20, 12, 12)", mixed, [](auto... f) { return BmiMixed::Encode(f...); });
+    decode("Decode: BMI2 mixed (20, 20, 12, 12)", [](uint64_t code) { return BmiMixed::Decode(code); });
+    encode("Encode: LUT mixed (20, 20, 12, 12)", mixed, [&](auto... f) { return LutMixedEncoder.Encode(f...); });
+    decode("Decode: LUT mixed (20, 20, 12, 12)", [&](uint64_t code) { return LutMixedDecoder.Decode(code); });
+}
+
+void mortonnd_mixed::BenchEncodeDecode() {
+    BenchMixed(std::make_index_sequence<4>{});
+}
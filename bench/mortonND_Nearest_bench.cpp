@@ -0,0 +1,37 @@
+#include "mortonND_Nearest_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_Nearest.h>
+
+#include <algorithm>
+#include <vector>
+
+using Nearest = mortonnd::MortonNDNearest<3, uint64_t, 21>;
+
+static constexpr size_t K = 8;
+
+// Compares single and batched exact kNN queries, for 3D points in 64-bit codes.
+void mortonnd_nearest::BenchNearest() {
+    const size_t count = BenchPoints / 4;
+    const size_t queryCount = size_t(1) << 16;
+
+    auto codes = RandomValues<uint64_t>(count, 63, 0);
+    std::sort(codes.begin(), codes.end());
+    const auto queries = RandomValues<uint64_t>(queryCount, 63, 1);
+
+    std::cout << "3D_64 (" << count << " points, " << queryCount << " queries, k = " << K << "):" << std::endl;
+
+    std::vector<size_t> indices(queryCount * K);
+
+    PrintThroughput("Nearest (per query)", queryCount, BestOf([&]() {
+        for (size_t q = 0; q < queryCount; q++) {
+            Nearest::Nearest(codes.data(), count, queries[q], K, &indices[q * K]);
+        }
+        DoNotOptimize(indices.data());
+    }));
+
+    PrintThroughput("NearestBatch", queryCount, BestOf([&]() {
+        Nearest::NearestBatch(codes.data(), count, queries.data(), queryCount, K, indices.data());
+        DoNotOptimize(indices.data());
+    }));
+}
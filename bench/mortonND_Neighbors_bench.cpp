@@ -0,0 +1,70 @@
+#include "mortonND_Neighbors_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_Neighbors.h>
+
+void mortonnd_neighbors::BenchNeighbors() {
+    using MortonND = mortonnd::MortonNDBmi_3D_64;
+    using Neighbors = mortonnd::MortonNDNeighbors_3D_64;
+    static const size_t Count = BenchPoints / 16;
+    static const uint64_t FieldMax = (uint64_t(1) << 21) - 1;
+
+    std::cout << "3D_64 (" << Count << " codes, Vector = " << Neighbors::VectorBatch << "):" << std::endl;
+
+    const auto codes = RandomValues<uint64_t>(Count, 63, 0);
+    std::vector<uint64_t> neighbors(Count * Neighbors::AllCount);
+
+    PrintThroughput("Face: BMI2 decode / encode, with boundary check", Count, BestOf([&]() {
+        for (size_t i = 0; i < Count; i++) {
+            uint64_t x, y, z;
+            std::tie(x, y, z) = MortonND::Decode(codes[i]);
+            neighbors[i] = x == 0 ? ~uint64_t(0) : MortonND::Encode(x - 1, y, z);
+            neighbors[Count + i] = x == FieldMax ? ~uint64_t(0) : MortonND::Encode(x + 1, y, z);
+            neighbors[2 * Count + i] = y == 0 ? ~uint64_t(0) : MortonND::Encode(x, y - 1, z);
+            neighbors[3 * Count + i] = y == FieldMax ? ~uint64_t(0) : MortonND::Encode(x, y + 1, z);
+            neighbors[4 * Count + i] = z == 0 ? ~uint64_t(0) : MortonND::Encode(x, y, z - 1);
+            neighbors[5 * Count + i] = z == FieldMax ? ~uint64_t(0) : MortonND::Encode(x, y, z + 1);
+        }
+        DoNotOptimize(neighbors.data());
+    }));
+
+    PrintThroughput("Face: FaceNeighbors (Fill)", Count, BestOf([&]() {
+        Neighbors::FaceNeighbors(codes.data(), Count, neighbors.data(), mortonnd::MortonNDBoundary::Fill);
+        DoNotOptimize(neighbors.data());
+    }));
+
+    PrintThroughput("Face: FaceNeighbors (Wrap)", Count, BestOf([&]() {
+        Neighbors::FaceNeighbors(codes.data(), Count, neighbors.data());
+        DoNotOptimize(neighbors.data());
+    }));
+
+    PrintThroughput("All (26): BMI2 decode / encode, wrapping", Count, BestOf([&]() {
+        for (size_t i = 0; i < Count; i++) {
+            uint64_t x, y, z;
+            std::tie(x, y, z) = MortonND::Decode(codes[i]);
+            size_t k = 0;
+            for (uint64_t dz = 0; dz < 3; dz++) {
+                for (uint64_t dy = 0; dy < 3; dy++) {
+                    for (uint64_t dx = 0; dx < 3; dx++) {
+                        if (dx == 1 && dy == 1 && dz == 1) {
+                            continue;
+                        }
+                        neighbors[k++ * Count + i] = MortonND::Encode((x + dx - 1) & FieldMax, (y + dy - 1) & FieldMax, (z + dz - 1) & FieldMax);
+                    }
+                }
+            }
+        }
+        DoNotOptimize(neighbors.data());
+    }));
+
+    PrintThroughput("All (26): AllNeighbors (Fill)", Count, BestOf([&]() {
+        Neighbors::AllNeighbors(codes.data(), Count, neighbors.data(), mortonnd::MortonNDBoundary::Fill);
+        DoNotOptimize(neighbors.data());
+    }));
+
+    PrintThroughput("All (26): AllNeighbors (Wrap)", Count, BestOf([&]() {
+        Neighbors::AllNeighbors(codes.data(), Count, neighbors.data());
+        DoNotOptimize(neighbors.data());
+    }));
+}
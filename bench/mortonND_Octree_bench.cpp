@@ -0,0 +1,62 @@
+#include "mortonND_Octree_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_Octree.h>
+
+#include <algorithm>
+#include <vector>
+
+using Octree = mortonnd::MortonNDOctree<3, uint64_t, 21>;
+
+// Sorted 63-bit codes: half uniform, half in a few small clusters (so that the tree is deep
+// and unbalanced around them).
+static std::vector<uint64_t> ClusteredCodes(size_t count) {
+    auto codes = RandomValues<uint64_t>(count, 63, 0);
+    const auto offsets = RandomValues<uint64_t>(count / 2, 24, 1);
+    for (size_t n = 0; n < count / 2; n++) {
+        codes[n] = (codes[n % 16] & ~uint64_t(0xFFFFFF)) | offsets[n];
+    }
+
+    std::sort(codes.begin(), codes.end());
+    return codes;
+}
+
+void mortonnd_octree::BenchBuild() {
+    const auto codes = ClusteredCodes(BenchPoints);
+    std::cout << "3D_64 (" << BenchPoints << " sorted codes, 16 points per leaf):" << std::endl;
+
+    PrintDuration("Build (1 thread)", BestOf([&]() {
+        const Octree tree(codes.data(), codes.size(), 16, 1);
+        DoNotOptimize(tree.Nodes().data());
+    }));
+
+    PrintDuration("Build (all threads)", BestOf([&]() {
+        const Octree tree(codes.data(), codes.size(), 16);
+        DoNotOptimize(tree.Nodes().data());
+    }));
+
+    PrintDuration("Build + Balance (all threads)", BestOf([&]() {
+        Octree tree(codes.data(), codes.size(), 16);
+        tree.Balance(codes.data());
+        DoNotOptimize(tree.Nodes().data());
+    }));
+
+    const Octree tree(codes.data(), codes.size(), 16);
+    std::cout << "  (" << tree.size() << " nodes)" << std::endl;
+
+    PrintThroughput("Locate (from the root)", codes.size(), BestOf([&]() {
+        size_t sum = 0;
+        for (const auto code : codes) {
+            sum += tree.Locate(code);
+        }
+        DoNotOptimize(sum);
+    }));
+
+    PrintThroughput("Locate (hinted, in Morton order)", codes.size(), BestOf([&]() {
+        size_t node = 0;
+        for (const auto code : codes) {
+            node = tree.Locate(code, node);
+        }
+        DoNotOptimize(node);
+    }));
+}
@@ -0,0 +1,64 @@
+#include "mortonND_Pack_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_Pack.h>
+#include <morton-nd/mortonND_Sort.h>
+
+#include <algorithm>
+#include <cstring>
+
+// Packs the sorted 63-bit codes of 3D points whose fields use 'fieldBits' bits (so denser points
+// have smaller deltas), and compares decoding against copying the raw codes.
+static void BenchDecode3D(size_t fieldBits) {
+    using MortonND = mortonnd::MortonNDBmi_3D_64;
+    using Pack = mortonnd::MortonNDDeltaPackFor<MortonND>;
+
+    const std::vector<uint64_t> fields[3] = {
+        RandomValues<uint64_t>(BenchPoints, fieldBits, 0), RandomValues<uint64_t>(BenchPoints, fieldBits, 1), RandomValues<uint64_t>(BenchPoints, fieldBits, 2)
+    };
+
+    std::vector<uint64_t> codes(BenchPoints);
+    std::vector<uint32_t> indices(BenchPoints);
+    mortonnd::SortByMorton<3>(mortonnd::MortonNDStatic<MortonND>{}, {{ fields[0].data(), fields[1].data(), fields[2].data() }},
+        BenchPoints, codes.data(), indices.data(), 63);
+
+    const Pack pack(codes.data(), codes.size());
+    std::cout << "3D_64, " << fieldBits << " bits/field (" << BenchPoints << " codes, " << std::fixed << std::setprecision(2)
+              << double(pack.Bytes() * 8) / BenchPoints << " bits/code, " << double(codes.size() * sizeof(uint64_t)) / pack.Bytes()
+              << "x smaller, vector = " << Pack::VectorDecode << "):" << std::endl;
+
+    std::vector<uint64_t> decoded(BenchPoints);
+    PrintThroughput("Copy raw codes (memcpy)", BenchPoints, BestOf([&]() {
+        std::memcpy(decoded.data(), codes.data(), codes.size() * sizeof(uint64_t));
+        DoNotOptimize(decoded.data());
+    }));
+
+    PrintThroughput("Decode", BenchPoints, BestOf([&]() {
+        pack.Decode(decoded.data());
+        DoNotOptimize(decoded.data());
+    }));
+
+    // Random lookups.
+    const auto targets = RandomValues<uint64_t>(BenchPoints / 16, 3 * fieldBits, 3);
+    size_t found = 0;
+    PrintThroughput("LowerBound (raw codes, std::lower_bound)", targets.size(), BestOf([&]() {
+        for (auto target : targets) {
+            found += size_t(std::lower_bound(codes.begin(), codes.end(), target) - codes.begin());
+        }
+    }));
+
+    PrintThroughput("LowerBound (packed)", targets.size(), BestOf([&]() {
+        for (auto target : targets) {
+            found += pack.LowerBound(target);
+        }
+    }));
+
+    DoNotOptimize(found);
+}
+
+void mortonnd_pack::BenchDecode() {
+    BenchDecode3D(10);
+    BenchDecode3D(14);
+    BenchDecode3D(21);
+}
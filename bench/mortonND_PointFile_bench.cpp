@@ -0,0 +1,81 @@
+#include "mortonND_PointFile_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_PointFile.h>
+#include <morton-nd/mortonND_Sort.h>
+
+#include <cstdio>
+#include <random>
+
+// Writes 3D points (3 21-bit 'uint32_t' fields and an ID) to a point file with 'codec', and
+// compares the latency of small box queries against a full scan of the file.
+static void BenchQuery3D(mortonnd::MortonNDBlockCodec codec, const char* name) {
+    using MortonND = mortonnd::MortonNDBmi_3D_64;
+    using Range = mortonnd::MortonNDRange_3D_64;
+    static const size_t Points = BenchPoints / 4;
+    static const size_t Queries = 100;
+    static const std::string Path = "/tmp/mortonnd-pointfile-bench";
+
+    struct Point {
+        uint32_t fields[3];
+        uint32_t id;
+    };
+
+    std::vector<uint64_t> fields[3] = {
+        RandomValues<uint64_t>(Points, 21, 0), RandomValues<uint64_t>(Points, 21, 1), RandomValues<uint64_t>(Points, 21, 2)
+    };
+
+    std::vector<uint64_t> codes(Points);
+    std::vector<uint32_t> indices(Points);
+    mortonnd::SortByMorton<3>(mortonnd::MortonNDStatic<MortonND>{}, {{ fields[0].data(), fields[1].data(), fields[2].data() }},
+        Points, codes.data(), indices.data(), 63);
+
+    {
+        mortonnd::MortonNDPointFileWriter<uint64_t> writer(Path, sizeof(Point), codec);
+        for (size_t n = 0; n < Points; n++) {
+            const auto i = indices[n];
+            const Point point{ { uint32_t(fields[0][i]), uint32_t(fields[1][i]), uint32_t(fields[2][i]) }, i };
+            writer.Append(codes[n], &point);
+        }
+        writer.Finish();
+    }
+
+    const mortonnd::MortonNDPointFileReader<uint64_t> reader(Path);
+    const auto& last = reader.BlockInfo(reader.BlockCount() - 1);
+    std::cout << "3D_64 " << name << " (" << Points << " points, " << reader.BlockCount() << " blocks, "
+              << (last.offset + last.bytes) / (1 << 20) << " MiB):" << std::endl;
+
+    // Boxes spanning 1/8 of each axis.
+    std::mt19937_64 rng(0);
+    std::vector<std::pair<uint64_t, uint64_t>> boxes(Queries);
+    for (auto& box : boxes) {
+        uint64_t lo[3], hi[3];
+        for (size_t f = 0; f < 3; f++) {
+            lo[f] = rng() % ((1 << 21) - (1 << 18));
+            hi[f] = lo[f] + (1 << 18) - 1;
+        }
+        box = { MortonND::Encode(lo[0], lo[1], lo[2]), MortonND::Encode(hi[0], hi[1], hi[2]) };
+    }
+
+    size_t found = 0;
+    PrintDuration("Query (per box)", BestOf([&]() {
+        for (const auto& box : boxes) {
+            reader.Query<3, 21>(box.first, box.second, [&](uint64_t, const unsigned char*) { found++; });
+        }
+    }) / Queries);
+
+    PrintDuration("Full scan (per box)", BestOf([&]() {
+        for (size_t q = 0; q < Queries / 10; q++) {
+            reader.Scan([&](uint64_t code, const unsigned char*) { found += Range::InBox(code, boxes[q].first, boxes[q].second); });
+        }
+    }) / (Queries / 10));
+
+    DoNotOptimize(found);
+    std::remove(Path.c_str());
+}
+
+void mortonnd_pointfile::BenchQuery() {
+    BenchQuery3D(mortonnd::MortonNDBlockCodec::Raw, "raw");
+    BenchQuery3D(mortonnd::MortonNDBlockCodec::DeltaVarint, "delta varint");
+}
@@ -0,0 +1,69 @@
+#include "mortonND_Quantize_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_Quantize.h>
+
+// Compares a separate quantize pass followed by 'EncodeBatch' against the fused batch functions,
+// for 3D float points (SoA) in 64-bit codes.
+static void BenchQuantize3D() {
+    using MortonND = mortonnd::MortonNDBmi_3D_64;
+    using Quantizer = mortonnd::MortonNDQuantizer<3, float, uint64_t>;
+    const auto engine = mortonnd::MortonNDStatic<MortonND>{};
+    const Quantizer quantizer({{ -100, -100, -100 }}, {{ 1000, 1000, 1000 }});
+
+    std::cout << "3D_64 float (" << BenchPoints << " points, vector = " << Quantizer::VectorBatch << "):" << std::endl;
+
+    std::vector<float> coordinates[3];
+    for (size_t d = 0; d < 3; d++) {
+        const auto values = RandomValues<uint32_t>(BenchPoints, 24, d);
+        coordinates[d].resize(BenchPoints);
+        for (size_t n = 0; n < BenchPoints; n++) {
+            coordinates[d][n] = float(values[n]) / float(1 << 24) * 200.0f - 100.0f;
+        }
+    }
+
+    std::vector<uint64_t> fields[3] = { std::vector<uint64_t>(BenchPoints), std::vector<uint64_t>(BenchPoints), std::vector<uint64_t>(BenchPoints) };
+    std::vector<uint64_t> codes(BenchPoints);
+
+    PrintThroughput("Encode: quantize pass + EncodeBatch", BenchPoints, BestOf([&]() {
+        for (size_t d = 0; d < 3; d++) {
+            for (size_t n = 0; n < BenchPoints; n++) {
+                fields[d][n] = quantizer.Quantize(d, coordinates[d][n]);
+            }
+        }
+        MortonND::EncodeBatch({{ fields[0].data(), fields[1].data(), fields[2].data() }}, codes.data(), BenchPoints);
+        DoNotOptimize(codes.data());
+    }));
+
+    PrintThroughput("Encode: fused (affine)", BenchPoints, BestOf([&]() {
+        quantizer.EncodeBatch(engine, {{ coordinates[0].data(), coordinates[1].data(), coordinates[2].data() }}, codes.data(), BenchPoints);
+        DoNotOptimize(codes.data());
+    }));
+
+    PrintThroughput("Encode: fused (ordered)", BenchPoints, BestOf([&]() {
+        Quantizer().EncodeBatch(engine, {{ coordinates[0].data(), coordinates[1].data(), coordinates[2].data() }}, codes.data(), BenchPoints);
+        DoNotOptimize(codes.data());
+    }));
+
+    std::vector<float> decoded[3] = { std::vector<float>(BenchPoints), std::vector<float>(BenchPoints), std::vector<float>(BenchPoints) };
+
+    PrintThroughput("Decode: DecodeBatch + dequantize pass", BenchPoints, BestOf([&]() {
+        MortonND::DecodeBatch(codes.data(), BenchPoints, {{ fields[0].data(), fields[1].data(), fields[2].data() }});
+        for (size_t d = 0; d < 3; d++) {
+            for (size_t n = 0; n < BenchPoints; n++) {
+                decoded[d][n] = quantizer.Dequantize(d, fields[d][n]);
+            }
+        }
+        DoNotOptimize(decoded[0].data());
+    }));
+
+    PrintThroughput("Decode: fused (affine)", BenchPoints, BestOf([&]() {
+        quantizer.DecodeBatch(engine, codes.data(), BenchPoints, {{ decoded[0].data(), decoded[1].data(), decoded[2].data() }});
+        DoNotOptimize(decoded[0].data());
+    }));
+}
+
+void mortonnd_quantize::BenchQuantize() {
+    BenchQuantize3D();
+}
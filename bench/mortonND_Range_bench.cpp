@@ -0,0 +1,114 @@
+#include "mortonND_Range_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_Range.h>
+
+#include <algorithm>
+
+void mortonnd_range::BenchQuery() {
+    using MortonND = mortonnd::MortonNDBmi_3D_64;
+    using Range = mortonnd::MortonNDRange_3D_64;
+    static const size_t Queries = 1000;
+    static const uint64_t Extent = uint64_t(1) << 21;
+    static const uint64_t BoxSize = Extent / 64;
+
+    std::cout << "3D_64 (" << BenchPoints << " sorted points, " << Queries << " boxes of 1/64 extent per axis):" << std::endl;
+
+    std::vector<uint64_t> codes(BenchPoints);
+    {
+        const auto xs = RandomValues<uint64_t>(BenchPoints, 21, 0);
+        const auto ys = RandomValues<uint64_t>(BenchPoints, 21, 1);
+        const auto zs = RandomValues<uint64_t>(BenchPoints, 21, 2);
+        MortonND::EncodeBatch({{ xs.data(), ys.data(), zs.data() }}, codes.data(), BenchPoints);
+    }
+    std::sort(codes.begin(), codes.end());
+
+    std::vector<std::pair<uint64_t, uint64_t>> boxes(Queries);
+    {
+        const auto corners = RandomValues<uint64_t>(Queries * 3, 21, 3);
+        for (size_t q = 0; q < Queries; q++) {
+            const auto x = corners[q * 3] % (Extent - BoxSize);
+            const auto y = corners[q * 3 + 1] % (Extent - BoxSize);
+            const auto z = corners[q * 3 + 2] % (Extent - BoxSize);
+            boxes[q] = { MortonND::Encode(x, y, z), MortonND::Encode(x + BoxSize, y + BoxSize, z + BoxSize) };
+        }
+    }
+
+    size_t scanned = 0, found = 0;
+    PrintDuration("Scan [min, max] with InBox filter", BestOf([&]() {
+        scanned = found = 0;
+        for (const auto& box : boxes) {
+            auto it = std::lower_bound(codes.begin(), codes.end(), box.first);
+            const auto end = std::upper_bound(it, codes.end(), box.second);
+            scanned += end - it;
+            for (; it != end; ++it) {
+                found += Range::InBox(*it, box.first, box.second);
+            }
+        }
+        DoNotOptimize(found);
+    }));
+    std::cout << "    " << found << " points found, " << scanned << " scanned" << std::endl;
+
+    size_t skips = 0;
+    PrintDuration("Query with BIGMIN skips", BestOf([&]() {
+        found = skips = 0;
+        for (const auto& box : boxes) {
+            const auto range = Range::Query(codes.begin(), codes.end(), box.first, box.second);
+            auto it = range.begin();
+            for (; it != range.end(); ++it) {
+                found++;
+            }
+            skips += it.SkipCount();
+        }
+        DoNotOptimize(found);
+    }));
+    std::cout << "    " << found << " points found, " << skips << " skips" << std::endl;
+}
+
+void mortonnd_range::BenchDecompose() {
+    using MortonND = mortonnd::MortonNDBmi_3D_64;
+    using Range = mortonnd::MortonNDRange_3D_64;
+    static const size_t Queries = 1000;
+    static const uint64_t Extent = uint64_t(1) << 21;
+    static const uint64_t BoxSize = Extent / 64;
+
+    std::cout << "3D_64 (" << Queries << " boxes of up to 1/64 extent per axis):" << std::endl;
+
+    std::vector<std::pair<uint64_t, uint64_t>> boxes(Queries);
+    double volume = 0;
+    {
+        const auto corners = RandomValues<uint64_t>(Queries * 6, 21, 4);
+        for (size_t q = 0; q < Queries; q++) {
+            const auto x = corners[q * 6] % (Extent - BoxSize);
+            const auto y = corners[q * 6 + 1] % (Extent - BoxSize);
+            const auto z = corners[q * 6 + 2] % (Extent - BoxSize);
+            const auto w = 1 + corners[q * 6 + 3] % BoxSize;
+            const auto h = 1 + corners[q * 6 + 4] % BoxSize;
+            const auto d = 1 + corners[q * 6 + 5] % BoxSize;
+            boxes[q] = { MortonND::Encode(x, y, z), MortonND::Encode(x + w - 1, y + h - 1, z + d - 1) };
+            volume += double(w) * double(h) * double(d);
+        }
+    }
+
+    for (size_t maxDepth : { 6, 8, 10 }) {
+        for (size_t maxIntervals : { 1, 8, 64, 512 }) {
+            size_t intervals = 0;
+            double falsePositives = 0;
+            const auto seconds = BestOf([&]() {
+                intervals = 0;
+                falsePositives = 0;
+                for (const auto& box : boxes) {
+                    const auto decomposition = Range::Decompose(box.first, box.second, maxIntervals, maxDepth);
+                    intervals += decomposition.intervals.size();
+                    falsePositives += double(decomposition.falsePositives);
+                }
+                DoNotOptimize(intervals);
+            });
+
+            PrintDuration("Depth " + std::to_string(maxDepth) + ", <= " + std::to_string(maxIntervals) + " intervals", seconds);
+            std::cout << "    " << std::fixed << std::setprecision(1) << double(intervals) / Queries << " intervals/box, "
+                      << std::setprecision(3) << falsePositives / volume << " false positives per code in box" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_range {
+void BenchQuery();
+void BenchDecompose();
+}
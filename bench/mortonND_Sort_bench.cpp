@@ -0,0 +1,50 @@
+#include "mortonND_Sort_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_Sort.h>
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+// Compares 'EncodeBatch' followed by 'std::sort' of (code, index) pairs against 'SortByMorton',
+// for 3D points (SoA) in 64-bit codes.
+static void BenchSort3D() {
+    using MortonND = mortonnd::MortonNDBmi_3D_64;
+    const auto engine = mortonnd::MortonNDStatic<MortonND>{};
+
+    std::cout << "3D_64 (" << BenchPoints << " points):" << std::endl;
+
+    const std::vector<uint64_t> fields[3] = {
+        RandomValues<uint64_t>(BenchPoints, 21, 0), RandomValues<uint64_t>(BenchPoints, 21, 1), RandomValues<uint64_t>(BenchPoints, 21, 2)
+    };
+    const std::array<const uint64_t*, 3> soa = {{ fields[0].data(), fields[1].data(), fields[2].data() }};
+
+    std::vector<uint64_t> codes(BenchPoints);
+    std::vector<uint32_t> indices(BenchPoints);
+
+    PrintDuration("EncodeBatch + std::sort (code, index)", BestOf([&]() {
+        std::vector<std::pair<uint64_t, uint32_t>> pairs(BenchPoints);
+        MortonND::EncodeBatch(soa, codes.data(), BenchPoints);
+        for (size_t n = 0; n < BenchPoints; n++) {
+            pairs[n] = { codes[n], uint32_t(n) };
+        }
+        std::sort(pairs.begin(), pairs.end());
+        DoNotOptimize(pairs.data());
+    }));
+
+    PrintDuration("SortByMorton (1 thread)", BestOf([&]() {
+        mortonnd::SortByMorton<3>(engine, soa, BenchPoints, codes.data(), indices.data(), 63, 1);
+        DoNotOptimize(codes.data());
+    }));
+
+    PrintDuration("SortByMorton (all threads)", BestOf([&]() {
+        mortonnd::SortByMorton<3>(engine, soa, BenchPoints, codes.data(), indices.data(), 63);
+        DoNotOptimize(codes.data());
+    }));
+}
+
+void mortonnd_sort::BenchSort() {
+    BenchSort3D();
+}
@@ -0,0 +1,97 @@
+#include "mortonND_Swizzle_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_Swizzle.h>
+
+#include <cstring>
+
+// Prints a bandwidth line (bytes read + written) for copying 'bytes' in 'seconds'.
+static void PrintBandwidth(const std::string& name, size_t bytes, double seconds) {
+    std::cout << "  " << std::left << std::setw(48) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1)
+              << (2.0 * double(bytes) / seconds / 1e9) << " GB/s" << std::endl;
+}
+
+template<typename T>
+static void BenchSwizzle2D(size_t extent, const std::string& what) {
+    using MortonND = mortonnd::MortonNDBmi<2, uint64_t>;
+    const size_t count = extent * extent, bytes = count * sizeof(T);
+    std::cout << what << " (" << extent << " x " << extent << ", " << (bytes >> 20) << " MiB):" << std::endl;
+
+    const auto source = RandomValues<T>(count, 8 * sizeof(T), 0);
+    std::vector<T> morton(count), restored(count);
+
+    PrintBandwidth("memcpy", bytes, BestOf([&]() {
+        std::memcpy(morton.data(), source.data(), bytes);
+        DoNotOptimize(morton.data());
+    }));
+
+    PrintBandwidth("Encode per element", bytes, BestOf([&]() {
+        for (size_t y = 0; y < extent; y++) {
+            for (size_t x = 0; x < extent; x++) {
+                morton[MortonND::Encode(x, y)] = source[y * extent + x];
+            }
+        }
+        DoNotOptimize(morton.data());
+    }));
+
+    PrintBandwidth("ToMorton (cached stores)", bytes, BestOf([&]() {
+        mortonnd::ToMorton<2>(source.data(), morton.data(), {{ extent, extent }}, mortonnd::MortonNDStores::Cached);
+        DoNotOptimize(morton.data());
+    }));
+
+    PrintBandwidth("ToMorton (streaming stores)", bytes, BestOf([&]() {
+        mortonnd::ToMorton<2>(source.data(), morton.data(), {{ extent, extent }}, mortonnd::MortonNDStores::Streaming);
+        DoNotOptimize(morton.data());
+    }));
+
+    PrintBandwidth("FromMorton (cached stores)", bytes, BestOf([&]() {
+        mortonnd::FromMorton<2>(morton.data(), restored.data(), {{ extent, extent }}, mortonnd::MortonNDStores::Cached);
+        DoNotOptimize(restored.data());
+    }));
+
+    PrintBandwidth("FromMorton (streaming stores)", bytes, BestOf([&]() {
+        mortonnd::FromMorton<2>(morton.data(), restored.data(), {{ extent, extent }}, mortonnd::MortonNDStores::Streaming);
+        DoNotOptimize(restored.data());
+    }));
+}
+
+template<typename T>
+static void BenchSwizzle3D(size_t extent, const std::string& what) {
+    using MortonND = mortonnd::MortonNDBmi<3, uint64_t>;
+    const size_t count = extent * extent * extent, bytes = count * sizeof(T);
+    std::cout << what << " (" << extent << "^3, " << (bytes >> 20) << " MiB):" << std::endl;
+
+    const auto source = RandomValues<T>(count, 8 * sizeof(T), 0);
+    std::vector<T> morton(count), restored(count);
+
+    PrintBandwidth("Encode per element", bytes, BestOf([&]() {
+        for (size_t z = 0; z < extent; z++) {
+            for (size_t y = 0; y < extent; y++) {
+                for (size_t x = 0; x < extent; x++) {
+                    morton[MortonND::Encode(x, y, z)] = source[(z * extent + y) * extent + x];
+                }
+            }
+        }
+        DoNotOptimize(morton.data());
+    }));
+
+    PrintBandwidth("ToMorton (auto stores)", bytes, BestOf([&]() {
+        mortonnd::ToMorton<3>(source.data(), morton.data(), {{ extent, extent, extent }});
+        DoNotOptimize(morton.data());
+    }));
+
+    PrintBandwidth("FromMorton (auto stores)", bytes, BestOf([&]() {
+        mortonnd::FromMorton<3>(morton.data(), restored.data(), {{ extent, extent, extent }});
+        DoNotOptimize(restored.data());
+    }));
+}
+
+void mortonnd_swizzle::BenchSwizzle() {
+    BenchSwizzle2D<uint32_t>(4096, "2D, RGBA8 texels");
+    BenchSwizzle2D<uint8_t>(4096, "2D, 8-bit texels");
+    BenchSwizzle2D<uint64_t>(2048, "2D, 64-bit texels");
+    BenchSwizzle3D<uint8_t>(512, "3D, 8-bit voxels");
+    BenchSwizzle3D<uint32_t>(256, "3D, 32-bit voxels");
+}
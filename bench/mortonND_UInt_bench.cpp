@@ -0,0 +1,77 @@
+#include "mortonND_UInt_bench.h"
+#include "mortonND_bench_util.h"
+
+#include <morton-nd/mortonND_UInt.h>
+#include <morton-nd/mortonND_LUT.h>
+#include <morton-nd/mortonND_BMI2.h>
+
+using mortonnd::UInt;
+
+/**
+ * A 'UInt' the engines don't recognize, so that they fall back to their generic (whole-value
+ * shifting) paths. This stands in for a user-supplied "big integer" class.
+ */
+template<std::size_t Bits>
+struct OpaqueUInt : UInt<Bits> {
+    using UInt<Bits>::UInt;
+    OpaqueUInt(const UInt<Bits>& value) : UInt<Bits>(value) {}
+};
+
+template<typename T, size_t Fields, size_t FieldBits, typename Encode, typename Decode, size_t ...i>
+void BenchWideEngine(const char* name, Encode encode, Decode decode, std::index_sequence<i...>) {
+    std::cout << name << " (" << BenchPoints << " points):" << std::endl;
+
+    std::vector<T> fields[Fields];
+    for (size_t f = 0; f < Fields; f++) {
+        const auto values = RandomValues<uint64_t>(BenchPoints, FieldBits, f);
+        fields[f].assign(values.begin(), values.end());
+    }
+
+    std::vector<T> codes(BenchPoints);
+    T* out = codes.data();
+
+    PrintThroughput("Encode (scalar loop)", BenchPoints, BestOf([&]() {
+        for (size_t n = 0; n < BenchPoints; n++) {
+            out[n] = encode(fields[i][n]...);
+        }
+        DoNotOptimize(out[0]);
+    }));
+
+    PrintThroughput("Decode (scalar loop)", BenchPoints, BestOf([&]() {
+        for (size_t n = 0; n < BenchPoints; n++) {
+            std::tie(fields[i][n]...) = decode(out[n]);
+        }
+        DoNotOptimize(fields[0][0]);
+    }));
+}
+
+template<typename T, size_t Fields, size_t FieldBits, size_t LutBits>
+void BenchWideLut(const char* name) {
+    static constexpr auto encoder = mortonnd::MortonNDLutEncoder<Fields, FieldBits, LutBits, T>();
+    static constexpr auto decoder = mortonnd::MortonNDLutDecoder<Fields, FieldBits, LutBits, T>();
+
+    BenchWideEngine<T, Fields, FieldBits>(name,
+        [](auto... fields) { return encoder.Encode(fields...); },
+        [](T encoding) { return decoder.Decode(encoding); },
+        std::make_index_sequence<Fields>{});
+}
+
+template<typename T, size_t Fields>
+void BenchWideBmi(const char* name) {
+    using MortonND = mortonnd::MortonNDBmi<Fields, T>;
+
+    BenchWideEngine<T, Fields, MortonND::FieldBits>(name,
+        [](auto... fields) { return MortonND::Encode(fields...); },
+        [](T encoding) { return MortonND::Decode(encoding); },
+        std::make_index_sequence<Fields>{});
+}
+
+void mortonnd_uint::BenchWide() {
+    BenchWideLut<__uint128_t, 3, 42, 14>("MortonNDLut 3D, 42-bit fields, __uint128_t");
+    BenchWideLut<UInt<128>, 3, 42, 14>("MortonNDLut 3D, 42-bit fields, UInt<128>");
+    BenchWideLut<OpaqueUInt<256>, 8, 32, 8>("MortonNDLut 8D, 32-bit fields, UInt<256> (generic path)");
+    BenchWideLut<UInt<256>, 8, 32, 8>("MortonNDLut 8D, 32-bit fields, UInt<256>");
+    BenchWideBmi<__uint128_t, 3>("MortonNDBmi 3D, 42-bit fields, __uint128_t");
+    BenchWideBmi<UInt<128>, 3>("MortonNDBmi 3D, 42-bit fields, UInt<128>");
+    BenchWideBmi<UInt<256>, 8>("MortonNDBmi 8D, 32-bit fields, UInt<256>");
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+
+struct bench_method {
+    void (*bench_func)();
+    std::string description;
+
+    bench_method(void(*bench_func)(), std::string description) : bench_func(bench_func), description(description) {}
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Number of points processed by each benchmark run.
+ */
+static constexpr size_t BenchPoints = size_t(1) << 24;
+
+/**
+ * Number of runs per benchmark. The fastest run is reported.
+ */
+static constexpr size_t BenchRuns = 5;
+
+/**
+ * Prevents the compiler from optimizing away 'value'.
+ */
+template<typename T>
+static inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Runs 'func' 'BenchRuns' times and returns the fastest run, in seconds.
+ */
+template<typename F>
+static double BestOf(F func) {
+    double best = 0;
+    for (size_t run = 0; run < BenchRuns; run++) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const auto end = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(end - start).count();
+        best = (run == 0 || seconds < best) ? seconds : best;
+    }
+
+    return best;
+}
+
+/**
+ * Prints a throughput line for 'items' processed in 'seconds'.
+ */
+static void PrintThroughput(const std::string& name, size_t items, double seconds) {
+    std::cout << "  " << std::left << std::setw(48) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1)
+              << (double(items) / seconds / 1e6) << " M/s" << std::endl;
+}
+
+/**
+ * Prints a line with the duration of a benchmark run, in milliseconds.
+ */
+static void PrintDuration(const std::string& name, double seconds) {
+    std::cout << "  " << std::left << std::setw(48) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1)
+              << (seconds * 1e3) << " ms" << std::endl;
+}
+
+/**
+ * Returns 'count' uniformly distributed random values, masked to 'bits' LSbs.
+ */
+template<typename T>
+static std::vector<T> RandomValues(size_t count, size_t bits, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    const T mask = bits >= size_t(std::numeric_limits<T>::digits) ? T(~T(0)) : T((T(1) << bits) - 1);
+
+    std::vector<T> values(count);
+    for (auto& value : values) {
+        value = T(rng()) & mask;
+    }
+
+    return values;
+}
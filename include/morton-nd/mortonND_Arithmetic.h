@@ -0,0 +1,220 @@
+//
+//  mortonND_Arithmetic.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_ARITHMETIC_H
+#define MORTON_ND_MORTONND_ARITHMETIC_H
+
+#include "mortonND_Magic.h"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace mortonnd {
+
+/**
+ * Per-field arithmetic directly on Morton codes ("dilated integer" arithmetic), without decoding.
+ *
+ * Each field of a Morton code is a dilated integer: its bits are spread out, with the bits of
+ * the other fields in between. To add to a single field, the bits in between are set to 1 in one
+ * operand (so that carries propagate across them) and cleared in the other, and the sum is masked
+ * back to the field:
+ *
+ *   sum = ((a | ~selector) + (b & selector)) & selector
+ *
+ * Subtraction works the same way, with borrows propagating across the cleared bits:
+ *
+ *   difference = ((a & selector) - (b & selector)) & selector
+ *
+ * The selectors are 'MortonNDMagic::Selector', which match the layout produced by every engine
+ * ('MortonNDBmi', 'MortonNDLutEncoder', 'MortonNDMagic'), so codes from any of them can be used.
+ * Each operation costs a few ALU instructions, versus a full decode and encode per step.
+ *
+ * All operations are constexpr. Fields wrap around modulo 2^'FieldBits' (i.e. incrementing the
+ * maximum coordinate yields 0), and other fields are never affected.
+ *
+ * Configuration:
+ *
+ * Dimensions
+ *   The number of fields (components) in each code.
+ *
+ * T
+ *   The type of the Morton codes. Must be an unsigned integer type (including '__uint128_t',
+ *   if your compiler supports it).
+ *
+ * FieldBits
+ *   The number of bits in each field. Defaults to the most that fit in 'T'.
+ *
+ * @tparam Dimensions the number of fields (components) in each code.
+ * @tparam T the type of the Morton codes.
+ * @tparam FieldBits the number of bits in each field.
+ */
+template<std::size_t Dimensions, typename T, std::size_t FieldBits = std::size_t(std::numeric_limits<T>::digits) / Dimensions>
+class MortonNDArithmetic
+{
+    using Magic = MortonNDMagic<Dimensions, T, FieldBits>;
+
+public:
+    /**
+     * Returns the mask of the bits belonging to field 'Field' (the field's selector).
+     */
+    template<std::size_t Field>
+    static constexpr T Selector()
+    {
+        static_assert(Field < Dimensions, "'Field' must be < 'Dimensions'.");
+        return FieldSelector<Field>::value;
+    }
+
+    /**
+     * Returns the code of the point with 'delta' in field 'Field', and 0 in every other field.
+     *
+     * Bits of 'delta' above 'FieldBits' are ignored, so negative deltas can be passed in two's
+     * complement (e.g. 'T(-2)').
+     */
+    template<std::size_t Field>
+    static constexpr T DilateAxis(T delta)
+    {
+        return Magic::Dilate(delta) << Field;
+    }
+
+    /**
+     * Adds 'delta' to field 'Field' of 'code'.
+     *
+     * Example:
+     *   AddAxis<1>(Encode(x, y, z), 3) == Encode(x, y + 3, z)
+     *
+     * @param code the Morton code.
+     * @param delta the (undilated) amount to add. May be negative, in two's complement.
+     */
+    template<std::size_t Field>
+    static constexpr T AddAxis(T code, T delta)
+    {
+        return AddDilated<Field>(code, DilateAxis<Field>(delta));
+    }
+
+    /**
+     * Subtracts 'delta' from field 'Field' of 'code'.
+     */
+    template<std::size_t Field>
+    static constexpr T SubAxis(T code, T delta)
+    {
+        return SubDilated<Field>(code, DilateAxis<Field>(delta));
+    }
+
+    /**
+     * Adds the field 'Field' of 'dilated' (e.g. from 'DilateAxis') to field 'Field' of 'code'.
+     *
+     * This is the cheapest form, for deltas which are reused across many codes.
+     */
+    template<std::size_t Field>
+    static constexpr T AddDilated(T code, T dilated)
+    {
+        return (((code | ~Selector<Field>()) + (dilated & Selector<Field>())) & Selector<Field>()) | (code & ~Selector<Field>());
+    }
+
+    /**
+     * Subtracts the field 'Field' of 'dilated' (e.g. from 'DilateAxis') from field 'Field' of 'code'.
+     */
+    template<std::size_t Field>
+    static constexpr T SubDilated(T code, T dilated)
+    {
+        return (((code & Selector<Field>()) - (dilated & Selector<Field>())) & Selector<Field>()) | (code & ~Selector<Field>());
+    }
+
+    /**
+     * Adds 1 to field 'Field' of 'code'.
+     */
+    template<std::size_t Field>
+    static constexpr T IncAxis(T code)
+    {
+        return AddDilated<Field>(code, T(1) << Field);
+    }
+
+    /**
+     * Subtracts 1 from field 'Field' of 'code'.
+     */
+    template<std::size_t Field>
+    static constexpr T DecAxis(T code)
+    {
+        return SubDilated<Field>(code, T(1) << Field);
+    }
+
+    /**
+     * Adds each field of 'b' to the corresponding field of 'a'.
+     *
+     * Example:
+     *   AddCodes(Encode(x1, y1), Encode(x2, y2)) == Encode(x1 + x2, y1 + y2)
+     */
+    static constexpr T AddCodes(T a, T b)
+    {
+        return AddCodesInternal(a, b, std::make_index_sequence<Dimensions>{});
+    }
+
+    /**
+     * Subtracts each field of 'b' from the corresponding field of 'a'.
+     *
+     * Example:
+     *   SubCodes(Encode(x1, y1), Encode(x2, y2)) == Encode(x1 - x2, y1 - y2)
+     */
+    static constexpr T SubCodes(T a, T b)
+    {
+        return SubCodesInternal(a, b, std::make_index_sequence<Dimensions>{});
+    }
+
+private:
+    MortonNDArithmetic() = default;
+
+    // Forces each selector to be computed at compile-time, regardless of the context of the call.
+    template<std::size_t Field>
+    using FieldSelector = std::integral_constant<T, Magic::Selector(Field)>;
+
+    template<std::size_t... i>
+    static constexpr T AddCodesInternal(T a, T b, std::index_sequence<i...>)
+    {
+        T result = 0;
+
+        using expander = int[];
+        (void)expander{ 0, (void(result |= ((a | ~Selector<i>()) + (b & Selector<i>())) & Selector<i>()), 0)... };
+
+        return result;
+    }
+
+    template<std::size_t... i>
+    static constexpr T SubCodesInternal(T a, T b, std::index_sequence<i...>)
+    {
+        T result = 0;
+
+        using expander = int[];
+        (void)expander{ 0, (void(result |= ((a & Selector<i>()) - (b & Selector<i>())) & Selector<i>()), 0)... };
+
+        return result;
+    }
+};
+
+/**
+ * Type alias for arithmetic on 2D 32-bit codes.
+ */
+using MortonNDArithmetic_2D_32 = MortonNDArithmetic<2, uint32_t>;
+
+/**
+ * Type alias for arithmetic on 2D 64-bit codes.
+ */
+using MortonNDArithmetic_2D_64 = MortonNDArithmetic<2, uint64_t>;
+
+/**
+ * Type alias for arithmetic on 3D 32-bit codes.
+ */
+using MortonNDArithmetic_3D_32 = MortonNDArithmetic<3, uint32_t>;
+
+/**
+ * Type alias for arithmetic on 3D 64-bit codes.
+ */
+using MortonNDArithmetic_3D_64 = MortonNDArithmetic<3, uint64_t>;
+
+}
+
+#endif
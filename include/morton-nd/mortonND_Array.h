@@ -0,0 +1,468 @@
+//
+//  mortonND_Array.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_ARRAY_H
+#define MORTON_ND_MORTONND_ARRAY_H
+
+#include "mortonND_Mixed.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace mortonnd {
+
+/**
+ * The bit layout of an element's index in a 'MortonNDArray'.
+ *
+ * The low 'TileBits' bits of each coordinate select an element within a tile of 2^'TileBits'
+ * elements per axis, which is stored in row-major order (axis 0 varying fastest). The remaining
+ * bits select the tile, and are interleaved round-robin (Morton order), so tiles are laid out
+ * along the Z-order curve.
+ *
+ * Example (Dimensions = 2, FieldBits = 3, TileBits = 2):
+ *   Index(x2x1x0, y2y1y0) => y2x2 y1y0x1x0  (a 4x4 row-major tile, then the tile's Morton bits)
+ *
+ * With 'TileBits' = 0, this is the layout produced by every other engine. With 'TileBits' =
+ * 'FieldBits', it's plain row-major order.
+ *
+ * Satisfies the layout requirements of 'MortonNDBmiLayout' and 'MortonNDLutLayoutEncoder'.
+ *
+ * @tparam Axes the number of axes.
+ * @tparam FieldBits the number of bits in each coordinate.
+ * @tparam TileBits the number of (low) bits of each coordinate stored in row-major order.
+ */
+template<std::size_t Axes, std::size_t FieldBits, std::size_t TileBits = 0>
+struct MortonNDTiledLayout
+{
+    static_assert(Axes > 0, "'Axes' must be > 0.");
+    static_assert(TileBits <= FieldBits, "'TileBits' must be <= 'FieldBits'.");
+
+    /**
+     * The number of fields (axes) in each index.
+     */
+    static constexpr std::size_t Dimensions = Axes;
+
+    /**
+     * Returns the number of bits in field 'field'.
+     */
+    static constexpr std::size_t Width(std::size_t)
+    {
+        return FieldBits;
+    }
+
+    /**
+     * Returns the total number of bits in each index.
+     */
+    static constexpr std::size_t CodeBits()
+    {
+        return Dimensions * FieldBits;
+    }
+
+    /**
+     * Returns the offset (in the index) of bit 'bit' of field 'field'.
+     */
+    static constexpr std::size_t Offset(std::size_t field, std::size_t bit)
+    {
+        return bit < TileBits
+            ? field * TileBits + bit
+            : Dimensions * TileBits + (bit - TileBits) * Dimensions + field;
+    }
+
+    /**
+     * Returns the number of bits of field 'field' which land below offset 'offset' in the index.
+     */
+    static constexpr std::size_t BitsBelow(std::size_t field, std::size_t offset)
+    {
+        std::size_t bits = 0;
+        while (bits < Width(field) && Offset(field, bits) < offset) {
+            bits++;
+        }
+
+        return bits;
+    }
+
+    /**
+     * Returns the mask of the bits belonging to field 'field' (the field's selector).
+     *
+     * @tparam T an unsigned integer type with at least 'CodeBits()' bits.
+     */
+    template<typename T>
+    static constexpr T Selector(std::size_t field)
+    {
+        T selector = 0;
+        for (std::size_t bit = 0; bit < Width(field); bit++) {
+            selector |= T(1) << Offset(field, bit);
+        }
+
+        return selector;
+    }
+};
+
+/**
+ * A dense array of 2^'FieldBits' elements per axis, stored in Z-order.
+ *
+ * Elements are stored at their Morton index (see 'MortonNDTiledLayout'), so that elements which
+ * are close in space are (mostly) close in memory, along every axis. Compared to row-major
+ * storage, this improves cache and TLB reuse for access patterns which aren't aligned with a
+ * single axis, such as stencils, blocked traversals and 2D/3D neighborhoods.
+ *
+ * Optionally, the low 'TileBits' bits of each coordinate can be stored in row-major order
+ * within small tiles (themselves stored in Z-order). This keeps short runs along axis 0
+ * contiguous, which suits vectorized inner loops, at the cost of coarser locality along the
+ * other axes.
+ *
+ * Indices are computed with 'MortonNDBmiLayout' when BMI2 is enabled at compile-time, or
+ * 'MortonNDLutLayoutEncoder' / 'MortonNDLutLayoutDecoder' otherwise. For traversals, 'Cursor'
+ * steps along an axis with dilated integer arithmetic (see 'MortonNDArithmetic') directly on
+ * the index, without re-encoding the coordinates.
+ *
+ * Iterating with 'begin()' / 'end()' visits every element in storage (Z) order, which is the
+ * fastest way to visit the whole array. Use 'Coordinates' to recover the position of an element.
+ *
+ * Configuration:
+ *
+ * T
+ *   The element type.
+ *
+ * Dimensions
+ *   The number of axes.
+ *
+ * FieldBits
+ *   The number of bits in each coordinate (the array has an extent of 2^'FieldBits' per axis).
+ *   'Dimensions' * 'FieldBits' must be < the width of 'std::size_t', and the array must fit
+ *   in memory.
+ *
+ * TileBits
+ *   The number of (low) bits of each coordinate stored in row-major order within a tile.
+ *   Defaults to 0 (pure Z-order).
+ *
+ * @tparam T the element type.
+ * @tparam Dimensions the number of axes.
+ * @tparam FieldBits the number of bits in each coordinate.
+ * @tparam TileBits the number of bits in each coordinate within a row-major tile.
+ */
+template<typename T, std::size_t Dimensions, std::size_t FieldBits, std::size_t TileBits = 0>
+class MortonNDArray
+{
+    static_assert(Dimensions > 0, "'Dimensions' must be > 0.");
+    static_assert(FieldBits > 0, "'FieldBits' must be > 0.");
+    static_assert(Dimensions * FieldBits < std::size_t(std::numeric_limits<std::size_t>::digits),
+        "The array's size must fit in 'std::size_t'.");
+
+public:
+    /**
+     * The bit layout of element indices.
+     */
+    using Layout = MortonNDTiledLayout<Dimensions, FieldBits, TileBits>;
+
+    /**
+     * The type of element indices, and of coordinates.
+     */
+    using Index = uint64_t;
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    /**
+     * The number of elements along each axis.
+     */
+    static constexpr Index Extent = Index(1) << FieldBits;
+
+    /**
+     * Returns the mask of the bits of the index belonging to axis 'Axis'.
+     */
+    template<std::size_t Axis>
+    static constexpr Index Selector()
+    {
+        static_assert(Axis < Dimensions, "'Axis' must be < 'Dimensions'.");
+        return Layout::template Selector<Index>(Axis);
+    }
+
+    /**
+     * Returns 'value' dilated into the bits of axis 'Axis' (i.e. the index of the element at
+     * coordinate 'value' along 'Axis', and 0 along every other axis).
+     *
+     * Can be used in constant expressions, e.g. to precompute a step for 'Add'.
+     *
+     * WARNING: 'value' must NOT use more than 'FieldBits' least-significant bits.
+     */
+    template<std::size_t Axis>
+    static constexpr Index Dilate(Index value)
+    {
+        static_assert(Axis < Dimensions, "'Axis' must be < 'Dimensions'.");
+
+        Index dilated = 0;
+        for (std::size_t bit = 0; bit < FieldBits; bit++) {
+            dilated |= ((value >> bit) & 1) << Layout::Offset(Axis, bit);
+        }
+
+        return dilated;
+    }
+
+    /**
+     * Adds the dilated value 'dilated' (see 'Dilate') to the coordinate of 'index' along axis
+     * 'Axis', wrapping around modulo 'Extent'. Other axes are unaffected.
+     *
+     * A step of -n is 'Dilate<Axis>(Extent - n)'.
+     */
+    template<std::size_t Axis>
+    static constexpr Index Add(Index index, Index dilated)
+    {
+        return (((index | ~Selector<Axis>()) + (dilated & Selector<Axis>())) & Selector<Axis>())
+            | (index & ~Selector<Axis>());
+    }
+
+    /**
+     * Returns the index of the element at the specified coordinates.
+     *
+     * WARNING: Coordinates must be < 'Extent'.
+     */
+    template<typename...Args>
+    static inline Index IndexOf(Index coord0, Args... coords)
+    {
+        static_assert(sizeof...(Args) == Dimensions - 1, "'IndexOf' must be called with exactly 'Dimensions' arguments.");
+#if MORTON_ND_BMI2_ENABLED
+        return MortonNDBmiLayout<Index, Layout>::Encode(coord0, Index(coords)...);
+#else
+        return Encoder.Encode(coord0, Index(coords)...);
+#endif
+    }
+
+    /**
+     * Returns the coordinates of the element at index 'index', as a tuple.
+     */
+    static inline auto Coordinates(Index index)
+    {
+#if MORTON_ND_BMI2_ENABLED
+        return MortonNDBmiLayout<Index, Layout>::Decode(index);
+#else
+        return Decoder.Decode(index);
+#endif
+    }
+
+    /**
+     * A position in the array, which can be moved along each axis in a few instructions.
+     *
+     * Moves wrap around modulo 'Extent' along the moved axis (the array is treated as periodic).
+     * Callers handling boundaries differently must check the coordinate before moving.
+     *
+     * @tparam E 'T' or 'const T'.
+     */
+    template<typename E>
+    class BasicCursor
+    {
+    public:
+        BasicCursor(E* data, Index index) : data(data), index(index) {}
+
+        /**
+         * Returns the element at the cursor.
+         */
+        E& operator*() const
+        {
+            return data[index];
+        }
+
+        E* operator->() const
+        {
+            return data + index;
+        }
+
+        /**
+         * Returns the index of the element at the cursor.
+         */
+        Index Position() const
+        {
+            return index;
+        }
+
+        /**
+         * Moves the cursor by 1 along axis 'Axis'.
+         */
+        template<std::size_t Axis>
+        BasicCursor& Next()
+        {
+            index = Add<Axis>(index, Dilate<Axis>(1));
+            return *this;
+        }
+
+        /**
+         * Moves the cursor by -1 along axis 'Axis'.
+         */
+        template<std::size_t Axis>
+        BasicCursor& Prev()
+        {
+            index = Add<Axis>(index, Selector<Axis>());
+            return *this;
+        }
+
+        /**
+         * Moves the cursor by 'delta' along axis 'Axis'.
+         */
+        template<std::size_t Axis>
+        BasicCursor& Move(std::ptrdiff_t delta)
+        {
+            index = Add<Axis>(index, Dilate<Axis>(Index(delta) & (Extent - 1)));
+            return *this;
+        }
+
+        /**
+         * Returns the element at offset 'Delta' along axis 'Axis' from the cursor, without
+         * moving it. The dilated offset is a compile-time constant.
+         */
+        template<std::size_t Axis, std::ptrdiff_t Delta>
+        E& Neighbor() const
+        {
+            return data[Add<Axis>(index, std::integral_constant<Index, Dilate<Axis>(Index(Delta) & (Extent - 1))>::value)];
+        }
+
+    private:
+        E* data;
+        Index index;
+    };
+
+    using Cursor = BasicCursor<T>;
+    using ConstCursor = BasicCursor<const T>;
+
+    /**
+     * Constructs an array of value-initialized elements.
+     */
+    MortonNDArray() : elements(size()) {}
+
+    /**
+     * Constructs an array with every element set to 'value'.
+     */
+    explicit MortonNDArray(const T& value) : elements(size(), value) {}
+
+    /**
+     * Returns the element at the specified coordinates.
+     *
+     * @throws std::out_of_range if any coordinate is >= 'Extent'.
+     */
+    template<typename...Args>
+    T& at(Index coord0, Args... coords)
+    {
+        return elements[CheckedIndexOf(coord0, Index(coords)...)];
+    }
+
+    template<typename...Args>
+    const T& at(Index coord0, Args... coords) const
+    {
+        return elements[CheckedIndexOf(coord0, Index(coords)...)];
+    }
+
+    /**
+     * Returns the element at the specified coordinates, without bounds checks.
+     */
+    template<typename...Args>
+    T& operator()(Index coord0, Args... coords)
+    {
+        return elements[IndexOf(coord0, Index(coords)...)];
+    }
+
+    template<typename...Args>
+    const T& operator()(Index coord0, Args... coords) const
+    {
+        return elements[IndexOf(coord0, Index(coords)...)];
+    }
+
+    /**
+     * Returns the element at index 'index' (see 'IndexOf').
+     */
+    T& operator[](Index index)
+    {
+        return elements[index];
+    }
+
+    const T& operator[](Index index) const
+    {
+        return elements[index];
+    }
+
+    /**
+     * Returns a cursor at the specified coordinates.
+     */
+    template<typename...Args>
+    Cursor CursorAt(Index coord0, Args... coords)
+    {
+        return Cursor(elements.data(), IndexOf(coord0, Index(coords)...));
+    }
+
+    template<typename...Args>
+    ConstCursor CursorAt(Index coord0, Args... coords) const
+    {
+        return ConstCursor(elements.data(), IndexOf(coord0, Index(coords)...));
+    }
+
+    /**
+     * Returns the total number of elements (2^('Dimensions' * 'FieldBits')).
+     */
+    static constexpr size_type size()
+    {
+        return size_type(1) << (Dimensions * FieldBits);
+    }
+
+    T* data() { return elements.data(); }
+    const T* data() const { return elements.data(); }
+
+    /**
+     * Iterators over every element, in storage (Z) order.
+     */
+    iterator begin() { return elements.data(); }
+    iterator end() { return elements.data() + elements.size(); }
+    const_iterator begin() const { return elements.data(); }
+    const_iterator end() const { return elements.data() + elements.size(); }
+
+private:
+    template<typename...Args>
+    static Index CheckedIndexOf(Args... coords)
+    {
+        const Index values[] = { coords... };
+        for (auto value : values) {
+            if (value >= Extent) {
+                throw std::out_of_range("MortonNDArray: coordinate out of range.");
+            }
+        }
+
+        return IndexOf(coords...);
+    }
+
+#if !MORTON_ND_BMI2_ENABLED
+    static constexpr std::size_t LutBits = FieldBits < 8 ? FieldBits : 8;
+    using LutEncoder = MortonNDLutLayoutEncoder<Index, LutBits, Layout>;
+    using LutDecoder = MortonNDLutLayoutDecoder<Index, LutBits, Layout>;
+
+    static constexpr LutEncoder Encoder = LutEncoder();
+    static constexpr LutDecoder Decoder = LutDecoder();
+#endif
+
+    std::vector<T> elements;
+};
+
+template<typename T, std::size_t Dimensions, std::size_t FieldBits, std::size_t TileBits>
+constexpr typename MortonNDArray<T, Dimensions, FieldBits, TileBits>::Index MortonNDArray<T, Dimensions, FieldBits, TileBits>::Extent;
+
+#if !MORTON_ND_BMI2_ENABLED
+template<typename T, std::size_t Dimensions, std::size_t FieldBits, std::size_t TileBits>
+constexpr typename MortonNDArray<T, Dimensions, FieldBits, TileBits>::LutEncoder MortonNDArray<T, Dimensions, FieldBits, TileBits>::Encoder;
+
+template<typename T, std::size_t Dimensions, std::size_t FieldBits, std::size_t TileBits>
+constexpr typename MortonNDArray<T, Dimensions, FieldBits, TileBits>::LutDecoder MortonNDArray<T, Dimensions, FieldBits, TileBits>::Decoder;
+#endif
+
+} // namespace mortonnd
+
+#endif // MORTON_ND_MORTONND_ARRAY_H
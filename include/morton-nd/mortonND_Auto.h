@@ -0,0 +1,447 @@
+//
+//  mortonND_Auto.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_AUTO_H
+#define MORTON_ND_MORTONND_AUTO_H
+
+#include "mortonND_Magic.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// BMI2 kernels are compiled with a function-level target attribute, so they're available
+// even when the translation unit isn't compiled with '-mbmi2'.
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define MORTON_ND_AUTO_X86 1
+#define MORTON_ND_TARGET_BMI2 __attribute__((target("bmi2")))
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace mortonnd {
+
+/**
+ * The engines 'MortonNDAuto' can dispatch to.
+ */
+enum class MortonNDEngine
+{
+    /**
+     * Shift / or / and dilation ('MortonNDMagic'). Always available.
+     */
+    Magic,
+
+    /**
+     * BMI2 'pdep' / 'pext' (as used by 'MortonNDBmi').
+     */
+    Bmi2
+};
+
+/**
+ * Returns a stable, human-readable name for 'engine' (e.g. for telemetry).
+ */
+inline const char* MortonNDEngineName(MortonNDEngine engine)
+{
+    switch (engine) {
+        case MortonNDEngine::Bmi2: return "bmi2";
+        case MortonNDEngine::Magic: return "magic";
+    }
+
+    return "unknown";
+}
+
+/**
+ * The CPU features relevant to engine selection, as reported by 'cpuid'.
+ */
+struct MortonNDCpuFeatures
+{
+    /**
+     * The CPU supports BMI2 ('pdep' / 'pext').
+     */
+    bool Bmi2 = false;
+
+    /**
+     * 'pdep' / 'pext' are microcoded, taking tens to hundreds of cycles depending on the
+     * mask. This is true for AMD CPUs before Zen 3 (family 0x19), as well as Hygon's.
+     */
+    bool SlowPdep = false;
+};
+
+/**
+ * Queries the executing CPU's features with 'cpuid'.
+ *
+ * On non-x86 targets (or compilers without <cpuid.h>), no features are reported.
+ */
+inline MortonNDCpuFeatures DetectCpuFeatures()
+{
+    MortonNDCpuFeatures features;
+
+#if MORTON_ND_AUTO_X86
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
+        return features;
+    }
+
+    const auto maxLeaf = eax;
+
+    char vendor[13] = {};
+    std::memcpy(vendor + 0, &ebx, 4);
+    std::memcpy(vendor + 4, &edx, 4);
+    std::memcpy(vendor + 8, &ecx, 4);
+
+    if (maxLeaf >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        features.Bmi2 = (ebx & (1u << 8)) != 0;
+    }
+
+    __cpuid(1, eax, ebx, ecx, edx);
+    auto family = (eax >> 8) & 0xF;
+    if (family == 0xF) {
+        family += (eax >> 20) & 0xFF;
+    }
+
+    const auto isAmd = std::strcmp(vendor, "AuthenticAMD") == 0 || std::strcmp(vendor, "HygonGenuine") == 0;
+    features.SlowPdep = features.Bmi2 && isAmd && family < 0x19;
+#endif
+
+    return features;
+}
+
+/**
+ * An N-dimensional Morton encoder/decoder which selects the fastest engine for the
+ * executing CPU at run-time.
+ *
+ * This is intended for binaries which are shipped to heterogeneous hosts, and so can't
+ * be compiled with '-mbmi2'. The CPU is queried (via 'cpuid') the first time any
+ * function is called, and an engine is selected:
+ *
+ *   - 'MortonNDEngine::Bmi2', if the CPU supports BMI2 and its 'pdep' / 'pext' are fast.
+ *   - 'MortonNDEngine::Magic', otherwise.
+ *
+ * Each engine's kernels are compiled for their target ISA with function attributes, and bound
+ * through a table of function pointers which is resolved once. Each call (and each batch)
+ * costs exactly one indirect call, so prefer the batch functions for large inputs.
+ *
+ * All engines produce identical results (the standard Morton layout).
+ *
+ * Configuration:
+ *
+ * Dimensions
+ *   The number of fields (components) to encode / decode.
+ *
+ * FieldBits
+ *   The number of bits (least-significant) in each field. 'Dimensions' * 'FieldBits' must be
+ *   <= 64. The result type 'T' is 'uint32_t' if the result fits, else 'uint64_t'.
+ *
+ * @tparam Dimensions the number of fields (components) to encode.
+ * @tparam FieldBits the number of bits in each field.
+ */
+template<std::size_t Dimensions, std::size_t FieldBits>
+class MortonNDAuto
+{
+    static_assert(Dimensions > 0, "'Dimensions' must be > 0.");
+    static_assert(FieldBits > 0, "'FieldBits' must be > 0.");
+    static_assert(Dimensions * FieldBits <= 64, "'Dimensions' * 'FieldBits' must be <= 64.");
+
+public:
+    /**
+     * The type of the components to encode/decode, as well as the result.
+     */
+    using T = typename std::conditional<Dimensions * FieldBits <= 32, uint32_t, uint64_t>::type;
+
+    /**
+     * The kernels of a single engine.
+     */
+    struct Dispatch
+    {
+        MortonNDEngine Engine;
+        T (*Encode)(const T* fields);
+        void (*Decode)(T encoding, T* fields);
+        void (*EncodeSoA)(const std::array<const T*, Dimensions>& fields, T* out, std::size_t count);
+        void (*EncodeAoS)(const T* points, std::size_t stride, T* out, std::size_t count);
+        void (*DecodeSoA)(const T* codes, std::size_t count, const std::array<T*, Dimensions>& fields);
+        void (*DecodeAoS)(const T* codes, std::size_t count, T* points, std::size_t stride);
+    };
+
+    /**
+     * Returns the engine selected for the executing CPU.
+     */
+    static MortonNDEngine SelectedEngine()
+    {
+        return Selected().Engine;
+    }
+
+    /**
+     * Returns true if 'engine' can run on the executing CPU (even if it wasn't selected).
+     */
+    static bool IsSupported(MortonNDEngine engine)
+    {
+        return engine == MortonNDEngine::Magic || (engine == MortonNDEngine::Bmi2 && DetectCpuFeatures().Bmi2);
+    }
+
+    /**
+     * Returns the kernels of a specific engine, bypassing selection (e.g. for testing or
+     * benchmarking). The caller must ensure that 'IsSupported(engine)'.
+     */
+    static const Dispatch& DispatchFor(MortonNDEngine engine)
+    {
+#if MORTON_ND_AUTO_X86
+        if (engine == MortonNDEngine::Bmi2) {
+            return Bmi2Kernels::Table;
+        }
+#endif
+        return MagicKernels::Table;
+    }
+
+    /**
+     * Calculates the Morton encoding of the specified input fields.
+     *
+     * Bits above 'FieldBits' in each input are ignored.
+     *
+     * @param field0 the first field (will start at offset 0 in the result)
+     * @param fields the rest.
+     * @return the calculated Morton code.
+     */
+    template<typename...Args>
+    static T Encode(T field0, Args... fields)
+    {
+        static_assert(sizeof...(Args) == Dimensions - 1, "'Encode' must be called with exactly 'Dimensions' arguments.");
+        const T values[] = { field0, static_cast<T>(fields)... };
+        return Selected().Encode(values);
+    }
+
+    /**
+     * Decodes a Morton code by de-interleaving it into its components.
+     *
+     * @param encoding the Morton code to decode.
+     * @return a tuple containing the code's individual components.
+     */
+    static auto Decode(T encoding)
+    {
+        T values[Dimensions];
+        Selected().Decode(encoding, values);
+        return MakeTuple(values, std::make_index_sequence<Dimensions>{});
+    }
+
+    /**
+     * Encodes 'count' points stored as one array per dimension (SoA).
+     *
+     * See 'MortonNDBmi::EncodeBatch'.
+     */
+    static void EncodeBatch(const std::array<const T*, Dimensions>& fields, T* out, std::size_t count)
+    {
+        Selected().EncodeSoA(fields, out, count);
+    }
+
+    /**
+     * Encodes 'count' points stored as records with a fixed stride (AoS).
+     *
+     * See 'MortonNDBmi::EncodeBatch'.
+     */
+    static void EncodeBatch(const T* points, std::size_t stride, T* out, std::size_t count)
+    {
+        Selected().EncodeAoS(points, stride, out, count);
+    }
+
+    /**
+     * Decodes 'count' codes into one array per dimension (SoA).
+     *
+     * See 'MortonNDBmi::DecodeBatch'.
+     */
+    static void DecodeBatch(const T* codes, std::size_t count, const std::array<T*, Dimensions>& fields)
+    {
+        Selected().DecodeSoA(codes, count, fields);
+    }
+
+    /**
+     * Decodes 'count' codes into records with a fixed stride (AoS).
+     *
+     * See 'MortonNDBmi::DecodeBatch'.
+     */
+    static void DecodeBatch(const T* codes, std::size_t count, T* points, std::size_t stride)
+    {
+        Selected().DecodeAoS(codes, count, points, stride);
+    }
+
+private:
+    MortonNDAuto() = default;
+
+    using Magic = MortonNDMagic<Dimensions, T, FieldBits>;
+
+    static MortonNDEngine Select()
+    {
+        const auto features = DetectCpuFeatures();
+        return features.Bmi2 && !features.SlowPdep ? MortonNDEngine::Bmi2 : MortonNDEngine::Magic;
+    }
+
+    // Resolved once (thread-safe), on first use.
+    static const Dispatch& Selected()
+    {
+        static const Dispatch& selected = DispatchFor(Select());
+        return selected;
+    }
+
+    template<std::size_t... i>
+    static auto MakeTuple(const T* values, std::index_sequence<i...>)
+    {
+        return std::make_tuple(values[i]...);
+    }
+
+    struct MagicKernels
+    {
+        static T Encode(const T* fields)
+        {
+            T encoding = 0;
+            for (std::size_t d = 0; d < Dimensions; d++) {
+                encoding |= Magic::Dilate(fields[d]) << d;
+            }
+
+            return encoding;
+        }
+
+        static void Decode(T encoding, T* fields)
+        {
+            for (std::size_t d = 0; d < Dimensions; d++) {
+                fields[d] = Magic::Compact(encoding >> d);
+            }
+        }
+
+        static void EncodeSoA(const std::array<const T*, Dimensions>& fields, T* out, std::size_t count)
+        {
+            for (std::size_t n = 0; n < count; n++) {
+                T encoding = 0;
+                for (std::size_t d = 0; d < Dimensions; d++) {
+                    encoding |= Magic::Dilate(fields[d][n]) << d;
+                }
+                out[n] = encoding;
+            }
+        }
+
+        static void EncodeAoS(const T* points, std::size_t stride, T* out, std::size_t count)
+        {
+            for (std::size_t n = 0; n < count; n++) {
+                out[n] = Encode(points + n * stride);
+            }
+        }
+
+        static void DecodeSoA(const T* codes, std::size_t count, const std::array<T*, Dimensions>& fields)
+        {
+            for (std::size_t n = 0; n < count; n++) {
+                for (std::size_t d = 0; d < Dimensions; d++) {
+                    fields[d][n] = Magic::Compact(codes[n] >> d);
+                }
+            }
+        }
+
+        static void DecodeAoS(const T* codes, std::size_t count, T* points, std::size_t stride)
+        {
+            for (std::size_t n = 0; n < count; n++) {
+                Decode(codes[n], points + n * stride);
+            }
+        }
+
+        static constexpr Dispatch Table = {
+            MortonNDEngine::Magic, &Encode, &Decode, &EncodeSoA, &EncodeAoS, &DecodeSoA, &DecodeAoS
+        };
+    };
+
+#if MORTON_ND_AUTO_X86
+    struct Bmi2Kernels
+    {
+        MORTON_ND_TARGET_BMI2 static uint32_t Deposit(uint32_t field, uint32_t selector)
+        {
+            return _pdep_u32(field, selector);
+        }
+
+        MORTON_ND_TARGET_BMI2 static uint32_t Extract(uint32_t encoding, uint32_t selector)
+        {
+            return _pext_u32(encoding, selector);
+        }
+
+        MORTON_ND_TARGET_BMI2 static uint64_t Deposit(uint64_t field, uint64_t selector)
+        {
+            return _pdep_u64(field, selector);
+        }
+
+        MORTON_ND_TARGET_BMI2 static uint64_t Extract(uint64_t encoding, uint64_t selector)
+        {
+            return _pext_u64(encoding, selector);
+        }
+
+        MORTON_ND_TARGET_BMI2 static T Encode(const T* fields)
+        {
+            T encoding = 0;
+            for (std::size_t d = 0; d < Dimensions; d++) {
+                encoding |= Deposit(fields[d], Magic::Selector(d));
+            }
+
+            return encoding;
+        }
+
+        MORTON_ND_TARGET_BMI2 static void Decode(T encoding, T* fields)
+        {
+            for (std::size_t d = 0; d < Dimensions; d++) {
+                fields[d] = Extract(encoding, Magic::Selector(d));
+            }
+        }
+
+        MORTON_ND_TARGET_BMI2 static void EncodeSoA(const std::array<const T*, Dimensions>& fields, T* out, std::size_t count)
+        {
+            for (std::size_t n = 0; n < count; n++) {
+                T encoding = 0;
+                for (std::size_t d = 0; d < Dimensions; d++) {
+                    encoding |= Deposit(fields[d][n], Magic::Selector(d));
+                }
+                out[n] = encoding;
+            }
+        }
+
+        MORTON_ND_TARGET_BMI2 static void EncodeAoS(const T* points, std::size_t stride, T* out, std::size_t count)
+        {
+            for (std::size_t n = 0; n < count; n++) {
+                out[n] = Encode(points + n * stride);
+            }
+        }
+
+        MORTON_ND_TARGET_BMI2 static void DecodeSoA(const T* codes, std::size_t count, const std::array<T*, Dimensions>& fields)
+        {
+            for (std::size_t n = 0; n < count; n++) {
+                for (std::size_t d = 0; d < Dimensions; d++) {
+                    fields[d][n] = Extract(codes[n], Magic::Selector(d));
+                }
+            }
+        }
+
+        MORTON_ND_TARGET_BMI2 static void DecodeAoS(const T* codes, std::size_t count, T* points, std::size_t stride)
+        {
+            for (std::size_t n = 0; n < count; n++) {
+                Decode(codes[n], points + n * stride);
+            }
+        }
+
+        static constexpr Dispatch Table = {
+            MortonNDEngine::Bmi2, &Encode, &Decode, &EncodeSoA, &EncodeAoS, &DecodeSoA, &DecodeAoS
+        };
+    };
+#endif
+};
+
+template<std::size_t Dimensions, std::size_t FieldBits>
+constexpr typename MortonNDAuto<Dimensions, FieldBits>::Dispatch MortonNDAuto<Dimensions, FieldBits>::MagicKernels::Table;
+
+#if MORTON_ND_AUTO_X86
+template<std::size_t Dimensions, std::size_t FieldBits>
+constexpr typename MortonNDAuto<Dimensions, FieldBits>::Dispatch MortonNDAuto<Dimensions, FieldBits>::Bmi2Kernels::Table;
+#endif
+
+}
+
+#endif
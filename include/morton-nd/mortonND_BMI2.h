@@ -13,11 +13,14 @@
 
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <limits>
 #include <tuple>
 #include <type_traits>
 #include <immintrin.h>
 
+#include "mortonND_UInt.h"
+
 namespace mortonnd {
 
 /**
@@ -46,13 +49,36 @@ constexpr uint64_t BuildSelector<1>(std::size_t) {
     return 1UL;
 }
 
+/**
+ * Special case for a field with no bits in a word (see 'MortonNDBmi' multi-word support).
+ */
+template<>
+constexpr uint64_t BuildSelector<0>(std::size_t) {
+    return 0UL;
+}
+
+/**
+ * Trait for result types supported by 'MortonNDBmi'.
+ */
+template<typename T>
+struct IsBmiResultType : std::integral_constant<bool, std::is_same<T, uint32_t>::value || std::is_same<T, uint64_t>::value> {};
+
+#if defined(__SIZEOF_INT128__)
+template<>
+struct IsBmiResultType<__uint128_t> : std::true_type {};
+#endif
+
+template<std::size_t Bits>
+struct IsBmiResultType<UInt<Bits>> : std::true_type {};
+
 /**
  * A fast N-dimensional Morton encoder/decoder for targets supporting BMI2/AVX2 instruction
  * set extensions.
  *
- * This implementation supports up to 64-bit encodings. If you need support for larger results,
- * consider using 'MortonNDLutEncoder' which can support 128-bit results natively, or even
- * larger results using a custom BigInteger-like class.
+ * This implementation supports 128-bit encodings (with '__uint128_t'), and encodings of any width
+ * with 'UInt'. Results wider than 64 bits are split into 64-bit words, and each field is deposited
+ * into (or extracted from) each word with its own 'pdep' / 'pext', using per-word selectors computed
+ * at compile-time.
  *
  * Configuration:
  *
@@ -62,12 +88,14 @@ constexpr uint64_t BuildSelector<1>(std::size_t) {
  *   exactly this number of inputs to be provided.
  *
  * T
- *   The type of the components to encode/decode, as well as the result. This must be either 'uint32_t'
- *   or 'uint64_t', since the underlying BMI instructions only operate on 32 and 64 bit fields.
+ *   The type of the components to encode/decode, as well as the result. This must be either 'uint32_t',
+ *   'uint64_t', '__uint128_t' (if supported by your compiler) or 'UInt<Bits>'. The underlying BMI
+ *   instructions only operate on 32 and 64 bit fields, so wider codes take 1 instruction per field
+ *   per 64-bit word.
  *
  * @tparam Dimensions the number of fields (components) to encode.
  * @tparam T the type of the components to encode/decode, as well as the type of the result.
- *         Must be either uint32_t or uint64_t.
+ *         Must be either uint32_t, uint64_t, __uint128_t or UInt<Bits>.
  */
 template<std::size_t Dimensions, typename T>
 class MortonNDBmi
@@ -76,8 +104,7 @@ public:
     static constexpr auto FieldBits = std::size_t(std::numeric_limits<T>::digits) / Dimensions;
 
     static_assert(Dimensions > 0, "'Dimensions' must be > 0.");
-    static_assert(std::is_same<T, uint32_t>::value | std::is_same<T, uint64_t>::value,
-        "'T' must be either uint32_t or uint64_t.");
+    static_assert(IsBmiResultType<T>::value, "'T' must be either uint32_t, uint64_t, __uint128_t or UInt<Bits>.");
 
     /**
      * Calculates the Morton encoding of the specified input fields by interleaving the bits
@@ -101,7 +128,7 @@ public:
     static inline T Encode(T field1, Args... fields)
     {
         static_assert(sizeof...(Args) == Dimensions - 1, "'Encode' must be called with exactly 'Dimensions' arguments.");
-        return EncodeInternal(field1, fields...);
+        return EncodeFields(IsUInt<T>{}, field1, fields...);
     }
 
     /**
@@ -118,10 +145,231 @@ public:
         return DecodeInternal(encoding, std::make_index_sequence<Dimensions>{});
     }
 
+    /**
+     * Calculates the Morton encodings of 'count' points whose components are stored
+     * in separate arrays (SoA), writing each code to 'out'.
+     *
+     * Equivalent to:
+     *   out[i] = Encode(fields[0][i], fields[1][i], ...)
+     *
+     * The loop is unrolled by 'BatchUnroll' points so that independent 'pdep'
+     * operations can be issued back-to-back.
+     *
+     * WARNING: Inputs must NOT use more than 'FieldBits' least-significant bits.
+     *
+     * @param fields one array per dimension, each holding at least 'count' components.
+     * @param out destination for 'count' Morton codes. Must not alias 'fields'.
+     * @param count the number of points to encode.
+     */
+    static inline void EncodeBatch(const std::array<const T*, Dimensions>& fields, T* out, std::size_t count)
+    {
+        std::size_t i = 0;
+        for (; i + BatchUnroll <= count; i += BatchUnroll) {
+            const T code0 = EncodeSoA(fields, i + 0, std::make_index_sequence<Dimensions>{});
+            const T code1 = EncodeSoA(fields, i + 1, std::make_index_sequence<Dimensions>{});
+            const T code2 = EncodeSoA(fields, i + 2, std::make_index_sequence<Dimensions>{});
+            const T code3 = EncodeSoA(fields, i + 3, std::make_index_sequence<Dimensions>{});
+            out[i + 0] = code0;
+            out[i + 1] = code1;
+            out[i + 2] = code2;
+            out[i + 3] = code3;
+        }
+
+        for (; i < count; i++) {
+            out[i] = EncodeSoA(fields, i, std::make_index_sequence<Dimensions>{});
+        }
+    }
+
+    /**
+     * Calculates the Morton encodings of 'count' points stored as records (AoS),
+     * writing each code to 'out'.
+     *
+     * Point 'i' is read from 'points + i * stride', and its 'Dimensions' components
+     * must be stored contiguously starting at that address.
+     *
+     * Equivalent to:
+     *   out[i] = Encode(points[i * stride + 0], points[i * stride + 1], ...)
+     *
+     * WARNING: Inputs must NOT use more than 'FieldBits' least-significant bits.
+     *
+     * @param points the first component of the first point.
+     * @param stride the distance (in elements of 'T') between consecutive points. Must be >= 'Dimensions'.
+     * @param out destination for 'count' Morton codes. Must not alias 'points'.
+     * @param count the number of points to encode.
+     */
+    static inline void EncodeBatch(const T* points, std::size_t stride, T* out, std::size_t count)
+    {
+        std::size_t i = 0;
+        for (; i + BatchUnroll <= count; i += BatchUnroll) {
+            const T code0 = EncodeAoS(points + (i + 0) * stride, std::make_index_sequence<Dimensions>{});
+            const T code1 = EncodeAoS(points + (i + 1) * stride, std::make_index_sequence<Dimensions>{});
+            const T code2 = EncodeAoS(points + (i + 2) * stride, std::make_index_sequence<Dimensions>{});
+            const T code3 = EncodeAoS(points + (i + 3) * stride, std::make_index_sequence<Dimensions>{});
+            out[i + 0] = code0;
+            out[i + 1] = code1;
+            out[i + 2] = code2;
+            out[i + 3] = code3;
+        }
+
+        for (; i < count; i++) {
+            out[i] = EncodeAoS(points + i * stride, std::make_index_sequence<Dimensions>{});
+        }
+    }
+
+    /**
+     * Decodes 'count' Morton codes, writing the components of each into separate
+     * arrays (SoA).
+     *
+     * Equivalent to:
+     *   std::tie(fields[0][i], fields[1][i], ...) = Decode(codes[i])
+     *
+     * @param codes the Morton codes to decode.
+     * @param count the number of codes to decode.
+     * @param fields one destination array per dimension, each with room for 'count' components.
+     */
+    static inline void DecodeBatch(const T* codes, std::size_t count, const std::array<T*, Dimensions>& fields)
+    {
+        std::size_t i = 0;
+        for (; i + BatchUnroll <= count; i += BatchUnroll) {
+            const T code0 = codes[i + 0];
+            const T code1 = codes[i + 1];
+            const T code2 = codes[i + 2];
+            const T code3 = codes[i + 3];
+            DecodeSoA(code0, fields, i + 0, std::make_index_sequence<Dimensions>{});
+            DecodeSoA(code1, fields, i + 1, std::make_index_sequence<Dimensions>{});
+            DecodeSoA(code2, fields, i + 2, std::make_index_sequence<Dimensions>{});
+            DecodeSoA(code3, fields, i + 3, std::make_index_sequence<Dimensions>{});
+        }
+
+        for (; i < count; i++) {
+            DecodeSoA(codes[i], fields, i, std::make_index_sequence<Dimensions>{});
+        }
+    }
+
+    /**
+     * Decodes 'count' Morton codes, writing the components of each as a record (AoS).
+     *
+     * The components of code 'i' are written contiguously starting at 'points + i * stride'.
+     *
+     * @param codes the Morton codes to decode.
+     * @param count the number of codes to decode.
+     * @param points destination for the first component of the first point.
+     * @param stride the distance (in elements of 'T') between consecutive points. Must be >= 'Dimensions'.
+     */
+    static inline void DecodeBatch(const T* codes, std::size_t count, T* points, std::size_t stride)
+    {
+        std::size_t i = 0;
+        for (; i + BatchUnroll <= count; i += BatchUnroll) {
+            const T code0 = codes[i + 0];
+            const T code1 = codes[i + 1];
+            const T code2 = codes[i + 2];
+            const T code3 = codes[i + 3];
+            DecodeAoS(code0, points + (i + 0) * stride, std::make_index_sequence<Dimensions>{});
+            DecodeAoS(code1, points + (i + 1) * stride, std::make_index_sequence<Dimensions>{});
+            DecodeAoS(code2, points + (i + 2) * stride, std::make_index_sequence<Dimensions>{});
+            DecodeAoS(code3, points + (i + 3) * stride, std::make_index_sequence<Dimensions>{});
+        }
+
+        for (; i < count; i++) {
+            DecodeAoS(codes[i], points + i * stride, std::make_index_sequence<Dimensions>{});
+        }
+    }
+
+    /**
+     * The number of points processed per iteration of the batch functions' main loop.
+     */
+    static constexpr std::size_t BatchUnroll = 4;
+
 private:
     MortonNDBmi() = default;
 
-    static const T Selector = BuildSelector<FieldBits>(Dimensions);
+    static constexpr std::size_t WordBits = 64;
+    static constexpr std::size_t WordCount = (std::size_t(std::numeric_limits<T>::digits) + WordBits - 1) / WordBits;
+
+    // The first bit of field 'fieldIndex' which lands in (64-bit) word 'word' of the result.
+    static constexpr std::size_t FirstWordBit(std::size_t fieldIndex, std::size_t word)
+    {
+        return word * WordBits <= fieldIndex ? 0 : (word * WordBits - fieldIndex + Dimensions - 1) / Dimensions;
+    }
+
+    // The number of bits of field 'fieldIndex' which land in word 'word' of the result.
+    static constexpr std::size_t WordBitCount(std::size_t fieldIndex, std::size_t word)
+    {
+        return (FirstWordBit(fieldIndex, word + 1) < FieldBits ? FirstWordBit(fieldIndex, word + 1) : FieldBits)
+            - (FirstWordBit(fieldIndex, word) < FieldBits ? FirstWordBit(fieldIndex, word) : FieldBits);
+    }
+
+    // The selector for field 'FieldIndex' within word 'Word' of the result (0 if no bits of the field land there).
+    template<std::size_t FieldIndex, std::size_t Word>
+    using WordSelector = std::integral_constant<uint64_t, WordBitCount(FieldIndex, Word) == 0 ? 0 :
+        (BuildSelector<WordBitCount(FieldIndex, Word)>(Dimensions) << (FirstWordBit(FieldIndex, Word) * Dimensions + FieldIndex - Word * WordBits))>;
+
+    template<std::size_t FieldIndex>
+    using Selector = WordSelector<FieldIndex, 0>;
+
+    template<size_t... i>
+    static inline T EncodeSoA(const std::array<const T*, Dimensions>& fields, std::size_t index, std::index_sequence<i...>)
+    {
+        return EncodeFields(IsUInt<T>{}, fields[i][index]...);
+    }
+
+    template<size_t... i>
+    static inline T EncodeAoS(const T* point, std::index_sequence<i...>)
+    {
+        return EncodeFields(IsUInt<T>{}, point[i]...);
+    }
+
+    template<size_t... i>
+    static inline void DecodeSoA(T encoding, const std::array<T*, Dimensions>& fields, std::size_t index, std::index_sequence<i...>)
+    {
+        using expander = int[];
+        (void)expander{ 0, (void(fields[i][index] = Extract<i>(encoding)), 0)... };
+    }
+
+    template<size_t... i>
+    static inline void DecodeAoS(T encoding, T* point, std::index_sequence<i...>)
+    {
+        using expander = int[];
+        (void)expander{ 0, (void(point[i] = Extract<i>(encoding)), 0)... };
+    }
+
+    template<typename...Args>
+    static inline T EncodeFields(std::false_type, Args... fields)
+    {
+        return EncodeInternal(fields...);
+    }
+
+    // 'UInt' specialization. Builds each word of the result from the bits every field deposits
+    // into it, rather than ORing together whole (wide) values.
+    template<typename...Args>
+    static inline T EncodeFields(std::true_type, Args... fields)
+    {
+        const T values[] = { fields... };
+        return EncodeWords(values, std::make_index_sequence<WordCount>{});
+    }
+
+    template<size_t... w>
+    static inline T EncodeWords(const T (&fields)[Dimensions], std::index_sequence<w...>)
+    {
+        T encoding;
+
+        using expander = int[];
+        (void)expander{ 0, (void(encoding.SetWord(w, EncodeWord<w>(fields, std::make_index_sequence<Dimensions>{}))), 0)... };
+
+        return encoding;
+    }
+
+    template<size_t Word, size_t... f>
+    static inline uint64_t EncodeWord(const T (&fields)[Dimensions], std::index_sequence<f...>)
+    {
+        uint64_t word = 0;
+
+        using expander = int[];
+        (void)expander{ 0, (void(word |= _pdep_u64(
+            fields[f].template GetBits<FirstWordBit(f, Word), WordBitCount(f, Word)>(), WordSelector<f, Word>::value)), 0)... };
+
+        return word;
+    }
 
     template<typename...Args>
     static inline T EncodeInternal(T field1, Args... fields)
@@ -142,22 +390,92 @@ private:
 
     template<size_t FieldIndex>
     static inline uint32_t Deposit(uint32_t field) {
-        return _pdep_u32(field, Selector << FieldIndex);
+        return _pdep_u32(field, static_cast<uint32_t>(Selector<FieldIndex>::value));
     }
 
     template<size_t FieldIndex>
     static inline uint64_t Deposit(uint64_t field) {
-        return _pdep_u64(field, Selector << FieldIndex);
+        return _pdep_u64(field, Selector<FieldIndex>::value);
     }
 
     template<size_t FieldIndex>
     static inline uint32_t Extract(uint32_t encoding) {
-        return _pext_u32(encoding, Selector << FieldIndex);
+        return _pext_u32(encoding, static_cast<uint32_t>(Selector<FieldIndex>::value));
     }
 
     template<size_t FieldIndex>
     static inline uint64_t Extract(uint64_t encoding) {
-        return _pext_u64(encoding, Selector << FieldIndex);
+        return _pext_u64(encoding, Selector<FieldIndex>::value);
+    }
+
+#if defined(__SIZEOF_INT128__)
+    template<size_t FieldIndex>
+    static inline __uint128_t Deposit(__uint128_t field) {
+        return DepositWords<FieldIndex>(field, std::make_index_sequence<WordCount>{});
+    }
+
+    template<size_t FieldIndex>
+    static inline __uint128_t Extract(__uint128_t encoding) {
+        return ExtractWords<FieldIndex>(encoding, std::make_index_sequence<WordCount>{});
+    }
+
+    // Deposits the bits of the field belonging to each word separately, then ORs the words together.
+    template<size_t FieldIndex, size_t... w>
+    static inline __uint128_t DepositWords(__uint128_t field, std::index_sequence<w...>) {
+        __uint128_t encoding = 0;
+
+        using expander = int[];
+        (void)expander{ 0, (void(encoding |= __uint128_t(
+            _pdep_u64(uint64_t(field >> FirstWordBit(FieldIndex, w)), WordSelector<FieldIndex, w>::value)) << (w * WordBits)), 0)... };
+
+        return encoding;
+    }
+
+    // Extracts the bits of the field from each word separately, then ORs them into place.
+    template<size_t FieldIndex, size_t... w>
+    static inline __uint128_t ExtractWords(__uint128_t encoding, std::index_sequence<w...>) {
+        __uint128_t field = 0;
+
+        using expander = int[];
+        (void)expander{ 0, (void(field |= __uint128_t(
+            _pext_u64(uint64_t(encoding >> (w * WordBits)), WordSelector<FieldIndex, w>::value)) << FirstWordBit(FieldIndex, w)), 0)... };
+
+        return field;
+    }
+#endif
+
+    // 'UInt' specialization. Each word of the result is deposited directly, from the (at most 2)
+    // words of the field holding its bits.
+    template<size_t FieldIndex, std::size_t Bits>
+    static inline UInt<Bits> Deposit(const UInt<Bits>& field) {
+        return DepositWords<FieldIndex>(field, std::make_index_sequence<WordCount>{});
+    }
+
+    template<size_t FieldIndex, std::size_t Bits>
+    static inline UInt<Bits> Extract(const UInt<Bits>& encoding) {
+        return ExtractWords<FieldIndex>(encoding, std::make_index_sequence<WordCount>{});
+    }
+
+    template<size_t FieldIndex, std::size_t Bits, size_t... w>
+    static inline UInt<Bits> DepositWords(const UInt<Bits>& field, std::index_sequence<w...>) {
+        UInt<Bits> encoding;
+
+        using expander = int[];
+        (void)expander{ 0, (void(encoding.SetWord(w, _pdep_u64(
+            field.template GetBits<FirstWordBit(FieldIndex, w), WordBitCount(FieldIndex, w)>(), WordSelector<FieldIndex, w>::value))), 0)... };
+
+        return encoding;
+    }
+
+    template<size_t FieldIndex, std::size_t Bits, size_t... w>
+    static inline UInt<Bits> ExtractWords(const UInt<Bits>& encoding, std::index_sequence<w...>) {
+        UInt<Bits> field;
+
+        using expander = int[];
+        (void)expander{ 0, (void(field.template OrBits<FirstWordBit(FieldIndex, w), WordBitCount(FieldIndex, w)>(
+            _pext_u64(encoding.Word(w), WordSelector<FieldIndex, w>::value))), 0)... };
+
+        return field;
     }
 };
 
@@ -189,6 +507,15 @@ using MortonNDBmi_3D_32 = MortonNDBmi<3, uint32_t>;
  */
 using MortonNDBmi_3D_64 = MortonNDBmi<3, uint64_t>;
 
+#if defined(__SIZEOF_INT128__)
+/**
+ * Type alias for 3D encodings that fit in a 128-bit result.
+ *
+ * Inputs must NOT use more than 42 least-significant bits.
+ */
+using MortonNDBmi_3D_128 = MortonNDBmi<3, __uint128_t>;
+#endif
+
 }
 
 #endif
@@ -0,0 +1,420 @@
+//
+//  mortonND_BVH.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_BVH_H
+#define MORTON_ND_MORTONND_BVH_H
+
+#include "mortonND_Quantize.h"
+#include "mortonND_Range.h"
+#include "mortonND_Sort.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace mortonnd {
+
+/**
+ * An axis-aligned box, with inclusive corners.
+ */
+template<std::size_t Dimensions, typename Real = float>
+struct MortonNDBox
+{
+    std::array<Real, Dimensions> min;
+    std::array<Real, Dimensions> max;
+};
+
+/**
+ * A node of a 'MortonNDBvh'.
+ *
+ * For internal nodes, 'left' and 'right' are the indices of the children. For leaves, both are
+ * the index of the leaf's primitive. The root is its own parent.
+ */
+template<std::size_t Dimensions, typename Real = float>
+struct MortonNDBvhNode
+{
+    MortonNDBox<Dimensions, Real> box;
+    uint32_t left;
+    uint32_t right;
+    uint32_t parent;
+};
+
+/**
+ * A linear bounding volume hierarchy (LBVH), built in parallel from Morton codes.
+ *
+ * Construction (Karras, "Maximizing Parallelism in the Construction of BVHs, Octrees, and k-d
+ * Trees", 2012) has four passes, each split across threads:
+ *
+ *   1. The bounds of the primitives' centroids are reduced (per-thread bounds, then their union).
+ *   2. The centroids are quantized to the bounds ('MortonNDQuantizer'), encoded with the given
+ *      engine and sorted ('MortonNDRadixSort'), a block at a time, as in 'SortByMorton'.
+ *   3. The binary radix tree of the sorted codes is built. Each internal node is independent: it
+ *      finds the range of leaves it covers by an exponential then binary search on the length of
+ *      the common prefix (found with 'clz') of pairs of codes, and then its split (the end of its
+ *      longest common prefix) by another binary search. Equal codes are told apart by appending
+ *      their position.
+ *   4. The bounds are refit bottom-up. Each thread climbs from its leaves, and counts its arrival
+ *      at each parent with an atomic. The second arrival computes the parent's box (its
+ *      children's boxes are complete by then) and continues; the first stops.
+ *
+ * For 'count' primitives, there are 'count - 1' internal nodes (indices '[0, count - 1)', with
+ * the root at 0) followed by 'count' leaves in Morton order. With a single primitive, the root is
+ * that leaf.
+ *
+ * Node indices are 32-bit, so at most 2^31 primitives are supported.
+ *
+ * Configuration:
+ *
+ * Dimensions
+ *   The number of axes of the boxes.
+ *
+ * Real
+ *   The type of the box coordinates. Must be 'float' or 'double'.
+ *
+ * T
+ *   The type of the Morton codes. Must be 'uint32_t', 'uint64_t' or '__uint128_t'.
+ *
+ * FieldBits
+ *   The number of bits each centroid coordinate is quantized to. Defaults to the most that fit in 'T'.
+ *
+ * @tparam Dimensions the number of axes of the boxes.
+ * @tparam Real the type of the box coordinates.
+ * @tparam T the type of the Morton codes.
+ * @tparam FieldBits the number of bits in each field.
+ */
+template<std::size_t Dimensions, typename Real, typename T, std::size_t FieldBits = std::size_t(std::numeric_limits<T>::digits) / Dimensions>
+class MortonNDBvh
+{
+    static_assert(std::is_floating_point<Real>::value, "'Real' must be a floating-point type.");
+
+    static constexpr std::size_t CodeBits = Dimensions * FieldBits;
+
+public:
+    using Box = MortonNDBox<Dimensions, Real>;
+    using Node = MortonNDBvhNode<Dimensions, Real>;
+    using Quantizer = MortonNDQuantizer<Dimensions, Real, T, FieldBits>;
+
+    /**
+     * The fewest primitives per thread. Smaller inputs use fewer threads.
+     */
+    static constexpr std::size_t MinPerThread = std::size_t(1) << 14;
+
+    /**
+     * Returns the quantizer used for the codes of primitives whose centroids have the bounds
+     * 'centroids': it maps 'centroids.min' to field 0, and 'centroids.max' to one past the last
+     * field (clamped).
+     */
+    static Quantizer CentroidQuantizer(const Box& centroids)
+    {
+        std::array<Real, Dimensions> scale;
+        for (std::size_t d = 0; d < Dimensions; d++) {
+            const Real extent = centroids.max[d] - centroids.min[d];
+            scale[d] = extent > Real(0) ? (Real(Quantizer::FieldMax) + Real(1)) / extent : Real(1);
+        }
+
+        return Quantizer(centroids.min, scale);
+    }
+
+    MortonNDBvh() = default;
+
+    /**
+     * Builds the hierarchy of 'count' primitives.
+     *
+     * @param engine the Morton engine (see 'MortonNDStatic' for engines with static members).
+     * @param boxes the bounds of each primitive.
+     * @param count the number of primitives.
+     * @param threads the number of threads to use. 0 selects 'std::thread::hardware_concurrency()'.
+     */
+    template<typename Engine>
+    MortonNDBvh(const Engine& engine, const Box* boxes, std::size_t count, std::size_t threads = 0)
+    {
+        if (count > (std::size_t(1) << 31)) {
+            throw std::invalid_argument("MortonNDBvh supports at most 2^31 primitives.");
+        }
+
+        if (count == 0) {
+            return;
+        }
+
+        const auto quantizer = CentroidQuantizer(CentroidBounds(boxes, count, threads));
+        codes.resize(count);
+        primitives.resize(count);
+        MortonNDRadixSort<T, uint32_t>::Sort(codes.data(), primitives.data(), count, CodeBits, threads,
+            [&](std::size_t first, std::size_t n, T* blockCodes, uint32_t* blockPrimitives) {
+                Real block[Dimensions][MortonNDRadixSort<T, uint32_t>::BlockSize];
+                std::array<const Real*, Dimensions> fields;
+                for (std::size_t d = 0; d < Dimensions; d++) {
+                    for (std::size_t i = 0; i < n; i++) {
+                        block[d][i] = Centroid(boxes[first + i], d);
+                    }
+                    fields[d] = block[d];
+                }
+
+                quantizer.EncodeBatch(engine, fields, blockCodes, n);
+                for (std::size_t i = 0; i < n; i++) {
+                    blockPrimitives[i] = uint32_t(first + i);
+                }
+            });
+
+        nodes.resize(2 * count - 1);
+        threads = ThreadCount(count, threads);
+        nodes[0].parent = 0;
+
+        Parallel(threads, [&](std::size_t t) {
+            const auto last = (count - 1) * (t + 1) / threads;
+            for (auto i = (count - 1) * t / threads; i < last; i++) {
+                BuildInternal(std::ptrdiff_t(i));
+            }
+        });
+
+        std::vector<std::atomic<uint32_t>> arrivals(count - 1);
+        Parallel(threads, [&](std::size_t t) {
+            const auto last = count * (t + 1) / threads;
+            for (auto k = count * t / threads; k < last; k++) {
+                Refit(boxes, k, arrivals);
+            }
+        });
+    }
+
+    /**
+     * Calls 'func(primitive)' for each primitive whose box overlaps 'box'.
+     */
+    template<typename F>
+    void Query(const Box& box, F func) const
+    {
+        if (nodes.empty()) {
+            return;
+        }
+
+        std::vector<uint32_t> stack(1, 0);
+        while (!stack.empty()) {
+            const auto i = stack.back();
+            stack.pop_back();
+
+            const auto& node = nodes[i];
+            if (!Overlaps(node.box, box)) {
+                continue;
+            }
+
+            if (IsLeaf(i)) {
+                func(std::size_t(node.left));
+            } else {
+                stack.push_back(node.right);
+                stack.push_back(node.left);
+            }
+        }
+    }
+
+    /**
+     * Returns true if node 'i' is a leaf.
+     */
+    bool IsLeaf(std::size_t i) const
+    {
+        return i + 1 >= codes.size();
+    }
+
+    /**
+     * Returns the nodes: the internal nodes, followed by the leaves in Morton order.
+     */
+    const std::vector<Node>& Nodes() const
+    {
+        return nodes;
+    }
+
+    /**
+     * Returns the sorted Morton codes of the primitives' centroids. Code 'k' belongs to leaf
+     * 'count - 1 + k'.
+     */
+    const std::vector<T>& Codes() const
+    {
+        return codes;
+    }
+
+    /**
+     * Returns the primitive of each sorted code.
+     */
+    const std::vector<uint32_t>& Primitives() const
+    {
+        return primitives;
+    }
+
+    const Node& operator[](std::size_t i) const
+    {
+        return nodes[i];
+    }
+
+    std::size_t size() const
+    {
+        return nodes.size();
+    }
+
+private:
+    static Real Centroid(const Box& box, std::size_t d)
+    {
+        return (box.min[d] + box.max[d]) * Real(0.5);
+    }
+
+    static bool Overlaps(const Box& a, const Box& b)
+    {
+        for (std::size_t d = 0; d < Dimensions; d++) {
+            if (a.max[d] < b.min[d] || b.max[d] < a.min[d]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    static void Enclose(Box& box, const Box& other)
+    {
+        for (std::size_t d = 0; d < Dimensions; d++) {
+            box.min[d] = std::min(box.min[d], other.min[d]);
+            box.max[d] = std::max(box.max[d], other.max[d]);
+        }
+    }
+
+    static std::size_t ThreadCount(std::size_t count, std::size_t threads)
+    {
+        if (threads == 0) {
+            threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        return std::max<std::size_t>(1, std::min(threads, count / MinPerThread));
+    }
+
+    // Runs 'func(t)' for each 't' in [0, threads), on 'threads' threads (including this one).
+    template<typename F>
+    static void Parallel(std::size_t threads, F func)
+    {
+        std::vector<std::thread> workers;
+        for (std::size_t t = 1; t < threads; t++) {
+            workers.emplace_back(func, t);
+        }
+
+        func(0);
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    static Box CentroidBounds(const Box* boxes, std::size_t count, std::size_t threads)
+    {
+        threads = ThreadCount(count, threads);
+        std::vector<Box> bounds(threads);
+        Parallel(threads, [&](std::size_t t) {
+            const auto last = count * (t + 1) / threads;
+            auto& threadBounds = bounds[t];
+            for (std::size_t d = 0; d < Dimensions; d++) {
+                threadBounds.min[d] = std::numeric_limits<Real>::max();
+                threadBounds.max[d] = std::numeric_limits<Real>::lowest();
+            }
+
+            for (auto i = count * t / threads; i < last; i++) {
+                for (std::size_t d = 0; d < Dimensions; d++) {
+                    const auto centroid = Centroid(boxes[i], d);
+                    threadBounds.min[d] = std::min(threadBounds.min[d], centroid);
+                    threadBounds.max[d] = std::max(threadBounds.max[d], centroid);
+                }
+            }
+        });
+
+        for (std::size_t t = 1; t < threads; t++) {
+            Enclose(bounds[0], bounds[t]);
+        }
+
+        return bounds[0];
+    }
+
+    // The length of the common prefix of sorted codes 'i' and 'j', or -1 if 'j' is out of range.
+    // Equal codes are extended with their (32-bit) positions.
+    int Delta(std::ptrdiff_t i, std::ptrdiff_t j) const
+    {
+        if (j < 0 || j >= std::ptrdiff_t(codes.size())) {
+            return -1;
+        }
+
+        const T diff = codes[std::size_t(i)] ^ codes[std::size_t(j)];
+        return diff != 0 ? int(CodeBits - 1 - HighestSetBit(diff))
+            : int(CodeBits + 31 - HighestSetBit(uint32_t(i ^ j)));
+    }
+
+    // Finds the range and split of internal node 'i', and links its children.
+    void BuildInternal(std::ptrdiff_t i)
+    {
+        // The range extends from 'i' towards the neighbor sharing the longer prefix.
+        const std::ptrdiff_t direction = Delta(i, i + 1) > Delta(i, i - 1) ? 1 : -1;
+        const auto minDelta = Delta(i, i - direction);
+
+        std::ptrdiff_t maxLength = 2;
+        while (Delta(i, i + maxLength * direction) > minDelta) {
+            maxLength *= 2;
+        }
+
+        std::ptrdiff_t length = 0;
+        for (auto step = maxLength / 2; step > 0; step /= 2) {
+            if (Delta(i, i + (length + step) * direction) > minDelta) {
+                length += step;
+            }
+        }
+
+        // The split is the last position (from 'i') sharing more than the range's common prefix.
+        const auto j = i + length * direction;
+        const auto nodeDelta = Delta(i, j);
+        std::ptrdiff_t split = 0;
+        for (auto step = length; step > 1;) {
+            step = (step + 1) / 2;
+            if (Delta(i, i + (split + step) * direction) > nodeDelta) {
+                split += step;
+            }
+        }
+
+        const auto gamma = i + split * direction + std::min<std::ptrdiff_t>(direction, 0);
+        const auto leaves = std::ptrdiff_t(codes.size()) - 1;
+        const auto left = std::min(i, j) == gamma ? leaves + gamma : gamma;
+        const auto right = std::max(i, j) == gamma + 1 ? leaves + gamma + 1 : gamma + 1;
+
+        auto& node = nodes[std::size_t(i)];
+        node.left = uint32_t(left);
+        node.right = uint32_t(right);
+        nodes[std::size_t(left)].parent = uint32_t(i);
+        nodes[std::size_t(right)].parent = uint32_t(i);
+    }
+
+    // Sets the box of leaf 'k', and of each ancestor which this is the last arrival at.
+    void Refit(const Box* boxes, std::size_t k, std::vector<std::atomic<uint32_t>>& arrivals)
+    {
+        auto i = codes.size() - 1 + k;
+        auto& leaf = nodes[i];
+        leaf.box = boxes[primitives[k]];
+        leaf.left = leaf.right = primitives[k];
+
+        while (i != 0) {
+            i = nodes[i].parent;
+            if (arrivals[i].fetch_add(1, std::memory_order_acq_rel) == 0) {
+                return;
+            }
+
+            auto& node = nodes[i];
+            node.box = nodes[node.left].box;
+            Enclose(node.box, nodes[node.right].box);
+        }
+    }
+
+    std::vector<Node> nodes;
+    std::vector<T> codes;
+    std::vector<uint32_t> primitives;
+};
+
+}
+
+#endif //MORTON_ND_MORTONND_BVH_H
@@ -0,0 +1,523 @@
+//
+//  mortonND_External.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_EXTERNAL_H
+#define MORTON_ND_MORTONND_EXTERNAL_H
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MORTON_ND_EXTERNAL_ENABLED 1
+#endif
+
+#if MORTON_ND_EXTERNAL_ENABLED
+
+#include "mortonND_Sort.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mortonnd {
+
+/**
+ * Configuration of 'SortFileByMorton'.
+ */
+struct MortonNDExternalSortOptions
+{
+    /**
+     * The approximate number of bytes of memory to use for buffers and in-memory sorting.
+     * Sorted runs are mapped from temporary files, so they are held by the page cache (not counted).
+     */
+    std::size_t memoryBytes = std::size_t(1) << 30;
+
+    /**
+     * The directory in which to create temporary run files. They're unlinked as soon as they're
+     * created, so they never outlive the sort.
+     */
+    std::string tempDirectory = "/tmp";
+
+    /**
+     * The number of threads used to sort each run. 0 selects 'std::thread::hardware_concurrency()'.
+     */
+    std::size_t threads = 0;
+
+    /**
+     * The number of bits in each code which may be set ('Dimensions * FieldBits').
+     */
+    std::size_t keyBits = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * If true, each record in the output is preceded by its code (as 'sizeof(T)' bytes, in native
+     * byte order).
+     */
+    bool writeCodes = false;
+};
+
+/**
+ * Per-stage timings of 'SortFileByMorton'.
+ *
+ * Reading the input overlaps with sorting and spilling runs, and writing the output overlaps
+ * with merging, so the stages' times may add up to more than 'totalSeconds'.
+ */
+struct MortonNDExternalSortStats
+{
+    struct Stage
+    {
+        std::uint64_t bytes = 0;
+        double seconds = 0;
+
+        /**
+         * Returns the stage's throughput, in bytes per second.
+         */
+        double Throughput() const
+        {
+            return seconds > 0 ? double(bytes) / seconds : 0;
+        }
+    };
+
+    std::uint64_t records = 0;
+    std::size_t runs = 0;
+
+    Stage read;   // Reading the input.
+    Stage sort;   // Encoding and sorting each run (bytes of records).
+    Stage spill;  // Writing each sorted run to its temporary file.
+    Stage merge;  // Merging the runs (bytes of output).
+    Stage write;  // Writing the output.
+
+    double totalSeconds = 0;
+};
+
+namespace external_detail {
+
+inline void ThrowErrno(const std::string& what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+inline double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// An open file descriptor, closed on destruction.
+class File
+{
+public:
+    File() = default;
+
+    File(const std::string& path, int flags, mode_t mode = 0644)
+        : fd(::open(path.c_str(), flags, mode))
+    {
+        if (fd < 0) {
+            ThrowErrno("open " + path);
+        }
+    }
+
+    // Creates (and immediately unlinks) a temporary file in 'directory'.
+    static File Temporary(const std::string& directory)
+    {
+        std::string path = directory + "/mortonnd-run-XXXXXX";
+        File file;
+        file.fd = ::mkstemp(&path[0]);
+        if (file.fd < 0) {
+            ThrowErrno("mkstemp " + path);
+        }
+
+        ::unlink(path.c_str());
+        return file;
+    }
+
+    File(File&& other) noexcept : fd(other.fd)
+    {
+        other.fd = -1;
+    }
+
+    File& operator=(File&& other) noexcept
+    {
+        std::swap(fd, other.fd);
+        return *this;
+    }
+
+    ~File()
+    {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    std::uint64_t Size() const
+    {
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ThrowErrno("fstat");
+        }
+
+        return std::uint64_t(st.st_size);
+    }
+
+    void Resize(std::uint64_t size) const
+    {
+        if (::ftruncate(fd, off_t(size)) != 0) {
+            ThrowErrno("ftruncate");
+        }
+    }
+
+    // Reads exactly 'size' bytes at 'offset'.
+    void Read(unsigned char* data, std::size_t size, std::uint64_t offset) const
+    {
+        while (size > 0) {
+            const auto n = ::pread(fd, data, size, off_t(offset));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (n < 0) {
+                ThrowErrno("pread");
+            }
+
+            if (n == 0) {
+                throw std::runtime_error("pread: unexpected end of file");
+            }
+
+            data += n;
+            size -= std::size_t(n);
+            offset += std::uint64_t(n);
+        }
+    }
+
+    // Writes exactly 'size' bytes at 'offset'.
+    void Write(const unsigned char* data, std::size_t size, std::uint64_t offset) const
+    {
+        while (size > 0) {
+            const auto n = ::pwrite(fd, data, size, off_t(offset));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (n < 0) {
+                ThrowErrno("pwrite");
+            }
+
+            data += n;
+            size -= std::size_t(n);
+            offset += std::uint64_t(n);
+        }
+    }
+
+    int fd = -1;
+};
+
+// A shared mapping of (part of) a file, unmapped on destruction.
+class Mapping
+{
+public:
+    Mapping(const File& file, std::size_t size, bool writable)
+        : size(size)
+    {
+        if (size == 0) {
+            return;
+        }
+
+        auto* address = ::mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file.fd, 0);
+        if (address == MAP_FAILED) {
+            ThrowErrno("mmap");
+        }
+
+        data = static_cast<unsigned char*>(address);
+        ::madvise(address, size, MADV_SEQUENTIAL);
+    }
+
+    Mapping(Mapping&& other) noexcept : data(other.data), size(other.size)
+    {
+        other.data = nullptr;
+    }
+
+    Mapping& operator=(Mapping&&) = delete;
+
+    ~Mapping()
+    {
+        if (data != nullptr) {
+            ::munmap(data, size);
+        }
+    }
+
+    unsigned char* data = nullptr;
+    std::size_t size;
+};
+
+// Runs a function on a background thread. 'Join' rethrows anything it threw.
+class Task
+{
+public:
+    template<typename F>
+    explicit Task(F func)
+        : thread([this, func]() {
+            try {
+                func();
+            } catch (...) {
+                error = std::current_exception();
+            }
+        })
+    {
+    }
+
+    ~Task()
+    {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    void Join()
+    {
+        thread.join();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    std::exception_ptr error;
+    std::thread thread;
+};
+
+}
+
+/**
+ * Sorts a file of fixed-size records by Morton code, using a bounded amount of memory.
+ *
+ * The input is sorted in two phases:
+ *
+ *   1. Runs: the input is read one run (as many records as fit in 'options.memoryBytes') at a
+ *      time. Each run is encoded and sorted in memory (see 'MortonNDRadixSort'), and then
+ *      gathered into a memory-mapped temporary file as (code, record) entries. The next run is
+ *      read on a background thread while the current one is sorted and spilled.
+ *   2. Merge: the runs are mapped read-only and k-way merged (by code, then by run) into an
+ *      output buffer, which is written to the output file on a background thread while the next
+ *      buffer is filled.
+ *
+ * The sort is stable: records with the same code keep their input order.
+ *
+ * 'encode(records, count, recordSize, codes)' must write the codes of the 'count' records at
+ * 'records' (spaced 'recordSize' bytes apart) to 'codes'. It's called concurrently for disjoint
+ * blocks of each run. Run buffers are aligned for any fundamental type, so if 'recordSize' is a
+ * multiple of the coordinates' size, 'records + offset' can be passed to an AoS 'EncodeBatch'
+ * (or 'MortonNDQuantizer::EncodeBatch') directly.
+ *
+ * Example (records of 3 'uint32_t' coordinates followed by a 'uint32_t' ID):
+ *   SortFileByMorton<uint32_t>("in.bin", "out.bin", 16,
+ *       [](const unsigned char* records, std::size_t count, std::size_t, uint32_t* codes) {
+ *           MortonNDBmi_3D_32::EncodeBatch(reinterpret_cast<const uint32_t*>(records), 4, codes, count);
+ *       });
+ *
+ * Throws 'std::system_error' if a file operation fails, and 'std::invalid_argument' if the
+ * input's size isn't a multiple of 'recordSize'.
+ *
+ * @tparam T the type of the Morton codes. Must be an unsigned integer type.
+ * @param inputPath the file of records to sort.
+ * @param outputPath the file to write the sorted records to (created or truncated).
+ * @param recordSize the size of each record, in bytes.
+ * @param encode computes the codes of a block of records.
+ * @param options memory budget, temporary directory, etc. (see 'MortonNDExternalSortOptions').
+ * @return per-stage byte counts and timings.
+ */
+template<typename T, typename Encode>
+MortonNDExternalSortStats SortFileByMorton(const std::string& inputPath, const std::string& outputPath, std::size_t recordSize,
+    Encode encode, const MortonNDExternalSortOptions& options = MortonNDExternalSortOptions())
+{
+    using namespace external_detail;
+    using Clock = std::chrono::steady_clock;
+
+    if (recordSize == 0) {
+        throw std::invalid_argument("SortFileByMorton: recordSize must be positive");
+    }
+
+    const auto start = Clock::now();
+    MortonNDExternalSortStats stats;
+
+    const File input(inputPath, O_RDONLY);
+    const auto inputSize = input.Size();
+    if (inputSize % recordSize != 0) {
+        throw std::invalid_argument("SortFileByMorton: input size is not a multiple of recordSize");
+    }
+
+    stats.records = inputSize / recordSize;
+
+    // Each record of a run needs space in both record buffers, plus a key and index in the sort
+    // and its scratch space.
+    const auto bytesPerRecord = 2 * recordSize + 2 * (sizeof(T) + sizeof(std::uint32_t));
+    const auto runRecords = std::size_t(std::min<std::uint64_t>(std::max<std::uint64_t>(stats.records, 1),
+        std::min<std::uint64_t>(std::numeric_limits<std::uint32_t>::max(), std::max<std::size_t>(1, options.memoryBytes / bytesPerRecord))));
+    const auto entrySize = sizeof(T) + recordSize;
+
+    // Phase 1: sort runs.
+    std::vector<File> runs;
+    std::vector<std::uint64_t> runSizes;
+    {
+        std::vector<unsigned char> buffers[2] = {
+            std::vector<unsigned char>(runRecords * recordSize),
+            std::vector<unsigned char>(runRecords * recordSize)
+        };
+        std::vector<T> codes(runRecords);
+        std::vector<std::uint32_t> indices(runRecords);
+
+        const auto readRun = [&](std::uint64_t first, unsigned char* buffer) {
+            const auto readStart = Clock::now();
+            const auto count = std::size_t(std::min<std::uint64_t>(runRecords, stats.records - first));
+            input.Read(buffer, count * recordSize, first * recordSize);
+            stats.read.bytes += count * recordSize;
+            stats.read.seconds += Seconds(readStart);
+        };
+
+        if (stats.records > 0) {
+            readRun(0, buffers[0].data());
+        }
+
+        for (std::uint64_t first = 0, run = 0; first < stats.records; first += runRecords, run++) {
+            const auto count = std::size_t(std::min<std::uint64_t>(runRecords, stats.records - first));
+            const auto* records = buffers[run % 2].data();
+
+            std::unique_ptr<Task> reader;
+            if (first + runRecords < stats.records) {
+                reader.reset(new Task(std::bind(readRun, first + runRecords, buffers[(run + 1) % 2].data())));
+            }
+
+            const auto sortStart = Clock::now();
+            MortonNDRadixSort<T, std::uint32_t>::Sort(codes.data(), indices.data(), count, options.keyBits, options.threads,
+                [&](std::size_t blockFirst, std::size_t n, T* blockCodes, std::uint32_t* blockIndices) {
+                    encode(records + blockFirst * recordSize, n, recordSize, blockCodes);
+                    for (std::size_t i = 0; i < n; i++) {
+                        blockIndices[i] = std::uint32_t(blockFirst + i);
+                    }
+                });
+            stats.sort.bytes += count * recordSize;
+            stats.sort.seconds += Seconds(sortStart);
+
+            const auto spillStart = Clock::now();
+            auto file = File::Temporary(options.tempDirectory);
+            file.Resize(std::uint64_t(count) * entrySize);
+            {
+                const Mapping mapping(file, count * entrySize, true);
+                auto* entry = mapping.data;
+                for (std::size_t i = 0; i < count; i++, entry += entrySize) {
+                    std::memcpy(entry, &codes[i], sizeof(T));
+                    std::memcpy(entry + sizeof(T), records + std::size_t(indices[i]) * recordSize, recordSize);
+                }
+            }
+            stats.spill.bytes += std::uint64_t(count) * entrySize;
+            stats.spill.seconds += Seconds(spillStart);
+
+            runs.push_back(std::move(file));
+            runSizes.push_back(count);
+
+            if (reader) {
+                reader->Join();
+            }
+        }
+    }
+
+    stats.runs = runs.size();
+
+    // Phase 2: merge runs.
+    const auto mergeStart = Clock::now();
+    const File output(outputPath, O_WRONLY | O_CREAT | O_TRUNC);
+    const auto outputEntrySize = options.writeCodes ? entrySize : recordSize;
+    const auto outputSkip = options.writeCodes ? 0 : sizeof(T);
+    output.Resize(stats.records * outputEntrySize);
+
+    std::vector<Mapping> mappings;
+    for (std::size_t r = 0; r < runs.size(); r++) {
+        mappings.emplace_back(runs[r], std::size_t(runSizes[r] * entrySize), false);
+    }
+
+    // Output buffers hold whole entries, and are at most 8 MiB (or 1/4 of the budget).
+    const auto bufferEntries = std::max<std::size_t>(1,
+        std::min<std::size_t>(std::size_t(8) << 20, options.memoryBytes / 4) / outputEntrySize);
+    std::vector<unsigned char> buffers[2] = {
+        std::vector<unsigned char>(bufferEntries * outputEntrySize),
+        std::vector<unsigned char>(bufferEntries * outputEntrySize)
+    };
+
+    const auto codeAt = [&](std::size_t run, std::uint64_t entry) {
+        T code;
+        std::memcpy(&code, mappings[run].data + entry * entrySize, sizeof(T));
+        return code;
+    };
+
+    // Min-heap of (code, run). Ties go to the earlier run, which keeps the merge stable.
+    using Head = std::pair<T, std::size_t>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    std::vector<std::uint64_t> positions(runs.size(), 0);
+    for (std::size_t r = 0; r < runs.size(); r++) {
+        heads.emplace(codeAt(r, 0), r);
+    }
+
+    std::unique_ptr<Task> writer;
+    std::uint64_t written = 0;
+    for (std::size_t buffer = 0; !heads.empty(); buffer ^= 1) {
+        auto* out = buffers[buffer].data();
+        std::size_t filled = 0;
+        for (; filled < bufferEntries && !heads.empty(); filled++, out += outputEntrySize) {
+            const auto run = heads.top().second;
+            heads.pop();
+
+            const auto position = positions[run]++;
+            std::memcpy(out, mappings[run].data + position * entrySize + outputSkip, outputEntrySize);
+
+            if (position + 1 < runSizes[run]) {
+                heads.emplace(codeAt(run, position + 1), run);
+            }
+        }
+
+        if (writer) {
+            writer->Join();
+        }
+
+        const auto offset = written;
+        const auto bytes = filled * outputEntrySize;
+        writer.reset(new Task([&output, &stats, &buffers, buffer, offset, bytes]() {
+            const auto writeStart = Clock::now();
+            output.Write(buffers[buffer].data(), bytes, offset);
+            stats.write.bytes += bytes;
+            stats.write.seconds += Seconds(writeStart);
+        }));
+        written += bytes;
+    }
+
+    if (writer) {
+        writer->Join();
+    }
+
+    stats.merge.bytes = written;
+    stats.merge.seconds = Seconds(mergeStart);
+    stats.totalSeconds = Seconds(start);
+
+    return stats;
+}
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,340 @@
+//
+//  mortonND_Hilbert.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_HILBERT_H
+#define MORTON_ND_MORTONND_HILBERT_H
+
+#include "mortonND_Magic.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace mortonnd {
+
+/**
+ * The maximum number of entries in each of 'HilbertND's state-transition LUTs.
+ */
+static constexpr std::size_t HilbertNDMaxLutSize = std::size_t(1) << 14;
+
+/**
+ * An N-dimensional Hilbert curve encoder/decoder, built on the Morton engines.
+ *
+ * A Hilbert index is computed from the corresponding Morton code, one level (a group of
+ * 'Dimensions' bits, one from each field) at a time, starting from the most-significant.
+ * Each level's Morton digit is transformed into a Hilbert digit by the current orientation of
+ * the curve (a reflection 'e' and a rotation 'd'), followed by an inverse Gray code. The digit
+ * then determines the orientation of the next level. This is the algorithm described by Hamilton
+ * ("Compact Hilbert Indices", 2006).
+ *
+ * Since the Morton code can be computed by any engine, the fastest way to encode is to use the
+ * fastest engine for your target (e.g. 'MortonNDBmi'), followed by 'FromMorton'. The same goes for
+ * decoding, with 'ToMorton'. 'Encode' and 'Decode' are provided for convenience, and use the
+ * portable (and constexpr) 'MortonNDMagic' engine.
+ *
+ * For small 'Dimensions', the transform is done with a state-transition LUT (generated at
+ * compile-time), indexed by the orientation and the next 'LevelsPerLookup' digits, which returns
+ * the transformed digits and the new orientation. Since each lookup depends on the previous one,
+ * as many levels as fit in 'HilbertNDMaxLutSize' entries are transformed per lookup. Otherwise,
+ * the transform is computed with a few bitwise operations per level. All functions are constexpr.
+ *
+ * Configuration:
+ *
+ * Dimensions
+ *   The number of fields (components) to encode / decode.
+ *
+ * T
+ *   The type of the components to encode/decode, as well as the result. Must be an unsigned
+ *   integer type (including '__uint128_t', if your compiler supports it).
+ *
+ * FieldBits
+ *   The number of bits (least-significant) in each field. Defaults to the most that fit in 'T'.
+ *
+ * Lut
+ *   True to use the state-transition LUT. Defaults to true when a single level's LUT fits in
+ *   'HilbertNDMaxLutSize' entries ('Dimensions' * 4^'Dimensions', i.e. 'Dimensions' <= 5).
+ *
+ * @tparam Dimensions the number of fields (components) to encode.
+ * @tparam T the type of the components to encode/decode, as well as the type of the result.
+ * @tparam FieldBits the number of bits in each field.
+ * @tparam Lut true to use the state-transition LUT.
+ */
+template<std::size_t Dimensions, typename T,
+    std::size_t FieldBits = std::size_t(std::numeric_limits<T>::digits) / Dimensions,
+    bool Lut = (Dimensions <= 8 && ((Dimensions << Dimensions) << Dimensions) <= HilbertNDMaxLutSize)>
+class HilbertND
+{
+    static_assert(Dimensions > 0, "'Dimensions' must be > 0.");
+    static_assert(Dimensions <= 32, "'Dimensions' must be <= 32.");
+    static_assert(!Lut || (Dimensions <= 8 && ((Dimensions << Dimensions) << Dimensions) <= HilbertNDMaxLutSize),
+        "The state-transition LUT would exceed 'HilbertNDMaxLutSize' entries.");
+    static_assert(FieldBits > 0, "'FieldBits' must be > 0.");
+    static_assert(std::is_integral<T>::value && !std::is_signed<T>::value, "'T' must be an unsigned integer type.");
+    static_assert(std::size_t(std::numeric_limits<T>::digits) >= Dimensions * FieldBits,
+        "'T' must be able to hold 'Dimensions' * 'FieldBits' bits (the result size).");
+
+    using Magic = MortonNDMagic<Dimensions, T, FieldBits>;
+
+    // The most levels whose transitions (from every state) fit in 'HilbertNDMaxLutSize' entries.
+    static constexpr std::size_t MaxLevelsPerLookup(std::size_t levels)
+    {
+        return levels < FieldBits && ((Dimensions << Dimensions) << (Dimensions * (levels + 1))) <= HilbertNDMaxLutSize
+            ? MaxLevelsPerLookup(levels + 1) : levels;
+    }
+
+public:
+    /**
+     * The number of orientations of the curve (the number of LUT states).
+     */
+    static constexpr std::size_t StateCount = Dimensions << Dimensions;
+
+    /**
+     * Equivalent to class template parameter 'Lut'.
+     *
+     * For debugging / perf tuning.
+     */
+    static constexpr bool UsesLut = Lut;
+
+    /**
+     * The number of levels transformed by each LUT lookup (0 if the LUT isn't used).
+     *
+     * For debugging / perf tuning.
+     */
+    static constexpr std::size_t LevelsPerLookup = Lut ? MaxLevelsPerLookup(1) : 0;
+
+    /**
+     * Calculates the Hilbert index of the specified input fields.
+     *
+     * Can be used in constant expressions. Bits above 'FieldBits' in each input are ignored.
+     *
+     * @param field0 the first field.
+     * @param fields the rest. Must be convertible to 'T' without precision loss for a correct result.
+     * @return the calculated Hilbert index.
+     */
+    template<typename...Args>
+    static constexpr T Encode(T field0, Args... fields)
+    {
+        static_assert(sizeof...(Args) == Dimensions - 1, "'Encode' must be called with exactly 'Dimensions' arguments.");
+        return FromMorton(Magic::Encode(field0, fields...));
+    }
+
+    /**
+     * Decodes a Hilbert index into its components.
+     *
+     * Can be used in constant expressions.
+     *
+     * @param index the Hilbert index to decode.
+     * @return a tuple containing the index's individual components.
+     */
+    static constexpr auto Decode(T index)
+    {
+        return Magic::Decode(ToMorton(index));
+    }
+
+    /**
+     * Converts a Morton code (from any engine) into the Hilbert index of the same point.
+     *
+     * Bits above 'Dimensions' * 'FieldBits' are ignored.
+     */
+    static constexpr T FromMorton(T morton)
+    {
+        return Transform(morton, std::integral_constant<bool, Lut>{}, std::true_type{});
+    }
+
+    /**
+     * Converts a Hilbert index into the Morton code of the same point, which can be decoded
+     * by any engine.
+     *
+     * Bits above 'Dimensions' * 'FieldBits' are ignored.
+     */
+    static constexpr T ToMorton(T index)
+    {
+        return Transform(index, std::integral_constant<bool, Lut>{}, std::false_type{});
+    }
+
+private:
+    HilbertND() = default;
+
+    static constexpr std::size_t DigitMask = (std::size_t(1) << Dimensions) - 1;
+
+    // The orientation of the curve within a cell: reflection 'e' and rotation 'd' (< 'Dimensions').
+    struct State
+    {
+        std::size_t e;
+        std::size_t d;
+    };
+
+    // Rotates the 'Dimensions'-bit 'digit' right by 'bits', which must be <= 'Dimensions'. Branch-free,
+    // since the rotation of each level depends on the data.
+    static constexpr std::size_t RotateRight(std::size_t digit, std::size_t bits)
+    {
+        return ((digit | (digit << Dimensions)) >> bits) & DigitMask;
+    }
+
+    static constexpr std::size_t RotateLeft(std::size_t digit, std::size_t bits)
+    {
+        return RotateRight(digit, Dimensions - bits);
+    }
+
+    static constexpr std::size_t GrayCode(std::size_t i)
+    {
+        return i ^ (i >> 1);
+    }
+
+    static constexpr std::size_t GrayCodeInverse(std::size_t gray)
+    {
+        std::size_t i = gray;
+        for (std::size_t shift = 1; shift < Dimensions; shift <<= 1) {
+            i ^= i >> shift;
+        }
+
+        return i;
+    }
+
+    // The orientation of the sub-cell at Hilbert digit 'w', given the orientation of its parent.
+    static constexpr State NextState(State state, std::size_t w)
+    {
+        // The entry point and the direction (the number of trailing ones, mod 'Dimensions') of sub-cell 'w'.
+        // For 'w' == 0, both are 0.
+        const std::size_t entry = GrayCode((w - 1) & ~std::size_t(1)) & DigitMask & (std::size_t(0) - std::size_t(w != 0));
+        const auto ones = std::size_t(__builtin_ctzll(~uint64_t(((w - 1) | 1) & DigitMask)));
+        const std::size_t direction = ones >= Dimensions ? ones - Dimensions : ones;
+        const std::size_t d = state.d + direction + 1;
+        return State{ state.e ^ RotateLeft(entry, state.d + 1), d >= Dimensions ? d - Dimensions : d };
+    }
+
+    // Transforms one level's digit (Morton to Hilbert if 'Forward'), returning the new digit and
+    // updating 'state'.
+    static constexpr std::size_t Step(State& state, std::size_t digit, std::true_type /* Forward */)
+    {
+        const std::size_t w = GrayCodeInverse(RotateRight(digit ^ state.e, state.d + 1));
+        state = NextState(state, w);
+        return w;
+    }
+
+    static constexpr std::size_t Step(State& state, std::size_t digit, std::false_type /* Forward */)
+    {
+        const std::size_t morton = RotateLeft(GrayCode(digit), state.d + 1) ^ state.e;
+        state = NextState(state, digit);
+        return morton;
+    }
+
+    // Transforms the 'levels' digits of 'chunk' (most-significant first).
+    template<typename Forward>
+    static constexpr std::size_t StepLevels(State& state, std::size_t chunk, std::size_t levels, Forward)
+    {
+        std::size_t result = 0;
+        for (std::size_t level = levels; level-- > 0;) {
+            result |= Step(state, (chunk >> (level * Dimensions)) & DigitMask, Forward{}) << (level * Dimensions);
+        }
+
+        return result;
+    }
+
+    static constexpr std::size_t ChunkBits = Dimensions * LevelsPerLookup;
+    static constexpr std::size_t LutSize = Lut ? StateCount << ChunkBits : 1;
+
+    // LUT entry for index '(state << ChunkBits) | chunk', where state = e * Dimensions + d: the
+    // transformed chunk, with the next state above it.
+    template<bool Forward>
+    static constexpr uint32_t BuildEntry(std::size_t i)
+    {
+        State state{ (i >> ChunkBits) / Dimensions, (i >> ChunkBits) % Dimensions };
+        const std::size_t chunk = StepLevels(state, i & ((std::size_t(1) << ChunkBits) - 1), LevelsPerLookup,
+            std::integral_constant<bool, Forward>{});
+        return uint32_t(chunk | ((state.e * Dimensions + state.d) << ChunkBits));
+    }
+
+    template<bool Forward, std::size_t ...i>
+    static constexpr auto BuildLut(std::index_sequence<i...>) noexcept
+    {
+        return std::array<uint32_t, sizeof...(i)>{{ BuildEntry<Forward>(i)... }};
+    }
+
+    static constexpr std::array<uint32_t, LutSize> EncodeLut = BuildLut<true>(std::make_index_sequence<LutSize>{});
+    static constexpr std::array<uint32_t, LutSize> DecodeLut = BuildLut<false>(std::make_index_sequence<LutSize>{});
+
+    // The levels left over after the LUT chunks, which are transformed first (they're the most-significant).
+    static constexpr std::size_t LeadingLevels = Lut ? FieldBits % LevelsPerLookup : FieldBits;
+
+    template<typename Forward>
+    static constexpr T Transform(T code, std::true_type /* Lut */, Forward)
+    {
+        T result = 0;
+        State state{ 0, 0 };
+        if (LeadingLevels > 0) {
+            const auto shift = Dimensions * (FieldBits - LeadingLevels);
+            result = T(StepLevels(state, std::size_t(code >> shift) & ((std::size_t(1) << (Dimensions * LeadingLevels)) - 1),
+                LeadingLevels, Forward{})) << shift;
+        }
+
+        const auto& lut = Forward::value ? EncodeLut : DecodeLut;
+        std::size_t lutState = state.e * Dimensions + state.d;
+        for (std::size_t level = FieldBits - LeadingLevels; level > 0;) {
+            level -= LevelsPerLookup;
+            const auto shift = level * Dimensions;
+            const auto entry = lut[(lutState << ChunkBits) | (std::size_t(code >> shift) & ((std::size_t(1) << ChunkBits) - 1))];
+            result |= T(entry & ((uint32_t(1) << ChunkBits) - 1)) << shift;
+            lutState = entry >> ChunkBits;
+        }
+
+        return result;
+    }
+
+    template<typename Forward>
+    static constexpr T Transform(T code, std::false_type /* Lut */, Forward)
+    {
+        T result = 0;
+        State state{ 0, 0 };
+        for (std::size_t level = FieldBits; level-- > 0;) {
+            const auto shift = level * Dimensions;
+            result |= T(Step(state, std::size_t(code >> shift) & DigitMask, Forward{})) << shift;
+        }
+
+        return result;
+    }
+};
+
+template<std::size_t Dimensions, typename T, std::size_t FieldBits, bool Lut>
+constexpr std::array<uint32_t, HilbertND<Dimensions, T, FieldBits, Lut>::LutSize> HilbertND<Dimensions, T, FieldBits, Lut>::EncodeLut;
+
+template<std::size_t Dimensions, typename T, std::size_t FieldBits, bool Lut>
+constexpr std::array<uint32_t, HilbertND<Dimensions, T, FieldBits, Lut>::LutSize> HilbertND<Dimensions, T, FieldBits, Lut>::DecodeLut;
+
+/**
+ * Type alias for 2D Hilbert indices that fit in a 32-bit result.
+ *
+ * Inputs must NOT use more than 16 least-significant bits.
+ */
+using HilbertND_2D_32 = HilbertND<2, uint32_t>;
+
+/**
+ * Type alias for 2D Hilbert indices that fit in a 64-bit result.
+ *
+ * Inputs must NOT use more than 32 least-significant bits.
+ */
+using HilbertND_2D_64 = HilbertND<2, uint64_t>;
+
+/**
+ * Type alias for 3D Hilbert indices that fit in a 32-bit result.
+ *
+ * Inputs must NOT use more than 10 least-significant bits.
+ */
+using HilbertND_3D_32 = HilbertND<3, uint32_t>;
+
+/**
+ * Type alias for 3D Hilbert indices that fit in a 64-bit result.
+ *
+ * Inputs must NOT use more than 21 least-significant bits.
+ */
+using HilbertND_3D_64 = HilbertND<3, uint64_t>;
+
+}
+
+#endif
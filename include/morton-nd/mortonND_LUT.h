@@ -9,11 +9,19 @@
 #define mortonND_h
 
 #include <cmath>
+#include <cstdint>
 #include <array>
 #include <tuple>
 #include <type_traits>
 #include <limits>
 
+#include "mortonND_UInt.h"
+
+#if defined(__AVX2__)
+#define MORTON_ND_LUT_AVX2_ENABLED 1
+#include <immintrin.h>
+#endif
+
 namespace mortonnd {
 
 /**
@@ -89,6 +97,37 @@ constexpr auto SplitByN<1>(std::size_t input, std::size_t) {
     return input & 1U;
 }
 
+#if MORTON_ND_LUT_AVX2_ENABLED
+/**
+ * Gathers four 'ValueBytes'-wide unsigned integers from 'base' at the byte offsets
+ * held in each 64-bit lane of 'offsets', zero-extending each to 64 bits.
+ *
+ * Values narrower than 4 bytes are read through the aligned 32-bit word containing
+ * them, so for those 'base' must be 4-byte aligned, and the size of the addressed
+ * table must be a multiple of 4 bytes (to keep every read in bounds).
+ */
+inline __m256i GatherZeroExtend(const void* base, __m256i offsets, std::integral_constant<std::size_t, 8>) {
+    return _mm256_i64gather_epi64(static_cast<const long long*>(base), offsets, 1);
+}
+
+inline __m256i GatherZeroExtend(const void* base, __m256i offsets, std::integral_constant<std::size_t, 4>) {
+    return _mm256_cvtepu32_epi64(_mm256_i64gather_epi32(static_cast<const int*>(base), offsets, 1));
+}
+
+template<std::size_t ValueBytes>
+inline __m256i GatherZeroExtend(const void* base, __m256i offsets, std::integral_constant<std::size_t, ValueBytes>) {
+    static_assert(ValueBytes == 1 || ValueBytes == 2, "'ValueBytes' must be 1, 2, 4 or 8.");
+
+    const __m256i misalignment = _mm256_and_si256(offsets, _mm256_set1_epi64x(3));
+    const __m256i words = _mm256_cvtepu32_epi64(_mm256_i64gather_epi32(
+        static_cast<const int*>(base), _mm256_sub_epi64(offsets, misalignment), 1));
+
+    return _mm256_and_si256(
+        _mm256_srlv_epi64(words, _mm256_slli_epi64(misalignment, 3)),
+        _mm256_set1_epi64x((1LL << (ValueBytes * 8)) - 1));
+}
+#endif
+
 /**
  * A fast portable N-dimensional LUT-based Morton encoder.
  *
@@ -263,10 +302,182 @@ public:
     constexpr T Encode(T field0, Args... fields) const
     {
         static_assert(sizeof...(Args) == Dimensions - 1, "'Encode' must be called with exactly 'Dimensions' arguments.");
-        return EncodeInternal(field0, fields...);
+        return EncodeFields(IsUInt<T>{}, field0, fields...);
     }
 
+    /**
+     * Calculates the Morton encodings of 'count' points whose components are stored
+     * in separate arrays (SoA), writing each code to 'out'.
+     *
+     * Equivalent to:
+     *   out[i] = Encode(fields[0][i], fields[1][i], ...)
+     *
+     * When compiled for AVX2 (and 'T' is a 64-bit integer), 8 points are encoded per
+     * iteration using vector gathers from the LUT. Otherwise, or if each field is looked
+     * up in a single chunk (where scalar loads are cheaper than a gather), this falls back
+     * to the scalar 'Encode'.
+     *
+     * WARNING: Inputs must NOT use more than 'FieldBits' least-significant bits.
+     *
+     * @param fields one array per dimension, each holding at least 'count' components.
+     * @param out destination for 'count' Morton codes. Must not alias 'fields'.
+     * @param count the number of points to encode.
+     */
+    void EncodeBatch(const std::array<const T*, Dimensions>& fields, T* out, std::size_t count) const
+    {
+        EncodeBatchInternal(SoAFields{fields}, out, count, std::integral_constant<bool, VectorBatch>{});
+    }
+
+    /**
+     * Calculates the Morton encodings of 'count' points stored as records (AoS),
+     * writing each code to 'out'.
+     *
+     * Point 'i' is read from 'points + i * stride', and its 'Dimensions' components
+     * must be stored contiguously starting at that address.
+     *
+     * WARNING: Inputs must NOT use more than 'FieldBits' least-significant bits.
+     *
+     * @param points the first component of the first point.
+     * @param stride the distance (in elements of 'T') between consecutive points. Must be >= 'Dimensions'.
+     * @param out destination for 'count' Morton codes. Must not alias 'points'.
+     * @param count the number of points to encode.
+     */
+    void EncodeBatch(const T* points, std::size_t stride, T* out, std::size_t count) const
+    {
+        EncodeBatchInternal(AoSFields{points, stride}, out, count, std::integral_constant<bool, VectorBatch>{});
+    }
+
+    /**
+     * True if 'EncodeBatch' uses the AVX2 gather kernel for this configuration.
+     *
+     * For debugging / perf tuning.
+     */
+#if MORTON_ND_LUT_AVX2_ENABLED
+    static constexpr bool VectorBatch = std::is_integral<T>::value && std::numeric_limits<T>::digits == 64
+        && (ChunkCount > 1)
+        && (sizeof(LutValue) >= 4 || (((std::size_t(1) << LutBits) * sizeof(LutValue)) % 4 == 0));
+#else
+    static constexpr bool VectorBatch = false;
+#endif
+
 private:
+    struct SoAFields {
+        const std::array<const T*, Dimensions>& fields;
+
+        T Get(std::size_t dimension, std::size_t index) const {
+            return fields[dimension][index];
+        }
+
+#if MORTON_ND_LUT_AVX2_ENABLED
+        __m256i Load(std::size_t dimension, std::size_t index) const {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fields[dimension] + index));
+        }
+#endif
+    };
+
+    struct AoSFields {
+        const T* points;
+        std::size_t stride;
+
+        T Get(std::size_t dimension, std::size_t index) const {
+            return points[index * stride + dimension];
+        }
+
+#if MORTON_ND_LUT_AVX2_ENABLED
+        __m256i Load(std::size_t dimension, std::size_t index) const {
+            const auto s = static_cast<long long>(stride);
+            return _mm256_i64gather_epi64(reinterpret_cast<const long long*>(points + index * stride + dimension),
+                _mm256_set_epi64x(3 * s, 2 * s, s, 0), sizeof(T));
+        }
+#endif
+    };
+
+    template<typename Fields, size_t ...I>
+    T EncodeAt(const Fields& fields, std::size_t index, std::index_sequence<I...>) const
+    {
+        return EncodeFields(IsUInt<T>{}, fields.Get(I, index)...);
+    }
+
+    template<typename...Args>
+    constexpr T EncodeFields(std::false_type, Args... fields) const
+    {
+        return EncodeInternal(fields...);
+    }
+
+    // 'UInt' specialization. Each chunk's LUT value is ORed directly into the word(s) at its
+    // final offset (known at compile-time), rather than shifting the whole (wide) result.
+    template<typename...Args>
+    constexpr T EncodeFields(std::true_type, Args... fields) const
+    {
+        const T values[] = { fields... };
+        return EncodeWords(values, std::make_index_sequence<Dimensions * ChunkCount>{});
+    }
+
+    template<std::size_t ...I>
+    constexpr T EncodeWords(const T (&fields)[Dimensions], std::index_sequence<I...>) const
+    {
+        T result;
+
+        // Element I is chunk (I % ChunkCount) of field (I / ChunkCount).
+        using expander = int[];
+        (void)expander{ 0, (void(result.template OrBits<(I % ChunkCount) * Dimensions * LutBits + I / ChunkCount, LutValueWidth>(
+            LookupTable[std::size_t(fields[I / ChunkCount].template GetBits<(I % ChunkCount) * LutBits, LutBits>())])), 0)... };
+
+        return result;
+    }
+
+    template<typename Fields>
+    void EncodeBatchInternal(const Fields& fields, T* out, std::size_t count, std::false_type, std::size_t first = 0) const
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            out[i] = EncodeAt(fields, first + i, std::make_index_sequence<Dimensions>{});
+        }
+    }
+
+#if MORTON_ND_LUT_AVX2_ENABLED
+    template<typename Fields>
+    void EncodeBatchInternal(const Fields& fields, T* out, std::size_t count, std::true_type) const
+    {
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            // Two independent halves, so that the latency of one's gathers is hidden
+            // by the other's.
+            const __m256i codes0 = EncodeVector(fields, i);
+            const __m256i codes1 = EncodeVector(fields, i + 4);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), codes0);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 4), codes1);
+        }
+
+        EncodeBatchInternal(fields, out + i, count - i, std::false_type{}, i);
+    }
+
+    /**
+     * Vector equivalent of 'EncodeInternal' for the 4 points starting at 'index'.
+     *
+     * Each chunk of each field is looked up with a single gather, then shifted to
+     * its final offset in the result: (ChunkIndex * Dimensions * LutBits) + FieldIndex.
+     */
+    template<typename Fields>
+    __m256i EncodeVector(const Fields& fields, std::size_t index) const
+    {
+        const __m256i chunkMask = _mm256_set1_epi64x(static_cast<long long>(ChunkMask));
+        const __m256i valueBytes = _mm256_set1_epi64x(sizeof(LutValue));
+
+        __m256i result = _mm256_setzero_si256();
+        for (std::size_t d = 0; d < Dimensions; d++) {
+            const __m256i field = fields.Load(d, index);
+            for (std::size_t c = 0; c < ChunkCount; c++) {
+                const __m256i chunk = _mm256_and_si256(_mm256_srl_epi64(field, _mm_cvtsi64_si128(c * LutBits)), chunkMask);
+                const __m256i value = GatherZeroExtend(LookupTable.data(), _mm256_mul_epu32(chunk, valueBytes),
+                    std::integral_constant<std::size_t, sizeof(LutValue)>{});
+                result = _mm256_or_si256(result, _mm256_sll_epi64(value, _mm_cvtsi64_si128(c * Dimensions * LutBits + d)));
+            }
+        }
+
+        return result;
+    }
+#endif
+
     template<typename...Args>
     constexpr T EncodeInternal(T field1, Args... fields) const
     {
@@ -295,7 +506,7 @@ private:
 
     constexpr T LookupField(T field, std::size_t) const
     {
-        return LookupTable[field & ChunkMask];
+        return LookupTable[std::size_t(field & ChunkMask)];
     }
 
     // NOTE: this is implemented at namespace level due to CWG727.
@@ -319,7 +530,8 @@ private:
 
     static constexpr std::size_t LutSize = ComputeLutSize();
     static constexpr std::size_t ChunkMask = ~std::size_t(0) >> (std::numeric_limits<std::size_t>::digits - LutBits);
-    const std::array<LutValue, LutSize> LookupTable = BuildLut(std::make_index_sequence<LutSize>{});
+    // Aligned so that the batch kernel's 32-bit gathers of narrow entries never cross the table's bounds.
+    alignas(4) const std::array<LutValue, LutSize> LookupTable = BuildLut(std::make_index_sequence<LutSize>{});
 };
 
 /**
@@ -502,7 +714,68 @@ public:
         return DecodeInternal(input, std::make_index_sequence<ChunkCount>{});
     }
 
+    /**
+     * Decodes 'count' Morton codes, writing the components of each into separate
+     * arrays (SoA).
+     *
+     * Equivalent to:
+     *   std::tie(fields[0][i], fields[1][i], ...) = Decode(codes[i])
+     *
+     * Note: unlike 'EncodeBatch', there is no vector kernel. Decoding needs one gather
+     * per component of each LUT entry, which benchmarks slower than the scalar loads.
+     *
+     * @param codes the Morton codes to decode.
+     * @param count the number of codes to decode.
+     * @param fields one destination array per dimension, each with room for 'count' components.
+     */
+    void DecodeBatch(const T* codes, std::size_t count, const std::array<T*, Dimensions>& fields) const
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            DecodeAt(codes[i], SoAFields{fields}, i, std::make_index_sequence<Dimensions>{});
+        }
+    }
+
+    /**
+     * Decodes 'count' Morton codes, writing the components of each as a record (AoS).
+     *
+     * The components of code 'i' are written contiguously starting at 'points + i * stride'.
+     *
+     * @param codes the Morton codes to decode.
+     * @param count the number of codes to decode.
+     * @param points destination for the first component of the first point.
+     * @param stride the distance (in elements of 'T') between consecutive points. Must be >= 'Dimensions'.
+     */
+    void DecodeBatch(const T* codes, std::size_t count, T* points, std::size_t stride) const
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            DecodeAt(codes[i], AoSFields{points, stride}, i, std::make_index_sequence<Dimensions>{});
+        }
+    }
+
 private:
+    struct SoAFields {
+        const std::array<T*, Dimensions>& fields;
+
+        T& Get(std::size_t dimension, std::size_t index) const {
+            return fields[dimension][index];
+        }
+    };
+
+    struct AoSFields {
+        T* points;
+        std::size_t stride;
+
+        T& Get(std::size_t dimension, std::size_t index) const {
+            return points[index * stride + dimension];
+        }
+    };
+
+    template<typename Fields, size_t ...I>
+    void DecodeAt(T code, const Fields& fields, std::size_t index, std::index_sequence<I...>) const
+    {
+        std::tie(fields.Get(I, index)...) = Decode(code);
+    }
+
     template<std::size_t ChunkStartBit, typename ResultTuple, std::size_t ...I>
     constexpr auto MapComponents(ResultTuple& result, const std::array<LutValue, Dimensions>& chunkLookupResult, std::index_sequence<I...>) const {
         MapComponents<ChunkStartBit>(result, chunkLookupResult, I...);
@@ -524,7 +797,30 @@ private:
         constexpr auto FieldStartIndex = ChunkStartBit + SourceIndex;
         constexpr auto DestIndex = FieldStartIndex % Dimensions;
         constexpr auto InsertOffset = FieldStartIndex / Dimensions;
-        std::get<DestIndex>(result) = (T(chunkLookupResult[SourceIndex]) << InsertOffset) | std::get<DestIndex>(result);
+        InjectComponent<InsertOffset>(std::get<DestIndex>(result), chunkLookupResult[SourceIndex], IsUInt<T>{});
+    }
+
+    template<std::size_t ChunkStartBit>
+    static constexpr std::size_t GetChunk(T field, std::false_type) {
+        return std::size_t((field >> ChunkStartBit) & ChunkMask);
+    }
+
+    // 'UInt' specialization. Reads the chunk from the (at most 2) words containing it.
+    template<std::size_t ChunkStartBit>
+    static constexpr std::size_t GetChunk(T field, std::true_type) {
+        return std::size_t(field.template GetBits<ChunkStartBit, (ChunkStartBit + LutBits <= MortonCodeWidth ? LutBits : MortonCodeWidth - ChunkStartBit)>());
+    }
+
+    template<std::size_t InsertOffset>
+    static constexpr void InjectComponent(T& dest, LutValue component, std::false_type) {
+        dest = (T(component) << InsertOffset) | dest;
+    }
+
+    // 'UInt' specialization. ORs the component directly into the word(s) at 'InsertOffset'.
+    template<std::size_t InsertOffset>
+    static constexpr void InjectComponent(T& dest, LutValue component, std::true_type) {
+        dest.template OrBits<InsertOffset, (InsertOffset >= FieldBits ? 0
+            : InsertOffset + LutValueWidth <= FieldBits ? LutValueWidth : FieldBits - InsertOffset)>(component);
     }
 
     /**
@@ -614,7 +910,7 @@ private:
         auto constexpr ChunkStartBit = ChunkIndex * LutBits;
 
         auto result = DecodeInternal(field, args...);
-        auto chunkLookupResult = LookupTable[std::size_t((field >> ChunkStartBit) & ChunkMask)];
+        auto chunkLookupResult = LookupTable[GetChunk<ChunkStartBit>(field, IsUInt<T>{})];
 
         // 'MapComponents' equivalent logic:
         //
@@ -637,7 +933,7 @@ private:
     constexpr auto DecodeInternal(T field, std::size_t) const
     {
         // This is the 0th chunk, so it lines up with the decode result array.
-        return CreateTuple(LookupTable[field & ChunkMask], std::make_index_sequence<Dimensions>{});
+        return CreateTuple(LookupTable[GetChunk<0>(field, IsUInt<T>{})], std::make_index_sequence<Dimensions>{});
     }
 
     template <size_t ...I>
@@ -0,0 +1,291 @@
+//
+//  mortonND_LocCode.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_LOCCODE_H
+#define MORTON_ND_MORTONND_LOCCODE_H
+
+#include "mortonND_Range.h"
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace mortonnd {
+
+/**
+ * A cell of a 2^N-tree, as the Morton code of its minimum corner ('prefix', with every bit below
+ * the cell's level cleared) and its level (0 is the whole grid).
+ */
+template<typename T>
+struct MortonNDCell
+{
+    T prefix;
+    uint32_t level;
+};
+
+/**
+ * Locational codes: the cells of a quadtree / octree / 2^N-tree, identified by Morton codes.
+ *
+ * A cell at level 'L' is the set of point codes (from any engine) which share their top
+ * 'L * Dimensions' bits. Each 'Dimensions' bits below the top select a child, so parents,
+ * children and siblings are shifts and masks, the deepest common ancestor of two cells is
+ * found from the highest set bit ('clz') of their XOR, and the point codes in a cell are a
+ * contiguous range. Every function is constexpr.
+ *
+ * Cells are represented in one of two ways:
+ *
+ * Prefix ('Sentinel' = false)
+ *   A 'MortonNDCell<T>': the code of the cell's minimum corner, and its level. Point codes and
+ *   cell prefixes are interchangeable (e.g. as keys of the same sorted array), which is how
+ *   'MortonNDOctree' stores its nodes.
+ *
+ * Sentinel ('Sentinel' = true)
+ *   A single 'T': the cell's top 'L * Dimensions' bits, below a 1 (the sentinel bit). The root is
+ *   1, and the level is the position of the sentinel, so cells of every level are distinct
+ *   integers (e.g. usable as hash map keys). This costs one bit, so 'FieldBits' defaults to
+ *   '(bits in T - 1) / Dimensions'.
+ *
+ * 'Parent', 'ChildIndex' and 'Sibling' must not be passed the root, and 'Child' must not be
+ * passed a cell at 'MaxLevel'.
+ *
+ * Configuration:
+ *
+ * Dimensions
+ *   The number of fields (components) in each code.
+ *
+ * T
+ *   The type of the Morton codes. Must be 'uint32_t', 'uint64_t' or '__uint128_t'.
+ *
+ * Sentinel
+ *   Whether cells are represented with a sentinel bit (see above).
+ *
+ * FieldBits
+ *   The number of bits in each field of a point code, i.e. the deepest level ('MaxLevel').
+ *
+ * @tparam Dimensions the number of fields (components) in each code.
+ * @tparam T the type of the Morton codes.
+ * @tparam Sentinel true for single-integer codes with a sentinel bit.
+ * @tparam FieldBits the number of bits in each field.
+ */
+template<std::size_t Dimensions, typename T, bool Sentinel = false,
+    std::size_t FieldBits = (std::size_t(std::numeric_limits<T>::digits) - (Sentinel ? 1 : 0)) / Dimensions>
+class MortonNDLocCode
+{
+    static_assert(Dimensions > 0, "'Dimensions' must be > 0.");
+    static_assert(FieldBits > 0, "'FieldBits' must be > 0.");
+    static_assert(std::size_t(std::numeric_limits<T>::digits) >= Dimensions * FieldBits + (Sentinel ? 1 : 0),
+        "'T' must be able to hold 'Dimensions' * 'FieldBits' bits (plus the sentinel bit).");
+
+    static constexpr std::size_t CodeBits = Dimensions * FieldBits;
+
+public:
+    /**
+     * The type of a cell: 'T' with a sentinel bit, or a 'MortonNDCell<T>'.
+     */
+    using Cell = typename std::conditional<Sentinel, T, MortonNDCell<T>>::type;
+
+    /**
+     * The number of children of a cell (2^'Dimensions').
+     */
+    static constexpr std::size_t Children = std::size_t(1) << Dimensions;
+
+    /**
+     * The deepest level (cells of a single point code).
+     */
+    static constexpr std::size_t MaxLevel = FieldBits;
+
+    /**
+     * Returns the cell covering the whole grid.
+     */
+    static constexpr Cell Root()
+    {
+        return Make(T(0), 0);
+    }
+
+    /**
+     * Returns the cell at 'level' which contains point code 'code'.
+     */
+    static constexpr Cell FromPoint(T code, std::size_t level)
+    {
+        return Make(code & ~LowMask(Dimensions * (FieldBits - level)), level);
+    }
+
+    /**
+     * Returns the level of 'cell'.
+     */
+    static constexpr std::size_t Level(Cell cell)
+    {
+        return LevelOf(cell, std::integral_constant<bool, Sentinel>{});
+    }
+
+    /**
+     * Returns the parent of 'cell'.
+     */
+    static constexpr Cell Parent(Cell cell)
+    {
+        return ParentOf(cell, std::integral_constant<bool, Sentinel>{});
+    }
+
+    /**
+     * Returns child 'i' (< 'Children') of 'cell'. Bit 'f' of 'i' is the offset along field 'f'.
+     */
+    static constexpr Cell Child(Cell cell, std::size_t i)
+    {
+        return ChildOf(cell, i, std::integral_constant<bool, Sentinel>{});
+    }
+
+    /**
+     * Returns the index of 'cell' among the children of its parent.
+     */
+    static constexpr std::size_t ChildIndex(Cell cell)
+    {
+        return ChildIndexOf(cell, std::integral_constant<bool, Sentinel>{});
+    }
+
+    /**
+     * Returns child 'i' of the parent of 'cell'.
+     */
+    static constexpr Cell Sibling(Cell cell, std::size_t i)
+    {
+        return Child(Parent(cell), i);
+    }
+
+    /**
+     * Returns the deepest cell which contains both 'a' and 'b'.
+     */
+    static constexpr Cell CommonAncestor(Cell a, Cell b)
+    {
+        return CommonAncestorOf(a, b, std::integral_constant<bool, Sentinel>{});
+    }
+
+    /**
+     * Returns true if 'ancestor' contains 'cell' (including if they're the same cell).
+     */
+    static constexpr bool Contains(Cell ancestor, Cell cell)
+    {
+        return Level(ancestor) <= Level(cell) && Prefix(FromPoint(Prefix(cell), Level(ancestor))) == Prefix(ancestor);
+    }
+
+    /**
+     * Returns the first and last (inclusive) point codes in 'cell'.
+     */
+    static constexpr std::pair<T, T> DescendantRange(Cell cell)
+    {
+        return std::pair<T, T>(Prefix(cell), Prefix(cell) | LowMask(Dimensions * (FieldBits - Level(cell))));
+    }
+
+    /**
+     * Returns the code of the minimum corner of 'cell' (a point code).
+     */
+    static constexpr T Prefix(Cell cell)
+    {
+        return PrefixOf(cell, std::integral_constant<bool, Sentinel>{});
+    }
+
+private:
+    MortonNDLocCode() = default;
+
+    static constexpr T LowMask(std::size_t bits)
+    {
+        return bits >= std::size_t(std::numeric_limits<T>::digits) ? T(~T(0)) : T((T(1) << bits) - 1);
+    }
+
+    // Prefix representation.
+
+    static constexpr Cell Make(T prefix, std::size_t level, std::false_type)
+    {
+        return Cell{ prefix, uint32_t(level) };
+    }
+
+    static constexpr std::size_t LevelOf(Cell cell, std::false_type)
+    {
+        return cell.level;
+    }
+
+    static constexpr T PrefixOf(Cell cell, std::false_type)
+    {
+        return cell.prefix;
+    }
+
+    static constexpr Cell ParentOf(Cell cell, std::false_type)
+    {
+        return FromPoint(cell.prefix, cell.level - 1);
+    }
+
+    static constexpr Cell ChildOf(Cell cell, std::size_t i, std::false_type)
+    {
+        return Cell{ cell.prefix | T(T(i) << (Dimensions * (FieldBits - cell.level - 1))), cell.level + 1 };
+    }
+
+    static constexpr std::size_t ChildIndexOf(Cell cell, std::false_type)
+    {
+        return std::size_t(cell.prefix >> (Dimensions * (FieldBits - cell.level))) & (Children - 1);
+    }
+
+    // The fields first differ in the highest set bit of the XOR of the prefixes.
+    static constexpr Cell CommonAncestorOf(Cell a, Cell b, std::false_type)
+    {
+        const T diff = (a.prefix ^ b.prefix) & LowMask(CodeBits);
+        const std::size_t level = a.level < b.level ? a.level : b.level;
+        const auto common = diff == 0 ? level : (CodeBits - 1 - HighestSetBit(diff)) / Dimensions;
+        return FromPoint(a.prefix, common < level ? common : level);
+    }
+
+    // Sentinel representation: the top 'level * Dimensions' bits of the prefix, below a 1.
+
+    static constexpr Cell Make(T prefix, std::size_t level, std::true_type)
+    {
+        return (prefix >> (Dimensions * (FieldBits - level))) | (T(1) << (Dimensions * level));
+    }
+
+    static constexpr std::size_t LevelOf(Cell cell, std::true_type)
+    {
+        return HighestSetBit(cell) / Dimensions;
+    }
+
+    static constexpr T PrefixOf(Cell cell, std::true_type)
+    {
+        return (cell ^ (T(1) << (Dimensions * LevelOf(cell, std::true_type{})))) << (Dimensions * (FieldBits - LevelOf(cell, std::true_type{})));
+    }
+
+    static constexpr Cell ParentOf(Cell cell, std::true_type)
+    {
+        return cell >> Dimensions;
+    }
+
+    static constexpr Cell ChildOf(Cell cell, std::size_t i, std::true_type)
+    {
+        return (cell << Dimensions) | T(i);
+    }
+
+    static constexpr std::size_t ChildIndexOf(Cell cell, std::true_type)
+    {
+        return std::size_t(cell) & (Children - 1);
+    }
+
+    // Once both are at the shallower level, their sentinels cancel in the XOR, and the highest
+    // set bit of the rest is in the first child index which differs.
+    static constexpr Cell CommonAncestorOf(Cell a, Cell b, std::true_type)
+    {
+        const auto levelA = LevelOf(a, std::true_type{});
+        const auto levelB = LevelOf(b, std::true_type{});
+        const auto upA = levelA > levelB ? a >> (Dimensions * (levelA - levelB)) : a;
+        const auto upB = levelB > levelA ? b >> (Dimensions * (levelB - levelA)) : b;
+        const T diff = upA ^ upB;
+        return diff == 0 ? upA : upA >> (Dimensions * (HighestSetBit(diff) / Dimensions + 1));
+    }
+
+    static constexpr Cell Make(T prefix, std::size_t level)
+    {
+        return Make(prefix, level, std::integral_constant<bool, Sentinel>{});
+    }
+};
+
+}
+
+#endif //MORTON_ND_MORTONND_LOCCODE_H
@@ -0,0 +1,270 @@
+//
+//  mortonND_Magic.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_MAGIC_H
+#define MORTON_ND_MORTONND_MAGIC_H
+
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mortonnd {
+
+/**
+ * Returns the mask applied after each step of a "magic bits" dilation.
+ *
+ * After the step which operates on groups of 'groupBits' bits, bit 'i' of the
+ * original field lives at:
+ *   (i / groupBits) * groupBits * fields + (i % groupBits)
+ *
+ * This mask selects exactly those positions for the 'fieldBits' bits of the field.
+ * With a 'groupBits' of 1, this is the final layout produced by 'SplitByN' (i.e. the
+ * field's selector). With a 'groupBits' >= 'fieldBits', it's the field's input mask.
+ *
+ * Example:
+ * BuildDilationMask<uint32_t>(8, 3, 2) => 11000011000011000011
+ *
+ * @tparam T the type of the mask.
+ * @param fieldBits the number of bits in the field.
+ * @param fields the number of interleaved fields (the dilation stride).
+ * @param groupBits the number of contiguous field bits kept together at this step.
+ * @return the dilation mask.
+ */
+template<typename T>
+constexpr T BuildDilationMask(std::size_t fieldBits, std::size_t fields, std::size_t groupBits) {
+    T mask = 0;
+    for (std::size_t i = 0; i < fieldBits; i++) {
+        mask |= T(1) << ((i / groupBits) * groupBits * fields + (i % groupBits));
+    }
+
+    return mask;
+}
+
+/**
+ * Returns ceil(log2('value')), or 0 if 'value' <= 1.
+ */
+constexpr std::size_t Log2Ceil(std::size_t value) {
+    return value <= 1 ? 0 : 1 + Log2Ceil((value + 1) / 2);
+}
+
+/**
+ * A portable N-dimensional Morton encoder/decoder based on generated "magic bits"
+ * shift-and-mask sequences.
+ *
+ * Unlike 'MortonNDLutEncoder', this performs no memory lookups at all, and unlike
+ * 'MortonNDBmi', it doesn't require (or suffer from a slow microcoded) 'pdep' / 'pext'.
+ * Each field is dilated in ceil(log2(FieldBits)) shift / or / and steps, each of which
+ * halves the size of the groups of bits that are still contiguous. The masks for each
+ * step are generated at compile-time from 'BuildDilationMask'.
+ *
+ * Like the LUT engine, 'Encode' and 'Decode' are constexpr.
+ *
+ * Example (3D, 8-bit fields):
+ *   ---- ---- ---- ---- 7654 3210     (input)
+ *   ---- ---- 7654 ---- ---- 3210     (groups of 4)
+ *   ---- 76-- --54 ---- 32-- --10     (groups of 2)
+ *   -7-- 6--5 --4- -3-- 2--1 --0-     (groups of 1, after shifting by field index 1)
+ *
+ * Configuration:
+ *
+ * Dimensions
+ *   The number of fields (components) to encode / decode.
+ *
+ * T
+ *   The type of the components to encode/decode, as well as the result. Must be an unsigned
+ *   integer type (including '__uint128_t', if your compiler supports it).
+ *
+ * FieldBits
+ *   The number of bits (least-significant) in each field. Defaults to the most that fit in 'T'.
+ *
+ * @tparam Dimensions the number of fields (components) to encode.
+ * @tparam T the type of the components to encode/decode, as well as the type of the result.
+ * @tparam FieldBits the number of bits in each field.
+ */
+template<std::size_t Dimensions, typename T, std::size_t FieldBits = std::size_t(std::numeric_limits<T>::digits) / Dimensions>
+class MortonNDMagic
+{
+    static_assert(Dimensions > 0, "'Dimensions' must be > 0.");
+    static_assert(FieldBits > 0, "'FieldBits' must be > 0.");
+    static_assert(std::is_integral<T>::value && !std::is_signed<T>::value, "'T' must be an unsigned integer type.");
+    static_assert(std::size_t(std::numeric_limits<T>::digits) >= Dimensions * FieldBits,
+        "'T' must be able to hold 'Dimensions' * 'FieldBits' bits (the result size).");
+
+public:
+    /**
+     * Equivalent to class template parameter 'FieldBits'.
+     */
+    static constexpr std::size_t FieldBitsCount = FieldBits;
+
+    /**
+     * The number of shift / or / and steps used to dilate (or compact) each field.
+     *
+     * For debugging / perf tuning.
+     */
+    static constexpr std::size_t StepCount = Log2Ceil(FieldBits);
+
+    /**
+     * Calculates the Morton encoding of the specified input fields by interleaving the bits
+     * of each. The first bit (LSb) of each field in the interleaved result starts at its offset in
+     * the parameter list.
+     *
+     * Can be used in constant expressions. Bits above 'FieldBits' in each input are ignored.
+     *
+     * Example:
+     *   Encode(xxxxxxxx, yyyyyyyy, zzzzzzzz) => zyxzyxzyxzyxzyxzyxzyxzyx
+     *
+     * @param field0 the first field (will start at offset 0 in the result)
+     * @param fields the rest. Must be convertible to 'T' without precision loss for a correct result.
+     * @return the calculated Morton code.
+     */
+    template<typename...Args>
+    static constexpr T Encode(T field0, Args... fields)
+    {
+        static_assert(sizeof...(Args) == Dimensions - 1, "'Encode' must be called with exactly 'Dimensions' arguments.");
+        return EncodeInternal(field0, fields...);
+    }
+
+    /**
+     * Decodes a Morton code by de-interleaving it into its components.
+     *
+     * Can be used in constant expressions.
+     *
+     * Example:
+     *   Decode(zyxzyxzyxzyxzyxzyxzyxzyx) => std::tuple { xxxxxxxx, yyyyyyyy, zzzzzzzz }
+     *
+     * @param encoding the Morton code to decode.
+     * @return a tuple containing the code's individual components.
+     */
+    static constexpr auto Decode(T encoding)
+    {
+        return DecodeInternal(encoding, std::make_index_sequence<Dimensions>{});
+    }
+
+    /**
+     * Spreads the 'FieldBits' LSbs of 'field' so that there are 'Dimensions' - 1 zero
+     * bits between each (i.e. the encoding of 'field' as field 0, all others 0).
+     *
+     * Bits above 'FieldBits' are ignored.
+     */
+    static constexpr T Dilate(T field)
+    {
+        return DilateInternal(field & Mask<FieldBits>::value, std::integral_constant<std::size_t, StepCount>{});
+    }
+
+    /**
+     * Inverse of 'Dilate'. Gathers every 'Dimensions'-th bit of 'dilated' (starting with the
+     * LSb) into the LSbs of the result. Other bits are ignored.
+     */
+    static constexpr T Compact(T dilated)
+    {
+        return CompactInternal(dilated & Mask<1>::value, std::integral_constant<std::size_t, 0>{});
+    }
+
+    /**
+     * Returns the mask of the bits belonging to field 'field' within a Morton code.
+     *
+     * This is the selector used by 'pdep' / 'pext' in 'MortonNDBmi', and is shared by
+     * every engine, since they all produce the same layout.
+     */
+    static constexpr T Selector(std::size_t field)
+    {
+        return Mask<1>::value << field;
+    }
+
+private:
+    MortonNDMagic() = default;
+
+    // Forces each mask to be computed at compile-time, regardless of the context of the call.
+    template<std::size_t GroupBits>
+    using Mask = std::integral_constant<T, BuildDilationMask<T>(FieldBits, Dimensions, GroupBits)>;
+
+    static constexpr T DilateInternal(T field, std::integral_constant<std::size_t, 0>)
+    {
+        return field;
+    }
+
+    // Splits groups of 2^Step bits into groups of 2^(Step - 1) bits.
+    template<std::size_t Step>
+    static constexpr T DilateInternal(T field, std::integral_constant<std::size_t, Step>)
+    {
+        constexpr auto GroupBits = std::size_t(1) << (Step - 1);
+        return DilateInternal((field | (field << (GroupBits * (Dimensions - 1)))) & Mask<GroupBits>::value,
+            std::integral_constant<std::size_t, Step - 1>{});
+    }
+
+    template<std::size_t Step>
+    static constexpr T CompactInternal(T dilated, std::integral_constant<std::size_t, Step>)
+    {
+        return CompactInternal(dilated, std::integral_constant<std::size_t, Step>{}, std::integral_constant<bool, Step == StepCount>{});
+    }
+
+    template<std::size_t Step>
+    static constexpr T CompactInternal(T dilated, std::integral_constant<std::size_t, Step>, std::true_type)
+    {
+        return dilated;
+    }
+
+    // Merges groups of 2^Step bits into groups of 2^(Step + 1) bits.
+    template<std::size_t Step>
+    static constexpr T CompactInternal(T dilated, std::integral_constant<std::size_t, Step>, std::false_type)
+    {
+        constexpr auto GroupBits = std::size_t(1) << Step;
+        return CompactInternal((dilated | (dilated >> (GroupBits * (Dimensions - 1)))) & Mask<GroupBits * 2>::value,
+            std::integral_constant<std::size_t, Step + 1>{});
+    }
+
+    template<typename...Args>
+    static constexpr T EncodeInternal(T field1, Args... fields)
+    {
+        return EncodeInternal(fields...) | (Dilate(field1) << (Dimensions - sizeof...(fields) - 1));
+    }
+
+    static constexpr T EncodeInternal(T field)
+    {
+        return Dilate(field) << (Dimensions - 1);
+    }
+
+    template<std::size_t... i>
+    static constexpr auto DecodeInternal(T encoding, std::index_sequence<i...>)
+    {
+        return std::make_tuple(Compact(encoding >> i)...);
+    }
+};
+
+/**
+ * Type alias for 2D encodings that fit in a 32-bit result.
+ *
+ * Inputs must NOT use more than 16 least-significant bits.
+ */
+using MortonNDMagic_2D_32 = MortonNDMagic<2, uint32_t>;
+
+/**
+ * Type alias for 2D encodings that fit in a 64-bit result.
+ *
+ * Inputs must NOT use more than 32 least-significant bits.
+ */
+using MortonNDMagic_2D_64 = MortonNDMagic<2, uint64_t>;
+
+/**
+ * Type alias for 3D encodings that fit in a 32-bit result.
+ *
+ * Inputs must NOT use more than 10 least-significant bits.
+ */
+using MortonNDMagic_3D_32 = MortonNDMagic<3, uint32_t>;
+
+/**
+ * Type alias for 3D encodings that fit in a 64-bit result.
+ *
+ * Inputs must NOT use more than 21 least-significant bits.
+ */
+using MortonNDMagic_3D_64 = MortonNDMagic<3, uint64_t>;
+
+}
+
+#endif
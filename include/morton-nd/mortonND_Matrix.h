@@ -0,0 +1,422 @@
+//
+//  mortonND_Matrix.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_MATRIX_H
+#define MORTON_ND_MORTONND_MATRIX_H
+
+#include "mortonND_BMI2.h"
+#include "mortonND_LUT.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace mortonnd {
+
+/**
+ * A dense matrix stored as row-major tiles, with the tiles in Z-order.
+ *
+ * Each tile ("micro-tile") of 2^'TileBits' x 2^'TileBits' elements is contiguous and row-major,
+ * so that kernels can work on it with unit-stride (vectorizable) loops. Tiles are ordered along
+ * the Z-order curve of their (column, row) coordinates, so every aligned square block of 2^k x
+ * 2^k tiles (a "macro-tile", at every k) is contiguous as well. Recursive algorithms which split
+ * matrices into quadrants (see 'Transpose' and 'MultiplyAdd') then work on contiguous memory at
+ * every level of the recursion, and make efficient use of every level of cache and the TLB,
+ * without tuning for their sizes (they're "cache-oblivious").
+ *
+ * Tile indices are computed with 'MortonNDBmi_2D_64' when BMI2 is enabled at compile-time, or
+ * 'MortonNDLutEncoder_2D_64' / 'MortonNDLutDecoder_2D_64' otherwise.
+ *
+ * Matrices of any size are supported. Partial tiles at the right and bottom edges are padded
+ * with zeros, and storage spans the Morton codes of all tiles up to the last one, so matrices
+ * much wider than tall (or vice versa) waste space between their tiles.
+ *
+ * @tparam T the element type (an arithmetic type, for 'MultiplyAdd').
+ * @tparam TileBits the log2 of the number of rows and columns in a tile.
+ */
+template<typename T, std::size_t TileBits = 5>
+class MortonNDMatrix
+{
+    static_assert(TileBits > 0 && TileBits <= 8, "'TileBits' must be in [1, 8].");
+
+public:
+    /**
+     * The number of rows and columns in a tile.
+     */
+    static constexpr std::size_t TileSize = std::size_t(1) << TileBits;
+
+    /**
+     * The number of elements in a tile.
+     */
+    static constexpr std::size_t TileElements = TileSize * TileSize;
+
+    /**
+     * Constructs an empty (0 x 0) matrix.
+     */
+    MortonNDMatrix() = default;
+
+    /**
+     * Constructs a 'rows' x 'cols' matrix of zeros.
+     */
+    MortonNDMatrix(std::size_t rows, std::size_t cols)
+        : rows(rows), cols(cols), tileRows(TileCount(rows)), tileCols(TileCount(cols)),
+          elements(tileRows == 0 || tileCols == 0 ? 0 : (EncodeTile(tileRows - 1, tileCols - 1) + 1) * TileElements)
+    {
+    }
+
+    /**
+     * Converts the row-major matrix at 'data' (with 'pitch' elements between the starts of
+     * consecutive rows, or 'cols' if 0).
+     */
+    static MortonNDMatrix FromRowMajor(const T* data, std::size_t rows, std::size_t cols, std::size_t pitch = 0)
+    {
+        pitch = pitch == 0 ? cols : pitch;
+        if (pitch < cols) {
+            throw std::invalid_argument("'pitch' must be >= 'cols'.");
+        }
+
+        MortonNDMatrix matrix(rows, cols);
+        matrix.ForEachTile([&](std::size_t row, std::size_t col, T* tile) {
+            const std::size_t width = std::min(TileSize, cols - col);
+            for (std::size_t r = 0; r < TileSize && row + r < rows; r++) {
+                std::memcpy(tile + r * TileSize, data + (row + r) * pitch + col, width * sizeof(T));
+            }
+        });
+
+        return matrix;
+    }
+
+    /**
+     * Converts the matrix to row-major order at 'data' (with 'pitch' elements between the starts
+     * of consecutive rows, or 'Cols()' if 0).
+     */
+    void ToRowMajor(T* data, std::size_t pitch = 0) const
+    {
+        pitch = pitch == 0 ? cols : pitch;
+        if (pitch < cols) {
+            throw std::invalid_argument("'pitch' must be >= 'Cols()'.");
+        }
+
+        ForEachTile([&](std::size_t row, std::size_t col, const T* tile) {
+            const std::size_t width = std::min(TileSize, cols - col);
+            for (std::size_t r = 0; r < TileSize && row + r < rows; r++) {
+                std::memcpy(data + (row + r) * pitch + col, tile + r * TileSize, width * sizeof(T));
+            }
+        });
+    }
+
+    std::size_t Rows() const { return rows; }
+    std::size_t Cols() const { return cols; }
+
+    /**
+     * The number of tile rows and columns (including partial tiles).
+     */
+    std::size_t TileRows() const { return tileRows; }
+    std::size_t TileCols() const { return tileCols; }
+
+    /**
+     * Returns the index in 'data()' of the element at ('row', 'col').
+     */
+    static inline std::size_t IndexOf(std::size_t row, std::size_t col)
+    {
+        return std::size_t(EncodeTile(row >> TileBits, col >> TileBits)) * TileElements
+            + ((row & (TileSize - 1)) << TileBits) + (col & (TileSize - 1));
+    }
+
+    /**
+     * Returns the first element of the (row-major) tile at tile row 'tileRow' and tile column
+     * 'tileCol'.
+     */
+    T* Tile(std::size_t tileRow, std::size_t tileCol)
+    {
+        return elements.data() + std::size_t(EncodeTile(tileRow, tileCol)) * TileElements;
+    }
+
+    const T* Tile(std::size_t tileRow, std::size_t tileCol) const
+    {
+        return elements.data() + std::size_t(EncodeTile(tileRow, tileCol)) * TileElements;
+    }
+
+    /**
+     * Returns the element at ('row', 'col'), without bounds checks.
+     */
+    T& operator()(std::size_t row, std::size_t col)
+    {
+        return elements[IndexOf(row, col)];
+    }
+
+    const T& operator()(std::size_t row, std::size_t col) const
+    {
+        return elements[IndexOf(row, col)];
+    }
+
+    /**
+     * Returns the element at ('row', 'col').
+     *
+     * @throws std::out_of_range if 'row' >= 'Rows()' or 'col' >= 'Cols()'.
+     */
+    T& at(std::size_t row, std::size_t col)
+    {
+        CheckBounds(row, col);
+        return (*this)(row, col);
+    }
+
+    const T& at(std::size_t row, std::size_t col) const
+    {
+        CheckBounds(row, col);
+        return (*this)(row, col);
+    }
+
+    /**
+     * The underlying storage (including padding), in Z-order of the tiles.
+     */
+    T* data() { return elements.data(); }
+    const T* data() const { return elements.data(); }
+    std::size_t size() const { return elements.size(); }
+
+    /**
+     * Calls 'func(row, col, tile)' for each tile in storage order, with the tile's first row
+     * and column, and a pointer to its elements.
+     */
+    template<typename F>
+    void ForEachTile(F func)
+    {
+        ForEachTileOf(*this, func);
+    }
+
+    template<typename F>
+    void ForEachTile(F func) const
+    {
+        ForEachTileOf(*this, func);
+    }
+
+private:
+    template<typename Matrix, typename F>
+    static void ForEachTileOf(Matrix& matrix, F func)
+    {
+        const std::size_t tiles = matrix.elements.size() / TileElements;
+        for (std::size_t tile = 0; tile < tiles; tile++) {
+            std::size_t tileRow, tileCol;
+            std::tie(tileRow, tileCol) = DecodeTile(tile);
+            if (tileRow < matrix.tileRows && tileCol < matrix.tileCols) {
+                func(tileRow << TileBits, tileCol << TileBits, matrix.elements.data() + tile * TileElements);
+            }
+        }
+    }
+
+    static std::size_t TileCount(std::size_t count)
+    {
+        return (count + TileSize - 1) >> TileBits;
+    }
+
+    // Tiles are ordered by (column, row), so that x (the column) is the LSb of each level.
+    static inline uint64_t EncodeTile(std::size_t tileRow, std::size_t tileCol)
+    {
+#if MORTON_ND_BMI2_ENABLED
+        return MortonNDBmi_2D_64::Encode(tileCol, tileRow);
+#else
+        return LutEncoder.Encode(tileCol, tileRow);
+#endif
+    }
+
+    static inline std::tuple<std::size_t, std::size_t> DecodeTile(uint64_t code)
+    {
+#if MORTON_ND_BMI2_ENABLED
+        const auto coords = MortonNDBmi_2D_64::Decode(code);
+#else
+        const auto coords = LutDecoder.Decode(code);
+#endif
+        return std::make_tuple(std::size_t(std::get<1>(coords)), std::size_t(std::get<0>(coords)));
+    }
+
+    void CheckBounds(std::size_t row, std::size_t col) const
+    {
+        if (row >= rows || col >= cols) {
+            throw std::out_of_range("MortonNDMatrix: element out of range.");
+        }
+    }
+
+#if !MORTON_ND_BMI2_ENABLED
+    static constexpr MortonNDLutEncoder_2D_64 LutEncoder = MortonNDLutEncoder_2D_64();
+    static constexpr MortonNDLutDecoder_2D_64 LutDecoder = MortonNDLutDecoder_2D_64();
+#endif
+
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::size_t tileRows = 0;
+    std::size_t tileCols = 0;
+    std::vector<T> elements;
+};
+
+template<typename T, std::size_t TileBits>
+constexpr std::size_t MortonNDMatrix<T, TileBits>::TileSize;
+
+template<typename T, std::size_t TileBits>
+constexpr std::size_t MortonNDMatrix<T, TileBits>::TileElements;
+
+#if !MORTON_ND_BMI2_ENABLED
+template<typename T, std::size_t TileBits>
+constexpr MortonNDLutEncoder_2D_64 MortonNDMatrix<T, TileBits>::LutEncoder;
+
+template<typename T, std::size_t TileBits>
+constexpr MortonNDLutDecoder_2D_64 MortonNDMatrix<T, TileBits>::LutDecoder;
+#endif
+
+namespace matrix_detail {
+
+// The smallest power of 2 >= 'count'.
+inline std::size_t BlockSize(std::size_t count)
+{
+    std::size_t size = 1;
+    while (size < count) {
+        size <<= 1;
+    }
+
+    return size;
+}
+
+template<typename T, std::size_t TileBits>
+inline void TransposeTile(const T* source, T* destination)
+{
+    constexpr std::size_t Size = MortonNDMatrix<T, TileBits>::TileSize;
+    for (std::size_t row = 0; row < Size; row++) {
+        for (std::size_t col = 0; col < Size; col++) {
+            destination[col * Size + row] = source[row * Size + col];
+        }
+    }
+}
+
+// Transposes the 'size' x 'size' block of tiles of 'destination' at tile ('row', 'col'),
+// recursing into its quadrants in Z-order.
+template<typename T, std::size_t TileBits>
+inline void TransposeBlock(const MortonNDMatrix<T, TileBits>& source, MortonNDMatrix<T, TileBits>& destination,
+    std::size_t row, std::size_t col, std::size_t size)
+{
+    if (row >= destination.TileRows() || col >= destination.TileCols()) {
+        return;
+    }
+
+    if (size == 1) {
+        TransposeTile<T, TileBits>(source.Tile(col, row), destination.Tile(row, col));
+        return;
+    }
+
+    const std::size_t half = size / 2;
+    TransposeBlock(source, destination, row, col, half);
+    TransposeBlock(source, destination, row, col + half, half);
+    TransposeBlock(source, destination, row + half, col, half);
+    TransposeBlock(source, destination, row + half, col + half, half);
+}
+
+// c += a * b, for row-major tiles. The tile of 'c' is accumulated a block of 'BlockRows' rows x
+// 'BlockCols' columns at a time, in local accumulators which the compiler keeps in registers.
+template<typename T, std::size_t TileBits>
+inline void MultiplyAddTile(const T* a, const T* b, T* c)
+{
+    constexpr std::size_t Size = MortonNDMatrix<T, TileBits>::TileSize;
+    constexpr std::size_t BlockRows = Size < 4 ? Size : 4;
+    constexpr std::size_t BlockCols = Size < 16 ? Size : 16;
+
+    for (std::size_t row = 0; row < Size; row += BlockRows) {
+        for (std::size_t col = 0; col < Size; col += BlockCols) {
+            T sums[BlockRows][BlockCols];
+            for (std::size_t r = 0; r < BlockRows; r++) {
+                for (std::size_t j = 0; j < BlockCols; j++) {
+                    sums[r][j] = c[(row + r) * Size + col + j];
+                }
+            }
+
+            for (std::size_t k = 0; k < Size; k++) {
+                const T* bRow = b + k * Size + col;
+                for (std::size_t r = 0; r < BlockRows; r++) {
+                    const T value = a[(row + r) * Size + k];
+                    for (std::size_t j = 0; j < BlockCols; j++) {
+                        sums[r][j] += value * bRow[j];
+                    }
+                }
+            }
+
+            for (std::size_t r = 0; r < BlockRows; r++) {
+                for (std::size_t j = 0; j < BlockCols; j++) {
+                    c[(row + r) * Size + col + j] = sums[r][j];
+                }
+            }
+        }
+    }
+}
+
+// c += a * b for the 'size' x 'size' blocks of tiles of 'c' at tile ('row', 'col'), 'a' at
+// ('row', 'inner') and 'b' at ('inner', 'col'), recursing into quadrants.
+template<typename T, std::size_t TileBits>
+inline void MultiplyAddBlock(const MortonNDMatrix<T, TileBits>& a, const MortonNDMatrix<T, TileBits>& b,
+    MortonNDMatrix<T, TileBits>& c, std::size_t row, std::size_t col, std::size_t inner, std::size_t size)
+{
+    if (row >= c.TileRows() || col >= c.TileCols() || inner >= a.TileCols()) {
+        return;
+    }
+
+    if (size == 1) {
+        MultiplyAddTile<T, TileBits>(a.Tile(row, inner), b.Tile(inner, col), c.Tile(row, col));
+        return;
+    }
+
+    const std::size_t half = size / 2;
+    for (std::size_t quadrant = 0; quadrant < 4; quadrant++) {
+        const std::size_t blockRow = row + (quadrant >> 1) * half;
+        const std::size_t blockCol = col + (quadrant & 1) * half;
+        MultiplyAddBlock(a, b, c, blockRow, blockCol, inner, half);
+        MultiplyAddBlock(a, b, c, blockRow, blockCol, inner + half, half);
+    }
+}
+
+} // namespace matrix_detail
+
+/**
+ * Transposes 'source' into 'destination', which is resized to 'source.Cols()' x
+ * 'source.Rows()'.
+ *
+ * Recurses into quadrants (in Z-order) down to single tiles, which are transposed in cache.
+ */
+template<typename T, std::size_t TileBits>
+inline void Transpose(const MortonNDMatrix<T, TileBits>& source, MortonNDMatrix<T, TileBits>& destination)
+{
+    if (destination.Rows() != source.Cols() || destination.Cols() != source.Rows()) {
+        destination = MortonNDMatrix<T, TileBits>(source.Cols(), source.Rows());
+    }
+
+    const std::size_t size = matrix_detail::BlockSize(std::max(destination.TileRows(), destination.TileCols()));
+    matrix_detail::TransposeBlock(source, destination, 0, 0, size);
+}
+
+/**
+ * Computes 'c' += 'a' * 'b'.
+ *
+ * Recurses into quadrants of all 3 matrices (C11 += A11 * B11, C11 += A12 * B21, ...) down to
+ * single tiles, which are multiplied with a register-blocked kernel.
+ *
+ * @throws std::invalid_argument if the matrices' dimensions don't match ('a' is m x k, 'b' is
+ *         k x n and 'c' is m x n).
+ */
+template<typename T, std::size_t TileBits>
+inline void MultiplyAdd(const MortonNDMatrix<T, TileBits>& a, const MortonNDMatrix<T, TileBits>& b,
+    MortonNDMatrix<T, TileBits>& c)
+{
+    if (a.Cols() != b.Rows() || c.Rows() != a.Rows() || c.Cols() != b.Cols()) {
+        throw std::invalid_argument("Matrix dimensions don't match.");
+    }
+
+    const std::size_t size = matrix_detail::BlockSize(std::max({ a.TileRows(), a.TileCols(), b.TileCols() }));
+    matrix_detail::MultiplyAddBlock(a, b, c, 0, 0, 0, size);
+}
+
+} // namespace mortonnd
+
+#endif // MORTON_ND_MORTONND_MATRIX_H
@@ -0,0 +1,821 @@
+//
+//  mortonND_Mixed.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_MIXED_H
+#define MORTON_ND_MORTONND_MIXED_H
+
+#include "mortonND_BMI2.h"
+#include "mortonND_LUT.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mortonnd {
+
+/**
+ * The bit layout of a Morton code whose fields have different widths.
+ *
+ * Bits are interleaved round-robin, one level (the next bit of each field) at a time, starting
+ * with the LSb of each field. Once a field runs out of bits, it's skipped, so the remaining
+ * fields are packed without gaps.
+ *
+ * Example (FieldBits = 4, 2, 3):
+ *   Encode(xxxx, yy, zzz) => xxzxzyxzyx
+ *
+ * When all fields have the same width, this is the layout produced by every other engine.
+ *
+ * All functions are constexpr, and are intended to be evaluated at compile-time.
+ *
+ * @tparam FieldBits the number of bits in each field, in field order.
+ */
+template<std::size_t... FieldBits>
+struct MortonNDMixedLayout
+{
+    static_assert(sizeof...(FieldBits) > 0, "At least one field width must be provided.");
+
+    /**
+     * The number of fields (components) in each code.
+     */
+    static constexpr std::size_t Dimensions = sizeof...(FieldBits);
+
+    /**
+     * Returns the number of bits in field 'field'.
+     */
+    static constexpr std::size_t Width(std::size_t field)
+    {
+        const std::size_t widths[] = { FieldBits... };
+        return widths[field];
+    }
+
+    /**
+     * Returns the total number of bits in each code (the sum of the field widths).
+     */
+    static constexpr std::size_t CodeBits()
+    {
+        std::size_t bits = 0;
+        for (std::size_t field = 0; field < Dimensions; field++) {
+            bits += Width(field);
+        }
+
+        return bits;
+    }
+
+    /**
+     * Returns the offset (in the code) of bit 'bit' of field 'field'.
+     *
+     * This is the number of bits of every field below level 'bit', plus the number of
+     * fields before 'field' which still have a bit at that level.
+     */
+    static constexpr std::size_t Offset(std::size_t field, std::size_t bit)
+    {
+        std::size_t offset = 0;
+        for (std::size_t other = 0; other < Dimensions; other++) {
+            offset += Width(other) < bit ? Width(other) : bit;
+            offset += other < field && Width(other) > bit;
+        }
+
+        return offset;
+    }
+
+    /**
+     * Returns the number of bits of field 'field' which land below offset 'offset' in the code.
+     */
+    static constexpr std::size_t BitsBelow(std::size_t field, std::size_t offset)
+    {
+        std::size_t bits = 0;
+        while (bits < Width(field) && Offset(field, bits) < offset) {
+            bits++;
+        }
+
+        return bits;
+    }
+
+    /**
+     * Returns the mask of the bits belonging to field 'field' (the field's selector).
+     *
+     * @tparam T an unsigned integer type with at least 'CodeBits()' bits.
+     */
+    template<typename T>
+    static constexpr T Selector(std::size_t field)
+    {
+        T selector = 0;
+        for (std::size_t bit = 0; bit < Width(field); bit++) {
+            selector |= T(1) << Offset(field, bit);
+        }
+
+        return selector;
+    }
+};
+
+#if MORTON_ND_BMI2_ENABLED
+/**
+ * A BMI2 Morton encoder/decoder for an arbitrary compile-time bit layout.
+ *
+ * Equivalent to 'MortonNDBmi', except that the position of each field's bits in the code is
+ * given by 'Layout' (e.g. 'MortonNDMixedLayout'). Each field's 'pdep' / 'pext' selector is
+ * generated at compile-time from the layout, so there's no run-time cost compared to the
+ * round-robin layout of 'MortonNDBmi'.
+ *
+ * Configuration:
+ *
+ * T
+ *   The type of the components to encode/decode, as well as the result. This must be either
+ *   'uint32_t', 'uint64_t' or '__uint128_t' (if supported by your compiler). Results wider than
+ *   64 bits take 1 'pdep' / 'pext' per field per 64-bit word.
+ *
+ * Layout
+ *   A layout type providing 'Dimensions', 'CodeBits()', 'Width(field)', 'Offset(field, bit)',
+ *   'BitsBelow(field, offset)' and 'Selector<T>(field)' (see 'MortonNDMixedLayout'). The bits
+ *   of each field must be placed in increasing order in the code.
+ *
+ * @tparam T the type of the components to encode/decode, as well as the type of the result.
+ * @tparam Layout the bit layout of the code.
+ */
+template<typename T, typename Layout>
+class MortonNDBmiLayout
+{
+public:
+    static constexpr std::size_t Dimensions = Layout::Dimensions;
+
+    static_assert(IsBmiResultType<T>::value && !IsUInt<T>::value,
+        "'T' must be either uint32_t, uint64_t or __uint128_t.");
+    static_assert(Layout::CodeBits() <= std::size_t(std::numeric_limits<T>::digits),
+        "The layout's code must fit in 'T'.");
+
+    /**
+     * Calculates the Morton encoding of the specified input fields by interleaving the bits
+     * of each, as given by 'Layout'.
+     *
+     * WARNING: Inputs must NOT use more than their field's width of least-significant bits.
+     *
+     * @param field0 the first field (will start at offset 0 in the result)
+     * @param fields the rest.
+     * @return the calculated Morton code.
+     */
+    template<typename...Args>
+    static inline T Encode(T field0, Args... fields)
+    {
+        static_assert(sizeof...(Args) == Dimensions - 1, "'Encode' must be called with exactly 'Dimensions' arguments.");
+        const T values[] = { field0, T(fields)... };
+        return EncodeInternal(values, std::make_index_sequence<Dimensions>{});
+    }
+
+    /**
+     * Decodes a Morton code by de-interleaving it into its components.
+     *
+     * @param encoding the Morton code to decode.
+     * @return a tuple containing the code's individual components.
+     */
+    static inline auto Decode(T encoding)
+    {
+        return DecodeInternal(encoding, std::make_index_sequence<Dimensions>{});
+    }
+
+    /**
+     * Returns the mask of the bits belonging to field 'Field'.
+     */
+    template<std::size_t Field>
+    static constexpr T Selector()
+    {
+        static_assert(Field < Dimensions, "'Field' must be < 'Dimensions'.");
+        return FieldSelector<Field>::value;
+    }
+
+private:
+    MortonNDBmiLayout() = default;
+
+    static constexpr std::size_t WordBits = 64;
+    static constexpr std::size_t WordCount = (std::size_t(std::numeric_limits<T>::digits) + WordBits - 1) / WordBits;
+
+    template<std::size_t Field>
+    using FieldSelector = std::integral_constant<T, Layout::template Selector<T>(Field)>;
+
+    // The selector for field 'Field' within (64-bit) word 'Word' of the result.
+    template<std::size_t Field, std::size_t Word>
+    using WordSelector = std::integral_constant<uint64_t, uint64_t(FieldSelector<Field>::value >> (Word * WordBits))>;
+
+    // The first bit of field 'Field' which lands in word 'Word' of the result.
+    template<std::size_t Field, std::size_t Word>
+    using FirstWordBit = std::integral_constant<std::size_t, Layout::BitsBelow(Field, Word * WordBits)>;
+
+    template<std::size_t... f>
+    static inline T EncodeInternal(const T (&fields)[Dimensions], std::index_sequence<f...>)
+    {
+        T encoding = 0;
+
+        using expander = int[];
+        (void)expander{ 0, (void(encoding |= Deposit<f>(fields[f])), 0)... };
+
+        return encoding;
+    }
+
+    template<std::size_t... f>
+    static inline auto DecodeInternal(T encoding, std::index_sequence<f...>)
+    {
+        return std::make_tuple(Extract<f>(encoding)...);
+    }
+
+    template<std::size_t Field>
+    static inline uint32_t Deposit(uint32_t field) {
+        return _pdep_u32(field, static_cast<uint32_t>(FieldSelector<Field>::value));
+    }
+
+    template<std::size_t Field>
+    static inline uint64_t Deposit(uint64_t field) {
+        return _pdep_u64(field, FieldSelector<Field>::value);
+    }
+
+    template<std::size_t Field>
+    static inline uint32_t Extract(uint32_t encoding) {
+        return _pext_u32(encoding, static_cast<uint32_t>(FieldSelector<Field>::value));
+    }
+
+    template<std::size_t Field>
+    static inline uint64_t Extract(uint64_t encoding) {
+        return _pext_u64(encoding, FieldSelector<Field>::value);
+    }
+
+#if defined(__SIZEOF_INT128__)
+    template<std::size_t Field>
+    static inline __uint128_t Deposit(__uint128_t field) {
+        return DepositWords<Field>(field, std::make_index_sequence<WordCount>{});
+    }
+
+    template<std::size_t Field>
+    static inline __uint128_t Extract(__uint128_t encoding) {
+        return ExtractWords<Field>(encoding, std::make_index_sequence<WordCount>{});
+    }
+
+    template<std::size_t Field, std::size_t... w>
+    static inline __uint128_t DepositWords(__uint128_t field, std::index_sequence<w...>) {
+        __uint128_t encoding = 0;
+
+        using expander = int[];
+        (void)expander{ 0, (void(encoding |= __uint128_t(
+            _pdep_u64(uint64_t(field >> FirstWordBit<Field, w>::value), WordSelector<Field, w>::value)) << (w * WordBits)), 0)... };
+
+        return encoding;
+    }
+
+    template<std::size_t Field, std::size_t... w>
+    static inline __uint128_t ExtractWords(__uint128_t encoding, std::index_sequence<w...>) {
+        __uint128_t field = 0;
+
+        using expander = int[];
+        (void)expander{ 0, (void(field |= __uint128_t(
+            _pext_u64(uint64_t(encoding >> (w * WordBits)), WordSelector<Field, w>::value)) << FirstWordBit<Field, w>::value), 0)... };
+
+        return field;
+    }
+#endif
+};
+
+/**
+ * A BMI2 Morton encoder/decoder for fields of different widths.
+ *
+ * Equivalent to 'MortonNDBmi', except that each field has its own width (see
+ * 'MortonNDMixedLayout' for the resulting layout). Each field's 'pdep' / 'pext' selector is
+ * generated at compile-time from its width, so there's no run-time cost compared to fields
+ * of a single width.
+ *
+ * Example (x, y: 20 bits; z, t: 12 bits, in a 64-bit code):
+ *   using MortonND = MortonNDBmiMixed<uint64_t, 20, 20, 12, 12>;
+ *   auto encoding = MortonND::Encode(x, y, z, t);
+ *
+ * @tparam T the type of the components to encode/decode, as well as the type of the result.
+ *         Must be either 'uint32_t', 'uint64_t' or '__uint128_t'.
+ * @tparam FieldBits the number of bits in each field, in field order. The sum must not exceed
+ *         the width of 'T'.
+ */
+template<typename T, std::size_t... FieldBits>
+using MortonNDBmiMixed = MortonNDBmiLayout<T, MortonNDMixedLayout<FieldBits...>>;
+#endif
+
+/**
+ * A portable LUT-based Morton encoder for an arbitrary compile-time bit layout.
+ *
+ * Equivalent to 'MortonNDLutEncoder', except that the position of each field's bits in the code
+ * is given by 'Layout' (see 'MortonNDBmiLayout' for its requirements). Each field is looked up
+ * 'LutBits' bits at a time. Since the spacing between a field's bits may change along the field
+ * (e.g. once a shorter field runs out), chunks can't share a single LUT. Instead, each distinct
+ * spacing has its own LUT, holding a chunk's bits spread out relative to the offset of its first
+ * bit (chunks with the same spacing, e.g. every field's first chunk in a mixed layout, share a
+ * LUT). The tables, and each chunk's table and offset, are generated at compile-time, so 'Encode'
+ * is a lookup, a shift and an OR per chunk.
+ *
+ * LUT size in memory will be:    2^^LutBits * sizeof(LutValue) * TableCount
+ *
+ * @tparam T the type of the components to encode, as well as the type of the result. Must be an
+ *         unsigned integer type (including '__uint128_t', if your compiler supports it).
+ * @tparam LutBits the number of bits for the LUT. Each field will be looked-up 'LutBits' bits at a time.
+ * @tparam Layout the bit layout of the code.
+ */
+template<typename T, std::size_t LutBits, typename Layout>
+class MortonNDLutLayoutEncoder
+{
+    static_assert(LutBits > 0, "'LutBits' must be > 0.");
+
+    // Note: there's no technical reason for '16', but a larger value would be unreasonable
+    //       given that there's a LUT per chunk.
+    static_assert(LutBits <= 16, "'LutBits' must be <= 16.");
+
+    static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value, "'T' must be an unsigned integer type.");
+    static_assert(Layout::CodeBits() <= std::size_t(std::numeric_limits<T>::digits),
+        "The layout's code must fit in 'T'.");
+
+public:
+    static constexpr std::size_t Dimensions = Layout::Dimensions;
+
+    /**
+     * The type used for encoding inputs as well as the result.
+     */
+    typedef T type;
+
+    /**
+     * Returns the number of chunks into which field 'field' is partitioned. This is also
+     * the number of LUT lookups performed for the field.
+     *
+     * For debugging / perf tuning.
+     */
+    static constexpr std::size_t ChunkCount(std::size_t field)
+    {
+        return (Layout::Width(field) + LutBits - 1) / LutBits;
+    }
+
+private:
+    static constexpr std::size_t LutSize = std::size_t(1) << LutBits;
+    static constexpr std::size_t ChunkMask = LutSize - 1;
+
+    static constexpr std::size_t TotalChunks()
+    {
+        std::size_t chunks = 0;
+        for (std::size_t field = 0; field < Dimensions; field++) {
+            chunks += ChunkCount(field);
+        }
+
+        return chunks;
+    }
+
+    // The field of (flattened) chunk 'chunk'.
+    static constexpr std::size_t ChunkField(std::size_t chunk)
+    {
+        std::size_t field = 0;
+        while (chunk >= ChunkCount(field)) {
+            chunk -= ChunkCount(field++);
+        }
+
+        return field;
+    }
+
+    // The first bit (in its field) of chunk 'chunk'.
+    static constexpr std::size_t ChunkFirstBit(std::size_t chunk)
+    {
+        for (std::size_t field = 0; chunk >= ChunkCount(field); field++) {
+            chunk -= ChunkCount(field);
+        }
+
+        return chunk * LutBits;
+    }
+
+    static constexpr std::size_t ChunkBits(std::size_t chunk)
+    {
+        return Layout::Width(ChunkField(chunk)) - ChunkFirstBit(chunk) < LutBits
+            ? Layout::Width(ChunkField(chunk)) - ChunkFirstBit(chunk) : LutBits;
+    }
+
+    // The distance between the offsets of the first and last bits of chunk 'chunk', plus 1.
+    static constexpr std::size_t ChunkSpan(std::size_t chunk)
+    {
+        return Layout::Offset(ChunkField(chunk), ChunkFirstBit(chunk) + ChunkBits(chunk) - 1)
+            - Layout::Offset(ChunkField(chunk), ChunkFirstBit(chunk)) + 1;
+    }
+
+    static constexpr std::size_t MaxSpan()
+    {
+        std::size_t span = 1;
+        for (std::size_t chunk = 0; chunk < TotalChunks(); chunk++) {
+            span = ChunkSpan(chunk) > span ? ChunkSpan(chunk) : span;
+        }
+
+        return span;
+    }
+
+    // True if chunks 'a' and 'b' have the same LUT, i.e. their bits are spread out the same way.
+    static constexpr bool SameTable(std::size_t a, std::size_t b)
+    {
+        if (ChunkBits(a) != ChunkBits(b)) {
+            return false;
+        }
+
+        for (std::size_t bit = 0; bit < ChunkBits(a); bit++) {
+            if (Layout::Offset(ChunkField(a), ChunkFirstBit(a) + bit) - Layout::Offset(ChunkField(a), ChunkFirstBit(a))
+                != Layout::Offset(ChunkField(b), ChunkFirstBit(b) + bit) - Layout::Offset(ChunkField(b), ChunkFirstBit(b))) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // The first chunk with the same LUT as chunk 'chunk' (the one its LUT is built from).
+    static constexpr std::size_t FirstWithTable(std::size_t chunk)
+    {
+        std::size_t first = 0;
+        while (!SameTable(first, chunk)) {
+            first++;
+        }
+
+        return first;
+    }
+
+    // The number of distinct LUTs used by the chunks before chunk 'chunk'.
+    static constexpr std::size_t TablesBefore(std::size_t chunk)
+    {
+        std::size_t tables = 0;
+        for (std::size_t other = 0; other < chunk; other++) {
+            tables += FirstWithTable(other) == other;
+        }
+
+        return tables;
+    }
+
+    // The index of the LUT of chunk 'chunk'.
+    static constexpr std::size_t TableOf(std::size_t chunk)
+    {
+        return TablesBefore(FirstWithTable(chunk));
+    }
+
+    // The first chunk using LUT 'table'.
+    static constexpr std::size_t TableChunk(std::size_t table)
+    {
+        std::size_t chunk = 0;
+        while (FirstWithTable(chunk) != chunk || TablesBefore(chunk) != table) {
+            chunk++;
+        }
+
+        return chunk;
+    }
+
+public:
+    /**
+     * The total number of chunks (and LUT lookups) over all fields.
+     */
+    static constexpr std::size_t TotalChunkCount = TotalChunks();
+
+    /**
+     * The number of distinct LUTs.
+     *
+     * For debugging / perf tuning.
+     */
+    static constexpr std::size_t TableCount = TablesBefore(TotalChunks());
+
+    /**
+     * The type selected internally for the LUT's value.
+     *
+     * For debugging / perf tuning.
+     */
+    using LutValue = MinInt<MaxSpan()>;
+
+    static_assert(MaxSpan() <= 64, "'LutBits' is too large for the layout (a chunk's bits must span <= 64 bits of the code).");
+
+    /**
+     * Constexpr constructor.
+     *
+     * The resulting class literal instance holds the generated LUTs, and can be used at
+     * compile-time.
+     */
+    constexpr MortonNDLutLayoutEncoder() = default;
+
+    /**
+     * Calculates the Morton encoding of the specified input fields by interleaving the bits
+     * of each, as given by 'Layout'.
+     *
+     * Can be used in constant expressions.
+     *
+     * WARNING: Inputs must NOT use more than their field's width of least-significant bits.
+     *
+     * @param field0 the first field (will start at offset 0 in the result)
+     * @param fields the rest.
+     * @return the calculated Morton code.
+     */
+    template<typename...Args>
+    constexpr T Encode(T field0, Args... fields) const
+    {
+        static_assert(sizeof...(Args) == Dimensions - 1, "'Encode' must be called with exactly 'Dimensions' arguments.");
+        const T values[] = { field0, T(fields)... };
+        return EncodeInternal(values, std::make_index_sequence<TotalChunkCount>{});
+    }
+
+private:
+    // Entry 'input' of the LUT of chunk 'Chunk'.
+    template<std::size_t Chunk>
+    static constexpr LutValue BuildEntry(std::size_t input)
+    {
+        constexpr auto field = ChunkField(Chunk);
+        constexpr auto first = ChunkFirstBit(Chunk);
+
+        LutValue value = 0;
+        for (std::size_t bit = 0; bit < ChunkBits(Chunk); bit++) {
+            value |= LutValue((input >> bit) & 1U) << (Layout::Offset(field, first + bit) - Layout::Offset(field, first));
+        }
+
+        return value;
+    }
+
+    // The chunk the LUT 'Table' is built from (evaluated once per LUT, rather than per entry).
+    template<std::size_t Table>
+    using FirstChunk = std::integral_constant<std::size_t, TableChunk(Table)>;
+
+    template<std::size_t... i>
+    static constexpr auto BuildLut(std::index_sequence<i...>) noexcept
+    {
+        return std::array<LutValue, sizeof...(i)>{{ BuildEntry<FirstChunk<i / LutSize>::value>(i % LutSize)... }};
+    }
+
+    template<std::size_t Chunk>
+    using Field = std::integral_constant<std::size_t, ChunkField(Chunk)>;
+
+    template<std::size_t Chunk>
+    using FirstBit = std::integral_constant<std::size_t, ChunkFirstBit(Chunk)>;
+
+    template<std::size_t Chunk>
+    using Table = std::integral_constant<std::size_t, TableOf(Chunk) * LutSize>;
+
+    template<std::size_t Chunk>
+    using ChunkOffset = std::integral_constant<std::size_t, Layout::Offset(ChunkField(Chunk), ChunkFirstBit(Chunk))>;
+
+    template<std::size_t... c>
+    constexpr T EncodeInternal(const T (&fields)[Dimensions], std::index_sequence<c...>) const
+    {
+        T result = 0;
+
+        using expander = int[];
+        (void)expander{ 0, (void(result |= T(LookupTable[Table<c>::value
+            + std::size_t((fields[Field<c>::value] >> FirstBit<c>::value) & ChunkMask)]) << ChunkOffset<c>::value), 0)... };
+
+        return result;
+    }
+
+    const std::array<LutValue, TableCount * LutSize> LookupTable = BuildLut(std::make_index_sequence<TableCount * LutSize>{});
+};
+
+/**
+ * A portable LUT-based Morton encoder for fields of different widths.
+ *
+ * Equivalent to 'MortonNDLutEncoder', except that each field has its own width (see
+ * 'MortonNDMixedLayout' for the resulting layout).
+ *
+ * Example (x, y: 20 bits; z, t: 12 bits, in a 64-bit code):
+ *   constexpr auto MortonND_Enc = MortonNDLutMixedEncoder<uint64_t, 8, 20, 20, 12, 12>();
+ *   auto encoding = MortonND_Enc.Encode(x, y, z, t);
+ *
+ * @tparam T the type of the components to encode, as well as the type of the result.
+ * @tparam LutBits the number of bits for the LUT.
+ * @tparam FieldBits the number of bits in each field.
+ */
+template<typename T, std::size_t LutBits, std::size_t... FieldBits>
+using MortonNDLutMixedEncoder = MortonNDLutLayoutEncoder<T, LutBits, MortonNDMixedLayout<FieldBits...>>;
+
+/**
+ * A portable LUT-based Morton decoder for an arbitrary compile-time bit layout.
+ *
+ * Equivalent to 'MortonNDLutDecoder', except that the position of each field's bits in the code
+ * is given by 'Layout' (see 'MortonNDBmiLayout' for its requirements). The code is looked up
+ * 'LutBits' bits at a time. Since the fields present in a chunk (and their order) may differ
+ * between chunks (e.g. once a shorter field runs out), chunks can't share a single LUT. Instead,
+ * each distinct arrangement of fields has its own LUT, whose entries hold the chunk's bits of
+ * each field. The tables, and each chunk's table and the offset in each field at which its bits
+ * are inserted, are generated at compile-time.
+ *
+ * LUT size in memory will be (appx.):    2^^LutBits * sizeof(std::array<LutValue, Dimensions>) * TableCount
+ *
+ * @tparam T the type of the Morton code to decode, as well as the tuple types of the result.
+ *         Must be an unsigned integer type (including '__uint128_t', if your compiler supports it).
+ * @tparam LutBits the number of bits for the LUT.
+ * @tparam Layout the bit layout of the code.
+ */
+template<typename T, std::size_t LutBits, typename Layout>
+class MortonNDLutLayoutDecoder
+{
+    static_assert(LutBits > 0, "'LutBits' must be > 0.");
+    static_assert(LutBits <= 16, "'LutBits' must be <= 16.");
+    static_assert(LutBits <= Layout::CodeBits(), "'LutBits' must be <= the number of bits in the layout's code.");
+
+    static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value, "'T' must be an unsigned integer type.");
+    static_assert(Layout::CodeBits() <= std::size_t(std::numeric_limits<T>::digits),
+        "The layout's code must fit in 'T'.");
+
+public:
+    static constexpr std::size_t Dimensions = Layout::Dimensions;
+
+    /**
+     * The type used for the Morton code as well as the decoded fields.
+     */
+    typedef T type;
+
+    /**
+     * The number of chunks into which the input Morton code is partitioned,
+     * i.e. the number of LUT lookups performed when decoding.
+     *
+     * For debugging / perf tuning.
+     */
+    static constexpr std::size_t ChunkCount = (Layout::CodeBits() + LutBits - 1) / LutBits;
+
+    /**
+     * The type selected internally for LUT entry array values.
+     * I.e. Each LUT entry is of type std::array<LutValue, Dimensions>.
+     *
+     * For debugging / perf tuning.
+     */
+    using LutValue = MinInt<LutBits>;
+
+    /**
+     * Constexpr constructor.
+     *
+     * The resulting class literal instance holds the generated LUTs, and can be used at
+     * compile-time.
+     */
+    constexpr MortonNDLutLayoutDecoder() = default;
+
+    /**
+     * Decode a Morton code.
+     * @param input The Morton code.
+     * @return The decoded components of 'input' as an std::tuple.
+     */
+    constexpr auto Decode(T input) const
+    {
+        return DecodeInternal(input, std::make_index_sequence<ChunkCount>{});
+    }
+
+private:
+    static constexpr std::size_t LutSize = std::size_t(1) << LutBits;
+    static constexpr std::size_t ChunkMask = LutSize - 1;
+
+    // The first bit of field 'field' which lands in chunk 'chunk' (i.e. the insert offset of
+    // the chunk's bits of the field).
+    static constexpr std::size_t InsertOffset(std::size_t field, std::size_t chunk)
+    {
+        return Layout::BitsBelow(field, chunk * LutBits);
+    }
+
+    // True if chunks 'a' and 'b' have the same LUT, i.e. the same arrangement of fields.
+    static constexpr bool SameTable(std::size_t a, std::size_t b)
+    {
+        for (std::size_t field = 0; field < Dimensions; field++) {
+            const auto bits = InsertOffset(field, a + 1) - InsertOffset(field, a);
+            if (bits != InsertOffset(field, b + 1) - InsertOffset(field, b)) {
+                return false;
+            }
+
+            for (std::size_t bit = 0; bit < bits; bit++) {
+                if (Layout::Offset(field, InsertOffset(field, a) + bit) - a * LutBits
+                    != Layout::Offset(field, InsertOffset(field, b) + bit) - b * LutBits) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // The first chunk with the same LUT as chunk 'chunk' (the one its LUT is built from).
+    static constexpr std::size_t FirstWithTable(std::size_t chunk)
+    {
+        std::size_t first = 0;
+        while (!SameTable(first, chunk)) {
+            first++;
+        }
+
+        return first;
+    }
+
+    // The number of distinct LUTs used by the chunks before chunk 'chunk'.
+    static constexpr std::size_t TablesBefore(std::size_t chunk)
+    {
+        std::size_t tables = 0;
+        for (std::size_t other = 0; other < chunk; other++) {
+            tables += FirstWithTable(other) == other;
+        }
+
+        return tables;
+    }
+
+    // The first chunk using LUT 'table'.
+    static constexpr std::size_t TableChunk(std::size_t table)
+    {
+        std::size_t chunk = 0;
+        while (FirstWithTable(chunk) != chunk || TablesBefore(chunk) != table) {
+            chunk++;
+        }
+
+        return chunk;
+    }
+
+public:
+    /**
+     * The number of distinct LUTs.
+     *
+     * For debugging / perf tuning.
+     */
+    static constexpr std::size_t TableCount = TablesBefore(ChunkCount);
+
+private:
+    // Field 'Field' of entry 'input' of the LUT of chunk 'Chunk'.
+    template<std::size_t Chunk, std::size_t Field>
+    static constexpr LutValue BuildComponent(std::size_t input)
+    {
+        constexpr auto first = InsertOffset(Field, Chunk);
+        constexpr auto last = InsertOffset(Field, Chunk + 1);
+
+        LutValue value = 0;
+        for (std::size_t bit = first; bit < last; bit++) {
+            value |= LutValue((input >> (Layout::Offset(Field, bit) - Chunk * LutBits)) & 1U) << (bit - first);
+        }
+
+        return value;
+    }
+
+    template<std::size_t Chunk, std::size_t... f>
+    static constexpr auto BuildEntry(std::size_t input, std::index_sequence<f...>)
+    {
+        return std::array<LutValue, Dimensions>{{ BuildComponent<Chunk, f>(input)... }};
+    }
+
+    // The chunk the LUT 'Table' is built from (evaluated once per LUT, rather than per entry).
+    template<std::size_t Table>
+    using FirstChunk = std::integral_constant<std::size_t, TableChunk(Table)>;
+
+    template<std::size_t... i>
+    static constexpr auto BuildLut(std::index_sequence<i...>) noexcept
+    {
+        return std::array<std::array<LutValue, Dimensions>, sizeof...(i)>{{
+            BuildEntry<FirstChunk<i / LutSize>::value>(i % LutSize, std::make_index_sequence<Dimensions>{})... }};
+    }
+
+    // Offsets past the end of a field only occur for fields with no bits in the chunk (whose
+    // components are 0), and are clamped to keep shifts in range.
+    template<std::size_t Field, std::size_t Chunk>
+    using Insert = std::integral_constant<std::size_t,
+        (InsertOffset(Field, Chunk) < std::size_t(std::numeric_limits<T>::digits) ? InsertOffset(Field, Chunk) : 0)>;
+
+    template<std::size_t Chunk>
+    using Table = std::integral_constant<std::size_t, TablesBefore(FirstWithTable(Chunk)) * LutSize>;
+
+    template<std::size_t Chunk, std::size_t... f>
+    constexpr void DecodeChunk(T input, T (&fields)[Dimensions], std::index_sequence<f...>) const
+    {
+        const auto& entry = LookupTable[Table<Chunk>::value + std::size_t((input >> (Chunk * LutBits)) & ChunkMask)];
+
+        using expander = int[];
+        (void)expander{ 0, (void(fields[f] |= T(entry[f]) << Insert<f, Chunk>::value), 0)... };
+    }
+
+    template<std::size_t... f>
+    static constexpr auto CreateTuple(const T (&fields)[Dimensions], std::index_sequence<f...>)
+    {
+        return std::make_tuple(fields[f]...);
+    }
+
+    template<std::size_t... c>
+    constexpr auto DecodeInternal(T input, std::index_sequence<c...>) const
+    {
+        T fields[Dimensions] = {};
+
+        using expander = int[];
+        (void)expander{ 0, (DecodeChunk<c>(input, fields, std::make_index_sequence<Dimensions>{}), 0)... };
+
+        return CreateTuple(fields, std::make_index_sequence<Dimensions>{});
+    }
+
+    const std::array<std::array<LutValue, Dimensions>, TableCount * LutSize> LookupTable
+        = BuildLut(std::make_index_sequence<TableCount * LutSize>{});
+};
+
+/**
+ * A portable LUT-based Morton decoder for fields of different widths.
+ *
+ * Equivalent to 'MortonNDLutDecoder', except that each field has its own width (see
+ * 'MortonNDMixedLayout' for the layout).
+ *
+ * Example (x, y: 20 bits; z, t: 12 bits, in a 64-bit code):
+ *   constexpr auto MortonND_Dec = MortonNDLutMixedDecoder<uint64_t, 8, 20, 20, 12, 12>();
+ *   std::tie(x, y, z, t) = MortonND_Dec.Decode(encoding);
+ *
+ * @tparam T the type of the Morton code to decode, as well as the tuple types of the result.
+ * @tparam LutBits the number of bits for the LUT.
+ * @tparam FieldBits the number of bits in each field.
+ */
+template<typename T, std::size_t LutBits, std::size_t... FieldBits>
+using MortonNDLutMixedDecoder = MortonNDLutLayoutDecoder<T, LutBits, MortonNDMixedLayout<FieldBits...>>;
+
+}
+
+#endif
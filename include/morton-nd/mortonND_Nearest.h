@@ -0,0 +1,388 @@
+//
+//  mortonND_Nearest.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_NEAREST_H
+#define MORTON_ND_MORTONND_NEAREST_H
+
+#include "mortonND_LocCode.h"
+#include "mortonND_Magic.h"
+#include "mortonND_Range.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mortonnd {
+
+/**
+ * Exact k-nearest-neighbor queries over a sorted array of Morton codes.
+ *
+ * Each code is a point of the grid (from any engine), and distances are squared Euclidean
+ * distances between the decoded fields. The search starts at the query's position in the array
+ * (found by binary search), and scans outward in both directions, keeping the best 'k' points
+ * seen so far. Their worst distance bounds the rest of the search:
+ *
+ *   - The box around the query which contains every point within that distance bounds each scan:
+ *     codes above the box's maximum corner (or below its minimum) can't be in it.
+ *   - When a scan reaches a code outside of the box, it skips to the next code inside the box
+ *     (BIGMIN, or LITMAX when scanning down, see 'MortonNDRange'), by galloping search.
+ *   - When it reaches a code inside the box which is too far away, it skips the coarsest cell
+ *     containing the code (but not the query) whose decoded box is too far away.
+ *
+ * The scans stop when both have left the box, at which point no closer point exists. Results
+ * are ordered by distance, with ties broken by the smaller index.
+ *
+ * 'NearestBatch' answers many queries at once. The queries are processed in Morton order, so each
+ * starts from the previous query's position in the array (by galloping search), and the distance
+ * from the previous query's neighbors bounds the search before any point has been scanned.
+ *
+ * Configuration:
+ *
+ * Dimensions
+ *   The number of fields (components) in each code.
+ *
+ * T
+ *   The type of the Morton codes. Must be 'uint32_t', 'uint64_t' or '__uint128_t'.
+ *
+ * FieldBits
+ *   The number of bits in each field. Defaults to the most that fit in 'T'.
+ *
+ * @tparam Dimensions the number of fields (components) in each code.
+ * @tparam T the type of the Morton codes.
+ * @tparam FieldBits the number of bits in each field.
+ */
+template<std::size_t Dimensions, typename T, std::size_t FieldBits = std::size_t(std::numeric_limits<T>::digits) / Dimensions>
+class MortonNDNearest
+{
+    static_assert(FieldBits <= 63, "'FieldBits' must be <= 63.");
+    static_assert(2 * FieldBits + Log2Ceil(Dimensions) <= 128, "Squared distances must fit in 128 bits.");
+
+    using Magic = MortonNDMagic<Dimensions, T, FieldBits>;
+    using Range = MortonNDRange<Dimensions, T, FieldBits>;
+    using LocCode = MortonNDLocCode<Dimensions, T, false, FieldBits>;
+    using Fields = std::array<uint64_t, Dimensions>;
+
+    static constexpr uint64_t FieldMax = (uint64_t(1) << FieldBits) - 1;
+
+public:
+    /**
+     * The type of squared distances: 'uint64_t' if it can't overflow, otherwise '__uint128_t'.
+     */
+    using Distance = typename std::conditional<2 * FieldBits + Log2Ceil(Dimensions) <= 64, uint64_t, __uint128_t>::type;
+
+    /**
+     * Finds the 'k' codes in 'codes' nearest to 'query'.
+     *
+     * @param codes the codes, in ascending order.
+     * @param count the number of codes.
+     * @param query the code of the query point.
+     * @param k the number of neighbors to find.
+     * @param indices receives the index (in 'codes') of each neighbor, nearest first.
+     * @param distances if not null, receives the squared distance of each neighbor.
+     * @return the number of neighbors found ('min(k, count)').
+     */
+    static std::size_t Nearest(const T* codes, std::size_t count, T query, std::size_t k,
+        std::size_t* indices, Distance* distances = nullptr)
+    {
+        Search search(codes, count, query, k);
+        search.Scan(std::lower_bound(codes, codes + count, query));
+        return search.Results(indices, distances);
+    }
+
+    /**
+     * Finds the 'k' codes in 'codes' nearest to each of 'queryCount' queries.
+     *
+     * The neighbors of query 'q' are written to 'indices[q * k]' (and 'distances[q * k]'),
+     * as by 'Nearest'. If 'count' < 'k', the remaining entries are left unchanged.
+     *
+     * @param codes the codes, in ascending order.
+     * @param count the number of codes.
+     * @param queries the codes of the query points, in any order.
+     * @param queryCount the number of queries.
+     * @param k the number of neighbors to find per query.
+     * @param indices receives 'k' indices per query.
+     * @param distances if not null, receives 'k' squared distances per query.
+     */
+    static void NearestBatch(const T* codes, std::size_t count, const T* queries, std::size_t queryCount,
+        std::size_t k, std::size_t* indices, Distance* distances = nullptr)
+    {
+        std::vector<std::size_t> order(queryCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return queries[a] < queries[b]; });
+
+        const T* position = codes;
+        const std::size_t* previous = nullptr;
+        std::size_t found = 0;
+        for (const auto q : order) {
+            Search search(codes, count, queries[q], k);
+            position = GallopLower(position, codes + count, queries[q]);
+
+            // The previous query's neighbors are 'found' points, so the nearest 'found' are at
+            // least as close as the farthest of them.
+            if (previous != nullptr && found == k) {
+                Distance bound = 0;
+                for (std::size_t n = 0; n < found; n++) {
+                    bound = std::max(bound, search.DistanceTo(codes[previous[n]]));
+                }
+                search.Bound(bound);
+            }
+
+            search.Scan(position);
+            found = search.Results(indices + q * k, distances != nullptr ? distances + q * k : nullptr);
+            previous = indices + q * k;
+        }
+    }
+
+private:
+    MortonNDNearest() = default;
+
+    static Fields Decode(T code)
+    {
+        Fields fields;
+        for (std::size_t f = 0; f < Dimensions; f++) {
+            fields[f] = uint64_t(Magic::Compact(code >> f));
+        }
+
+        return fields;
+    }
+
+    static T Encode(const Fields& fields)
+    {
+        T code = 0;
+        for (std::size_t f = 0; f < Dimensions; f++) {
+            code |= Magic::Dilate(T(fields[f])) << f;
+        }
+
+        return code;
+    }
+
+    // The first position in '[first, last)' whose code is >= 'code', searching from 'first'.
+    static const T* GallopLower(const T* first, const T* last, T code)
+    {
+        const auto size = std::size_t(last - first);
+        std::size_t bound = 1;
+        while (bound < size && first[bound] < code) {
+            bound *= 2;
+        }
+
+        return std::lower_bound(first + bound / 2, first + std::min(bound + 1, size), code);
+    }
+
+    // The last position in '[first, last)' whose code is <= 'code', plus one, searching from 'last'.
+    static const T* GallopUpper(const T* first, const T* last, T code)
+    {
+        const auto size = std::size_t(last - first);
+        std::size_t bound = 1;
+        while (bound <= size && code < *(last - bound)) {
+            bound *= 2;
+        }
+
+        return std::upper_bound(last - std::min(bound, size), last - bound / 2, code);
+    }
+
+    // The state of one query: the best 'k' (distance, index) pairs so far, as a max-heap.
+    class Search
+    {
+    public:
+        Search(const T* codes, std::size_t count, T query, std::size_t k)
+            : codes(codes), count(count), k(std::min(k, count)), query(Decode(query))
+        {
+            heap.reserve(this->k);
+            UpdateBox();
+        }
+
+        Distance DistanceTo(T code) const
+        {
+            const auto fields = Decode(code);
+            Distance distance = 0;
+            for (std::size_t f = 0; f < Dimensions; f++) {
+                const auto diff = Distance(fields[f] > query[f] ? fields[f] - query[f] : query[f] - fields[f]);
+                distance += diff * diff;
+            }
+
+            return distance;
+        }
+
+        // Limits the search to points within 'distance' (which must be an upper bound of the
+        // distance of the 'k'th nearest point).
+        void Bound(Distance distance)
+        {
+            if (distance < limit) {
+                limit = distance;
+                UpdateBox();
+            }
+        }
+
+        // Scans outward from 'position', the first code >= the query.
+        void Scan(const T* position)
+        {
+            if (k == 0) {
+                return;
+            }
+
+            const T* up = position;
+            const T* down = position;
+            bool scanUp = up != codes + count;
+            bool scanDown = down != codes;
+
+            while (scanUp || scanDown) {
+                if (scanUp) {
+                    scanUp = StepUp(up);
+                }
+
+                if (scanDown) {
+                    scanDown = StepDown(down);
+                }
+            }
+        }
+
+        std::size_t Results(std::size_t* indices, Distance* distances)
+        {
+            std::sort_heap(heap.begin(), heap.end());
+            for (std::size_t n = 0; n < heap.size(); n++) {
+                indices[n] = heap[n].second;
+                if (distances != nullptr) {
+                    distances[n] = heap[n].first;
+                }
+            }
+
+            return heap.size();
+        }
+
+    private:
+        // Visits the code at 'up' (or skips past it). Returns false when the scan is complete.
+        bool StepUp(const T*& up)
+        {
+            const T code = *up;
+            if (code > boxMax) {
+                return false;
+            }
+
+            const auto distance = DistanceTo(code);
+            if (distance <= limit) {
+                Offer(distance, std::size_t(up - codes));
+                up++;
+            } else if (!Range::InBox(code, boxMin, boxMax)) {
+                up = GallopLower(up + 1, codes + count, Range::BigMin(code, boxMin, boxMax));
+            } else {
+                up = GallopUpper(up + 1, codes + count, FarCell(code).second);
+            }
+
+            return up != codes + count;
+        }
+
+        // Visits the code before 'down' (or skips past it). Returns false when the scan is complete.
+        bool StepDown(const T*& down)
+        {
+            const T code = down[-1];
+            if (code < boxMin) {
+                return false;
+            }
+
+            const auto distance = DistanceTo(code);
+            if (distance <= limit) {
+                Offer(distance, std::size_t(down - 1 - codes));
+                down--;
+            } else if (!Range::InBox(code, boxMin, boxMax)) {
+                down = GallopUpper(codes, down - 1, Range::LitMax(code, boxMin, boxMax));
+            } else {
+                down = GallopLower(codes, down - 1, FarCell(code).first);
+            }
+
+            return down != codes;
+        }
+
+        void Offer(Distance distance, std::size_t index)
+        {
+            const std::pair<Distance, std::size_t> entry(distance, index);
+            if (heap.size() < k) {
+                heap.push_back(entry);
+                std::push_heap(heap.begin(), heap.end());
+            } else if (entry < heap.front()) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = entry;
+                std::push_heap(heap.begin(), heap.end());
+            } else {
+                return;
+            }
+
+            if (heap.size() == k) {
+                Bound(heap.front().first);
+            }
+        }
+
+        // The box of points within 'limit' of the query, as the codes of its corners.
+        void UpdateBox()
+        {
+            // 'sqrt' may round down (for wide distances), so the radius is corrected upwards.
+            const auto root = std::sqrt(double(limit));
+            auto radius = root < double(FieldMax) ? uint64_t(root) : FieldMax;
+            while (radius < FieldMax && __uint128_t(radius + 1) * (radius + 1) <= limit) {
+                radius++;
+            }
+
+            Fields lo, hi;
+            for (std::size_t f = 0; f < Dimensions; f++) {
+                lo[f] = query[f] > radius ? query[f] - radius : 0;
+                hi[f] = FieldMax - query[f] > radius ? query[f] + radius : FieldMax;
+            }
+
+            boxMin = Encode(lo);
+            boxMax = Encode(hi);
+        }
+
+        // The code range of the coarsest cell containing 'code' (but not the query) whose box is
+        // farther than 'limit' from the query. 'code' itself is farther than 'limit'.
+        std::pair<T, T> FarCell(T code) const
+        {
+            const auto queryCell = LocCode::FromPoint(Encode(query), LocCode::MaxLevel);
+            auto level = LocCode::Level(LocCode::CommonAncestor(LocCode::FromPoint(code, LocCode::MaxLevel), queryCell)) + 1;
+            for (; level < LocCode::MaxLevel; level++) {
+                if (CellDistance(code, level) > limit) {
+                    break;
+                }
+            }
+
+            return LocCode::DescendantRange(LocCode::FromPoint(code, level));
+        }
+
+        // The distance from the query to the nearest point of the cell at 'level' containing 'code'.
+        Distance CellDistance(T code, std::size_t level) const
+        {
+            const auto range = LocCode::DescendantRange(LocCode::FromPoint(code, level));
+            const auto lo = Decode(range.first);
+            const auto hi = Decode(range.second);
+
+            Distance distance = 0;
+            for (std::size_t f = 0; f < Dimensions; f++) {
+                const auto diff = Distance(query[f] < lo[f] ? lo[f] - query[f] : query[f] > hi[f] ? query[f] - hi[f] : 0);
+                distance += diff * diff;
+            }
+
+            return distance;
+        }
+
+        const T* codes;
+        std::size_t count;
+        std::size_t k;
+        Fields query;
+        Distance limit = std::numeric_limits<Distance>::max();
+        T boxMin = 0;
+        T boxMax = 0;
+        std::vector<std::pair<Distance, std::size_t>> heap;
+    };
+};
+
+}
+
+#endif //MORTON_ND_MORTONND_NEAREST_H
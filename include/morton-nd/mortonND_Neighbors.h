@@ -0,0 +1,353 @@
+//
+//  mortonND_Neighbors.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_NEIGHBORS_H
+#define MORTON_ND_MORTONND_NEIGHBORS_H
+
+#include "mortonND_Magic.h"
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#define MORTON_ND_NEIGHBORS_AVX2_ENABLED 1
+#include <immintrin.h>
+#endif
+
+namespace mortonnd {
+
+/**
+ * How neighbors which fall outside of the grid are handled.
+ */
+enum class MortonNDBoundary
+{
+    /**
+     * Coordinates wrap around (i.e. the grid is periodic).
+     */
+    Wrap,
+
+    /**
+     * Neighbors outside of the grid are replaced with a fill value.
+     */
+    Fill
+};
+
+/**
+ * Batched neighbor generation for Morton codes, without decoding.
+ *
+ * Each neighbor is computed with the same dilated arithmetic as 'MortonNDArithmetic': for each
+ * dimension, the field is masked out of the code with its selector, and incremented
+ * ('((field | ~selector) + 1) & selector') or decremented ('(field - 1) & selector') in place.
+ * Cells on the edge of the grid are detected by comparing the field against 0 or its selector.
+ * Since the selectors match the layout of every engine ('MortonNDBmi', 'MortonNDLutEncoder',
+ * 'MortonNDMagic'), codes from any of them can be used.
+ *
+ * Neighbors are written one array per neighbor (SoA): neighbor 'k' of code 'i' is written to
+ * 'neighbors[k * count + i]'.
+ *
+ * When compiled for AVX2 (and 'T' is a 64-bit integer), 4 codes are processed per iteration.
+ * The static member 'VectorBatch' reports which path is used.
+ *
+ * Configuration:
+ *
+ * Dimensions
+ *   The number of fields (components) in each code.
+ *
+ * T
+ *   The type of the Morton codes. Must be an unsigned integer type.
+ *
+ * FieldBits
+ *   The number of bits in each field. Defaults to the most that fit in 'T'.
+ *
+ * @tparam Dimensions the number of fields (components) in each code.
+ * @tparam T the type of the Morton codes.
+ * @tparam FieldBits the number of bits in each field.
+ */
+template<std::size_t Dimensions, typename T, std::size_t FieldBits = std::size_t(std::numeric_limits<T>::digits) / Dimensions>
+class MortonNDNeighbors
+{
+    using Magic = MortonNDMagic<Dimensions, T, FieldBits>;
+
+    static constexpr std::size_t Pow3(std::size_t exp)
+    {
+        return exp == 0 ? 1 : 3 * Pow3(exp - 1);
+    }
+
+public:
+    /**
+     * The number of face neighbors of each cell (2 * 'Dimensions').
+     */
+    static constexpr std::size_t FaceCount = 2 * Dimensions;
+
+    /**
+     * The number of face, edge and corner neighbors of each cell (3^'Dimensions' - 1).
+     */
+    static constexpr std::size_t AllCount = Pow3(Dimensions) - 1;
+
+    /**
+     * True if the AVX2 kernel is used for this configuration.
+     *
+     * For debugging / perf tuning.
+     */
+#if MORTON_ND_NEIGHBORS_AVX2_ENABLED
+    static constexpr bool VectorBatch = std::is_integral<T>::value && std::numeric_limits<T>::digits == 64;
+#else
+    static constexpr bool VectorBatch = false;
+#endif
+
+    /**
+     * Returns the offset (-1, 0 or 1) of face neighbor 'neighbor' in dimension 'dimension'.
+     *
+     * Face neighbor '2 * d' is the cell before the cell in dimension 'd', and '2 * d + 1' is the
+     * cell after it.
+     */
+    static constexpr int FaceOffset(std::size_t neighbor, std::size_t dimension)
+    {
+        return neighbor / 2 != dimension ? 0 : neighbor % 2 == 0 ? -1 : 1;
+    }
+
+    /**
+     * Returns the offset (-1, 0 or 1) of neighbor 'neighbor' (of 'AllNeighbors') in dimension
+     * 'dimension'.
+     *
+     * Neighbors are ordered by their offsets as base-3 numbers (-1 => 0, 0 => 1, 1 => 2), where
+     * dimension 0 is the least-significant digit. The cell itself (all offsets 0) is skipped.
+     */
+    static constexpr int AllOffset(std::size_t neighbor, std::size_t dimension)
+    {
+        return int((neighbor < Center ? neighbor : neighbor + 1) / Pow3(dimension) % 3) - 1;
+    }
+
+    /**
+     * Computes the 'FaceCount' face neighbors of each of 'count' codes.
+     *
+     * @param codes the codes of the cells.
+     * @param count the number of codes.
+     * @param neighbors destination for 'FaceCount' * 'count' codes. Face neighbor 'k' of code 'i'
+     *                  is written to 'neighbors[k * count + i]'. Must not alias 'codes'.
+     * @param boundary how neighbors outside of the grid are handled.
+     * @param fill the code written for neighbors outside of the grid, if 'boundary' is 'Fill'.
+     */
+    static void FaceNeighbors(const T* codes, std::size_t count, T* neighbors,
+        MortonNDBoundary boundary = MortonNDBoundary::Wrap, T fill = ~T(0))
+    {
+        if (boundary == MortonNDBoundary::Fill) {
+            Neighbors(codes, count, neighbors, fill, FaceKernel<true>{});
+        } else {
+            Neighbors(codes, count, neighbors, fill, FaceKernel<false>{});
+        }
+    }
+
+    /**
+     * Computes the 'AllCount' face, edge and corner neighbors of each of 'count' codes.
+     *
+     * @param codes the codes of the cells.
+     * @param count the number of codes.
+     * @param neighbors destination for 'AllCount' * 'count' codes. Neighbor 'k' (see 'AllOffset')
+     *                  of code 'i' is written to 'neighbors[k * count + i]'. Must not alias 'codes'.
+     * @param boundary how neighbors outside of the grid are handled.
+     * @param fill the code written for neighbors outside of the grid, if 'boundary' is 'Fill'.
+     */
+    static void AllNeighbors(const T* codes, std::size_t count, T* neighbors,
+        MortonNDBoundary boundary = MortonNDBoundary::Wrap, T fill = ~T(0))
+    {
+        if (boundary == MortonNDBoundary::Fill) {
+            Neighbors(codes, count, neighbors, fill, AllKernel<true>{});
+        } else {
+            Neighbors(codes, count, neighbors, fill, AllKernel<false>{});
+        }
+    }
+
+private:
+    MortonNDNeighbors() = default;
+
+    // The index of the cell itself in the base-3 ordering of 'AllOffset'.
+    static constexpr std::size_t Center = (Pow3(Dimensions) - 1) / 2;
+
+    struct ScalarOps
+    {
+        using V = T;
+        static constexpr std::size_t Lanes = 1;
+
+        static V Load(const T* p) { return *p; }
+        static void Store(T* p, V value) { *p = value; }
+        static V Set1(T value) { return value; }
+        static V And(V a, V b) { return a & b; }
+        static V Or(V a, V b) { return a | b; }
+        static V AndNot(V a, V b) { return ~a & b; }
+        static V Add(V a, V b) { return a + b; }
+        static V Sub(V a, V b) { return a - b; }
+        static V Equal(V a, V b) { return T(0) - T(a == b); }
+        static V Select(V mask, V a, V b) { return (a & mask) | (b & ~mask); }
+    };
+
+#if MORTON_ND_NEIGHBORS_AVX2_ENABLED
+    struct VectorOps
+    {
+        using V = __m256i;
+        static constexpr std::size_t Lanes = 4;
+
+        static V Load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        static void Store(T* p, V value) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), value); }
+        static V Set1(T value) { return _mm256_set1_epi64x(static_cast<long long>(value)); }
+        static V And(V a, V b) { return _mm256_and_si256(a, b); }
+        static V Or(V a, V b) { return _mm256_or_si256(a, b); }
+        static V AndNot(V a, V b) { return _mm256_andnot_si256(a, b); }
+        static V Add(V a, V b) { return _mm256_add_epi64(a, b); }
+        static V Sub(V a, V b) { return _mm256_sub_epi64(a, b); }
+        static V Equal(V a, V b) { return _mm256_cmpeq_epi64(a, b); }
+        static V Select(V mask, V a, V b) { return _mm256_blendv_epi8(b, a, mask); }
+    };
+#endif
+
+    // The field of each dimension of a cell, decremented and incremented, along with masks of
+    // the lanes in which each would leave the grid.
+    template<typename Ops>
+    struct Fields
+    {
+        using V = typename Ops::V;
+
+        V field[Dimensions];
+        V minus[Dimensions];
+        V plus[Dimensions];
+        V lowEdge[Dimensions];
+        V highEdge[Dimensions];
+
+        explicit Fields(V code)
+        {
+            for (std::size_t d = 0; d < Dimensions; d++) {
+                const V selector = Ops::Set1(Magic::Selector(d));
+                const V one = Ops::Set1(T(1) << d);
+
+                field[d] = Ops::And(code, selector);
+                minus[d] = Ops::And(Ops::Sub(field[d], one), selector);
+                plus[d] = Ops::And(Ops::Add(Ops::Or(code, Ops::Set1(~Magic::Selector(d))), one), selector);
+                lowEdge[d] = Ops::Equal(field[d], Ops::Set1(0));
+                highEdge[d] = Ops::Equal(field[d], selector);
+            }
+        }
+    };
+
+    template<bool Fill>
+    struct FaceKernel
+    {
+        template<typename Ops>
+        void operator()(Ops, typename Ops::V code, T* out, std::size_t count, typename Ops::V fill) const
+        {
+            const Fields<Ops> fields(code);
+            for (std::size_t d = 0; d < Dimensions; d++) {
+                const auto rest = Ops::AndNot(Ops::Set1(Magic::Selector(d)), code);
+                auto before = Ops::Or(rest, fields.minus[d]);
+                auto after = Ops::Or(rest, fields.plus[d]);
+                if (Fill) {
+                    before = Ops::Select(fields.lowEdge[d], fill, before);
+                    after = Ops::Select(fields.highEdge[d], fill, after);
+                }
+
+                Ops::Store(out + (2 * d) * count, before);
+                Ops::Store(out + (2 * d + 1) * count, after);
+            }
+        }
+    };
+
+    template<bool Fill>
+    struct AllKernel
+    {
+        template<typename Ops>
+        void operator()(Ops, typename Ops::V code, T* out, std::size_t count, typename Ops::V fill) const
+        {
+            const Fields<Ops> fields(code);
+            Emit<Ops>(fields, out, count, fill, Ops::Set1(0), Ops::Set1(0), 0, std::integral_constant<std::size_t, Dimensions>{});
+        }
+
+        // Chooses the offset of dimension 'Remaining' - 1, from the most-significant dimension down.
+        template<typename Ops, std::size_t Remaining>
+        static void Emit(const Fields<Ops>& fields, T* out, std::size_t count, typename Ops::V fill,
+            typename Ops::V partial, typename Ops::V outside, std::size_t index, std::integral_constant<std::size_t, Remaining>)
+        {
+            constexpr auto d = Remaining - 1;
+            using Next = std::integral_constant<std::size_t, d>;
+
+            Emit<Ops>(fields, out, count, fill, Ops::Or(partial, fields.minus[d]), Ops::Or(outside, fields.lowEdge[d]), index * 3, Next{});
+            Emit<Ops>(fields, out, count, fill, Ops::Or(partial, fields.field[d]), outside, index * 3 + 1, Next{});
+            Emit<Ops>(fields, out, count, fill, Ops::Or(partial, fields.plus[d]), Ops::Or(outside, fields.highEdge[d]), index * 3 + 2, Next{});
+        }
+
+        template<typename Ops>
+        static void Emit(const Fields<Ops>&, T* out, std::size_t count, typename Ops::V fill,
+            typename Ops::V neighbor, typename Ops::V outside, std::size_t index, std::integral_constant<std::size_t, 0>)
+        {
+            if (index == Center) {
+                return;
+            }
+
+            const auto k = index < Center ? index : index - 1;
+            Ops::Store(out + k * count, Fill ? Ops::Select(outside, fill, neighbor) : neighbor);
+        }
+    };
+
+    template<typename Kernel>
+    static void Neighbors(const T* codes, std::size_t count, T* neighbors, T fill, Kernel kernel)
+    {
+#if MORTON_ND_NEIGHBORS_AVX2_ENABLED
+        const auto vectorCount = NeighborsVector(codes, count, neighbors, fill, kernel, std::integral_constant<bool, VectorBatch>{});
+#else
+        const std::size_t vectorCount = 0;
+#endif
+
+        for (auto i = vectorCount; i < count; i++) {
+            kernel(ScalarOps{}, ScalarOps::Load(codes + i), neighbors + i, count, ScalarOps::Set1(fill));
+        }
+    }
+
+#if MORTON_ND_NEIGHBORS_AVX2_ENABLED
+    // Returns the number of codes processed.
+    template<typename Kernel>
+    static std::size_t NeighborsVector(const T*, std::size_t, T*, T, Kernel, std::false_type)
+    {
+        return 0;
+    }
+
+    template<typename Kernel>
+    static std::size_t NeighborsVector(const T* codes, std::size_t count, T* neighbors, T fill, Kernel kernel, std::true_type)
+    {
+        const auto fillVector = VectorOps::Set1(fill);
+        const auto vectorCount = count - count % VectorOps::Lanes;
+        for (std::size_t i = 0; i < vectorCount; i += VectorOps::Lanes) {
+            kernel(VectorOps{}, VectorOps::Load(codes + i), neighbors + i, count, fillVector);
+        }
+
+        return vectorCount;
+    }
+#endif
+};
+
+/**
+ * Type alias for neighbors of 2D 64-bit codes.
+ */
+using MortonNDNeighbors_2D_64 = MortonNDNeighbors<2, uint64_t>;
+
+/**
+ * Type alias for neighbors of 3D 32-bit codes.
+ */
+using MortonNDNeighbors_3D_32 = MortonNDNeighbors<3, uint32_t>;
+
+/**
+ * Type alias for neighbors of 3D 64-bit codes.
+ */
+using MortonNDNeighbors_3D_64 = MortonNDNeighbors<3, uint64_t>;
+
+/**
+ * Type alias for neighbors of 4D 64-bit codes.
+ */
+using MortonNDNeighbors_4D_64 = MortonNDNeighbors<4, uint64_t>;
+
+}
+
+#endif
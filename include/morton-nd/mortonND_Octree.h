@@ -0,0 +1,412 @@
+//
+//  mortonND_Octree.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_OCTREE_H
+#define MORTON_ND_MORTONND_OCTREE_H
+
+#include "mortonND_LocCode.h"
+#include "mortonND_Magic.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace mortonnd {
+
+/**
+ * A node of a 'MortonNDOctree'.
+ *
+ * The node's cell is the set of codes which share its top 'level * Dimensions' bits, which are
+ * 'prefix' (with the bits below them cleared). Its points are the sorted codes
+ * '[first, first + count)'.
+ *
+ * Only non-empty children are stored. They're contiguous, in Z-order, starting at 'firstChild':
+ * the child in octant 'o' (bit 'i' of which is the offset along field 'i') is stored at
+ * 'firstChild + popcount(childMask & ((1 << o) - 1))', if bit 'o' of 'childMask' is set.
+ * Leaves have a 'childMask' of 0.
+ */
+template<typename T>
+struct MortonNDOctreeNode
+{
+    T prefix;
+    uint32_t first;
+    uint32_t count;
+    uint32_t parent;
+    uint32_t firstChild;
+    uint32_t childMask;
+    uint32_t level;
+};
+
+/**
+ * A linear (pointerless) quadtree / octree / 2^N-tree, built from sorted Morton codes.
+ *
+ * The codes can come from any engine, since all engines produce the same layout. The tree is
+ * built breadth-first, a level at a time. Each level is split across threads in two passes:
+ *
+ *   1. For each node, the boundaries of its children are found by binary search (the codes of
+ *      each child are contiguous), giving its child mask.
+ *   2. An exclusive prefix sum over the number of children of each node (per-thread sums, then
+ *      a scan of those) gives each node the index of its first child, and the children are
+ *      written.
+ *
+ * A node is split while it has more than 'maxLeafPoints' points, down to 'FieldBits' levels
+ * (cells of a single code). Only non-empty children are created, so the tree stays sparse.
+ *
+ * Point location ('Locate') descends from the root, or from a hint node: the level of the
+ * deepest cell containing both the code and the hint is found from the highest set bit ('clz')
+ * of their XOR, and the search climbs only to that ancestor. Queries made in Morton order, with
+ * the previous result as the hint, only revisit the part of the path that differs.
+ *
+ * 'Balance' refines the tree until it is 2:1 balanced: leaves with points which share a face
+ * differ by at most one level. Empty space isn't refined.
+ *
+ * Node indices are 32-bit, so at most 2^32 - 1 points are supported.
+ *
+ * Configuration:
+ *
+ * Dimensions
+ *   The number of fields (components) in each code. Must be <= 5, so that the child mask fits
+ *   in 32 bits.
+ *
+ * T
+ *   The type of the Morton codes. Must be 'uint32_t', 'uint64_t' or '__uint128_t'.
+ *
+ * FieldBits
+ *   The number of bits in each field, i.e. the deepest level. Defaults to the most that fit in 'T'.
+ *
+ * @tparam Dimensions the number of fields (components) in each code.
+ * @tparam T the type of the Morton codes.
+ * @tparam FieldBits the number of bits in each field.
+ */
+template<std::size_t Dimensions, typename T, std::size_t FieldBits = std::size_t(std::numeric_limits<T>::digits) / Dimensions>
+class MortonNDOctree
+{
+    static_assert(Dimensions > 0 && Dimensions <= 5, "'Dimensions' must be > 0 and <= 5.");
+    static_assert(FieldBits > 0, "'FieldBits' must be > 0.");
+    static_assert(std::size_t(std::numeric_limits<T>::digits) >= Dimensions * FieldBits,
+        "'T' must be able to hold 'Dimensions' * 'FieldBits' bits.");
+
+    using Magic = MortonNDMagic<Dimensions, T, FieldBits>;
+    using LocCode = MortonNDLocCode<Dimensions, T, false, FieldBits>;
+
+public:
+    using Node = MortonNDOctreeNode<T>;
+
+    /**
+     * The number of children of a node (2^'Dimensions').
+     */
+    static constexpr std::size_t Children = std::size_t(1) << Dimensions;
+
+    /**
+     * The deepest level (cells of a single code). The root is level 0.
+     */
+    static constexpr std::size_t MaxLevel = FieldBits;
+
+    /**
+     * The fewest nodes expanded per thread, per level. Smaller levels use fewer threads.
+     */
+    static constexpr std::size_t MinPerThread = 4096;
+
+    /**
+     * Returns the prefix of the cell at 'level' which contains 'code'.
+     */
+    static constexpr T Prefix(T code, std::size_t level)
+    {
+        return LocCode::FromPoint(code, level).prefix;
+    }
+
+    /**
+     * Returns the octant of the cell at 'level' (> 0) containing 'code', within its parent.
+     */
+    static constexpr std::size_t Octant(T code, std::size_t level)
+    {
+        return LocCode::ChildIndex(LocCode::FromPoint(code, level));
+    }
+
+    /**
+     * Returns the level of the deepest cell which contains both 'a' and 'b'.
+     */
+    static constexpr std::size_t CommonLevel(T a, T b)
+    {
+        return LocCode::CommonAncestor(LocCode::FromPoint(a, MaxLevel), LocCode::FromPoint(b, MaxLevel)).level;
+    }
+
+    /**
+     * Builds the tree of 'count' sorted codes.
+     *
+     * @param codes the codes, in ascending order. Bits above 'Dimensions * FieldBits' must be 0.
+     * @param count the number of codes.
+     * @param maxLeafPoints the most points in a leaf, above its deepest level.
+     * @param threads the number of threads to use. 0 selects 'std::thread::hardware_concurrency()'.
+     */
+    MortonNDOctree(const T* codes, std::size_t count, std::size_t maxLeafPoints = 1, std::size_t threads = 0)
+    {
+        if (count > std::numeric_limits<uint32_t>::max()) {
+            throw std::invalid_argument("MortonNDOctree supports at most 2^32 - 1 points.");
+        }
+
+        nodes.push_back(Node{ T(0), 0, uint32_t(count), 0, 0, 0, 0 });
+
+        for (std::size_t levelBegin = 0, levelEnd = 1; levelBegin < levelEnd;) {
+            Expand(codes, levelEnd - levelBegin, [&](std::size_t k) { return levelBegin + k; }, [&](const Node& node) {
+                return node.count > maxLeafPoints && node.level < FieldBits;
+            }, threads);
+
+            levelBegin = levelEnd;
+            levelEnd = nodes.size();
+        }
+    }
+
+    /**
+     * Refines the tree until leaves with points which share a face differ by at most one level.
+     *
+     * Each round, every leaf which might be unbalanced finds the node containing each of its
+     * face neighbors (of the same size) with 'Locate', and marks it if it's a leaf more than one
+     * level coarser. The marked leaves are then split (in parallel, as in construction). Only
+     * the new leaves, and the leaves which marked a split, are checked in the next round.
+     *
+     * @param codes the codes the tree was built from.
+     * @param threads the number of threads to use. 0 selects 'std::thread::hardware_concurrency()'.
+     */
+    void Balance(const T* codes, std::size_t threads = 0)
+    {
+        std::vector<uint32_t> check;
+        for (std::size_t i = 0; i < nodes.size(); i++) {
+            if (nodes[i].childMask == 0 && nodes[i].level >= 2) {
+                check.push_back(uint32_t(i));
+            }
+        }
+
+        while (!check.empty()) {
+            const auto checkThreads = ThreadCount(check.size(), threads);
+            std::vector<std::vector<uint32_t>> splits(checkThreads), marked(checkThreads);
+
+            Parallel(checkThreads, [&](std::size_t t) {
+                const auto last = check.size() * (t + 1) / checkThreads;
+                for (auto k = check.size() * t / checkThreads; k < last; k++) {
+                    if (MarkUnbalanced(check[k], splits[t])) {
+                        marked[t].push_back(check[k]);
+                    }
+                }
+            });
+
+            auto split = Merge(splits);
+            if (split.empty()) {
+                break;
+            }
+
+            const auto firstNew = nodes.size();
+            Expand(codes, split.size(), [&](std::size_t k) { return split[k]; }, [](const Node&) { return true; }, threads);
+
+            check = Merge(marked);
+            for (auto i = firstNew; i < nodes.size(); i++) {
+                check.push_back(uint32_t(i));
+            }
+        }
+    }
+
+    /**
+     * Returns the index of the deepest node whose cell contains 'code'.
+     *
+     * The search starts from node 'hint', climbing only as far as the deepest ancestor of
+     * 'hint' which contains 'code'.
+     */
+    std::size_t Locate(T code, std::size_t hint = 0) const
+    {
+        const auto level = CommonLevel(code, nodes[hint].prefix);
+
+        auto i = hint;
+        while (nodes[i].level > level) {
+            i = nodes[i].parent;
+        }
+
+        while (nodes[i].level < FieldBits) {
+            const auto& node = nodes[i];
+            const auto octant = Octant(code, node.level + 1);
+            if ((node.childMask >> octant & 1) == 0) {
+                break;
+            }
+
+            i = node.firstChild + std::size_t(__builtin_popcount(node.childMask & ((uint32_t(1) << octant) - 1)));
+        }
+
+        return i;
+    }
+
+    /**
+     * Returns the nodes. The root is node 0, and nodes are ordered by level (breadth-first)
+     * until 'Balance' is called.
+     */
+    const std::vector<Node>& Nodes() const
+    {
+        return nodes;
+    }
+
+    const Node& operator[](std::size_t i) const
+    {
+        return nodes[i];
+    }
+
+    std::size_t size() const
+    {
+        return nodes.size();
+    }
+
+private:
+    static std::size_t ThreadCount(std::size_t count, std::size_t threads)
+    {
+        if (threads == 0) {
+            threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        return std::max<std::size_t>(1, std::min(threads, count / MinPerThread));
+    }
+
+    // Runs 'func(t)' for each 't' in [0, threads), on 'threads' threads (including this one).
+    template<typename F>
+    static void Parallel(std::size_t threads, F func)
+    {
+        std::vector<std::thread> workers;
+        for (std::size_t t = 1; t < threads; t++) {
+            workers.emplace_back(func, t);
+        }
+
+        func(0);
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // Calls 'func(octant, first, last)' for each non-empty child of 'node'.
+    template<typename F>
+    static void ForEachChild(const T* codes, const Node& node, F func)
+    {
+        const auto level = node.level + 1;
+        const auto shift = Dimensions * (FieldBits - level);
+        const auto end = codes + node.first + node.count;
+
+        for (auto first = codes + node.first; first != end;) {
+            const auto octant = Octant(*first, level);
+            const auto last = octant == Children - 1 ? end :
+                std::lower_bound(first, end, node.prefix | (T(octant + 1) << shift));
+
+            func(octant, uint32_t(first - codes), uint32_t(last - first));
+            first = last;
+        }
+    }
+
+    // Splits node 'index(k)' for each 'k' in [0, count) for which 'split(node)' is true, appending
+    // its children.
+    template<typename Index, typename Split>
+    void Expand(const T* codes, std::size_t count, Index index, Split split, std::size_t threads)
+    {
+        threads = ThreadCount(count, threads);
+
+        // Pass 1: child masks, and the number of children of each thread's chunk.
+        std::vector<std::size_t> offsets(threads + 1);
+        Parallel(threads, [&](std::size_t t) {
+            std::size_t children = 0;
+            const auto last = count * (t + 1) / threads;
+            for (auto k = count * t / threads; k < last; k++) {
+                auto& node = nodes[index(k)];
+                if (split(node)) {
+                    ForEachChild(codes, node, [&](std::size_t octant, uint32_t, uint32_t) {
+                        node.childMask |= uint32_t(1) << octant;
+                    });
+                    children += std::size_t(__builtin_popcount(node.childMask));
+                }
+            }
+
+            offsets[t + 1] = children;
+        });
+
+        offsets[0] = nodes.size();
+        for (std::size_t t = 0; t < threads; t++) {
+            offsets[t + 1] += offsets[t];
+        }
+
+        if (offsets[threads] > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("MortonNDOctree supports at most 2^32 - 1 nodes.");
+        }
+
+        nodes.resize(offsets[threads]);
+
+        // Pass 2: each thread continues the scan within its chunk, and writes the children.
+        Parallel(threads, [&](std::size_t t) {
+            auto next = offsets[t];
+            const auto last = count * (t + 1) / threads;
+            for (auto k = count * t / threads; k < last; k++) {
+                const auto parent = index(k);
+                auto& node = nodes[parent];
+                if (node.childMask == 0) {
+                    continue;
+                }
+
+                node.firstChild = uint32_t(next);
+                const auto shift = Dimensions * (FieldBits - node.level - 1);
+                ForEachChild(codes, node, [&](std::size_t octant, uint32_t first, uint32_t n) {
+                    nodes[next++] = Node{ node.prefix | (T(octant) << shift), first, n, uint32_t(parent), 0, 0, node.level + 1 };
+                });
+            }
+        });
+    }
+
+    // Appends to 'splits' each leaf with points which shares a face with leaf 'i', and is more
+    // than one level coarser. Returns true if any was found.
+    bool MarkUnbalanced(uint32_t i, std::vector<uint32_t>& splits) const
+    {
+        const auto& leaf = nodes[i];
+        if (leaf.childMask != 0) {
+            return false;
+        }
+
+        bool found = false;
+        const T step = T(1) << (Dimensions * (FieldBits - leaf.level));
+        for (std::size_t field = 0; field < Dimensions; field++) {
+            const T selector = Magic::Selector(field);
+            const T cell = leaf.prefix & selector;
+            const T rest = leaf.prefix & ~selector;
+            const T dilated = step << field;
+
+            // The same-size cells on either side along 'field', unless they're outside the grid.
+            const T up = ((cell | ~selector) + dilated) & selector;
+            const T down = (cell - dilated) & selector;
+            for (const auto neighbor : { up > cell ? rest | up : leaf.prefix, cell != 0 ? rest | down : leaf.prefix }) {
+                const auto j = Locate(neighbor, i);
+                if (nodes[j].childMask == 0 && nodes[j].level + 1 < leaf.level) {
+                    splits.push_back(uint32_t(j));
+                    found = true;
+                }
+            }
+        }
+
+        return found;
+    }
+
+    // Concatenates 'lists', sorted and without duplicates.
+    static std::vector<uint32_t> Merge(const std::vector<std::vector<uint32_t>>& lists)
+    {
+        std::vector<uint32_t> merged;
+        for (const auto& list : lists) {
+            merged.insert(merged.end(), list.begin(), list.end());
+        }
+
+        std::sort(merged.begin(), merged.end());
+        merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+        return merged;
+    }
+
+    std::vector<Node> nodes;
+};
+
+}
+
+#endif //MORTON_ND_MORTONND_OCTREE_H
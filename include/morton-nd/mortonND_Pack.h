@@ -0,0 +1,518 @@
+//
+//  mortonND_Pack.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_PACK_H
+#define MORTON_ND_MORTONND_PACK_H
+
+#include "mortonND_Auto.h"
+#include "mortonND_Magic.h"
+#include "mortonND_Mixed.h"
+#include "mortonND_Static.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#define MORTON_ND_PACK_AVX2_ENABLED 1
+#include <immintrin.h>
+#endif
+
+namespace mortonnd {
+
+/**
+ * The code type ('type') and number of significant code bits ('Bits') of a Morton engine.
+ *
+ * Example:
+ *   MortonNDCodeTraits<MortonNDLutEncoder<3, 21, 8>>::Bits == 63
+ */
+template<typename Engine>
+struct MortonNDCodeTraits;
+
+template<std::size_t Dimensions, std::size_t FieldBits, std::size_t LutBits, typename T>
+struct MortonNDCodeTraits<MortonNDLutEncoder<Dimensions, FieldBits, LutBits, T>>
+{
+    using type = T;
+    static constexpr std::size_t Bits = Dimensions * FieldBits;
+};
+
+template<std::size_t Dimensions, std::size_t FieldBits, std::size_t LutBits, typename T>
+struct MortonNDCodeTraits<MortonNDLutDecoder<Dimensions, FieldBits, LutBits, T>>
+{
+    using type = T;
+    static constexpr std::size_t Bits = Dimensions * FieldBits;
+};
+
+template<std::size_t Dimensions, typename T, std::size_t FieldBits>
+struct MortonNDCodeTraits<MortonNDMagic<Dimensions, T, FieldBits>>
+{
+    using type = T;
+    static constexpr std::size_t Bits = Dimensions * FieldBits;
+};
+
+template<std::size_t Dimensions, std::size_t FieldBits>
+struct MortonNDCodeTraits<MortonNDAuto<Dimensions, FieldBits>>
+{
+    using type = typename MortonNDAuto<Dimensions, FieldBits>::T;
+    static constexpr std::size_t Bits = Dimensions * FieldBits;
+};
+
+template<typename T, std::size_t LutBits, typename Layout>
+struct MortonNDCodeTraits<MortonNDLutLayoutEncoder<T, LutBits, Layout>>
+{
+    using type = T;
+    static constexpr std::size_t Bits = Layout::CodeBits();
+};
+
+template<typename T, std::size_t LutBits, typename Layout>
+struct MortonNDCodeTraits<MortonNDLutLayoutDecoder<T, LutBits, Layout>>
+{
+    using type = T;
+    static constexpr std::size_t Bits = Layout::CodeBits();
+};
+
+#if MORTON_ND_BMI2_ENABLED
+template<std::size_t Dimensions, typename T>
+struct MortonNDCodeTraits<MortonNDBmi<Dimensions, T>>
+{
+    using type = T;
+    static constexpr std::size_t Bits = Dimensions * MortonNDBmi<Dimensions, T>::FieldBits;
+};
+
+template<typename T, typename Layout>
+struct MortonNDCodeTraits<MortonNDBmiLayout<T, Layout>>
+{
+    using type = T;
+    static constexpr std::size_t Bits = Layout::CodeBits();
+};
+#endif
+
+template<typename Engine>
+struct MortonNDCodeTraits<MortonNDStatic<Engine>> : MortonNDCodeTraits<Engine> {};
+
+/**
+ * A compressed, immutable sequence of sorted Morton codes, in the style of BP128 (binary packing).
+ *
+ * Codes are stored in blocks of 'BlockSize' (256). Each block stores its first code (its base)
+ * in full, and the differences between its consecutive codes (deltas) bit-packed at the width of
+ * the block's largest delta. Sorted codes of dense point sets have small deltas, so blocks
+ * typically take a few bits per code, instead of 'sizeof(T)' bytes.
+ *
+ * Blocks with deltas of at most 32 bits are packed in 8 interleaved 32-bit lanes (code 'i' in lane
+ * 'i % 8'), so that an AVX2 decoder unpacks 8 deltas per instruction, and prefix-sums them in
+ * registers. Wider deltas (sparse blocks of 64-bit codes) are packed sequentially, and decoded
+ * one at a time.
+ *
+ * Each block can be decoded independently ('DecodeBlock'), and single codes can be read without
+ * decoding a whole block ('At').
+ *
+ * Example:
+ *   const MortonNDDeltaPack<uint64_t, 63> packed(codes.data(), codes.size());
+ *   packed.Decode(decoded.data());
+ *
+ * @tparam T the type of the codes. Must be 'uint32_t', 'uint64_t' or '__uint128_t'.
+ * @tparam CodeBits the number of bits in each code which may be set (see 'MortonNDCodeTraits').
+ */
+template<typename T, std::size_t CodeBits = std::size_t(std::numeric_limits<T>::digits)>
+class MortonNDDeltaPack
+{
+    static_assert(std::is_unsigned<T>::value || std::is_same<T, __uint128_t>::value, "'T' must be an unsigned integer type.");
+    static_assert(CodeBits > 0 && CodeBits <= std::size_t(std::numeric_limits<T>::digits), "'CodeBits' must fit in 'T'.");
+
+public:
+    /**
+     * The number of codes per block.
+     */
+    static constexpr std::size_t BlockSize = 256;
+
+    /**
+     * The number of interleaved lanes of narrow (<= 32-bit) blocks.
+     */
+    static constexpr std::size_t Lanes = 8;
+
+#if MORTON_ND_PACK_AVX2_ENABLED
+    /**
+     * True if narrow blocks are decoded with AVX2.
+     */
+    static constexpr bool VectorDecode = std::numeric_limits<T>::digits == 32 || std::numeric_limits<T>::digits == 64;
+#else
+    static constexpr bool VectorDecode = false;
+#endif
+
+    MortonNDDeltaPack() = default;
+
+    /**
+     * Compresses 'count' codes.
+     *
+     * Throws 'std::invalid_argument' if the codes aren't sorted (non-decreasing), or if a code has
+     * bits set at or above 'CodeBits'.
+     */
+    MortonNDDeltaPack(const T* codes, std::size_t count)
+        : count(count)
+    {
+        const auto blocks = (count + BlockSize - 1) / BlockSize;
+        bases.reserve(blocks);
+        offsets.reserve(blocks);
+        widths.reserve(blocks);
+
+        for (std::size_t first = 0; first < count; first += BlockSize) {
+            EncodeBlock(codes + first, std::min(BlockSize, count - first));
+        }
+    }
+
+    /**
+     * Returns the number of codes.
+     */
+    std::size_t Size() const
+    {
+        return count;
+    }
+
+    std::size_t BlockCount() const
+    {
+        return bases.size();
+    }
+
+    /**
+     * Returns the bit width of block 'block''s deltas.
+     */
+    std::size_t BlockWidth(std::size_t block) const
+    {
+        return widths[block];
+    }
+
+    /**
+     * Returns the first code of block 'block'.
+     */
+    T BlockBase(std::size_t block) const
+    {
+        return bases[block];
+    }
+
+    /**
+     * Returns the number of bytes of memory used by the packed codes and the block headers.
+     */
+    std::size_t Bytes() const
+    {
+        return words.size() * sizeof(std::uint32_t)
+            + bases.size() * (sizeof(T) + sizeof(std::uint64_t) + sizeof(std::uint8_t));
+    }
+
+    /**
+     * Decodes block 'block' into 'out', which must have room for 'BlockSize' codes. If the block
+     * holds fewer codes (i.e. it's the last), the rest of 'out' is filled with its last code.
+     */
+    void DecodeBlock(std::size_t block, T* out) const
+    {
+        const auto* in = words.data() + offsets[block];
+        const auto width = std::size_t(widths[block]);
+
+        if (width > 32) {
+            DecodeWide(in, width, bases[block], out);
+        } else {
+            DecodeNarrow(in, width, bases[block], out);
+        }
+    }
+
+    /**
+     * Decodes all codes into 'out', which must have room for 'Size()' codes.
+     */
+    void Decode(T* out) const
+    {
+        const auto full = count / BlockSize;
+        for (std::size_t block = 0; block < full; block++) {
+            DecodeBlock(block, out + block * BlockSize);
+        }
+
+        if (full < BlockCount()) {
+            T last[BlockSize];
+            DecodeBlock(full, last);
+            std::copy(last, last + (count - full * BlockSize), out + full * BlockSize);
+        }
+    }
+
+    /**
+     * Returns code 'index' (< 'Size()'), by summing the deltas before it in its block.
+     */
+    T At(std::size_t index) const
+    {
+        const auto block = index / BlockSize;
+        const auto position = index % BlockSize;
+        const auto* in = words.data() + offsets[block];
+        const auto width = std::size_t(widths[block]);
+
+        T code = bases[block];
+        for (std::size_t i = 1; i <= position; i++) {
+            code += width > 32 ? Extract(in, i * width, width) : ExtractLane(in, i, width);
+        }
+
+        return code;
+    }
+
+    /**
+     * Returns the index of the first code >= 'code' (or 'Size()' if there are none). Only the
+     * block which may hold it is decoded.
+     */
+    std::size_t LowerBound(T code) const
+    {
+        // The last block whose base is < 'code' is the only one which may hold it, unless it's
+        // the next block's base.
+        const auto next = std::size_t(std::lower_bound(bases.begin(), bases.end(), code) - bases.begin());
+        if (next == 0) {
+            return 0;
+        }
+
+        T block[BlockSize];
+        DecodeBlock(next - 1, block);
+
+        const auto first = (next - 1) * BlockSize;
+        const auto size = std::min(BlockSize, count - first);
+        return first + std::size_t(std::lower_bound(block, block + size, code) - block);
+    }
+
+private:
+    static constexpr T CodeMask = CodeBits == std::size_t(std::numeric_limits<T>::digits)
+        ? ~T(0) : (T(1) << CodeBits) - 1;
+
+    static std::size_t Width(T value)
+    {
+        std::size_t width = 0;
+        for (; value != 0; value >>= 1) {
+            width++;
+        }
+
+        return width;
+    }
+
+    static T LowMask(std::size_t bits)
+    {
+        return bits >= std::size_t(std::numeric_limits<T>::digits) ? ~T(0) : (T(1) << bits) - 1;
+    }
+
+    void EncodeBlock(const T* codes, std::size_t size)
+    {
+        T deltas[BlockSize];
+        T previous = codes[0];
+        T all = 0;
+        for (std::size_t i = 0; i < BlockSize; i++) {
+            const auto code = codes[i < size ? i : size - 1];
+            if (code < previous || (code & ~CodeMask) != 0) {
+                throw std::invalid_argument("MortonNDDeltaPack: codes must be sorted, and fit in 'CodeBits' bits");
+            }
+
+            deltas[i] = code - previous;
+            all |= deltas[i];
+            previous = code;
+        }
+
+        // Every block of width 'b' takes 'b' words per lane (i.e. 8 * 'b' words), in either layout.
+        const auto width = Width(all);
+        const auto offset = words.size();
+        words.resize(offset + Lanes * width, 0);
+
+        bases.push_back(codes[0]);
+        offsets.push_back(offset);
+        widths.push_back(std::uint8_t(width));
+
+        auto* out = words.data() + offset;
+        for (std::size_t i = 0; i < BlockSize && width > 0; i++) {
+            if (width > 32) {
+                Insert(out, i * width, width, deltas[i]);
+            } else {
+                // Lane 'i % 8' holds a stream of 32 deltas, whose words are 'Lanes' apart.
+                const auto bit = (i / Lanes) * width;
+                auto* lane = out + i % Lanes;
+                lane[bit / 32 * Lanes] |= std::uint32_t(deltas[i] << (bit % 32));
+                if (bit % 32 + width > 32) {
+                    lane[(bit / 32 + 1) * Lanes] |= std::uint32_t(deltas[i] >> (32 - bit % 32));
+                }
+            }
+        }
+    }
+
+    // Writes the 'width' LSbs of 'value' at bit 'bit' of 'out'.
+    static void Insert(std::uint32_t* out, std::size_t bit, std::size_t width, T value)
+    {
+        for (std::size_t done = 0; done < width;) {
+            const auto shift = (bit + done) % 32;
+            const auto take = std::min(32 - shift, width - done);
+            out[(bit + done) / 32] |= std::uint32_t((value >> done) & LowMask(take)) << shift;
+            done += take;
+        }
+    }
+
+    // Reads the 'width' bits at bit 'bit' of 'in'.
+    static T Extract(const std::uint32_t* in, std::size_t bit, std::size_t width)
+    {
+        T value = 0;
+        for (std::size_t done = 0; done < width;) {
+            const auto shift = (bit + done) % 32;
+            const auto take = std::min(32 - shift, width - done);
+            value |= (T(in[(bit + done) / 32] >> shift) & LowMask(take)) << done;
+            done += take;
+        }
+
+        return value;
+    }
+
+    // Reads delta 'i' of a narrow block.
+    static T ExtractLane(const std::uint32_t* in, std::size_t i, std::size_t width)
+    {
+        if (width == 0) {
+            return 0;
+        }
+
+        const auto bit = (i / Lanes) * width;
+        const auto* lane = in + i % Lanes;
+        std::uint64_t value = lane[bit / 32 * Lanes] >> (bit % 32);
+        if (bit % 32 + width > 32) {
+            value |= std::uint64_t(lane[(bit / 32 + 1) * Lanes]) << (32 - bit % 32);
+        }
+
+        return T(value & ((std::uint64_t(1) << width) - 1));
+    }
+
+    static void DecodeWide(const std::uint32_t* in, std::size_t width, T base, T* out)
+    {
+        T code = base;
+        for (std::size_t i = 0; i < BlockSize; i++) {
+            code += Extract(in, i * width, width);
+            out[i] = code;
+        }
+    }
+
+    static void DecodeNarrow(const std::uint32_t* in, std::size_t width, T base, T* out)
+    {
+        DecodeNarrow(in, width, base, out, std::integral_constant<bool, VectorDecode>{});
+    }
+
+    static void DecodeNarrow(const std::uint32_t* in, std::size_t width, T base, T* out, std::false_type)
+    {
+        T code = base;
+        for (std::size_t i = 0; i < BlockSize; i++) {
+            code += ExtractLane(in, i, width);
+            out[i] = code;
+        }
+    }
+
+#if MORTON_ND_PACK_AVX2_ENABLED
+    using Unpacker = void (*)(const std::uint32_t*, T, T*);
+
+    static void DecodeNarrow(const std::uint32_t* in, std::size_t width, T base, T* out, std::true_type)
+    {
+        static constexpr Unpacker unpackers[] = {
+            &Unpack<0>, &Unpack<1>, &Unpack<2>, &Unpack<3>, &Unpack<4>, &Unpack<5>, &Unpack<6>, &Unpack<7>,
+            &Unpack<8>, &Unpack<9>, &Unpack<10>, &Unpack<11>, &Unpack<12>, &Unpack<13>, &Unpack<14>, &Unpack<15>,
+            &Unpack<16>, &Unpack<17>, &Unpack<18>, &Unpack<19>, &Unpack<20>, &Unpack<21>, &Unpack<22>, &Unpack<23>,
+            &Unpack<24>, &Unpack<25>, &Unpack<26>, &Unpack<27>, &Unpack<28>, &Unpack<29>, &Unpack<30>, &Unpack<31>,
+            &Unpack<32>
+        };
+
+        unpackers[width](in, base, out);
+    }
+
+    // Unpacks the 32 rows of 8 deltas of width 'Width', prefix-summing each row onto the last
+    // code of the previous one.
+    template<std::size_t Width>
+    static void Unpack(const std::uint32_t* in, T base, T* out)
+    {
+        const auto mask = _mm256_set1_epi32(int(Width == 32 ? ~std::uint32_t(0) : (std::uint32_t(1) << Width) - 1));
+        auto carry = Broadcast(base);
+
+        for (std::size_t row = 0; row < BlockSize / Lanes; row++) {
+            const auto bit = row * Width;
+            const auto shift = bit % 32;
+
+            auto deltas = _mm256_setzero_si256();
+            if (Width > 0) {
+                const auto* words = reinterpret_cast<const __m256i*>(in + bit / 32 * Lanes);
+                deltas = _mm256_srli_epi32(_mm256_loadu_si256(words), int(shift));
+                if (shift + Width > 32) {
+                    deltas = _mm256_or_si256(deltas, _mm256_slli_epi32(_mm256_loadu_si256(words + 1), int(32 - shift)));
+                }
+
+                deltas = _mm256_and_si256(deltas, mask);
+            }
+
+            carry = ScanRow(deltas, carry, out + row * Lanes);
+        }
+    }
+
+    static __m256i Broadcast(T value)
+    {
+        return std::numeric_limits<T>::digits == 32
+            ? _mm256_set1_epi32(int(std::uint32_t(value)))
+            : _mm256_set1_epi64x(static_cast<long long>(value));
+    }
+
+    // Writes 'carry' plus the inclusive prefix sums of the 8 32-bit 'deltas' to 'out', and
+    // returns the last (broadcast).
+    static __m256i ScanRow(__m256i deltas, __m256i carry, T* out)
+    {
+        return ScanRow(deltas, carry, out, std::integral_constant<bool, std::numeric_limits<T>::digits == 32>{});
+    }
+
+    static __m256i ScanRow(__m256i deltas, __m256i carry, T* out, std::true_type)
+    {
+        auto sums = _mm256_add_epi32(deltas, _mm256_slli_si256(deltas, 4));
+        sums = _mm256_add_epi32(sums, _mm256_slli_si256(sums, 8));
+        sums = _mm256_add_epi32(sums, _mm256_blend_epi32(_mm256_setzero_si256(),
+            _mm256_permutevar8x32_epi32(sums, _mm256_set1_epi32(3)), 0xF0));
+        sums = _mm256_add_epi32(sums, carry);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), sums);
+        return _mm256_permutevar8x32_epi32(sums, _mm256_set1_epi32(7));
+    }
+
+    static __m256i ScanRow(__m256i deltas, __m256i carry, T* out, std::false_type)
+    {
+        auto low = Scan4(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(deltas)));
+        low = _mm256_add_epi64(low, carry);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), low);
+        carry = _mm256_permute4x64_epi64(low, 0xFF);
+
+        auto high = Scan4(_mm256_cvtepu32_epi64(_mm256_extracti128_si256(deltas, 1)));
+        high = _mm256_add_epi64(high, carry);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4), high);
+        return _mm256_permute4x64_epi64(high, 0xFF);
+    }
+
+    // Inclusive prefix sums of 4 64-bit values.
+    static __m256i Scan4(__m256i values)
+    {
+        values = _mm256_add_epi64(values, _mm256_slli_si256(values, 8));
+        return _mm256_add_epi64(values, _mm256_blend_epi32(_mm256_setzero_si256(), _mm256_permute4x64_epi64(values, 0x55), 0xF0));
+    }
+#endif
+
+    std::size_t count = 0;
+    std::vector<T> bases;
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint8_t> widths;
+    std::vector<std::uint32_t> words;
+};
+
+// Out-of-class definitions, since 'std::min' binds 'BlockSize' by reference.
+template<typename T, std::size_t CodeBits>
+constexpr std::size_t MortonNDDeltaPack<T, CodeBits>::BlockSize;
+
+/**
+ * A 'MortonNDDeltaPack' for the codes produced by 'Engine' (see 'MortonNDCodeTraits').
+ *
+ * Example:
+ *   MortonNDDeltaPackFor<MortonNDLutEncoder<3, 21, 8>>   // MortonNDDeltaPack<uint64_t, 63>
+ */
+template<typename Engine>
+using MortonNDDeltaPackFor = MortonNDDeltaPack<typename MortonNDCodeTraits<Engine>::type, MortonNDCodeTraits<Engine>::Bits>;
+
+}
+
+#endif
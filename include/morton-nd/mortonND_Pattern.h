@@ -0,0 +1,211 @@
+//
+//  mortonND_Pattern.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_PATTERN_H
+#define MORTON_ND_MORTONND_PATTERN_H
+
+#include "mortonND_Mixed.h"
+
+#include <cstdint>
+#include <limits>
+
+namespace mortonnd {
+
+/**
+ * The bit layout of a code described by an explicit bit pattern.
+ *
+ * 'Pattern' lists, for each bit of the code (starting with the LSb), the field whose next bit
+ * is placed there. Each field's bits are taken in order, starting with its LSb.
+ *
+ * Example (x = 0, y = 1, z = 2):
+ *   MortonNDPattern<0, 1, 0, 1, 2, 2, 2>
+ *   Encode(xx, yy, zzz) => zzzyxyx          (2D Morton minor, z major)
+ *
+ *   MortonNDPattern<0, 0, 1, 0, 0, 1>
+ *   Encode(xxxx, zz) => zxxzxx              (2 bits of x per bit of z, with x = 0, z = 1)
+ *
+ * A pattern with round-robin field indices (e.g. '0, 1, 2, 0, 1, 2, ...') is the layout
+ * produced by every other engine.
+ *
+ * All functions are constexpr, and are intended to be evaluated at compile-time.
+ *
+ * @tparam Pattern the field of each bit of the code, starting with the LSb.
+ */
+template<std::size_t... Pattern>
+struct MortonNDPattern
+{
+    static_assert(sizeof...(Pattern) > 0, "The pattern must have at least one bit.");
+
+private:
+    // Helpers which must be usable in the class body (i.e. before 'MortonNDPattern' is complete).
+    struct Bits
+    {
+        static constexpr std::size_t Width(std::size_t field)
+        {
+            const std::size_t pattern[] = { Pattern... };
+
+            std::size_t bits = 0;
+            for (std::size_t offset = 0; offset < sizeof...(Pattern); offset++) {
+                bits += pattern[offset] == field;
+            }
+
+            return bits;
+        }
+
+        static constexpr std::size_t MaxField()
+        {
+            const std::size_t pattern[] = { Pattern... };
+
+            std::size_t field = 0;
+            for (std::size_t offset = 0; offset < sizeof...(Pattern); offset++) {
+                field = pattern[offset] > field ? pattern[offset] : field;
+            }
+
+            return field;
+        }
+
+        static constexpr bool Complete()
+        {
+            for (std::size_t field = 0; field <= MaxField(); field++) {
+                if (Width(field) == 0) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+
+    static_assert(Bits::Complete(), "Every field index below the largest in the pattern must appear at least once.");
+
+public:
+    /**
+     * The number of fields (components) in each code (the largest field index in 'Pattern',
+     * plus 1).
+     */
+    static constexpr std::size_t Dimensions = Bits::MaxField() + 1;
+
+    /**
+     * Returns the number of bits in field 'field' (the number of times it appears in 'Pattern').
+     */
+    static constexpr std::size_t Width(std::size_t field)
+    {
+        return Bits::Width(field);
+    }
+
+    /**
+     * Returns the total number of bits in each code (the length of 'Pattern').
+     */
+    static constexpr std::size_t CodeBits()
+    {
+        return sizeof...(Pattern);
+    }
+
+    /**
+     * Returns the offset (in the code) of bit 'bit' of field 'field'.
+     */
+    static constexpr std::size_t Offset(std::size_t field, std::size_t bit)
+    {
+        const std::size_t pattern[] = { Pattern... };
+        for (std::size_t offset = 0; offset < sizeof...(Pattern); offset++) {
+            if (pattern[offset] == field && bit-- == 0) {
+                return offset;
+            }
+        }
+
+        return sizeof...(Pattern);
+    }
+
+    /**
+     * Returns the number of bits of field 'field' which land below offset 'offset' in the code.
+     */
+    static constexpr std::size_t BitsBelow(std::size_t field, std::size_t offset)
+    {
+        const std::size_t pattern[] = { Pattern... };
+
+        std::size_t bits = 0;
+        for (std::size_t other = 0; other < offset && other < sizeof...(Pattern); other++) {
+            bits += pattern[other] == field;
+        }
+
+        return bits;
+    }
+
+    /**
+     * Returns the mask of the bits belonging to field 'field' (the field's selector).
+     *
+     * @tparam T an unsigned integer type with at least 'CodeBits()' bits.
+     */
+    template<typename T>
+    static constexpr T Selector(std::size_t field)
+    {
+        const std::size_t pattern[] = { Pattern... };
+
+        T selector = 0;
+        for (std::size_t offset = 0; offset < sizeof...(Pattern); offset++) {
+            selector |= T(pattern[offset] == field) << offset;
+        }
+
+        return selector;
+    }
+};
+
+#if MORTON_ND_BMI2_ENABLED
+/**
+ * A BMI2 Morton encoder/decoder for an explicit bit pattern.
+ *
+ * Each field's 'pdep' / 'pext' selector is generated at compile-time from 'Pattern' (see
+ * 'MortonNDPattern'), so encoding and decoding take 1 'pdep' / 'pext' per field (per 64-bit
+ * word of the result), as with 'MortonNDBmi'.
+ *
+ * Example (2D Morton tiles of x and y, with z above them):
+ *   using Encoder = MortonNDBmiPattern<uint32_t, 0, 1, 0, 1, 2, 2, 2>;
+ *   auto encoding = Encoder::Encode(x, y, z);
+ *
+ * @tparam T the type of the components to encode/decode, as well as the type of the result.
+ *         Must be either 'uint32_t', 'uint64_t' or '__uint128_t'.
+ * @tparam Pattern the field of each bit of the code, starting with the LSb.
+ */
+template<typename T, std::size_t... Pattern>
+using MortonNDBmiPattern = MortonNDBmiLayout<T, MortonNDPattern<Pattern...>>;
+#endif
+
+/**
+ * A portable LUT-based Morton encoder for an explicit bit pattern (see 'MortonNDPattern').
+ *
+ * Chunks whose bits are spread out the same way share a LUT (see 'MortonNDLutLayoutEncoder').
+ *
+ * Example:
+ *   constexpr auto Encoder = MortonNDLutPatternEncoder<uint32_t, 4, 0, 1, 0, 1, 2, 2, 2>();
+ *   auto encoding = Encoder.Encode(x, y, z);
+ *
+ * @tparam T the type of the components to encode, as well as the type of the result.
+ * @tparam LutBits the number of bits for the LUT.
+ * @tparam Pattern the field of each bit of the code, starting with the LSb.
+ */
+template<typename T, std::size_t LutBits, std::size_t... Pattern>
+using MortonNDLutPatternEncoder = MortonNDLutLayoutEncoder<T, LutBits, MortonNDPattern<Pattern...>>;
+
+/**
+ * A portable LUT-based Morton decoder for an explicit bit pattern (see 'MortonNDPattern').
+ *
+ * Chunks with the same arrangement of fields share a LUT (see 'MortonNDLutLayoutDecoder').
+ *
+ * Example:
+ *   constexpr auto Decoder = MortonNDLutPatternDecoder<uint32_t, 4, 0, 1, 0, 1, 2, 2, 2>();
+ *   std::tie(x, y, z) = Decoder.Decode(encoding);
+ *
+ * @tparam T the type of the Morton code to decode, as well as the tuple types of the result.
+ * @tparam LutBits the number of bits for the LUT.
+ * @tparam Pattern the field of each bit of the code, starting with the LSb.
+ */
+template<typename T, std::size_t LutBits, std::size_t... Pattern>
+using MortonNDLutPatternDecoder = MortonNDLutLayoutDecoder<T, LutBits, MortonNDPattern<Pattern...>>;
+
+}
+
+#endif
@@ -0,0 +1,460 @@
+//
+//  mortonND_PointFile.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_POINTFILE_H
+#define MORTON_ND_MORTONND_POINTFILE_H
+
+#include "mortonND_External.h"
+
+#if MORTON_ND_EXTERNAL_ENABLED
+
+#include "mortonND_Range.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mortonnd {
+
+/**
+ * How the codes of each block of a point file are stored. Records are always stored as-is.
+ */
+enum class MortonNDBlockCodec : std::uint32_t
+{
+    /**
+     * Codes are stored as an array of 'T', so blocks can be read without copying.
+     */
+    Raw = 0,
+
+    /**
+     * Each code is stored as its difference from the previous code (the first as is), in LEB128
+     * varint form (7 bits per byte).
+     */
+    DeltaVarint = 1
+};
+
+/**
+ * The header at the start of a point file.
+ *
+ * A point file holds records sorted by Morton code, in blocks of up to 'blockRecords' records:
+ *
+ *   [header] [block 0] [block 1] ... [block n - 1] [index]
+ *
+ * Each block holds its codes (encoded with 'codec'), followed by its records. The index holds a
+ * 'MortonNDPointFileBlock' per block. Blocks and the index start at multiples of 'Alignment'
+ * bytes. All values are in native byte order.
+ */
+struct MortonNDPointFileHeader
+{
+    static constexpr std::uint32_t Version = 1;
+    static constexpr std::size_t Alignment = 16;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t codec;
+    std::uint32_t codeSize;
+    std::uint32_t recordSize;
+    std::uint64_t records;
+    std::uint64_t blocks;
+    std::uint64_t blockRecords;
+    std::uint64_t indexOffset;
+    std::uint64_t reserved;
+
+    static const char* Magic()
+    {
+        return "MORTONND";
+    }
+};
+
+static_assert(sizeof(MortonNDPointFileHeader) == 64, "Unexpected point file header size.");
+
+/**
+ * An entry of a point file's block index.
+ */
+template<typename T>
+struct MortonNDPointFileBlock
+{
+    T firstCode;
+    T lastCode;
+    std::uint64_t offset;
+    std::uint64_t bytes;
+    std::uint64_t records;
+};
+
+/**
+ * Writes records, in Morton order, to a point file (see 'MortonNDPointFileHeader').
+ *
+ * Records are buffered into blocks, and each full block is encoded and written. 'Finish' writes
+ * the index and the header. The header is written last, so a file which wasn't finished is
+ * rejected by 'MortonNDPointFileReader'.
+ *
+ * Example:
+ *   MortonNDPointFileWriter<uint64_t> writer("points.mnd", sizeof(Point), MortonNDBlockCodec::DeltaVarint);
+ *   for (auto n = 0; n < count; n++) {
+ *       writer.Append(codes[n], &points[n]);
+ *   }
+ *   writer.Finish();
+ *
+ * Throws 'std::system_error' if a file operation fails.
+ *
+ * @tparam T the type of the Morton codes. Must be an unsigned integer type.
+ */
+template<typename T>
+class MortonNDPointFileWriter
+{
+public:
+    using Block = MortonNDPointFileBlock<T>;
+
+    /**
+     * Creates (or truncates) the file at 'path'.
+     *
+     * @param path the file to write.
+     * @param recordSize the size of each record, in bytes.
+     * @param codec how to store the codes of each block.
+     * @param blockRecords the number of records per block.
+     */
+    MortonNDPointFileWriter(const std::string& path, std::size_t recordSize,
+        MortonNDBlockCodec codec = MortonNDBlockCodec::DeltaVarint, std::size_t blockRecords = 4096)
+        : file(path, O_WRONLY | O_CREAT | O_TRUNC), recordSize(recordSize), codec(codec),
+          blockRecords(std::max<std::size_t>(1, blockRecords)), offset(sizeof(MortonNDPointFileHeader))
+    {
+        codes.reserve(this->blockRecords);
+        records.reserve(this->blockRecords * recordSize);
+    }
+
+    /**
+     * Appends a record. Codes must be appended in non-decreasing order.
+     *
+     * Throws 'std::invalid_argument' if 'code' is less than the previous code.
+     */
+    void Append(T code, const void* record)
+    {
+        if ((!codes.empty() && code < codes.back()) || (codes.empty() && !index.empty() && code < index.back().lastCode)) {
+            throw std::invalid_argument("MortonNDPointFileWriter: codes must be appended in non-decreasing order");
+        }
+
+        codes.push_back(code);
+        const auto* bytes = static_cast<const unsigned char*>(record);
+        records.insert(records.end(), bytes, bytes + recordSize);
+
+        if (codes.size() == blockRecords) {
+            Flush();
+        }
+    }
+
+    /**
+     * Appends 'count' records, spaced 'recordSize' bytes apart.
+     */
+    void Append(const T* codes, const void* records, std::size_t count)
+    {
+        for (std::size_t n = 0; n < count; n++) {
+            Append(codes[n], static_cast<const unsigned char*>(records) + n * recordSize);
+        }
+    }
+
+    /**
+     * Writes the last block, the index and the header. No records can be appended afterwards.
+     */
+    void Finish()
+    {
+        Flush();
+
+        offset = Align(offset);
+        file.Write(reinterpret_cast<const unsigned char*>(index.data()), index.size() * sizeof(Block), offset);
+
+        MortonNDPointFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MortonNDPointFileHeader::Magic(), sizeof(header.magic));
+        header.version = MortonNDPointFileHeader::Version;
+        header.codec = std::uint32_t(codec);
+        header.codeSize = sizeof(T);
+        header.recordSize = std::uint32_t(recordSize);
+        header.records = written;
+        header.blocks = index.size();
+        header.blockRecords = blockRecords;
+        header.indexOffset = offset;
+        file.Write(reinterpret_cast<const unsigned char*>(&header), sizeof(header), 0);
+    }
+
+private:
+    static std::uint64_t Align(std::uint64_t value)
+    {
+        return (value + MortonNDPointFileHeader::Alignment - 1) / MortonNDPointFileHeader::Alignment * MortonNDPointFileHeader::Alignment;
+    }
+
+    void Flush()
+    {
+        if (codes.empty()) {
+            return;
+        }
+
+        block.clear();
+        if (codec == MortonNDBlockCodec::Raw) {
+            const auto* bytes = reinterpret_cast<const unsigned char*>(codes.data());
+            block.insert(block.end(), bytes, bytes + codes.size() * sizeof(T));
+        } else {
+            T previous = 0;
+            for (auto code : codes) {
+                auto delta = code - previous;
+                for (; delta >= 0x80; delta >>= 7) {
+                    block.push_back(static_cast<unsigned char>(delta | 0x80));
+                }
+
+                block.push_back(static_cast<unsigned char>(delta));
+                previous = code;
+            }
+        }
+
+        block.insert(block.end(), records.begin(), records.end());
+
+        offset = Align(offset);
+        file.Write(block.data(), block.size(), offset);
+        index.push_back(Block{ codes.front(), codes.back(), offset, block.size(), codes.size() });
+
+        offset += block.size();
+        written += codes.size();
+        codes.clear();
+        records.clear();
+    }
+
+    external_detail::File file;
+    std::size_t recordSize;
+    MortonNDBlockCodec codec;
+    std::size_t blockRecords;
+    std::uint64_t offset;
+    std::uint64_t written = 0;
+
+    std::vector<T> codes;
+    std::vector<unsigned char> records;
+    std::vector<unsigned char> block;
+    std::vector<Block> index;
+};
+
+/**
+ * Reads a point file (see 'MortonNDPointFileHeader') through a read-only memory mapping.
+ *
+ * Blocks are only touched (paged in) when read. Blocks stored with 'MortonNDBlockCodec::Raw' are
+ * read without copying; for other codecs, the codes are decoded into a caller-provided buffer,
+ * and the records are still read in place.
+ *
+ * Example:
+ *   MortonNDPointFileReader<uint64_t> reader("points.mnd");
+ *   reader.Query<3>(boxMin, boxMax, [](uint64_t code, const unsigned char* record) { ... });
+ *
+ * Throws 'std::system_error' if the file can't be opened or mapped, and 'std::runtime_error' if
+ * it isn't a (finished) point file with codes of type 'T'.
+ *
+ * @tparam T the type of the Morton codes. Must be an unsigned integer type.
+ */
+template<typename T>
+class MortonNDPointFileReader
+{
+public:
+    using Block = MortonNDPointFileBlock<T>;
+
+    /**
+     * Selects 'Query''s decomposition depth from the number of blocks.
+     */
+    static constexpr std::size_t AutoDepth = std::numeric_limits<std::size_t>::max();
+
+    /**
+     * The codes and records of a block. 'codes' points either into the file's mapping, or into
+     * the buffer passed to 'ReadBlock'.
+     */
+    struct BlockView
+    {
+        const T* codes;
+        const unsigned char* records;
+        std::size_t count;
+    };
+
+    /**
+     * Counters for a single query.
+     */
+    struct QueryStats
+    {
+        std::size_t intervals = 0;  // The intervals the box was decomposed into.
+        std::size_t blocks = 0;     // The blocks read.
+        std::size_t records = 0;    // The records inside the box.
+    };
+
+    explicit MortonNDPointFileReader(const std::string& path)
+        : file(path, O_RDONLY), mapping(file, std::size_t(file.Size()), false)
+    {
+        if (mapping.size < sizeof(MortonNDPointFileHeader)) {
+            throw std::runtime_error("MortonNDPointFileReader: file is too small: " + path);
+        }
+
+        std::memcpy(&header, mapping.data, sizeof(header));
+        if (std::memcmp(header.magic, MortonNDPointFileHeader::Magic(), sizeof(header.magic)) != 0
+            || header.version != MortonNDPointFileHeader::Version) {
+            throw std::runtime_error("MortonNDPointFileReader: not a point file: " + path);
+        }
+
+        if (header.codeSize != sizeof(T)) {
+            throw std::runtime_error("MortonNDPointFileReader: unexpected code size: " + path);
+        }
+
+        if (header.indexOffset % MortonNDPointFileHeader::Alignment != 0 || header.indexOffset > mapping.size
+            || header.blocks > (mapping.size - header.indexOffset) / sizeof(Block)) {
+            throw std::runtime_error("MortonNDPointFileReader: truncated index: " + path);
+        }
+
+        index = reinterpret_cast<const Block*>(mapping.data + header.indexOffset);
+
+        // Blocks are ordered, so only the last needs to be checked.
+        if (header.blocks > 0 && index[header.blocks - 1].offset + index[header.blocks - 1].bytes > header.indexOffset) {
+            throw std::runtime_error("MortonNDPointFileReader: truncated block: " + path);
+        }
+    }
+
+    std::uint64_t Records() const
+    {
+        return header.records;
+    }
+
+    std::size_t RecordSize() const
+    {
+        return header.recordSize;
+    }
+
+    MortonNDBlockCodec Codec() const
+    {
+        return MortonNDBlockCodec(header.codec);
+    }
+
+    std::size_t BlockCount() const
+    {
+        return std::size_t(header.blocks);
+    }
+
+    /**
+     * Returns the index entry of block 'block'.
+     */
+    const Block& BlockInfo(std::size_t block) const
+    {
+        return index[block];
+    }
+
+    /**
+     * Reads block 'block'. 'buffer' is used to hold the decoded codes if the block isn't 'Raw'.
+     */
+    BlockView ReadBlock(std::size_t block, std::vector<T>& buffer) const
+    {
+        const auto& info = index[block];
+        const auto count = std::size_t(info.records);
+        const auto* data = mapping.data + info.offset;
+
+        if (Codec() == MortonNDBlockCodec::Raw) {
+            return BlockView{ reinterpret_cast<const T*>(data), data + count * sizeof(T), count };
+        }
+
+        buffer.resize(count);
+        T previous = 0;
+        for (std::size_t n = 0; n < count; n++) {
+            T delta = 0;
+            std::size_t shift = 0;
+            for (; *data & 0x80; data++, shift += 7) {
+                delta |= T(*data & 0x7F) << shift;
+            }
+
+            delta |= T(*data++) << shift;
+            previous += delta;
+            buffer[n] = previous;
+        }
+
+        return BlockView{ buffer.data(), data, count };
+    }
+
+    /**
+     * Calls 'func(code, record)' for each record whose code lies within the box with corners
+     * 'boxMin' and 'boxMax', in Morton order.
+     *
+     * The box is decomposed into at most 'maxIntervals' code intervals (see
+     * 'MortonNDRange::Decompose'), and only the blocks which overlap an interval are read. Within
+     * each block, codes outside of the box are skipped with BIGMIN (see 'MortonNDRange::Query').
+     *
+     * By default, the box is split down to cells of about 1 block each (for uniformly distributed
+     * codes), since smaller cells can't skip more blocks, and the number of cells visited grows
+     * with each level.
+     *
+     * @tparam Dimensions the number of fields in each code.
+     * @tparam FieldBits the number of bits in each field.
+     * @param maxIntervals the maximum number of intervals to decompose the box into.
+     * @param maxDepth the maximum number of levels to split the box (see 'MortonNDRange::Decompose').
+     */
+    template<std::size_t Dimensions, std::size_t FieldBits = std::size_t(std::numeric_limits<T>::digits) / Dimensions, typename F>
+    QueryStats Query(T boxMin, T boxMax, F func, std::size_t maxIntervals = 64, std::size_t maxDepth = AutoDepth) const
+    {
+        using Range = MortonNDRange<Dimensions, T, FieldBits>;
+
+        if (maxDepth == AutoDepth) {
+            // The smallest depth with at least as many cells as blocks, plus 1.
+            maxDepth = 1;
+            for (std::uint64_t cells = 1; cells < header.blocks && maxDepth <= FieldBits; cells <<= Dimensions) {
+                maxDepth++;
+            }
+        }
+
+        QueryStats stats;
+        const auto decomposition = Range::Decompose(boxMin, boxMax, maxIntervals, maxDepth);
+        stats.intervals = decomposition.intervals.size();
+
+        std::vector<T> buffer;
+        std::size_t next = 0;
+        for (const auto& interval : decomposition.intervals) {
+            // The first block which may hold a code >= 'interval.lo' (that isn't already read).
+            auto block = std::size_t(std::partition_point(index + next, index + header.blocks,
+                [&](const Block& info) { return info.lastCode < interval.lo; }) - index);
+
+            for (; block < header.blocks && index[block].firstCode <= interval.hi; block++) {
+                const auto view = ReadBlock(block, buffer);
+                stats.blocks++;
+
+                for (const auto& code : Range::Query(view.codes, view.codes + view.count, boxMin, boxMax)) {
+                    func(code, view.records + std::size_t(&code - view.codes) * header.recordSize);
+                    stats.records++;
+                }
+            }
+
+            next = block;
+        }
+
+        return stats;
+    }
+
+    /**
+     * Calls 'func(code, record)' for every record, in Morton order.
+     */
+    template<typename F>
+    void Scan(F func) const
+    {
+        std::vector<T> buffer;
+        for (std::size_t block = 0; block < header.blocks; block++) {
+            const auto view = ReadBlock(block, buffer);
+            for (std::size_t n = 0; n < view.count; n++) {
+                func(view.codes[n], view.records + n * header.recordSize);
+            }
+        }
+    }
+
+private:
+    external_detail::File file;
+    external_detail::Mapping mapping;
+    MortonNDPointFileHeader header;
+    const Block* index = nullptr;
+};
+
+}
+
+#endif
+
+#endif
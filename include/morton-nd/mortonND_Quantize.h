@@ -0,0 +1,466 @@
+//
+//  mortonND_Quantize.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_QUANTIZE_H
+#define MORTON_ND_MORTONND_QUANTIZE_H
+
+#include "mortonND_Static.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#define MORTON_ND_QUANTIZE_AVX2_ENABLED 1
+#include <immintrin.h>
+#endif
+
+namespace mortonnd {
+
+/**
+ * Order-preserving conversion between 'Input' values and unsigned keys of the same width.
+ *
+ * For any 'a' and 'b', 'a < b' if and only if 'ToKey(a) < ToKey(b)':
+ *   - unsigned integers are unchanged.
+ *   - signed integers have their sign bit flipped (i.e. are biased by 2^(bits - 1)).
+ *   - IEEE floats have their sign bit flipped if positive, and all bits flipped if negative.
+ *     -0.0 orders directly below +0.0, and NaNs order above +infinity (or below -infinity, if
+ *     their sign bit is set).
+ *
+ * @tparam Input an integer or floating-point type ('float' or 'double').
+ */
+template<typename Input, typename = void>
+struct MortonNDOrderedKey;
+
+template<typename Input>
+struct MortonNDOrderedKey<Input, typename std::enable_if<std::is_integral<Input>::value>::type>
+{
+    using Key = typename std::make_unsigned<Input>::type;
+
+    static constexpr Key ToKey(Input value)
+    {
+        return Key(value) ^ SignBit;
+    }
+
+    static constexpr Input FromKey(Key key)
+    {
+        return Input(Key(key ^ SignBit));
+    }
+
+private:
+    static constexpr Key SignBit = std::is_signed<Input>::value ? Key(Key(1) << (std::numeric_limits<Key>::digits - 1)) : Key(0);
+};
+
+template<typename Input>
+struct MortonNDOrderedKey<Input, typename std::enable_if<std::is_floating_point<Input>::value>::type>
+{
+    static_assert(std::numeric_limits<Input>::is_iec559 && (sizeof(Input) == 4 || sizeof(Input) == 8),
+        "'Input' must be an IEEE 754 'float' or 'double'.");
+
+    using Key = typename std::conditional<sizeof(Input) == 4, uint32_t, uint64_t>::type;
+
+    static inline Key ToKey(Input value)
+    {
+        Key bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & SignBit) != 0 ? Key(~bits) : Key(bits | SignBit);
+    }
+
+    static inline Input FromKey(Key key)
+    {
+        const Key bits = (key & SignBit) != 0 ? Key(key ^ SignBit) : Key(~key);
+
+        Input value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+private:
+    static constexpr Key SignBit = Key(1) << (std::numeric_limits<Key>::digits - 1);
+};
+
+/**
+ * Fused conversion between signed integer / floating-point coordinates and Morton codes.
+ *
+ * Each coordinate is converted to an unsigned field of 'FieldBits' bits in one of two ways:
+ *
+ * Ordered (default constructor)
+ *   The coordinate's order-preserving key ('MortonNDOrderedKey') is truncated to its 'FieldBits'
+ *   most-significant bits. This covers the full range of 'Input' (e.g. every 'float'), and
+ *   needs no configuration. Decoding yields the middle of each field's range of keys.
+ *
+ * Affine (origin and scale per axis)
+ *   field = clamp(floor((coordinate - origin) * scale), 0, 2^FieldBits - 1)
+ *
+ *   Coordinates outside of the grid (and NaNs, which become 0) are clamped. Decoding yields the
+ *   center of each cell: origin + (field + 0.5) / scale (rounded down for integers). The
+ *   arithmetic is done in 'Input' for floating-point coordinates, and in 'double' for integers.
+ *
+ * The batch functions convert a block of 'BlockSize' points at a time into a buffer on the stack,
+ * which is then encoded with the engine's own 'EncodeBatch' (or decoded with its 'DecodeBatch',
+ * and converted back). Blocks stay in L1, so the conversion isn't a separate pass over memory.
+ * When compiled for AVX2, SoA conversion of 32-bit coordinates ('float', 'int32_t', 'uint32_t')
+ * to fields of up to 31 bits uses an 8-wide kernel ('VectorBatch' reports whether it's used).
+ *
+ * Any engine with 'EncodeBatch' / 'DecodeBatch' for 'Dimensions' and 'T' can be used: pass a
+ * LUT encoder / decoder instance, or wrap engines with static members in 'MortonNDStatic'.
+ *
+ * Example (3D float points, 21 bits per field, BMI2):
+ *   using MortonND = MortonNDBmi_3D_64;
+ *   const auto quantizer = MortonNDQuantizer<3, float, uint64_t>({{ -100, -100, 0 }}, {{ 1000, 1000, 1000 }});
+ *   quantizer.EncodeBatch(MortonNDStatic<MortonND>{}, points, 3, codes, count);
+ *
+ * Configuration:
+ *
+ * Dimensions
+ *   The number of fields (components) in each code.
+ *
+ * Input
+ *   The type of the coordinates. Must be an integer type, 'float' or 'double'.
+ *
+ * T
+ *   The type of the Morton codes (and the engine's fields).
+ *
+ * FieldBits
+ *   The number of bits in each field. Defaults to the most that fit in 'T'.
+ *
+ * @tparam Dimensions the number of fields (components) in each code.
+ * @tparam Input the type of the coordinates.
+ * @tparam T the type of the Morton codes.
+ * @tparam FieldBits the number of bits in each field.
+ */
+template<std::size_t Dimensions, typename Input, typename T, std::size_t FieldBits = std::size_t(std::numeric_limits<T>::digits) / Dimensions>
+class MortonNDQuantizer
+{
+    static_assert(Dimensions > 0, "'Dimensions' must be > 0.");
+    static_assert(FieldBits > 0, "'FieldBits' must be > 0.");
+    static_assert(Dimensions * FieldBits <= std::size_t(std::numeric_limits<T>::digits),
+        "'Dimensions' * 'FieldBits' must be <= the width of 'T'.");
+    static_assert(std::is_integral<Input>::value || std::is_floating_point<Input>::value,
+        "'Input' must be an integer or floating-point type.");
+
+    using Ordered = MortonNDOrderedKey<Input>;
+    using Key = typename Ordered::Key;
+
+    static constexpr std::size_t KeyBits = std::size_t(std::numeric_limits<Key>::digits);
+
+public:
+    /**
+     * The type used for affine conversion.
+     */
+    using Real = typename std::conditional<std::is_floating_point<Input>::value, Input, double>::type;
+
+    /**
+     * The largest field value.
+     */
+    static constexpr T FieldMax = T(T(T(1) << (FieldBits - 1)) << 1) - 1;
+
+    /**
+     * The number of points converted per block.
+     */
+    static constexpr std::size_t BlockSize = 256;
+
+    /**
+     * True if SoA conversion uses the AVX2 kernel for this configuration.
+     *
+     * For debugging / perf tuning.
+     */
+#if MORTON_ND_QUANTIZE_AVX2_ENABLED
+    static constexpr bool VectorBatch = sizeof(Input) == 4 && FieldBits <= 31
+        && std::is_integral<T>::value && (std::numeric_limits<T>::digits == 32 || std::numeric_limits<T>::digits == 64);
+#else
+    static constexpr bool VectorBatch = false;
+#endif
+
+    /**
+     * Creates an ordered quantizer, covering the full range of 'Input'.
+     */
+    MortonNDQuantizer() : ordered(true), origin(), scale(), inverseScale() { }
+
+    /**
+     * Creates an affine quantizer.
+     *
+     * @param origin the coordinate of the minimum corner of the grid, per axis.
+     * @param scale the number of cells per unit, per axis. Must be > 0.
+     */
+    MortonNDQuantizer(const std::array<Real, Dimensions>& origin, const std::array<Real, Dimensions>& scale)
+        : ordered(false), origin(origin), scale(scale), inverseScale()
+    {
+        for (std::size_t d = 0; d < Dimensions; d++) {
+            inverseScale[d] = Real(1) / scale[d];
+        }
+    }
+
+    /**
+     * Converts coordinate 'value' of axis 'axis' to a field.
+     */
+    T Quantize(std::size_t axis, Input value) const
+    {
+        if (ordered) {
+            return ToField(Ordered::ToKey(value));
+        }
+
+        Real cell = (Real(value) - origin[axis]) * scale[axis];
+        const Real max = MaxCell;
+        cell = cell > Real(0) ? cell : Real(0);
+        cell = cell < max ? cell : max;
+        return T(cell);
+    }
+
+    /**
+     * Converts field 'field' of axis 'axis' back to a coordinate.
+     */
+    Input Dequantize(std::size_t axis, T field) const
+    {
+        if (ordered) {
+            return Ordered::FromKey(FromField(field));
+        }
+
+        const Real value = origin[axis] + (Real(field) + Real(0.5)) * inverseScale[axis];
+        return std::is_integral<Input>::value ? Input(std::floor(value)) : Input(value);
+    }
+
+    /**
+     * Converts and encodes 'count' points stored in separate arrays (SoA).
+     *
+     * Equivalent to:
+     *   out[i] = engine.Encode(Quantize(0, fields[0][i]), Quantize(1, fields[1][i]), ...)
+     *
+     * @param engine the Morton engine (see 'MortonNDStatic' for engines with static members).
+     * @param fields one array per dimension, each holding at least 'count' coordinates.
+     * @param out destination for 'count' Morton codes.
+     * @param count the number of points to encode.
+     */
+    template<typename Engine>
+    void EncodeBatch(const Engine& engine, const std::array<const Input*, Dimensions>& fields, T* out, std::size_t count) const
+    {
+        EncodeBlocks(engine, out, count, [&](std::size_t d, std::size_t first, T* block, std::size_t n) {
+            QuantizeContiguous(d, fields[d] + first, block, n, std::integral_constant<bool, VectorBatch>{});
+        });
+    }
+
+    /**
+     * Converts and encodes 'count' points stored as records (AoS).
+     *
+     * Point 'i' is read from 'points + i * stride', and its 'Dimensions' coordinates must be
+     * stored contiguously starting at that address.
+     *
+     * @param engine the Morton engine (see 'MortonNDStatic' for engines with static members).
+     * @param points the first coordinate of the first point.
+     * @param stride the distance (in elements of 'Input') between consecutive points. Must be >= 'Dimensions'.
+     * @param out destination for 'count' Morton codes.
+     * @param count the number of points to encode.
+     */
+    template<typename Engine>
+    void EncodeBatch(const Engine& engine, const Input* points, std::size_t stride, T* out, std::size_t count) const
+    {
+        EncodeBlocks(engine, out, count, [&](std::size_t d, std::size_t first, T* block, std::size_t n) {
+            const Input* values = points + first * stride + d;
+            for (std::size_t j = 0; j < n; j++) {
+                block[j] = Quantize(d, values[j * stride]);
+            }
+        });
+    }
+
+    /**
+     * Decodes and converts 'count' Morton codes, writing the coordinates of each into separate
+     * arrays (SoA).
+     *
+     * Equivalent to:
+     *   fields[d][i] = Dequantize(d, std::get<d>(engine.Decode(codes[i])))
+     *
+     * @param engine the Morton engine (see 'MortonNDStatic' for engines with static members).
+     * @param codes the Morton codes to decode.
+     * @param count the number of codes to decode.
+     * @param fields one destination array per dimension, each with room for 'count' coordinates.
+     */
+    template<typename Engine>
+    void DecodeBatch(const Engine& engine, const T* codes, std::size_t count, const std::array<Input*, Dimensions>& fields) const
+    {
+        DecodeBlocks(engine, codes, count, [&](std::size_t d, std::size_t first, const T* block, std::size_t n) {
+            Input* values = fields[d] + first;
+            for (std::size_t j = 0; j < n; j++) {
+                values[j] = Dequantize(d, block[j]);
+            }
+        });
+    }
+
+    /**
+     * Decodes and converts 'count' Morton codes, writing the coordinates of each as a record (AoS).
+     *
+     * @param engine the Morton engine (see 'MortonNDStatic' for engines with static members).
+     * @param codes the Morton codes to decode.
+     * @param count the number of codes to decode.
+     * @param points destination for the first coordinate of the first point.
+     * @param stride the distance (in elements of 'Input') between consecutive points. Must be >= 'Dimensions'.
+     */
+    template<typename Engine>
+    void DecodeBatch(const Engine& engine, const T* codes, std::size_t count, Input* points, std::size_t stride) const
+    {
+        DecodeBlocks(engine, codes, count, [&](std::size_t d, std::size_t first, const T* block, std::size_t n) {
+            Input* values = points + first * stride + d;
+            for (std::size_t j = 0; j < n; j++) {
+                values[j * stride] = Dequantize(d, block[j]);
+            }
+        });
+    }
+
+private:
+    // The largest 'Real' which is <= 'FieldMax' (the low bits of 'FieldMax' may not be representable).
+    static constexpr Real MaxCell = Real(FieldBits > std::size_t(std::numeric_limits<Real>::digits)
+        ? FieldMax & ~T((T(1) << (FieldBits - std::size_t(std::numeric_limits<Real>::digits))) - 1) : FieldMax);
+
+    // The number of least-significant key bits dropped by ordered conversion.
+    static constexpr std::size_t DroppedBits = FieldBits < KeyBits ? KeyBits - FieldBits : 0;
+
+    static constexpr T ToField(Key key)
+    {
+        return T(key >> DroppedBits);
+    }
+
+    // Fills the bits dropped by 'ToField' with the middle of their range.
+    static constexpr Key FromField(T field)
+    {
+        return Key(Key(field) << DroppedBits) | Key(Key(1) << DroppedBits >> 1);
+    }
+
+    template<typename Engine, typename Convert>
+    void EncodeBlocks(const Engine& engine, T* out, std::size_t count, Convert convert) const
+    {
+        T block[Dimensions][BlockSize];
+        std::array<const T*, Dimensions> blockFields;
+        for (std::size_t d = 0; d < Dimensions; d++) {
+            blockFields[d] = block[d];
+        }
+
+        for (std::size_t first = 0; first < count; first += BlockSize) {
+            const auto n = count - first < BlockSize ? count - first : BlockSize;
+            for (std::size_t d = 0; d < Dimensions; d++) {
+                convert(d, first, block[d], n);
+            }
+
+            engine.EncodeBatch(blockFields, out + first, n);
+        }
+    }
+
+    template<typename Engine, typename Convert>
+    void DecodeBlocks(const Engine& engine, const T* codes, std::size_t count, Convert convert) const
+    {
+        T block[Dimensions][BlockSize];
+        std::array<T*, Dimensions> blockFields;
+        for (std::size_t d = 0; d < Dimensions; d++) {
+            blockFields[d] = block[d];
+        }
+
+        for (std::size_t first = 0; first < count; first += BlockSize) {
+            const auto n = count - first < BlockSize ? count - first : BlockSize;
+            engine.DecodeBatch(codes + first, n, blockFields);
+            for (std::size_t d = 0; d < Dimensions; d++) {
+                convert(d, first, block[d], n);
+            }
+        }
+    }
+
+    void QuantizeContiguous(std::size_t d, const Input* values, T* block, std::size_t n, std::false_type) const
+    {
+        for (std::size_t j = 0; j < n; j++) {
+            block[j] = Quantize(d, values[j]);
+        }
+    }
+
+#if MORTON_ND_QUANTIZE_AVX2_ENABLED
+    void QuantizeContiguous(std::size_t d, const Input* values, T* block, std::size_t n, std::true_type) const
+    {
+        const auto vectorCount = n - n % 8;
+        for (std::size_t j = 0; j < vectorCount; j += 8) {
+            const auto input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + j));
+            const auto fields = ordered ? QuantizeOrdered(input) : QuantizeAffine(d, input, std::is_floating_point<Input>{});
+            StoreFields(block + j, fields, std::integral_constant<bool, std::numeric_limits<T>::digits == 64>{});
+        }
+
+        QuantizeContiguous(d, values + vectorCount, block + vectorCount, n - vectorCount, std::false_type{});
+    }
+
+    // The keys of 8 32-bit coordinates, truncated to 'FieldBits' bits.
+    static __m256i QuantizeOrdered(__m256i input)
+    {
+        const auto sign = _mm256_set1_epi32(int(0x80000000u));
+        __m256i keys;
+        if (std::is_floating_point<Input>::value) {
+            // Negative: flip every bit. Positive: flip the sign bit.
+            keys = _mm256_xor_si256(input, _mm256_or_si256(_mm256_srai_epi32(input, 31), sign));
+        } else {
+            keys = std::is_signed<Input>::value ? _mm256_xor_si256(input, sign) : input;
+        }
+
+        return _mm256_srli_epi32(keys, int(DroppedBits));
+    }
+
+    __m256i QuantizeAffine(std::size_t d, __m256i input, std::true_type) const
+    {
+        auto cell = _mm256_mul_ps(_mm256_sub_ps(_mm256_castsi256_ps(input), _mm256_set1_ps(float(origin[d]))),
+            _mm256_set1_ps(float(scale[d])));
+
+        // 'max' returns its second operand for NaNs, so NaNs become 0 (as in 'Quantize').
+        cell = _mm256_max_ps(cell, _mm256_setzero_ps());
+        cell = _mm256_min_ps(cell, _mm256_set1_ps(float(MaxCell)));
+        return _mm256_cvttps_epi32(cell);
+    }
+
+    // Integer coordinates are converted in 'double' (as in 'Quantize'), 4 at a time.
+    __m256i QuantizeAffine(std::size_t d, __m256i input, std::false_type) const
+    {
+        const auto low = QuantizeAffine(d, ToDouble(_mm256_castsi256_si128(input)));
+        const auto high = QuantizeAffine(d, ToDouble(_mm256_extracti128_si256(input, 1)));
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+    }
+
+    __m128i QuantizeAffine(std::size_t d, __m256d input) const
+    {
+        auto cell = _mm256_mul_pd(_mm256_sub_pd(input, _mm256_set1_pd(double(origin[d]))), _mm256_set1_pd(double(scale[d])));
+        cell = _mm256_max_pd(cell, _mm256_setzero_pd());
+        cell = _mm256_min_pd(cell, _mm256_set1_pd(double(MaxCell)));
+        return _mm256_cvttpd_epi32(cell);
+    }
+
+    static __m256d ToDouble(__m128i input)
+    {
+        if (std::is_signed<Input>::value) {
+            return _mm256_cvtepi32_pd(input);
+        }
+
+        // Unsigned: convert as signed, then add 2^32 to lanes which were negative.
+        const auto converted = _mm256_cvtepi32_pd(input);
+        const auto negative = _mm256_cmp_pd(converted, _mm256_setzero_pd(), _CMP_LT_OQ);
+        return _mm256_add_pd(converted, _mm256_and_pd(negative, _mm256_set1_pd(4294967296.0)));
+    }
+
+    static void StoreFields(T* block, __m256i fields, std::false_type)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(block), fields);
+    }
+
+    static void StoreFields(T* block, __m256i fields, std::true_type)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(block), _mm256_cvtepu32_epi64(_mm256_castsi256_si128(fields)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(block + 4), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(fields, 1)));
+    }
+#endif
+
+    bool ordered;
+    std::array<Real, Dimensions> origin;
+    std::array<Real, Dimensions> scale;
+    std::array<Real, Dimensions> inverseScale;
+};
+
+}
+
+#endif
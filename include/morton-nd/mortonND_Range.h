@@ -0,0 +1,554 @@
+//
+//  mortonND_Range.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_RANGE_H
+#define MORTON_ND_MORTONND_RANGE_H
+
+#include "mortonND_Magic.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mortonnd {
+
+/**
+ * Returns the index of the most-significant set bit of 'value', which must not be 0.
+ */
+constexpr std::size_t HighestSetBit(uint32_t value) {
+    return 31 - std::size_t(__builtin_clz(value));
+}
+
+constexpr std::size_t HighestSetBit(uint64_t value) {
+    return 63 - std::size_t(__builtin_clzll(value));
+}
+
+#if defined(__SIZEOF_INT128__)
+constexpr std::size_t HighestSetBit(__uint128_t value) {
+    return uint64_t(value >> 64) != 0 ? 64 + HighestSetBit(uint64_t(value >> 64)) : HighestSetBit(uint64_t(value));
+}
+#endif
+
+/**
+ * Range (bounding box) queries over Morton codes, without decoding.
+ *
+ * A query box is given by the Morton codes of its minimum and maximum corners (inclusive), i.e.
+ * 'Encode(minX, minY, ...)' and 'Encode(maxX, maxY, ...)'. These can come from any engine, since
+ * all engines produce the same layout.
+ *
+ * Scanning every code in '[boxMin, boxMax]' reads a lot of data outside of the box. Instead, the
+ * Tropf-Herzog BIGMIN / LITMAX computations find the next (previous) code inside the box after
+ * (before) a code outside of it, so that a scan can jump over the gaps. Each is implemented on the
+ * dilated codes with per-dimension masks ('MortonNDMagic::Selector'), and visits only the bit
+ * positions at which the code differs from the (shrinking) box corners, found with 'clz'.
+ *
+ * For scans over sorted arrays, use 'Query', which returns an iterable range of the elements
+ * inside a box. For other ordered structures (e.g. B-trees), use 'NextInBox' to find each seek target.
+ * For stores where each range scan is a separate request, use 'Decompose' to compute a bounded
+ * list of code intervals covering the box up front.
+ *
+ * Configuration:
+ *
+ * Dimensions
+ *   The number of fields (components) in each code.
+ *
+ * T
+ *   The type of the Morton codes. Must be 'uint32_t', 'uint64_t' or '__uint128_t'.
+ *
+ * FieldBits
+ *   The number of bits in each field. Defaults to the most that fit in 'T'.
+ *
+ * @tparam Dimensions the number of fields (components) in each code.
+ * @tparam T the type of the Morton codes.
+ * @tparam FieldBits the number of bits in each field.
+ */
+template<std::size_t Dimensions, typename T, std::size_t FieldBits = std::size_t(std::numeric_limits<T>::digits) / Dimensions>
+class MortonNDRange
+{
+    using Magic = MortonNDMagic<Dimensions, T, FieldBits>;
+
+public:
+    /**
+     * Returns true if 'code' lies within the box with corners 'boxMin' and 'boxMax'.
+     *
+     * Each dimension is compared in its dilated form (masked in place), which preserves order.
+     */
+    static constexpr bool InBox(T code, T boxMin, T boxMax)
+    {
+        return InBoxInternal(code, boxMin, boxMax, std::make_index_sequence<Dimensions>{});
+    }
+
+    /**
+     * Computes BIGMIN: the smallest code inside the box which is greater than 'code'.
+     *
+     * 'code' must lie outside of the box, and within '(boxMin, boxMax)'.
+     */
+    static constexpr T BigMin(T code, T boxMin, T boxMax)
+    {
+        T bigMin = boxMin;
+        T diff = ((code ^ boxMin) | (code ^ boxMax)) & CodeMask;
+
+        while (diff != 0) {
+            const auto bitIndex = HighestSetBit(diff);
+            const auto bit = T(1) << bitIndex;
+            const auto lower = Magic::Selector(bitIndex % Dimensions) & (bit - 1);
+
+            if ((code & bit) == 0) {
+                if ((boxMin & bit) != 0) {
+                    // (0, 1, 1): the rest of the box is above 'code'.
+                    return boxMin;
+                }
+
+                // (0, 0, 1): split the box at 'bit'. The upper half's minimum is a candidate.
+                bigMin = (boxMin & ~lower) | bit;
+                boxMax = (boxMax & ~(bit | lower)) | lower;
+            } else {
+                if ((boxMax & bit) == 0) {
+                    // (1, 0, 0): the rest of the box is below 'code'.
+                    return bigMin;
+                }
+
+                // (1, 0, 1): continue in the upper half of the box.
+                boxMin = (boxMin & ~lower) | bit;
+            }
+
+            diff = ((code ^ boxMin) | (code ^ boxMax)) & (bit - 1);
+        }
+
+        return bigMin;
+    }
+
+    /**
+     * Computes LITMAX: the largest code inside the box which is less than 'code'.
+     *
+     * 'code' must lie outside of the box, and within '(boxMin, boxMax)'.
+     */
+    static constexpr T LitMax(T code, T boxMin, T boxMax)
+    {
+        T litMax = boxMax;
+        T diff = ((code ^ boxMin) | (code ^ boxMax)) & CodeMask;
+
+        while (diff != 0) {
+            const auto bitIndex = HighestSetBit(diff);
+            const auto bit = T(1) << bitIndex;
+            const auto lower = Magic::Selector(bitIndex % Dimensions) & (bit - 1);
+
+            if ((code & bit) == 0) {
+                if ((boxMin & bit) != 0) {
+                    // (0, 1, 1): the rest of the box is above 'code'.
+                    return litMax;
+                }
+
+                // (0, 0, 1): continue in the lower half of the box.
+                boxMax = (boxMax & ~(bit | lower)) | lower;
+            } else {
+                if ((boxMax & bit) == 0) {
+                    // (1, 0, 0): the rest of the box is below 'code'.
+                    return boxMax;
+                }
+
+                // (1, 0, 1): split the box at 'bit'. The lower half's maximum is a candidate.
+                litMax = (boxMax & ~(bit | lower)) | lower;
+                boxMin = (boxMin & ~lower) | bit;
+            }
+
+            diff = ((code ^ boxMin) | (code ^ boxMax)) & (bit - 1);
+        }
+
+        return litMax;
+    }
+
+    /**
+     * Finds the smallest code inside the box which is >= 'code' (the next seek target of a scan).
+     *
+     * @param code the current position of the scan.
+     * @param boxMin the code of the box's minimum corner.
+     * @param boxMax the code of the box's maximum corner.
+     * @param next receives the result, if found.
+     * @return false if no code >= 'code' lies within the box (the scan is complete).
+     */
+    static constexpr bool NextInBox(T code, T boxMin, T boxMax, T& next)
+    {
+        if (code <= boxMin) {
+            next = boxMin;
+            return true;
+        }
+
+        if (code > boxMax) {
+            return false;
+        }
+
+        next = InBox(code, boxMin, boxMax) ? code : BigMin(code, boxMin, boxMax);
+        return true;
+    }
+
+    /**
+     * Default key projection for 'Query', for arrays of codes.
+     */
+    struct Identity
+    {
+        constexpr T operator()(T code) const
+        {
+            return code;
+        }
+    };
+
+    /**
+     * A forward iterator over the elements of a sorted range whose keys lie within a box.
+     *
+     * When an element outside of the box is reached, the iterator computes the next code inside
+     * the box with 'BigMin', and jumps to it with a galloping (exponential) search, rather than
+     * stepping through the gap.
+     */
+    template<typename RandomIt, typename KeyFn>
+    class BoxIterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename std::iterator_traits<RandomIt>::value_type;
+        using difference_type = typename std::iterator_traits<RandomIt>::difference_type;
+        using pointer = typename std::iterator_traits<RandomIt>::pointer;
+        using reference = typename std::iterator_traits<RandomIt>::reference;
+
+        BoxIterator(RandomIt current, RandomIt last, T boxMin, T boxMax, KeyFn key)
+            : current(current), last(last), boxMin(boxMin), boxMax(boxMax), key(key)
+        {
+            Settle();
+        }
+
+        reference operator*() const { return *current; }
+        pointer operator->() const { return &*current; }
+
+        BoxIterator& operator++()
+        {
+            ++current;
+            Settle();
+            return *this;
+        }
+
+        BoxIterator operator++(int)
+        {
+            auto copy = *this;
+            ++(*this);
+            return copy;
+        }
+
+        bool operator==(const BoxIterator& other) const { return current == other.current; }
+        bool operator!=(const BoxIterator& other) const { return current != other.current; }
+
+        /**
+         * Returns the underlying iterator.
+         */
+        RandomIt Base() const { return current; }
+
+        /**
+         * The number of jumps taken so far (for diagnostics).
+         */
+        std::size_t SkipCount() const { return skips; }
+
+    private:
+        // Advances 'current' to the first element at or after it whose key is inside the box.
+        void Settle()
+        {
+            while (current != last) {
+                const T code = key(*current);
+                if (InBox(code, boxMin, boxMax)) {
+                    return;
+                }
+
+                T next;
+                if (!NextInBox(code, boxMin, boxMax, next)) {
+                    current = last;
+                    return;
+                }
+
+                current = Gallop(current, next);
+                skips++;
+            }
+        }
+
+        // Returns the first element in '[from, last)' with key >= 'target', probing at exponentially
+        // increasing distances before binary searching.
+        RandomIt Gallop(RandomIt from, T target) const
+        {
+            difference_type step = 1;
+            auto low = from;
+            auto remaining = last - from;
+
+            while (step < remaining && key(*(from + step)) < target) {
+                low = from + step;
+                step *= 2;
+            }
+
+            auto count = (step < remaining ? step + 1 : remaining) - (low - from);
+            while (count > 0) {
+                const auto half = count / 2;
+                const auto middle = low + half;
+                if (key(*middle) < target) {
+                    low = middle + 1;
+                    count -= half + 1;
+                } else {
+                    count = half;
+                }
+            }
+
+            return low;
+        }
+
+        RandomIt current;
+        RandomIt last;
+        T boxMin;
+        T boxMax;
+        KeyFn key;
+        std::size_t skips = 0;
+    };
+
+    /**
+     * An iterable range of 'BoxIterator's (for use with range-based for loops).
+     */
+    template<typename RandomIt, typename KeyFn>
+    struct BoxRange
+    {
+        BoxIterator<RandomIt, KeyFn> first;
+        BoxIterator<RandomIt, KeyFn> last;
+
+        BoxIterator<RandomIt, KeyFn> begin() const { return first; }
+        BoxIterator<RandomIt, KeyFn> end() const { return last; }
+    };
+
+    /**
+     * Returns the elements of the sorted range '[first, last)' whose keys lie within the box.
+     *
+     * Example:
+     *   for (auto& point : MortonNDRange_3D_64::Query(points.begin(), points.end(), boxMin, boxMax, keyOf)) { ... }
+     *
+     * @param first the beginning of the range, which must be sorted by key.
+     * @param last the end of the range.
+     * @param boxMin the code of the box's minimum corner.
+     * @param boxMax the code of the box's maximum corner.
+     * @param key projects an element to its Morton code. Defaults to the identity, for ranges of codes.
+     */
+    template<typename RandomIt, typename KeyFn = Identity>
+    static BoxRange<RandomIt, KeyFn> Query(RandomIt first, RandomIt last, T boxMin, T boxMax, KeyFn key = KeyFn())
+    {
+        return BoxRange<RandomIt, KeyFn>{
+            BoxIterator<RandomIt, KeyFn>(first, last, boxMin, boxMax, key),
+            BoxIterator<RandomIt, KeyFn>(last, last, boxMin, boxMax, key)
+        };
+    }
+
+    /**
+     * An inclusive interval of Morton codes, '[lo, hi]'.
+     */
+    struct Interval
+    {
+        T lo;
+        T hi;
+    };
+
+    /**
+     * The result of 'Decompose'.
+     */
+    struct Decomposition
+    {
+        /**
+         * Disjoint, non-adjacent intervals in increasing order, which together cover the box.
+         */
+        std::vector<Interval> intervals;
+
+        /**
+         * The number of codes covered by 'intervals' which lie outside of the box.
+         */
+        T falsePositives;
+    };
+
+    /**
+     * Decomposes the box with corners 'boxMin' and 'boxMax' into a list of code intervals, each
+     * of which can be read with a single range scan.
+     *
+     * The box is split recursively along Morton cell boundaries (quadrants in 2D, octants in 3D,
+     * and so on), descending only into cells which intersect the box. Each cell is either fully
+     * inside the box (and emitted as one interval), or partially inside it. Partial cells at
+     * 'maxDepth' are emitted whole, which covers codes outside of the box. Adjacent intervals are
+     * merged.
+     *
+     * If more than 'maxIntervals' intervals remain, the intervals separated by the smallest gaps
+     * are merged, which adds the fewest false positives possible for the intervals found at
+     * 'maxDepth'.
+     *
+     * With the defaults, the result is exact (no false positives), and contains the fewest
+     * intervals that cover the box exactly. The work done is proportional to the number of cells
+     * visited, which 'maxDepth' bounds.
+     *
+     * @param boxMin the code of the box's minimum corner.
+     * @param boxMax the code of the box's maximum corner.
+     * @param maxIntervals the maximum number of intervals to return. Must be > 0.
+     * @param maxDepth the maximum number of levels to split, where each level halves each dimension.
+     *                 Values >= 'FieldBits' split down to individual codes.
+     * @return the intervals, and the number of false positives they include.
+     */
+    static Decomposition Decompose(T boxMin, T boxMax,
+        std::size_t maxIntervals = std::numeric_limits<std::size_t>::max(), std::size_t maxDepth = FieldBits)
+    {
+        maxIntervals = std::max(maxIntervals, std::size_t(1));
+
+        Decomposition result{ {}, 0 };
+        DecomposeCell(0, 0, boxMin, boxMax, std::min(maxDepth, FieldBits), maxIntervals, result.intervals);
+        MergeSmallestGaps(result.intervals, maxIntervals);
+
+        // Computed modulo 2^digits, which is exact since the result is < 2^(Dimensions * FieldBits).
+        T covered = 0;
+        for (const auto& interval : result.intervals) {
+            covered += interval.hi - interval.lo + 1;
+        }
+
+        result.falsePositives = covered - BoxVolume(boxMin, boxMax, std::make_index_sequence<Dimensions>{});
+        return result;
+    }
+
+private:
+    MortonNDRange() = default;
+
+    static constexpr T LowMask(std::size_t bits)
+    {
+        return bits >= std::size_t(std::numeric_limits<T>::digits) ? ~T(0) : (T(1) << bits) - 1;
+    }
+
+    // Visits the cell at 'depth' whose codes start at 'lo', which must intersect the box.
+    static void DecomposeCell(T lo, std::size_t depth, T boxMin, T boxMax, std::size_t maxDepth,
+        std::size_t maxIntervals, std::vector<Interval>& intervals)
+    {
+        const auto cellBits = Dimensions * (FieldBits - depth);
+        const T hi = lo | LowMask(cellBits);
+
+        if (depth == maxDepth || (InBox(lo, boxMin, boxMax) && InBox(hi, boxMin, boxMax))) {
+            Append(intervals, lo, hi, maxIntervals);
+            return;
+        }
+
+        // In each dimension, find which halves of the cell intersect the box. Dimensions where both
+        // do are 'free' in the children's codes, and the rest are 'fixed'.
+        const auto childBits = cellBits - Dimensions;
+        T free = 0;
+        T fixed = 0;
+        for (std::size_t d = 0; d < Dimensions; d++) {
+            const T selector = Magic::Selector(d);
+            const T bit = T(1) << (childBits + d);
+            const bool lower = (boxMin & selector) <= (hi & ~bit & selector);
+            const bool upper = (boxMax & selector) >= ((lo | bit) & selector);
+
+            free |= lower && upper ? bit : 0;
+            fixed |= !lower ? bit : 0;
+        }
+
+        // Enumerates the subsets of 'free' in increasing (i.e. Morton) order.
+        T child = 0;
+        do {
+            DecomposeCell(lo | fixed | child, depth + 1, boxMin, boxMax, maxDepth, maxIntervals, intervals);
+            child = (child - free) & free;
+        } while (child != 0);
+    }
+
+    static void Append(std::vector<Interval>& intervals, T lo, T hi, std::size_t maxIntervals)
+    {
+        if (!intervals.empty() && intervals.back().hi + 1 == lo) {
+            intervals.back().hi = hi;
+            return;
+        }
+
+        intervals.push_back(Interval{ lo, hi });
+
+        // Merging early bounds memory. Any gap merged here is smaller than 'maxIntervals' - 1 others,
+        // so it wouldn't survive the final merge either.
+        if (intervals.size() > maxIntervals && intervals.size() - maxIntervals > maxIntervals) {
+            MergeSmallestGaps(intervals, maxIntervals);
+        }
+    }
+
+    // Merges intervals until at most 'maxIntervals' remain, by keeping only the largest gaps.
+    static void MergeSmallestGaps(std::vector<Interval>& intervals, std::size_t maxIntervals)
+    {
+        if (intervals.size() <= maxIntervals) {
+            return;
+        }
+
+        std::vector<std::size_t> gaps(intervals.size() - 1);
+        for (std::size_t i = 0; i < gaps.size(); i++) {
+            gaps[i] = i;
+        }
+
+        const auto gapSize = [&](std::size_t i) { return intervals[i + 1].lo - intervals[i].hi; };
+        const auto kept = gaps.begin() + std::ptrdiff_t(maxIntervals - 1);
+        std::nth_element(gaps.begin(), kept, gaps.end(), [&](std::size_t a, std::size_t b) {
+            return gapSize(a) > gapSize(b) || (gapSize(a) == gapSize(b) && a < b);
+        });
+
+        std::vector<bool> split(intervals.size(), false);
+        std::for_each(gaps.begin(), kept, [&](std::size_t i) { split[i] = true; });
+
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < intervals.size(); i++) {
+            if (i == 0 || split[i - 1]) {
+                intervals[count++] = intervals[i];
+            } else {
+                intervals[count - 1].hi = intervals[i].hi;
+            }
+        }
+
+        intervals.resize(count);
+    }
+
+    template<std::size_t... i>
+    static constexpr T BoxVolume(T boxMin, T boxMax, std::index_sequence<i...>)
+    {
+        T volume = 1;
+
+        using expander = int[];
+        (void)expander{ 0, (void(volume *= Magic::Compact(boxMax >> i) - Magic::Compact(boxMin >> i) + 1), 0)... };
+
+        return volume;
+    }
+
+    static constexpr T CodeMask = Dimensions * FieldBits == std::size_t(std::numeric_limits<T>::digits)
+        ? ~T(0) : (T(1) << (Dimensions * FieldBits)) - 1;
+
+    template<std::size_t... i>
+    static constexpr bool InBoxInternal(T code, T boxMin, T boxMax, std::index_sequence<i...>)
+    {
+        bool inBox = true;
+
+        using expander = int[];
+        (void)expander{ 0, (void(inBox = inBox
+            && (code & Magic::Selector(i)) >= (boxMin & Magic::Selector(i))
+            && (code & Magic::Selector(i)) <= (boxMax & Magic::Selector(i))), 0)... };
+
+        return inBox;
+    }
+};
+
+/**
+ * Type alias for range queries over 2D 64-bit codes.
+ */
+using MortonNDRange_2D_64 = MortonNDRange<2, uint64_t>;
+
+/**
+ * Type alias for range queries over 3D 32-bit codes.
+ */
+using MortonNDRange_3D_32 = MortonNDRange<3, uint32_t>;
+
+/**
+ * Type alias for range queries over 3D 64-bit codes.
+ */
+using MortonNDRange_3D_64 = MortonNDRange<3, uint64_t>;
+
+}
+
+#endif
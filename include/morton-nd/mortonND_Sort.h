@@ -0,0 +1,334 @@
+//
+//  mortonND_Sort.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_SORT_H
+#define MORTON_ND_MORTONND_SORT_H
+
+#include "mortonND_Static.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mortonnd {
+
+/**
+ * A parallel, stable radix sort of (key, payload) pairs, for Morton codes.
+ *
+ * Keys are sorted 'DigitBits' bits (a digit) at a time:
+ *
+ *   1. Each thread produces the keys (and payloads) of a contiguous chunk of the input, a block
+ *      at a time, counting the digits of each block while it's still in L1. Only the digits
+ *      below 'keyBits' (e.g. 'Dimensions * FieldBits') are counted. This is also where
+ *      'SortByMorton' encodes the points, so encoding isn't a separate pass.
+ *   2. Digits which are the same for every key are skipped. The most-significant remaining digit
+ *      is sorted first (MSD), with each thread scattering its chunk into one of 'Buckets' buckets.
+ *   3. The buckets are distributed among the threads, and each is sorted by the remaining lower
+ *      digits (LSD), again skipping digits which are the same for every key in the bucket.
+ *
+ * The MSD pass keeps each bucket's LSD passes within a range small enough to stay in cache, and
+ * lets the buckets be sorted independently. If the keys are clustered such that one bucket holds
+ * most of them, that bucket is sorted by a single thread.
+ *
+ * Scratch space of 'count' keys and payloads is allocated internally.
+ *
+ * @tparam T the type of the keys. Must be an unsigned integer type (including '__uint128_t').
+ * @tparam Payload the type of the payloads. Must be trivially copyable.
+ */
+template<typename T, typename Payload>
+class MortonNDRadixSort
+{
+    static constexpr std::size_t KeyBits = std::size_t(std::numeric_limits<T>::digits);
+
+public:
+    /**
+     * The number of bits sorted per pass.
+     */
+    static constexpr std::size_t DigitBits = 8;
+
+    /**
+     * The number of buckets per pass (2^'DigitBits').
+     */
+    static constexpr std::size_t Buckets = std::size_t(1) << DigitBits;
+
+    /**
+     * The number of keys produced (and counted) per block.
+     */
+    static constexpr std::size_t BlockSize = 1024;
+
+    /**
+     * The fewest keys sorted per thread. Smaller inputs use fewer threads.
+     */
+    static constexpr std::size_t MinPerThread = std::size_t(1) << 16;
+
+    /**
+     * Sorts 'count' keys, along with their payloads.
+     *
+     * @param keys the keys to sort.
+     * @param payloads the payload of each key, permuted along with the keys.
+     * @param count the number of keys.
+     * @param keyBits the number of (least-significant) bits in each key which may be set.
+     *                Higher bits are ignored.
+     * @param threads the number of threads to use. 0 selects 'std::thread::hardware_concurrency()'.
+     */
+    static void Sort(T* keys, Payload* payloads, std::size_t count, std::size_t keyBits = KeyBits, std::size_t threads = 0)
+    {
+        Sort(keys, payloads, count, keyBits, threads, [](std::size_t, std::size_t, T*, Payload*) { });
+    }
+
+    /**
+     * Sorts 'count' keys produced by 'produce', along with their payloads.
+     *
+     * 'produce(first, n, keys + first, payloads + first)' must write the keys (and payloads)
+     * 'first' to 'first + n'. It's called concurrently for disjoint blocks.
+     */
+    template<typename Produce>
+    static void Sort(T* keys, Payload* payloads, std::size_t count, std::size_t keyBits, std::size_t threads, Produce produce)
+    {
+        const auto digits = ((keyBits < KeyBits ? keyBits : KeyBits) + DigitBits - 1) / DigitBits;
+        threads = ThreadCount(count, threads);
+        const auto chunk = (count + threads - 1) / threads;
+
+        // counts[(t * digits + d) * Buckets + b]: keys of thread 't' with value 'b' in digit 'd'.
+        std::vector<std::size_t> counts(threads * digits * Buckets);
+        Parallel(threads, [&](std::size_t t) {
+            const auto last = std::min(count, (t + 1) * chunk);
+            auto* threadCounts = counts.data() + t * digits * Buckets;
+
+            for (auto first = std::min(count, t * chunk); first < last; first += BlockSize) {
+                const auto n = std::min(BlockSize, last - first);
+                produce(first, n, keys + first, payloads + first);
+                CountDigits(keys + first, n, digits, threadCounts);
+            }
+        });
+
+        // The most-significant digit which isn't the same for every key.
+        auto top = digits;
+        std::vector<std::size_t> total(Buckets);
+        for (auto d = digits; d-- > 0 && top == digits;) {
+            std::fill(total.begin(), total.end(), 0);
+            for (std::size_t t = 0; t < threads; t++) {
+                for (std::size_t b = 0; b < Buckets; b++) {
+                    total[b] += counts[(t * digits + d) * Buckets + b];
+                }
+            }
+
+            top = IsTrivial(total.data(), count) ? digits : d;
+        }
+
+        if (top == digits) {
+            // Every key is the same.
+            return;
+        }
+
+        std::vector<T> scratchKeys(count);
+        std::vector<Payload> scratchPayloads(count);
+
+        // MSD: each thread scatters its chunk by digit 'top', after the chunks of earlier threads.
+        std::vector<std::size_t> offsets(threads * Buckets);
+        std::vector<std::size_t> bucketStart(Buckets + 1);
+        std::size_t offset = 0;
+        for (std::size_t b = 0; b < Buckets; b++) {
+            bucketStart[b] = offset;
+            for (std::size_t t = 0; t < threads; t++) {
+                offsets[t * Buckets + b] = offset;
+                offset += counts[(t * digits + top) * Buckets + b];
+            }
+        }
+        bucketStart[Buckets] = count;
+
+        Parallel(threads, [&](std::size_t t) {
+            const auto first = std::min(count, t * chunk);
+            const auto last = std::min(count, (t + 1) * chunk);
+            Scatter(keys + first, payloads + first, last - first, top,
+                scratchKeys.data(), scratchPayloads.data(), offsets.data() + t * Buckets);
+        });
+
+        // LSD: sort each bucket by the digits below 'top', back into 'keys' / 'payloads'.
+        std::atomic<std::size_t> nextBucket{0};
+        Parallel(threads, [&](std::size_t) {
+            std::vector<std::size_t> bucketCounts(top * Buckets);
+            for (auto b = nextBucket++; b < Buckets; b = nextBucket++) {
+                const auto first = bucketStart[b];
+                SortBucket(scratchKeys.data() + first, scratchPayloads.data() + first, keys + first, payloads + first,
+                    bucketStart[b + 1] - first, top, bucketCounts.data());
+            }
+        });
+    }
+
+private:
+    MortonNDRadixSort() = default;
+
+    static std::size_t ThreadCount(std::size_t count, std::size_t threads)
+    {
+        if (threads == 0) {
+            threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        return std::max<std::size_t>(1, std::min(threads, count / MinPerThread));
+    }
+
+    // Runs 'func(t)' for each 't' in [0, threads), on 'threads' threads (including this one).
+    template<typename F>
+    static void Parallel(std::size_t threads, F func)
+    {
+        std::vector<std::thread> workers;
+        for (std::size_t t = 1; t < threads; t++) {
+            workers.emplace_back(func, t);
+        }
+
+        func(0);
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    static std::size_t Digit(T key, std::size_t digit)
+    {
+        return std::size_t(key >> (digit * DigitBits)) & (Buckets - 1);
+    }
+
+    static void CountDigits(const T* keys, std::size_t count, std::size_t digits, std::size_t* counts)
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            for (std::size_t d = 0; d < digits; d++) {
+                counts[d * Buckets + Digit(keys[i], d)]++;
+            }
+        }
+    }
+
+    // True if every key has the same value for the digit counted by 'counts'.
+    static bool IsTrivial(const std::size_t* counts, std::size_t count)
+    {
+        return std::find(counts, counts + Buckets, count) != counts + Buckets;
+    }
+
+    // Stable scatter by digit 'digit', advancing each bucket's offset in 'offsets'.
+    static void Scatter(const T* keys, const Payload* payloads, std::size_t count, std::size_t digit,
+        T* outKeys, Payload* outPayloads, std::size_t* offsets)
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            const auto position = offsets[Digit(keys[i], digit)]++;
+            outKeys[position] = keys[i];
+            outPayloads[position] = payloads[i];
+        }
+    }
+
+    // Sorts a bucket by its lowest 'digits' digits, writing the result to 'outKeys' / 'outPayloads'
+    // ('keys' / 'payloads' are clobbered).
+    static void SortBucket(T* keys, Payload* payloads, T* outKeys, Payload* outPayloads, std::size_t count,
+        std::size_t digits, std::size_t* counts)
+    {
+        std::fill(counts, counts + digits * Buckets, 0);
+        CountDigits(keys, count, digits, counts);
+
+        auto* sourceKeys = keys;
+        auto* sourcePayloads = payloads;
+        auto* targetKeys = outKeys;
+        auto* targetPayloads = outPayloads;
+
+        for (std::size_t d = 0; d < digits; d++) {
+            auto* digitCounts = counts + d * Buckets;
+            if (IsTrivial(digitCounts, count)) {
+                continue;
+            }
+
+            std::size_t offset = 0;
+            for (std::size_t b = 0; b < Buckets; b++) {
+                const auto bucketCount = digitCounts[b];
+                digitCounts[b] = offset;
+                offset += bucketCount;
+            }
+
+            Scatter(sourceKeys, sourcePayloads, count, d, targetKeys, targetPayloads, digitCounts);
+            std::swap(sourceKeys, targetKeys);
+            std::swap(sourcePayloads, targetPayloads);
+        }
+
+        if (sourceKeys != outKeys) {
+            std::copy(sourceKeys, sourceKeys + count, outKeys);
+            std::copy(sourcePayloads, sourcePayloads + count, outPayloads);
+        }
+    }
+};
+
+// Out-of-class definitions, since 'std::min' binds 'BlockSize' by reference.
+template<typename T, typename Payload>
+constexpr std::size_t MortonNDRadixSort<T, Payload>::BlockSize;
+
+/**
+ * Computes the Morton codes of 'count' points stored in separate arrays (SoA), and sorts them,
+ * along with the index of each point.
+ *
+ * Points are encoded with 'engine.EncodeBatch' a block at a time, as part of the radix sort's
+ * first pass (see 'MortonNDRadixSort').
+ *
+ * Example:
+ *   using MortonND = MortonNDBmi_3D_64;
+ *   SortByMorton<3>(MortonNDStatic<MortonND>{}, {{ xs, ys, zs }}, count, codes, indices, 63);
+ *
+ * @param engine the Morton engine (see 'MortonNDStatic' for engines with static members).
+ * @param fields one array per dimension, each holding at least 'count' components.
+ * @param count the number of points.
+ * @param codes destination for the sorted codes.
+ * @param indices destination for the index of the point of each sorted code.
+ * @param keyBits the number of bits in each code ('Dimensions * FieldBits').
+ * @param threads the number of threads to use. 0 selects 'std::thread::hardware_concurrency()'.
+ */
+template<std::size_t Dimensions, typename Engine, typename T, typename Index>
+void SortByMorton(const Engine& engine, const std::array<const T*, Dimensions>& fields, std::size_t count,
+    T* codes, Index* indices, std::size_t keyBits = std::size_t(std::numeric_limits<T>::digits), std::size_t threads = 0)
+{
+    MortonNDRadixSort<T, Index>::Sort(codes, indices, count, keyBits, threads,
+        [&](std::size_t first, std::size_t n, T* blockCodes, Index* blockIndices) {
+            std::array<const T*, Dimensions> blockFields;
+            for (std::size_t d = 0; d < Dimensions; d++) {
+                blockFields[d] = fields[d] + first;
+            }
+
+            engine.EncodeBatch(blockFields, blockCodes, n);
+            for (std::size_t i = 0; i < n; i++) {
+                blockIndices[i] = Index(first + i);
+            }
+        });
+}
+
+/**
+ * Computes the Morton codes of 'count' points stored as records (AoS), and sorts them, along
+ * with the index of each point.
+ *
+ * @param engine the Morton engine (see 'MortonNDStatic' for engines with static members).
+ * @param points the first component of the first point.
+ * @param stride the distance (in elements of 'T') between consecutive points. Must be >= 'Dimensions'.
+ * @param count the number of points.
+ * @param codes destination for the sorted codes.
+ * @param indices destination for the index of the point of each sorted code.
+ * @param keyBits the number of bits in each code ('Dimensions * FieldBits').
+ * @param threads the number of threads to use. 0 selects 'std::thread::hardware_concurrency()'.
+ */
+template<std::size_t Dimensions, typename Engine, typename T, typename Index>
+void SortByMorton(const Engine& engine, const T* points, std::size_t stride, std::size_t count,
+    T* codes, Index* indices, std::size_t keyBits = std::size_t(std::numeric_limits<T>::digits), std::size_t threads = 0)
+{
+    MortonNDRadixSort<T, Index>::Sort(codes, indices, count, keyBits, threads,
+        [&](std::size_t first, std::size_t n, T* blockCodes, Index* blockIndices) {
+            engine.EncodeBatch(points + first * stride, stride, blockCodes, n);
+            for (std::size_t i = 0; i < n; i++) {
+                blockIndices[i] = Index(first + i);
+            }
+        });
+}
+
+}
+
+#endif
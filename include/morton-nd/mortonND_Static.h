@@ -0,0 +1,40 @@
+//
+//  mortonND_Static.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_STATIC_H
+#define MORTON_ND_MORTONND_STATIC_H
+
+#include <utility>
+
+namespace mortonnd {
+
+/**
+ * Adapts an engine whose members are static (e.g. 'MortonNDBmi', 'MortonNDAuto') for use where
+ * an engine instance is expected (e.g. 'MortonNDQuantizer', 'SortByMorton').
+ *
+ * Example:
+ *   quantizer.EncodeBatch(MortonNDStatic<MortonNDBmi_3D_64>{}, points, 3, codes, count);
+ */
+template<typename Engine>
+struct MortonNDStatic
+{
+    template<typename... Args>
+    void EncodeBatch(Args&&... args) const
+    {
+        Engine::EncodeBatch(std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void DecodeBatch(Args&&... args) const
+    {
+        Engine::DecodeBatch(std::forward<Args>(args)...);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,637 @@
+//
+//  mortonND_Swizzle.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_SWIZZLE_H
+#define MORTON_ND_MORTONND_SWIZZLE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#define MORTON_ND_SWIZZLE_SSE2_ENABLED 1
+#include <emmintrin.h>
+#endif
+
+namespace mortonnd {
+
+/**
+ * How 'ToMorton' / 'FromMorton' write their output.
+ */
+enum class MortonNDStores
+{
+    /**
+     * 'Streaming' if the output is at least 'MortonNDStreamingBytes', 'Cached' otherwise.
+     */
+    Auto,
+
+    /**
+     * Regular stores. Best when the output is used soon after, and fits in the cache.
+     */
+    Cached,
+
+    /**
+     * Non-temporal (streaming) stores, which bypass the cache. Best for outputs much larger than
+     * the cache, since they avoid reading each destination line before it's overwritten, and
+     * evicting the input.
+     */
+    Streaming
+};
+
+/**
+ * The output size at which 'MortonNDStores::Auto' switches to streaming stores.
+ */
+constexpr std::size_t MortonNDStreamingBytes = std::size_t(8) << 20;
+
+namespace swizzle_detail {
+
+// The size of the tile buffer. A tile is the largest power-of-two square (cube) that fits.
+constexpr std::size_t TileBytes = std::size_t(16) << 10;
+
+inline bool IsPowerOfTwo(std::size_t value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+inline std::size_t Log2(std::size_t value)
+{
+    std::size_t bits = 0;
+    while ((std::size_t(1) << bits) < value) {
+        bits++;
+    }
+
+    return bits;
+}
+
+// The selector of each axis in the Morton layout of an array with 2^'bits[axis]' elements along
+// each axis. Bits are interleaved round-robin, and axes which run out of bits are skipped (the
+// layout of 'MortonNDMixedLayout'), so the layout is dense.
+template<std::size_t Dimensions>
+inline std::array<uint64_t, Dimensions> Selectors(const std::array<std::size_t, Dimensions>& bits)
+{
+    std::array<uint64_t, Dimensions> selectors{};
+    std::size_t offset = 0;
+    for (std::size_t level = 0; offset < 64; level++) {
+        const std::size_t start = offset;
+        for (std::size_t axis = 0; axis < Dimensions; axis++) {
+            if (bits[axis] > level) {
+                selectors[axis] |= uint64_t(1) << offset++;
+            }
+        }
+
+        if (offset == start) {
+            break;
+        }
+    }
+
+    return selectors;
+}
+
+// Deposits the LSbs of 'value' into the set bits of 'selector'.
+inline uint64_t Dilate(uint64_t value, uint64_t selector)
+{
+    uint64_t dilated = 0;
+    for (; selector != 0 && value != 0; selector &= selector - 1, value >>= 1) {
+        dilated |= (value & 1) ? selector & (~selector + 1) : 0;
+    }
+
+    return dilated;
+}
+
+// Adds dilated 'step' to dilated 'value' (see 'MortonNDArithmetic').
+inline uint64_t Add(uint64_t value, uint64_t step, uint64_t selector)
+{
+    return ((value | ~selector) + step) & selector;
+}
+
+// A group of rows of a tile: 2 (y, y + 1) in 2D, 4 ((y, z), (y + 1, z), (y, z + 1),
+// (y + 1, z + 1)) in 3D. In Morton order, 4 consecutive elements from each row of a group (a
+// "quad", starting at a multiple of 4) are contiguous: 2 elements from each row, in row order,
+// then the next 2 from each row.
+template<std::size_t Dimensions>
+struct Group
+{
+    static_assert(Dimensions == 2 || Dimensions == 3, "Only 2D and 3D arrays are supported.");
+    static constexpr std::size_t Rows = Dimensions == 2 ? 2 : 4;
+};
+
+// Moves the quad at 'x' of each row of a group between 'rows' and 'quad', a unit (2
+// elements) at a time.
+template<std::size_t Rows, std::size_t Size, bool Forward>
+inline void MoveQuad(unsigned char* const* rows, std::size_t x, unsigned char* quad)
+{
+    constexpr std::size_t Unit = 2 * Size;
+    for (std::size_t half = 0; half < 2; half++) {
+        for (std::size_t row = 0; row < Rows; row++) {
+            unsigned char* element = rows[row] + (x + 2 * half) * Size;
+            unsigned char* unit = quad + (half * Rows + row) * Unit;
+            if (Forward) {
+                std::memcpy(unit, element, Unit);
+            } else {
+                std::memcpy(element, unit, Unit);
+            }
+        }
+    }
+}
+
+#if MORTON_ND_SWIZZLE_SSE2_ENABLED
+// Interleaves the 'Unit'-byte units of 'a' and 'b': 'lo' and 'hi' are a0 b0 a1 b1 ...
+template<std::size_t Unit>
+inline void Interleave(__m128i a, __m128i b, __m128i& lo, __m128i& hi);
+
+template<>
+inline void Interleave<2>(__m128i a, __m128i b, __m128i& lo, __m128i& hi)
+{
+    lo = _mm_unpacklo_epi16(a, b);
+    hi = _mm_unpackhi_epi16(a, b);
+}
+
+template<>
+inline void Interleave<4>(__m128i a, __m128i b, __m128i& lo, __m128i& hi)
+{
+    lo = _mm_unpacklo_epi32(a, b);
+    hi = _mm_unpackhi_epi32(a, b);
+}
+
+template<>
+inline void Interleave<8>(__m128i a, __m128i b, __m128i& lo, __m128i& hi)
+{
+    lo = _mm_unpacklo_epi64(a, b);
+    hi = _mm_unpackhi_epi64(a, b);
+}
+
+template<>
+inline void Interleave<16>(__m128i a, __m128i b, __m128i& lo, __m128i& hi)
+{
+    lo = a;
+    hi = b;
+}
+
+// The inverse of 'Interleave'. Interleaving is a perfect shuffle of the 32 / 'Unit' units of
+// 'a' and 'b', which is the identity after log2(32 / 'Unit') applications, so it's inverted by
+// applying it once less than that.
+template<std::size_t Unit>
+inline void Deinterleave(__m128i a, __m128i b, __m128i& lo, __m128i& hi)
+{
+    lo = a;
+    hi = b;
+    for (std::size_t n = 1; (std::size_t(32) / Unit) >> (n + 1) != 0; n++) {
+        Interleave<Unit>(lo, hi, lo, hi);
+    }
+}
+
+// Moves 16 bytes of each row of a group (4 / 'Size' quads) between 'rows' and 'Rows' * 16
+// bytes of consecutive quads in 'quads', with SSE2 shuffles.
+template<std::size_t Rows, std::size_t Size, bool Forward>
+struct SimdChunk;
+
+template<std::size_t Size, bool Forward>
+struct SimdChunk<2, Size, Forward>
+{
+    static inline void Move(unsigned char* const* rows, std::size_t x, __m128i* quads)
+    {
+        constexpr std::size_t Unit = 2 * Size;
+        if (Forward) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[0] + x * Size));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[1] + x * Size));
+            Interleave<Unit>(a, b, quads[0], quads[1]);
+        } else {
+            __m128i a, b;
+            Deinterleave<Unit>(quads[0], quads[1], a, b);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rows[0] + x * Size), a);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rows[1] + x * Size), b);
+        }
+    }
+};
+
+template<std::size_t Size, bool Forward>
+struct SimdChunk<4, Size, Forward>
+{
+    static inline void Move(unsigned char* const* rows, std::size_t x, __m128i* quads)
+    {
+        constexpr std::size_t Unit = 2 * Size;
+        __m128i ab0, ab1, cd0, cd1;
+        if (Forward) {
+            __m128i in[4];
+            for (std::size_t row = 0; row < 4; row++) {
+                in[row] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[row] + x * Size));
+            }
+
+            Interleave<Unit>(in[0], in[1], ab0, ab1);
+            Interleave<Unit>(in[2], in[3], cd0, cd1);
+            Interleave<2 * Unit>(ab0, cd0, quads[0], quads[1]);
+            Interleave<2 * Unit>(ab1, cd1, quads[2], quads[3]);
+        } else {
+            __m128i out[4];
+            Deinterleave<2 * Unit>(quads[0], quads[1], ab0, cd0);
+            Deinterleave<2 * Unit>(quads[2], quads[3], ab1, cd1);
+            Deinterleave<Unit>(ab0, ab1, out[0], out[1]);
+            Deinterleave<Unit>(cd0, cd1, out[2], out[3]);
+            for (std::size_t row = 0; row < 4; row++) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(rows[row] + x * Size), out[row]);
+            }
+        }
+    }
+};
+#endif
+
+// True if groups are moved with 'SimdChunk' (a chunk is 16 / 'Size' elements of each row).
+template<std::size_t Size>
+struct UseSimd
+{
+#if MORTON_ND_SWIZZLE_SSE2_ENABLED
+    static constexpr bool value = Size <= 4;
+#else
+    static constexpr bool value = false;
+#endif
+};
+
+// The dilated steps within a tile, computed once per array.
+struct TileSteps
+{
+    std::size_t tile;
+
+    // The selectors of x, y and z (0 in 2D).
+    uint64_t x, y, z;
+
+    // The offsets of the 4 quads of a 16-element chunk (x = 0, 4, 8 and 12).
+    uint64_t quads[4];
+
+    // Steps of a quad, of a group's SIMD chunk (see 'MoveGroup'), and of a group along y and z.
+    uint64_t quadStep, chunkStep, yStep, zStep;
+};
+
+template<std::size_t Dimensions>
+inline TileSteps MakeTileSteps(std::size_t tileBits, std::size_t chunk)
+{
+    std::array<std::size_t, Dimensions> bits;
+    bits.fill(tileBits);
+    const auto selectors = Selectors(bits);
+
+    TileSteps steps;
+    steps.tile = std::size_t(1) << tileBits;
+    steps.x = selectors[0];
+    steps.y = selectors[1];
+    steps.z = Dimensions == 3 ? selectors[Dimensions - 1] : 0;
+    for (std::size_t quad = 0; quad < 4; quad++) {
+        steps.quads[quad] = Dilate(4 * quad, steps.x);
+    }
+
+    steps.quadStep = Dilate(4, steps.x);
+    steps.chunkStep = Dilate(chunk, steps.x);
+    steps.yStep = Dilate(2, steps.y);
+    steps.zStep = Dilate(2, steps.z);
+    return steps;
+}
+
+// Moves a group of rows of a tile between 'rows' and the tile's Morton buffer 'morton'. 'group'
+// is the (dilated) offset of the group's first element in the tile.
+template<std::size_t Rows, std::size_t Size, bool Forward>
+inline void MoveGroup(unsigned char* const* rows, unsigned char* morton, uint64_t group, const TileSteps& steps,
+    std::false_type /* simd */)
+{
+    uint64_t dx = 0;
+    for (std::size_t x = 0; x < steps.tile; x += 4, dx = Add(dx, steps.quadStep, steps.x)) {
+        MoveQuad<Rows, Size, Forward>(rows, x, morton + (dx | group) * Size);
+    }
+}
+
+template<std::size_t Rows, std::size_t Size, bool Forward>
+inline void MoveGroup(unsigned char* const* rows, unsigned char* morton, uint64_t group, const TileSteps& steps,
+    std::true_type /* simd */)
+{
+#if MORTON_ND_SWIZZLE_SSE2_ENABLED
+    // A chunk is 16 bytes of each row. Chunks start at multiples of 'Chunk' elements, so each
+    // quad's offset within its chunk can be OR-ed with the chunk's.
+    constexpr std::size_t Chunk = 16 / Size;
+    constexpr std::size_t Quads = Chunk / 4;
+    constexpr std::size_t QuadBytes = 4 * Rows * Size;
+
+    uint64_t dx = 0;
+    for (std::size_t x = 0; x < steps.tile; x += Chunk, dx = Add(dx, steps.chunkStep, steps.x)) {
+        // The chunk's quads, in order. A quad is either half of a register (8 bytes), or whole
+        // registers.
+        __m128i quads[Rows];
+        unsigned char* targets[Quads];
+        for (std::size_t quad = 0; quad < Quads; quad++) {
+            targets[quad] = morton + (dx | steps.quads[quad] | group) * Size;
+        }
+
+        if (!Forward) {
+            for (std::size_t quad = 0; quad < Quads; quad++) {
+                if (QuadBytes == 8) {
+                    quads[quad / 2] = quad % 2 == 0
+                        ? _mm_loadl_epi64(reinterpret_cast<const __m128i*>(targets[quad]))
+                        : _mm_castpd_si128(_mm_loadh_pd(_mm_castsi128_pd(quads[quad / 2]), reinterpret_cast<const double*>(targets[quad])));
+                } else {
+                    for (std::size_t part = 0; part < QuadBytes / 16; part++) {
+                        quads[quad * (QuadBytes / 16) + part] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(targets[quad] + 16 * part));
+                    }
+                }
+            }
+        }
+
+        SimdChunk<Rows, Size, Forward>::Move(rows, x, quads);
+
+        if (Forward) {
+            for (std::size_t quad = 0; quad < Quads; quad++) {
+                if (QuadBytes == 8) {
+                    if (quad % 2 == 0) {
+                        _mm_storel_epi64(reinterpret_cast<__m128i*>(targets[quad]), quads[quad / 2]);
+                    } else {
+                        _mm_storeh_pd(reinterpret_cast<double*>(targets[quad]), _mm_castsi128_pd(quads[quad / 2]));
+                    }
+                } else {
+                    for (std::size_t part = 0; part < QuadBytes / 16; part++) {
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(targets[quad] + 16 * part), quads[quad * (QuadBytes / 16) + part]);
+                    }
+                }
+            }
+        }
+    }
+#else
+    MoveGroup<Rows, Size, Forward>(rows, morton, group, steps, std::false_type{});
+#endif
+}
+
+// Moves a tile between the row-major array at 'rowMajor' (with the given pitches, in bytes) and
+// its Morton-ordered copy at 'morton'.
+template<std::size_t Dimensions, std::size_t Size, bool Forward>
+inline void MoveTile(unsigned char* rowMajor, std::size_t rowPitch, std::size_t slicePitch, unsigned char* morton,
+    const TileSteps& steps)
+{
+    constexpr std::size_t Rows = Group<Dimensions>::Rows;
+
+    uint64_t dz = 0;
+    for (std::size_t z = 0; z < (Dimensions == 3 ? steps.tile : 1); z += 2, dz = Add(dz, steps.zStep, steps.z)) {
+        uint64_t dy = 0;
+        for (std::size_t y = 0; y < steps.tile; y += 2, dy = Add(dy, steps.yStep, steps.y)) {
+            unsigned char* rows[Rows];
+            for (std::size_t row = 0; row < Rows; row++) {
+                rows[row] = rowMajor + (y + (row & 1)) * rowPitch + (z + (row >> 1)) * slicePitch;
+            }
+
+            MoveGroup<Rows, Size, Forward>(rows, morton, dy | dz, steps, std::integral_constant<bool, UseSimd<Size>::value>{});
+        }
+    }
+}
+
+// Copies 'bytes' (a multiple of 16) from 'source' to 'destination', with non-temporal stores if
+// 'destination' is 16-byte aligned.
+inline void Stream(unsigned char* destination, const unsigned char* source, std::size_t bytes)
+{
+#if MORTON_ND_SWIZZLE_SSE2_ENABLED
+    if ((reinterpret_cast<std::uintptr_t>(destination) & 15) == 0) {
+        for (std::size_t offset = 0; offset < bytes; offset += 16) {
+            _mm_stream_si128(reinterpret_cast<__m128i*>(destination + offset),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset)));
+        }
+
+        return;
+    }
+#endif
+
+    std::memcpy(destination, source, bytes);
+}
+
+inline void StreamFence()
+{
+#if MORTON_ND_SWIZZLE_SSE2_ENABLED
+    _mm_sfence();
+#endif
+}
+
+// Moves every element of a row-major array individually. Used when the array is too thin for
+// tiles (an extent below a tile's width).
+template<std::size_t Dimensions, std::size_t Size, bool Forward>
+inline void MoveElements(unsigned char* rowMajor, const std::array<std::size_t, Dimensions>& extents,
+    std::size_t rowPitch, std::size_t slicePitch, unsigned char* morton, const std::array<uint64_t, Dimensions>& selectors)
+{
+    const std::size_t depth = Dimensions == 3 ? extents[Dimensions - 1] : 1;
+    const uint64_t zSelector = Dimensions == 3 ? selectors[Dimensions - 1] : 0;
+
+    uint64_t dz = 0;
+    for (std::size_t z = 0; z < depth; z++, dz = Add(dz, Dilate(1, zSelector), zSelector)) {
+        uint64_t dy = 0;
+        for (std::size_t y = 0; y < extents[1]; y++, dy = Add(dy, Dilate(1, selectors[1]), selectors[1])) {
+            unsigned char* row = rowMajor + y * rowPitch + z * slicePitch;
+            uint64_t dx = 0;
+            for (std::size_t x = 0; x < extents[0]; x++, dx = Add(dx, Dilate(1, selectors[0]), selectors[0])) {
+                unsigned char* element = morton + (dx | dy | dz) * Size;
+                if (Forward) {
+                    std::memcpy(element, row + x * Size, Size);
+                } else {
+                    std::memcpy(row + x * Size, element, Size);
+                }
+            }
+        }
+    }
+}
+
+template<std::size_t Dimensions, std::size_t Size, bool Forward>
+inline void Swizzle(unsigned char* rowMajor, const std::array<std::size_t, Dimensions>& extents,
+    const std::array<std::size_t, Dimensions - 1>& pitches, unsigned char* morton, MortonNDStores stores)
+{
+    static_assert(Dimensions == 2 || Dimensions == 3, "Only 2D and 3D arrays are supported.");
+
+    std::array<std::size_t, Dimensions> bits;
+    std::size_t count = 1;
+    for (std::size_t axis = 0; axis < Dimensions; axis++) {
+        if (!IsPowerOfTwo(extents[axis])) {
+            throw std::invalid_argument("Extents must be powers of 2.");
+        }
+
+        bits[axis] = Log2(extents[axis]);
+        count *= extents[axis];
+        if (axis > 0 && pitches[axis - 1] < (axis == 1 ? extents[0] : pitches[0] * extents[1])) {
+            throw std::invalid_argument("Pitches must be >= the size of a row / slice.");
+        }
+    }
+
+    const std::size_t rowPitch = pitches[0] * Size;
+    const std::size_t slicePitch = Dimensions == 3 ? pitches[Dimensions - 2] * Size : 0;
+    const auto selectors = Selectors(bits);
+
+    // The tile is the largest cube which fits in the buffer and the array. Groups take quads of
+    // 4 elements (or SIMD chunks of 16 bytes) from each row.
+    std::size_t tileBits = *std::min_element(bits.begin(), bits.end());
+    while (tileBits > 0 && (Size << (Dimensions * tileBits)) > TileBytes) {
+        tileBits--;
+    }
+
+    const std::size_t minTile = UseSimd<Size>::value ? 16 / Size : 4;
+    const std::size_t tile = std::size_t(1) << tileBits;
+    if (tile < minTile) {
+        MoveElements<Dimensions, Size, Forward>(rowMajor, extents, rowPitch, slicePitch, morton, selectors);
+        return;
+    }
+
+    const auto steps = MakeTileSteps<Dimensions>(tileBits, minTile);
+    const std::size_t tileBytes = Size << (Dimensions * tileBits);
+
+    // Unswizzled tiles are streamed out a row at a time, which only pays off for whole cache
+    // lines (write-combining buffers are flushed partially otherwise).
+    const bool streaming = (stores == MortonNDStores::Streaming
+        || (stores == MortonNDStores::Auto && count * Size >= MortonNDStreamingBytes))
+        && (Forward || tile * Size >= 64);
+    alignas(16) unsigned char buffer[TileBytes];
+
+    const std::size_t depth = Dimensions == 3 ? extents[Dimensions - 1] : 1;
+    const uint64_t zSelector = Dimensions == 3 ? selectors[Dimensions - 1] : 0;
+    const uint64_t zStep = Dilate(Dimensions == 3 ? tile : 0, zSelector);
+    const uint64_t yStep = Dilate(tile, selectors[1]);
+    const uint64_t xStep = Dilate(tile, selectors[0]);
+
+    uint64_t dz = 0;
+    for (std::size_t z = 0; z < depth; z += (Dimensions == 3 ? tile : 1), dz = Add(dz, zStep, zSelector)) {
+        uint64_t dy = 0;
+        for (std::size_t y = 0; y < extents[1]; y += tile, dy = Add(dy, yStep, selectors[1])) {
+            uint64_t dx = 0;
+            for (std::size_t x = 0; x < extents[0]; x += tile, dx = Add(dx, xStep, selectors[0])) {
+                unsigned char* tileRows = rowMajor + x * Size + y * rowPitch + z * slicePitch;
+                unsigned char* tileMorton = morton + (dx | dy | dz) * Size;
+
+                if (!streaming) {
+                    MoveTile<Dimensions, Size, Forward>(tileRows, rowPitch, slicePitch, tileMorton, steps);
+                } else if (Forward) {
+                    MoveTile<Dimensions, Size, true>(tileRows, rowPitch, slicePitch, buffer, steps);
+                    Stream(tileMorton, buffer, tileBytes);
+                } else {
+                    // Unswizzle into a row-major tile, then stream each of its rows out.
+                    const std::size_t tileRow = tile * Size;
+                    MoveTile<Dimensions, Size, false>(buffer, tileRow, tileRow * tile, tileMorton, steps);
+                    for (std::size_t row = 0; row < (Dimensions == 3 ? tile * tile : tile); row++) {
+                        Stream(tileRows + (row % tile) * rowPitch + (row / tile) * slicePitch, buffer + row * tileRow, tileRow);
+                    }
+                }
+            }
+        }
+    }
+
+    if (streaming) {
+        StreamFence();
+    }
+}
+
+template<typename T>
+struct CheckElement
+{
+    static_assert(std::is_trivially_copyable<T>::value, "'T' must be trivially copyable.");
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8 || sizeof(T) == 16,
+        "'T' must be 1, 2, 4, 8 or 16 bytes.");
+    static constexpr bool value = true;
+};
+
+} // namespace swizzle_detail
+
+/**
+ * Copies a row-major 2D or 3D array into Morton order ("swizzles" it).
+ *
+ * The element at (x, y[, z]) is copied to the index given by interleaving the bits of its
+ * coordinates round-robin, starting with x. Each extent must be a power of 2, but extents may
+ * differ: once an axis runs out of bits, it's skipped (the layout of 'MortonNDMixedLayout'), so
+ * 'destination' is dense. For square (cubic) arrays, this is the layout produced by every
+ * other engine, e.g. 'MortonNDBmi_2D_32::Encode(x, y)'.
+ *
+ * The array is moved a tile (the largest square or cube of at most 16 KiB) at a time. Each tile
+ * is contiguous in Morton order, and its base index is computed once, and then advanced with
+ * dilated additions (see 'MortonNDArithmetic'), as are the offsets of each element group within
+ * the tile. With SSE2, elements of 1, 2 or 4 bytes are interleaved with 16-byte loads and
+ * unpacks, and larger elements are moved as 2-element units (16 or 32 bytes). With streaming
+ * stores (see 'MortonNDStores'), each tile is swizzled in a buffer, and then written with
+ * non-temporal stores.
+ *
+ * Example:
+ *   // A 4096 x 4096 RGBA8 texture.
+ *   mortonnd::ToMorton<2>(pixels.data(), swizzled.data(), {{ 4096, 4096 }});
+ *
+ * @tparam Dimensions 2 or 3.
+ * @tparam T the element type: trivially copyable, of 1, 2, 4, 8 or 16 bytes.
+ * @param source the row-major array (x varies fastest).
+ * @param destination the Morton-ordered output, of 'extents[0] * ... * extents[Dimensions - 1]'
+ *        elements. Must not overlap 'source'.
+ * @param extents the number of elements along each axis (powers of 2).
+ * @param pitches the number of elements between the starts of consecutive rows (and slices, in
+ *        3D) of 'source'.
+ * @param stores whether to write 'destination' with streaming stores.
+ * @throws std::invalid_argument if an extent isn't a power of 2, or a pitch is too small.
+ */
+template<std::size_t Dimensions, typename T>
+inline void ToMorton(const T* source, T* destination, const std::array<std::size_t, Dimensions>& extents,
+    const std::array<std::size_t, Dimensions - 1>& pitches, MortonNDStores stores = MortonNDStores::Auto)
+{
+    static_assert(swizzle_detail::CheckElement<T>::value, "");
+    swizzle_detail::Swizzle<Dimensions, sizeof(T), true>(
+        reinterpret_cast<unsigned char*>(const_cast<T*>(source)), extents, pitches,
+        reinterpret_cast<unsigned char*>(destination), stores);
+}
+
+/**
+ * Copies a dense row-major 2D or 3D array into Morton order (see 'ToMorton' above).
+ */
+template<std::size_t Dimensions, typename T>
+inline void ToMorton(const T* source, T* destination, const std::array<std::size_t, Dimensions>& extents,
+    MortonNDStores stores = MortonNDStores::Auto)
+{
+    std::array<std::size_t, Dimensions - 1> pitches;
+    std::size_t pitch = 1;
+    for (std::size_t axis = 0; axis + 1 < Dimensions; axis++) {
+        pitch *= extents[axis];
+        pitches[axis] = pitch;
+    }
+
+    ToMorton<Dimensions>(source, destination, extents, pitches, stores);
+}
+
+/**
+ * Copies a Morton-ordered 2D or 3D array (as produced by 'ToMorton') into row-major order
+ * ("unswizzles" it).
+ *
+ * @tparam Dimensions 2 or 3.
+ * @tparam T the element type: trivially copyable, of 1, 2, 4, 8 or 16 bytes.
+ * @param source the Morton-ordered array.
+ * @param destination the row-major output (x varies fastest). Must not overlap 'source'.
+ * @param extents the number of elements along each axis (powers of 2).
+ * @param pitches the number of elements between the starts of consecutive rows (and slices, in
+ *        3D) of 'destination'.
+ * @param stores whether to write 'destination' with streaming stores.
+ * @throws std::invalid_argument if an extent isn't a power of 2, or a pitch is too small.
+ */
+template<std::size_t Dimensions, typename T>
+inline void FromMorton(const T* source, T* destination, const std::array<std::size_t, Dimensions>& extents,
+    const std::array<std::size_t, Dimensions - 1>& pitches, MortonNDStores stores = MortonNDStores::Auto)
+{
+    static_assert(swizzle_detail::CheckElement<T>::value, "");
+    swizzle_detail::Swizzle<Dimensions, sizeof(T), false>(
+        reinterpret_cast<unsigned char*>(destination), extents, pitches,
+        reinterpret_cast<unsigned char*>(const_cast<T*>(source)), stores);
+}
+
+/**
+ * Copies a Morton-ordered 2D or 3D array into a dense row-major array (see 'FromMorton' above).
+ */
+template<std::size_t Dimensions, typename T>
+inline void FromMorton(const T* source, T* destination, const std::array<std::size_t, Dimensions>& extents,
+    MortonNDStores stores = MortonNDStores::Auto)
+{
+    std::array<std::size_t, Dimensions - 1> pitches;
+    std::size_t pitch = 1;
+    for (std::size_t axis = 0; axis + 1 < Dimensions; axis++) {
+        pitch *= extents[axis];
+        pitches[axis] = pitch;
+    }
+
+    FromMorton<Dimensions>(source, destination, extents, pitches, stores);
+}
+
+} // namespace mortonnd
+
+#endif // MORTON_ND_MORTONND_SWIZZLE_H
@@ -0,0 +1,273 @@
+//
+//  mortonND_UInt.h
+//  morton-nd
+//
+//  Copyright (c) 2015 Kevin Hartman.
+//
+
+#ifndef MORTON_ND_MORTONND_UINT_H
+#define MORTON_ND_MORTONND_UINT_H
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace mortonnd {
+
+/**
+ * A fixed-width unsigned integer of 'Bits' bits, stored as an array of 64-bit words
+ * (least-significant word first).
+ *
+ * This is intended for Morton codes which are too wide for native integer types (e.g. 8D x
+ * 32-bit fields => 256-bit codes), and can be used as 'T' with 'MortonNDLutEncoder',
+ * 'MortonNDLutDecoder' and 'MortonNDBmi'. Each engine specializes on this type, moving bits
+ * directly into (or out of) the word they belong to with 'OrBits' / 'GetBits', rather than
+ * shifting the whole value with the generic operators.
+ *
+ * All operators are constexpr. Bits above 'Bits' are always 0.
+ *
+ * @tparam Bits the width of the integer, in bits.
+ */
+template<std::size_t Bits>
+class UInt
+{
+    static_assert(Bits > 0, "'Bits' must be > 0.");
+
+public:
+    static constexpr std::size_t WordBits = 64;
+    static constexpr std::size_t WordCount = (Bits + WordBits - 1) / WordBits;
+
+    constexpr UInt() : words{} {}
+
+    constexpr UInt(uint64_t value) : words{}
+    {
+        words[0] = value;
+        Normalize();
+    }
+
+    /**
+     * Returns the least-significant 'std::size_t' bits (as required by the LUT engine for lookups).
+     */
+    explicit constexpr operator std::size_t() const
+    {
+        return static_cast<std::size_t>(words[0]);
+    }
+
+    /**
+     * Returns word 'index' (0 is the least-significant).
+     */
+    constexpr uint64_t Word(std::size_t index) const
+    {
+        return words[index];
+    }
+
+    /**
+     * Sets word 'index' (0 is the least-significant) to 'value'.
+     */
+    constexpr void SetWord(std::size_t index, uint64_t value)
+    {
+        words[index] = value;
+        Normalize();
+    }
+
+    /**
+     * Returns the 'Width' bits starting at bit 'Offset', in the LSbs of the result.
+     *
+     * Since 'Offset' and 'Width' are known at compile-time, this reads at most 2 words.
+     */
+    template<std::size_t Offset, std::size_t Width>
+    constexpr uint64_t GetBits() const
+    {
+        static_assert(Width <= WordBits, "'Width' must be <= 64.");
+        return Width == 0 || Offset >= Bits ? 0 : LowMask(Width) & (
+            (words[Offset / WordBits] >> (Offset % WordBits)) |
+            (Offset % WordBits != 0 && Offset / WordBits + 1 < WordCount
+                ? words[Offset / WordBits + 1] << (WordBits - Offset % WordBits)
+                : 0));
+    }
+
+    /**
+     * ORs the 'Width' LSbs of 'value' into this integer, starting at bit 'Offset'.
+     *
+     * Since 'Offset' and 'Width' are known at compile-time, this writes at most 2 words.
+     * Bits of 'value' above 'Width' must be 0.
+     */
+    template<std::size_t Offset, std::size_t Width>
+    constexpr void OrBits(uint64_t value)
+    {
+        static_assert(Width <= WordBits, "'Width' must be <= 64.");
+        static_assert(Width == 0 || Offset < Bits, "'Offset' must be < 'Bits'.");
+
+        if (Width == 0) {
+            return;
+        }
+
+        words[Offset / WordBits] |= value << (Offset % WordBits);
+        if (Offset % WordBits != 0 && Offset % WordBits + Width > WordBits && Offset / WordBits + 1 < WordCount) {
+            words[Offset / WordBits + 1] |= value >> (WordBits - Offset % WordBits);
+        }
+
+        Normalize();
+    }
+
+    constexpr UInt& operator|=(const UInt& other)
+    {
+        for (std::size_t i = 0; i < WordCount; i++) {
+            words[i] |= other.words[i];
+        }
+
+        return *this;
+    }
+
+    constexpr UInt& operator&=(const UInt& other)
+    {
+        for (std::size_t i = 0; i < WordCount; i++) {
+            words[i] &= other.words[i];
+        }
+
+        return *this;
+    }
+
+    constexpr UInt& operator^=(const UInt& other)
+    {
+        for (std::size_t i = 0; i < WordCount; i++) {
+            words[i] ^= other.words[i];
+        }
+
+        return *this;
+    }
+
+    constexpr UInt& operator<<=(std::size_t shift)
+    {
+        const auto wordShift = shift / WordBits;
+        const auto bitShift = shift % WordBits;
+
+        for (std::size_t i = WordCount; i-- > 0;) {
+            uint64_t word = 0;
+            if (i >= wordShift) {
+                word = words[i - wordShift] << bitShift;
+                if (bitShift != 0 && i > wordShift) {
+                    word |= words[i - wordShift - 1] >> (WordBits - bitShift);
+                }
+            }
+
+            words[i] = word;
+        }
+
+        Normalize();
+        return *this;
+    }
+
+    constexpr UInt& operator>>=(std::size_t shift)
+    {
+        const auto wordShift = shift / WordBits;
+        const auto bitShift = shift % WordBits;
+
+        for (std::size_t i = 0; i < WordCount; i++) {
+            uint64_t word = 0;
+            if (i + wordShift < WordCount) {
+                word = words[i + wordShift] >> bitShift;
+                if (bitShift != 0 && i + wordShift + 1 < WordCount) {
+                    word |= words[i + wordShift + 1] << (WordBits - bitShift);
+                }
+            }
+
+            words[i] = word;
+        }
+
+        return *this;
+    }
+
+    constexpr UInt operator~() const
+    {
+        UInt result;
+        for (std::size_t i = 0; i < WordCount; i++) {
+            result.words[i] = ~words[i];
+        }
+
+        result.Normalize();
+        return result;
+    }
+
+    friend constexpr UInt operator|(UInt lhs, const UInt& rhs) { return lhs |= rhs; }
+    friend constexpr UInt operator&(UInt lhs, const UInt& rhs) { return lhs &= rhs; }
+    friend constexpr UInt operator^(UInt lhs, const UInt& rhs) { return lhs ^= rhs; }
+    friend constexpr UInt operator<<(UInt lhs, std::size_t shift) { return lhs <<= shift; }
+    friend constexpr UInt operator>>(UInt lhs, std::size_t shift) { return lhs >>= shift; }
+
+    friend constexpr bool operator==(const UInt& lhs, const UInt& rhs)
+    {
+        for (std::size_t i = 0; i < WordCount; i++) {
+            if (lhs.words[i] != rhs.words[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    friend constexpr bool operator<(const UInt& lhs, const UInt& rhs)
+    {
+        for (std::size_t i = WordCount; i-- > 0;) {
+            if (lhs.words[i] != rhs.words[i]) {
+                return lhs.words[i] < rhs.words[i];
+            }
+        }
+
+        return false;
+    }
+
+    friend constexpr bool operator!=(const UInt& lhs, const UInt& rhs) { return !(lhs == rhs); }
+    friend constexpr bool operator>(const UInt& lhs, const UInt& rhs) { return rhs < lhs; }
+    friend constexpr bool operator<=(const UInt& lhs, const UInt& rhs) { return !(rhs < lhs); }
+    friend constexpr bool operator>=(const UInt& lhs, const UInt& rhs) { return !(lhs < rhs); }
+
+private:
+    static constexpr uint64_t LowMask(std::size_t width)
+    {
+        return width >= WordBits ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+    }
+
+    // Clears the bits of the most-significant word above 'Bits'.
+    constexpr void Normalize()
+    {
+        words[WordCount - 1] &= LowMask(Bits - (WordCount - 1) * WordBits);
+    }
+
+    uint64_t words[WordCount];
+};
+
+/**
+ * Trait for detecting 'UInt', used by the engines to select their multi-word paths.
+ */
+template<typename T>
+struct IsUInt : std::false_type {};
+
+template<std::size_t Bits>
+struct IsUInt<UInt<Bits>> : std::true_type {};
+
+}
+
+namespace std {
+
+template<std::size_t Bits>
+class numeric_limits<mortonnd::UInt<Bits>>
+{
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = false;
+    static constexpr bool is_integer = true;
+    static constexpr bool is_exact = true;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = true;
+    static constexpr int digits = static_cast<int>(Bits);
+    static constexpr int radix = 2;
+
+    static constexpr mortonnd::UInt<Bits> min() noexcept { return mortonnd::UInt<Bits>(); }
+    static constexpr mortonnd::UInt<Bits> lowest() noexcept { return mortonnd::UInt<Bits>(); }
+    static constexpr mortonnd::UInt<Bits> max() noexcept { return ~mortonnd::UInt<Bits>(); }
+};
+
+}
+
+#endif
@@ -4,6 +4,27 @@
 #include "mortonND_test.h"
 #include "mortonND_LUT_test.h"
 #include "mortonND_BMI2_test.h"
+#include "mortonND_Magic_test.h"
+#include "mortonND_Auto_test.h"
+#include "mortonND_UInt_test.h"
+#include "mortonND_Range_test.h"
+#include "mortonND_Arithmetic_test.h"
+#include "mortonND_Neighbors_test.h"
+#include "mortonND_Hilbert_test.h"
+#include "mortonND_Mixed_test.h"
+#include "mortonND_Pattern_test.h"
+#include "mortonND_Quantize_test.h"
+#include "mortonND_Sort_test.h"
+#include "mortonND_External_test.h"
+#include "mortonND_PointFile_test.h"
+#include "mortonND_Pack_test.h"
+#include "mortonND_Array_test.h"
+#include "mortonND_Swizzle_test.h"
+#include "mortonND_Matrix_test.h"
+#include "mortonND_Octree_test.h"
+#include "mortonND_BVH_test.h"
+#include "mortonND_LocCode_test.h"
+#include "mortonND_Nearest_test.h"
 
 #include <iostream>
 
@@ -11,7 +32,54 @@ auto test_methods = std::vector<test_method>{
     test_method(&mortonnd_lut::TestEncode, "Test LUT encoder configurations (dimension, field size, LUT entry size)."),
     test_method(&mortonnd_bmi2::TestEncode, "Test BMI2 encoder configurations (dimension, field size)."),
     test_method(&mortonnd_bmi2::TestDecode, "Test BMI2 decoder configurations (dimension, field size)."),
-    test_method(&mortonnd_lut::TestDecode, "Test LUT decoder configurations (dimension, field size, LUT entry size).")
+    test_method(&mortonnd_bmi2::TestBatch, "Test BMI2 batch encoder/decoder configurations (dimension, field size, layout)."),
+    test_method(&mortonnd_bmi2::TestWide, "Test 128-bit BMI2 encoder/decoder configurations (dimension)."),
+    test_method(&mortonnd_lut::TestDecode, "Test LUT decoder configurations (dimension, field size, LUT entry size)."),
+    test_method(&mortonnd_magic::TestEncode, "Test magic bits encoder configurations (dimension, field size)."),
+    test_method(&mortonnd_magic::TestDecode, "Test magic bits decoder configurations (dimension, field size)."),
+    test_method(&mortonnd_auto::TestEncode, "Test auto (run-time dispatch) encoder configurations (dimension, field size)."),
+    test_method(&mortonnd_auto::TestDecode, "Test auto (run-time dispatch) decoder configurations (dimension, field size)."),
+    test_method(&mortonnd_auto::TestEngines, "Test each auto (run-time dispatch) engine supported by this CPU (dimension, field size, layout)."),
+    test_method(&mortonnd_uint::TestOperators, "Test UInt operators (width)."),
+    test_method(&mortonnd_uint::TestLut, "Test UInt LUT encoder/decoder configurations (dimension, field size, LUT entry size)."),
+    test_method(&mortonnd_uint::TestBmi, "Test UInt BMI2 encoder/decoder configurations (dimension, width)."),
+    test_method(&mortonnd_range::TestBigMinLitMax, "Test BIGMIN / LITMAX against exhaustive scans (dimension, field size)."),
+    test_method(&mortonnd_range::TestQuery, "Test box queries over sorted codes (dimension, field size)."),
+    test_method(&mortonnd_range::TestDecompose, "Test box-to-interval decomposition against exhaustive scans (dimension, field size)."),
+    test_method(&mortonnd_arithmetic::TestAxis, "Test per-axis dilated arithmetic against decode / encode (dimension, field size)."),
+    test_method(&mortonnd_arithmetic::TestCodes, "Test per-field addition / subtraction of codes (dimension, field size)."),
+    test_method(&mortonnd_neighbors::TestFace, "Test batched face neighbors (dimension, field size, engine)."),
+    test_method(&mortonnd_neighbors::TestAll, "Test batched face, edge and corner neighbors (dimension, field size, engine)."),
+    test_method(&mortonnd_hilbert::TestCurve, "Test Hilbert curve continuity against exhaustive scans (dimension, field size)."),
+    test_method(&mortonnd_hilbert::TestRoundTrip, "Test Hilbert encoder/decoder configurations (dimension, field size)."),
+    test_method(&mortonnd_mixed::TestEncodeDecode, "Test mixed-width BMI2 / LUT encoder/decoder configurations (field sizes, LUT entry size)."),
+    test_method(&mortonnd_mixed::TestUniform, "Test mixed-width BMI2 encoders/decoders against single-width configurations (dimension)."),
+    test_method(&mortonnd_pattern::TestEncodeDecode, "Test bit pattern BMI2 / LUT encoder/decoder configurations (pattern, LUT entry size)."),
+    test_method(&mortonnd_quantize::TestOrderedKeys, "Test order-preserving keys for signed integers and floats (type)."),
+    test_method(&mortonnd_quantize::TestBatch, "Test fused quantize + encode / decode + dequantize configurations (dimension, input type, field size, engine)."),
+    test_method(&mortonnd_sort::TestRadixSort, "Test parallel radix sort against std::stable_sort (key width, count, distribution, threads)."),
+    test_method(&mortonnd_sort::TestSortByMorton, "Test fused encode + sort against std::stable_sort (dimension, field size, engine, threads)."),
+    test_method(&mortonnd_external::TestSortFile, "Test external (out-of-core) file sort against std::stable_sort (count, memory budget, output format)."),
+    test_method(&mortonnd_pointfile::TestRoundTrip, "Test point file writer / reader round trips (count, codec, block size)."),
+    test_method(&mortonnd_pointfile::TestQuery, "Test point file box queries against exhaustive scans (codec, block size, decomposition)."),
+    test_method(&mortonnd_pack::TestRoundTrip, "Test delta + bit-packed code sequences (code width, count, gap size)."),
+    test_method(&mortonnd_pack::TestWidths, "Test delta + bit-packed code sequences at every delta width (code type)."),
+    test_method(&mortonnd_array::TestIndexing, "Test Z-order array indexing, iteration and bounds checks (dimension, field size, tile size)."),
+    test_method(&mortonnd_array::TestCursor, "Test Z-order array cursor steps against re-encoding (dimension, field size, tile size)."),
+    test_method(&mortonnd_swizzle::TestToMorton, "Test row-major to Morton swizzling against mixed-width encoders (dimension, extents, element size, pitch, stores)."),
+    test_method(&mortonnd_swizzle::TestRoundTrip, "Test swizzle / unswizzle round trips (dimension, extents, element size, pitch, stores)."),
+    test_method(&mortonnd_matrix::TestLayout, "Test Morton-tiled matrix indexing and row-major conversions (dimensions, tile size, pitch)."),
+    test_method(&mortonnd_matrix::TestKernels, "Test Morton-tiled matrix transpose and multiply-add against naive loops (dimensions, tile size, element type)."),
+    test_method(&mortonnd_octree::TestBuild, "Test parallel linear octree construction against binary searches of the codes (dimension, count, leaf size, threads)."),
+    test_method(&mortonnd_octree::TestBalance, "Test 2:1 octree balancing against exhaustive leaf pair checks (dimension, count, leaf size, threads)."),
+    test_method(&mortonnd_octree::TestLocate, "Test octree point location (with and without hints) against exhaustive node scans (dimension, balance)."),
+    test_method(&mortonnd_bvh::TestBuild, "Test parallel LBVH construction against sorted codes and radix tree splits (dimension, count, engine, threads)."),
+    test_method(&mortonnd_bvh::TestQuery, "Test LBVH box overlap queries against exhaustive scans (dimension, count)."),
+    test_method(&mortonnd_loccode::TestCells, "Test locational code parent / child / sibling / common ancestor / range helpers against coordinates (dimension, field size, sentinel)."),
+    test_method(&mortonnd_loccode::TestExhaustive, "Test locational codes of every cell of small grids for uniqueness and containment (dimension, sentinel)."),
+    test_method(&mortonnd_nearest::TestNearest, "Test exact k-nearest-neighbor queries against brute force (dimension, field size, k, duplicates)."),
+    test_method(&mortonnd_nearest::TestBatch, "Test batched k-nearest-neighbor queries of unsorted queries against brute force (dimension, k)."),
+    test_method(&mortonnd_lut::TestBatch, "Test LUT batch encoder/decoder configurations (dimension, field size, LUT entry size).")
 };
 
 int main(int argc, const char *argv[]) {
@@ -0,0 +1,155 @@
+#include "mortonND_Arithmetic_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_Arithmetic.h>
+#include <morton-nd/mortonND_Magic.h>
+
+#include <array>
+#include <iostream>
+#include <random>
+
+// Arithmetic must be usable in constant expressions.
+static_assert(mortonnd::MortonNDArithmetic_3D_32::IncAxis<1>(mortonnd::MortonNDMagic_3D_32::Encode(9, 5, 1))
+    == mortonnd::MortonNDMagic_3D_32::Encode(9, 6, 1), "Unexpected constexpr increment.");
+static_assert(mortonnd::MortonNDArithmetic_3D_32::AddCodes(mortonnd::MortonNDMagic_3D_32::Encode(9, 5, 1), mortonnd::MortonNDMagic_3D_32::Encode(1, 2, 3))
+    == mortonnd::MortonNDMagic_3D_32::Encode(10, 7, 4), "Unexpected constexpr addition.");
+
+template<size_t Fields, typename T, size_t FieldBits>
+static std::array<T, Fields> RandomFields(std::mt19937_64& rng) {
+    std::array<T, Fields> fields;
+    for (auto& field : fields) {
+        field = T(rng());
+        if (std::numeric_limits<T>::digits > 64) {
+            field = (field << (std::numeric_limits<T>::digits > 64 ? 64 : 0)) | T(rng());
+        }
+        field &= (T(1) << (FieldBits - 1) << 1) - 1;
+    }
+
+    return fields;
+}
+
+template<size_t Fields, typename T, size_t FieldBits>
+static T EncodeFields(const std::array<T, Fields>& fields) {
+    using Magic = mortonnd::MortonNDMagic<Fields, T, FieldBits>;
+
+    T code = 0;
+    for (size_t f = 0; f < Fields; f++) {
+        code |= Magic::Dilate(fields[f]) << f;
+    }
+
+    return code;
+}
+
+template<size_t Fields, typename T, size_t FieldBits, size_t Field>
+static bool TestMortonNDArithmeticField(std::mt19937_64& rng) {
+    using Arithmetic = mortonnd::MortonNDArithmetic<Fields, T, FieldBits>;
+    static const T FieldMask = (T(1) << (FieldBits - 1) << 1) - 1;
+
+    bool ok = true;
+    for (size_t n = 0; n < 1000; n++) {
+        auto fields = RandomFields<Fields, T, FieldBits>(rng);
+        const T code = EncodeFields<Fields, T, FieldBits>(fields);
+
+        // Include the edges of the field, to check wrap-around.
+        if (n % 4 == 0) {
+            fields[Field] = n % 8 == 0 ? 0 : FieldMask;
+        }
+        const T edgeCode = EncodeFields<Fields, T, FieldBits>(fields);
+        const T delta = RandomFields<1, T, FieldBits>(rng)[0] >> (n % FieldBits);
+
+        auto expect = [&](T field) {
+            auto modified = fields;
+            modified[Field] = field & FieldMask;
+            return EncodeFields<Fields, T, FieldBits>(modified);
+        };
+
+        ok &= Arithmetic::template IncAxis<Field>(edgeCode) == expect(fields[Field] + 1);
+        ok &= Arithmetic::template DecAxis<Field>(edgeCode) == expect(fields[Field] - 1);
+        ok &= Arithmetic::template AddAxis<Field>(edgeCode, delta) == expect(fields[Field] + delta);
+        ok &= Arithmetic::template SubAxis<Field>(edgeCode, delta) == expect(fields[Field] - delta);
+        ok &= Arithmetic::template AddAxis<Field>(edgeCode, T(0) - delta) == expect(fields[Field] - delta);
+        ok &= Arithmetic::template AddDilated<Field>(edgeCode, Arithmetic::template DilateAxis<Field>(delta)) == expect(fields[Field] + delta);
+        ok &= Arithmetic::template AddAxis<Field>(code, 0) == code;
+
+        if (!ok) {
+            std::cout << "  Mismatch for field " << Field << " of code " << uint64_t(edgeCode) << ", delta " << uint64_t(delta) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<size_t Fields, typename T, size_t FieldBits, size_t... i>
+static bool TestMortonNDArithmeticAxis(std::index_sequence<i...>) {
+    std::mt19937_64 rng(Fields * FieldBits);
+    return Reduce(std::logical_and<bool>{}, TestMortonNDArithmeticField<Fields, T, FieldBits, i>(rng)...);
+}
+
+template<size_t Fields, typename T, size_t FieldBits = std::numeric_limits<T>::digits / Fields>
+static bool TestMortonNDArithmeticAxis() {
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D per-axis arithmetic (Bits/Field = " << FieldBits << ")..." << std::endl;
+    return TestMortonNDArithmeticAxis<Fields, T, FieldBits>(std::make_index_sequence<Fields>{});
+}
+
+template<size_t Fields, typename T, size_t FieldBits = std::numeric_limits<T>::digits / Fields>
+static bool TestMortonNDArithmeticCodes() {
+    using Arithmetic = mortonnd::MortonNDArithmetic<Fields, T, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D code arithmetic (Bits/Field = " << FieldBits << ")..." << std::endl;
+
+    static const T FieldMask = (T(1) << (FieldBits - 1) << 1) - 1;
+    std::mt19937_64 rng(Fields * FieldBits);
+
+    for (size_t n = 0; n < 10000; n++) {
+        const auto a = RandomFields<Fields, T, FieldBits>(rng);
+        const auto b = RandomFields<Fields, T, FieldBits>(rng);
+
+        std::array<T, Fields> sum, difference;
+        for (size_t f = 0; f < Fields; f++) {
+            sum[f] = (a[f] + b[f]) & FieldMask;
+            difference[f] = (a[f] - b[f]) & FieldMask;
+        }
+
+        const auto codeA = EncodeFields<Fields, T, FieldBits>(a);
+        const auto codeB = EncodeFields<Fields, T, FieldBits>(b);
+        if (Arithmetic::AddCodes(codeA, codeB) != EncodeFields<Fields, T, FieldBits>(sum)
+            || Arithmetic::SubCodes(codeA, codeB) != EncodeFields<Fields, T, FieldBits>(difference)) {
+            std::cout << "  Mismatch for codes " << uint64_t(codeA) << ", " << uint64_t(codeB) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool mortonnd_arithmetic::TestAxis() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDArithmeticAxis<1, uint32_t>(),
+        TestMortonNDArithmeticAxis<1, uint64_t, 40>(),
+        TestMortonNDArithmeticAxis<2, uint32_t>(),
+        TestMortonNDArithmeticAxis<2, uint64_t>(),
+        TestMortonNDArithmeticAxis<2, uint64_t, 19>(),
+        TestMortonNDArithmeticAxis<3, uint32_t>(),
+        TestMortonNDArithmeticAxis<3, uint64_t>(),
+        TestMortonNDArithmeticAxis<3, __uint128_t>(),
+        TestMortonNDArithmeticAxis<4, uint64_t>(),
+        TestMortonNDArithmeticAxis<5, uint32_t>(),
+        TestMortonNDArithmeticAxis<7, uint64_t>(),
+        TestMortonNDArithmeticAxis<16, uint64_t>(),
+        TestMortonNDArithmeticAxis<64, uint64_t>()
+    );
+}
+
+bool mortonnd_arithmetic::TestCodes() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDArithmeticCodes<1, uint64_t>(),
+        TestMortonNDArithmeticCodes<2, uint32_t>(),
+        TestMortonNDArithmeticCodes<2, uint64_t>(),
+        TestMortonNDArithmeticCodes<3, uint32_t>(),
+        TestMortonNDArithmeticCodes<3, uint64_t>(),
+        TestMortonNDArithmeticCodes<3, uint64_t, 17>(),
+        TestMortonNDArithmeticCodes<3, __uint128_t>(),
+        TestMortonNDArithmeticCodes<5, uint64_t>(),
+        TestMortonNDArithmeticCodes<8, uint64_t>()
+    );
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_arithmetic {
+bool TestAxis();
+bool TestCodes();
+}
@@ -0,0 +1,184 @@
+#include "mortonND_Array_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_Array.h>
+
+#include <array>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+static_assert(mortonnd::MortonNDTiledLayout<2, 3, 2>::Selector<uint64_t>(0) == 0x13, "Unexpected tiled selector.");
+static_assert(mortonnd::MortonNDTiledLayout<2, 3, 2>::Selector<uint64_t>(1) == 0x2C, "Unexpected tiled selector.");
+static_assert(mortonnd::MortonNDTiledLayout<3, 4>::Selector<uint64_t>(1) == 0x492, "Unexpected untiled selector.");
+static_assert(mortonnd::MortonNDArray<float, 2, 3, 3>::Dilate<1>(5) == 40, "Row-major tiles should dilate to a shift.");
+
+template<size_t Dimensions>
+using Coords = std::array<uint64_t, Dimensions>;
+
+// The reference index of 'coords': the tile's coordinates interleaved round-robin, above the
+// row-major position within the tile.
+template<size_t Dimensions, size_t FieldBits, size_t TileBits>
+static uint64_t ReferenceIndex(const Coords<Dimensions>& coords) {
+    uint64_t index = 0;
+    for (size_t axis = 0; axis < Dimensions; axis++) {
+        index |= (coords[axis] & ((uint64_t(1) << TileBits) - 1)) << (axis * TileBits);
+        for (size_t bit = TileBits; bit < FieldBits; bit++) {
+            index |= ((coords[axis] >> bit) & 1) << (Dimensions * TileBits + (bit - TileBits) * Dimensions + axis);
+        }
+    }
+
+    return index;
+}
+
+template<typename Array, size_t... I>
+static uint64_t IndexOf(const Coords<sizeof...(I)>& coords, std::index_sequence<I...>) {
+    return Array::IndexOf(coords[I]...);
+}
+
+template<typename Array, size_t... I>
+static Coords<sizeof...(I)> CoordinatesOf(uint64_t index, std::index_sequence<I...>) {
+    const auto decoded = Array::Coordinates(index);
+    return {{ std::get<I>(decoded)... }};
+}
+
+template<typename Array, size_t... I>
+static typename Array::value_type& At(Array& array, const Coords<sizeof...(I)>& coords, std::index_sequence<I...>) {
+    return array.at(coords[I]...);
+}
+
+template<size_t Dimensions, size_t FieldBits, size_t TileBits>
+static bool TestIndexArray() {
+    using Array = mortonnd::MortonNDArray<uint64_t, Dimensions, FieldBits, TileBits>;
+    const auto axes = std::make_index_sequence<Dimensions>{};
+    std::cout << "Testing " << Dimensions << "D array indexing (field bits = " << FieldBits << ", tile bits = " << TileBits << ")..." << std::endl;
+
+    Array array;
+    if (array.size() != (size_t(1) << (Dimensions * FieldBits)) || size_t(array.end() - array.begin()) != array.size()) {
+        std::cout << "  Unexpected size" << std::endl;
+        return false;
+    }
+
+    // Every index decodes to coordinates which map back to it.
+    for (uint64_t index = 0; index < array.size(); index++) {
+        const auto coords = CoordinatesOf<Array>(index, axes);
+        if (ReferenceIndex<Dimensions, FieldBits, TileBits>(coords) != index || IndexOf<Array>(coords, axes) != index) {
+            std::cout << "  Index mismatch at " << index << std::endl;
+            return false;
+        }
+
+        At(array, coords, axes) = index;
+    }
+
+    // Iteration is in storage order.
+    uint64_t expected = 0;
+    for (auto value : array) {
+        if (value != expected++) {
+            std::cout << "  Iteration order mismatch at " << value << std::endl;
+            return false;
+        }
+    }
+
+    for (size_t axis = 0; axis < Dimensions; axis++) {
+        Coords<Dimensions> coords{};
+        coords[axis] = Array::Extent;
+        try {
+            At(array, coords, axes);
+            std::cout << "  Expected std::out_of_range" << std::endl;
+            return false;
+        } catch (const std::out_of_range&) {
+        }
+    }
+
+    return true;
+}
+
+// Checks each way of stepping along 'Axis' from 'coords' against re-encoding the wrapped
+// coordinates.
+template<typename Array, size_t Axis, size_t Dimensions>
+static bool CheckSteps(Array& array, const Coords<Dimensions>& coords, std::ptrdiff_t delta) {
+    const auto axes = std::make_index_sequence<Dimensions>{};
+    const auto moved = [&](std::ptrdiff_t offset) {
+        auto result = coords;
+        result[Axis] = (result[Axis] + uint64_t(offset)) & (Array::Extent - 1);
+        return IndexOf<Array>(result, axes);
+    };
+
+    const auto start = typename Array::Cursor(array.data(), IndexOf<Array>(coords, axes));
+    const typename Array::Cursor cursors[] = {
+        typename Array::Cursor(start).template Next<Axis>(),
+        typename Array::Cursor(start).template Prev<Axis>(),
+        typename Array::Cursor(start).template Move<Axis>(delta)
+    };
+
+    const auto& constArray = array;
+    return cursors[0].Position() == moved(1)
+        && cursors[1].Position() == moved(-1)
+        && cursors[2].Position() == moved(delta)
+        && &start.template Neighbor<Axis, 1>() == &array[moved(1)]
+        && &start.template Neighbor<Axis, -1>() == &array[moved(-1)]
+        && &start.template Neighbor<Axis, -3>() == &array[moved(-3)]
+        && &typename Array::ConstCursor(constArray.data(), start.Position()).template Neighbor<Axis, 2>() == &constArray[moved(2)];
+}
+
+template<typename Array, size_t Dimensions, size_t... Axis>
+static bool CheckAllSteps(Array& array, const Coords<Dimensions>& coords, std::ptrdiff_t delta, std::index_sequence<Axis...>) {
+    const bool results[] = { CheckSteps<Array, Axis>(array, coords, delta)... };
+    for (auto result : results) {
+        if (!result) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<size_t Dimensions, size_t FieldBits, size_t TileBits>
+static bool TestCursorArray() {
+    using Array = mortonnd::MortonNDArray<float, Dimensions, FieldBits, TileBits>;
+    std::cout << "Testing " << Dimensions << "D array cursor (field bits = " << FieldBits << ", tile bits = " << TileBits << ")..." << std::endl;
+
+    Array array;
+    std::mt19937_64 rng(Dimensions * FieldBits + TileBits);
+    for (size_t n = 0; n < 10000; n++) {
+        Coords<Dimensions> coords;
+        for (auto& coord : coords) {
+            // Bias towards the edges, where steps wrap around.
+            coord = n % 4 == 0 ? (rng() % 2 ? 0 : Array::Extent - 1) : rng() & (Array::Extent - 1);
+        }
+
+        const auto delta = std::ptrdiff_t(rng() % (2 * Array::Extent)) - std::ptrdiff_t(Array::Extent);
+        if (!CheckAllSteps(array, coords, delta, std::make_index_sequence<Dimensions>{})) {
+            std::cout << "  Step mismatch at iteration " << n << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool mortonnd_array::TestIndexing() {
+    bool ok = true;
+    ok &= TestIndexArray<1, 10, 0>();
+    ok &= TestIndexArray<2, 6, 0>();
+    ok &= TestIndexArray<2, 6, 2>();
+    ok &= TestIndexArray<2, 6, 6>();
+    ok &= TestIndexArray<3, 5, 0>();
+    ok &= TestIndexArray<3, 5, 1>();
+    ok &= TestIndexArray<3, 5, 3>();
+    ok &= TestIndexArray<4, 3, 2>();
+    return ok;
+}
+
+bool mortonnd_array::TestCursor() {
+    bool ok = true;
+    ok &= TestCursorArray<2, 8, 0>();
+    ok &= TestCursorArray<2, 8, 3>();
+    ok &= TestCursorArray<3, 6, 0>();
+    ok &= TestCursorArray<3, 6, 2>();
+    ok &= TestCursorArray<3, 6, 6>();
+    ok &= TestCursorArray<4, 4, 1>();
+    return ok;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_array {
+bool TestIndexing();
+bool TestCursor();
+}
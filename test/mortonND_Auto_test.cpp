@@ -0,0 +1,164 @@
+#include "mortonND_Auto_test.h"
+#include "mortonND_test_util.h"
+#include "mortonND_test_common.h"
+
+#include <morton-nd/mortonND_Auto.h>
+
+#include <random>
+#include <vector>
+
+// Note: this file is compiled without BMI2 (see CMakeLists.txt), since 'MortonNDAuto' must
+// not depend on it.
+
+template<size_t FieldBits, typename Ret, typename ...Fields>
+bool TestMortonNDAutoEncoder(type_sequence<Fields...>) {
+    static const auto func = std::function<Ret(Fields...)>([](Fields... fields) {
+        return mortonnd::MortonNDAuto<sizeof...(Fields), FieldBits>::Encode(fields...);
+    });
+    return TestEncodeFunction<FieldBits>(func);
+}
+
+template<size_t Fields, size_t FieldBits>
+bool TestMortonNDAutoEncoder() {
+    using MortonND = mortonnd::MortonNDAuto<Fields, FieldBits>;
+    std::cout << "Testing " << Fields << "D auto encoders (Bits/Field = " << FieldBits << ", engine = "
+              << mortonnd::MortonNDEngineName(MortonND::SelectedEngine()) << ")...";
+    return TestMortonNDAutoEncoder<FieldBits, typename MortonND::T>(make_type_sequence<Fields, typename MortonND::T>());
+}
+
+template<size_t FieldBits, typename Ret, typename ...Fields>
+bool TestMortonNDAutoDecoder(type_sequence<Fields...>) {
+    static const auto func = std::function<std::tuple<Fields...>(Ret)>([](Ret encoding) {
+        return mortonnd::MortonNDAuto<sizeof...(Fields), FieldBits>::Decode(encoding);
+    });
+    return TestDecodeFunction<FieldBits>(func);
+}
+
+template<size_t Fields, size_t FieldBits>
+bool TestMortonNDAutoDecoder() {
+    using MortonND = mortonnd::MortonNDAuto<Fields, FieldBits>;
+    std::cout << "Testing " << Fields << "D auto decoders (Bits/Field = " << FieldBits << ", engine = "
+              << mortonnd::MortonNDEngineName(MortonND::SelectedEngine()) << ")..." << std::endl;
+    return TestMortonNDAutoDecoder<FieldBits, typename MortonND::T>(make_type_sequence<Fields, typename MortonND::T>());
+}
+
+template<size_t Fields, size_t FieldBits, size_t ...i>
+bool TestMortonNDAutoEngine(mortonnd::MortonNDEngine engine, std::index_sequence<i...>) {
+    using MortonND = mortonnd::MortonNDAuto<Fields, FieldBits>;
+    using T = typename MortonND::T;
+    using Magic = mortonnd::MortonNDMagic<Fields, T, FieldBits>;
+
+    if (!MortonND::IsSupported(engine)) {
+        std::cout << "Skipping " << Fields << "D auto engine '" << mortonnd::MortonNDEngineName(engine) << "' (unsupported by this CPU)." << std::endl;
+        return true;
+    }
+
+    std::cout << "Testing " << Fields << "D auto engine '" << mortonnd::MortonNDEngineName(engine) << "' (Bits/Field = " << FieldBits << ")..." << std::endl;
+    const auto& kernels = MortonND::DispatchFor(engine);
+
+    static const size_t Count = 1027;
+    static const size_t Stride = Fields + 1;
+
+    // Upper bits are left dirty, since every engine must ignore them.
+    std::mt19937_64 rng(Fields);
+    std::vector<T> soa[Fields];
+    std::vector<T> aos(Count * Stride);
+    for (auto& field : soa) {
+        field.resize(Count);
+    }
+
+    for (size_t n = 0; n < Count; n++) {
+        for (size_t f = 0; f < Fields; f++) {
+            soa[f][n] = T(rng());
+            aos[n * Stride + f] = soa[f][n];
+        }
+    }
+
+    std::vector<T> soaCodes(Count), aosCodes(Count);
+    kernels.EncodeSoA({{ soa[i].data()... }}, soaCodes.data(), Count);
+    kernels.EncodeAoS(aos.data(), Stride, aosCodes.data(), Count);
+
+    std::vector<T> soaDecoded[Fields];
+    std::vector<T> aosDecoded(Count * Stride);
+    for (auto& field : soaDecoded) {
+        field.resize(Count);
+    }
+
+    kernels.DecodeSoA(soaCodes.data(), Count, {{ soaDecoded[i].data()... }});
+    kernels.DecodeAoS(aosCodes.data(), Count, aosDecoded.data(), Stride);
+
+    bool ok = true;
+    for (size_t n = 0; n < Count; n++) {
+        const T correct = Magic::Encode(soa[i][n]...);
+        const T point[] = { soa[i][n]... };
+        const T scalar = kernels.Encode(point);
+        if (soaCodes[n] != correct || aosCodes[n] != correct || scalar != correct) {
+            std::cout << "  Mismatch when encoding point " << n << std::endl;
+            std::cout << "    Correct: " << correct << " Computed (SoA): " << soaCodes[n] << " Computed (AoS): " << aosCodes[n]
+                      << " Computed (scalar): " << scalar << std::endl;
+            ok = false;
+        }
+
+        T decoded[Fields];
+        kernels.Decode(correct, decoded);
+        for (size_t f = 0; f < Fields; f++) {
+            const T field = Magic::Compact(Magic::Dilate(soa[f][n]));
+            if (soaDecoded[f][n] != field || aosDecoded[n * Stride + f] != field || decoded[f] != field) {
+                std::cout << "  Mismatch when decoding field " << f << " of point " << n << std::endl;
+                std::cout << "    Correct field: " << field << " Computed field (SoA): " << soaDecoded[f][n]
+                          << " Computed field (AoS): " << aosDecoded[n * Stride + f] << " Computed field (scalar): " << decoded[f] << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    return ok;
+}
+
+template<size_t Fields, size_t FieldBits>
+bool TestMortonNDAutoEngines() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDAutoEngine<Fields, FieldBits>(mortonnd::MortonNDEngine::Magic, std::make_index_sequence<Fields>{}),
+        TestMortonNDAutoEngine<Fields, FieldBits>(mortonnd::MortonNDEngine::Bmi2, std::make_index_sequence<Fields>{})
+    );
+}
+
+bool mortonnd_auto::TestEncode() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDAutoEncoder<1, 32>(),
+        TestMortonNDAutoEncoder<2, 16>(),
+        TestMortonNDAutoEncoder<2, 32>(),
+        TestMortonNDAutoEncoder<3, 10>(),
+        TestMortonNDAutoEncoder<3, 21>(),
+        TestMortonNDAutoEncoder<4, 16>(),
+        TestMortonNDAutoEncoder<5, 12>(),
+        TestMortonNDAutoEncoder<8, 8>()
+    );
+}
+
+bool mortonnd_auto::TestDecode() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDAutoDecoder<1, 32>(),
+        TestMortonNDAutoDecoder<2, 16>(),
+        TestMortonNDAutoDecoder<2, 32>(),
+        TestMortonNDAutoDecoder<3, 10>(),
+        TestMortonNDAutoDecoder<3, 21>(),
+        TestMortonNDAutoDecoder<4, 16>(),
+        TestMortonNDAutoDecoder<5, 12>(),
+        TestMortonNDAutoDecoder<8, 8>()
+    );
+}
+
+bool mortonnd_auto::TestEngines() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDAutoEngines<1, 64>(),
+        TestMortonNDAutoEngines<2, 16>(),
+        TestMortonNDAutoEngines<2, 32>(),
+        TestMortonNDAutoEngines<3, 10>(),
+        TestMortonNDAutoEngines<3, 17>(),
+        TestMortonNDAutoEngines<3, 21>(),
+        TestMortonNDAutoEngines<4, 16>(),
+        TestMortonNDAutoEngines<5, 12>(),
+        TestMortonNDAutoEngines<8, 8>()
+    );
+}
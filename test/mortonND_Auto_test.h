@@ -0,0 +1,7 @@
+#pragma once
+
+namespace mortonnd_auto {
+bool TestEncode();
+bool TestDecode();
+bool TestEngines();
+}
@@ -4,6 +4,9 @@
 
 #include <morton-nd/mortonND_BMI2.h>
 
+#include <random>
+#include <vector>
+
 template<typename Ret, typename ...Fields>
 bool TestMortonNDBmiEncoder(type_sequence<Fields...>) {
     static const auto func = std::function<Ret(Fields...)>(static_cast<Ret(*)(Fields...)>(mortonnd::MortonNDBmi<sizeof...(Fields), Ret>::Encode));
@@ -18,7 +21,9 @@ bool TestMortonNDBmiEncoder() {
 
 template<typename Ret, typename ...Fields>
 bool TestMortonNDBmiDecoder(type_sequence<Fields...>) {
-    static const auto func = std::function<std::tuple<Fields...>(Ret)>(static_cast<std::tuple<Fields...>(*)(Ret)>(mortonnd::MortonNDBmi<sizeof...(Fields), Ret>::Decode));
+    static const auto func = std::function<std::tuple<Fields...>(Ret)>([](Ret encoding) {
+        return mortonnd::MortonNDBmi<sizeof...(Fields), Ret>::Decode(encoding);
+    });
     return TestDecodeFunction<std::numeric_limits<Ret>::digits / sizeof...(Fields)>(func);
 }
 
@@ -28,6 +33,125 @@ bool TestMortonNDBmiDecoder() {
     return TestMortonNDBmiDecoder<T>(make_type_sequence<Fields, T>());
 }
 
+template<size_t Fields, typename T, size_t ...i>
+bool TestMortonNDBmiBatch(std::index_sequence<i...>) {
+    using MortonND = mortonnd::MortonNDBmi<Fields, T>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D BMI2 batch encoders/decoders..." << std::endl;
+
+    // Not a multiple of 'BatchUnroll', so that the remainder loop is covered.
+    static const size_t Count = 1027;
+    static const size_t Stride = Fields + 1;
+    static const T InputMask = T(~T(0)) >> (std::numeric_limits<T>::digits - MortonND::FieldBits);
+
+    std::mt19937_64 rng(Fields);
+    std::vector<T> soa[Fields];
+    std::vector<T> aos(Count * Stride);
+    for (auto& field : soa) {
+        field.resize(Count);
+    }
+
+    for (size_t n = 0; n < Count; n++) {
+        for (size_t f = 0; f < Fields; f++) {
+            soa[f][n] = T(rng()) & InputMask;
+            aos[n * Stride + f] = soa[f][n];
+        }
+    }
+
+    std::vector<T> soaCodes(Count), aosCodes(Count);
+    MortonND::EncodeBatch({{ soa[i].data()... }}, soaCodes.data(), Count);
+    MortonND::EncodeBatch(aos.data(), Stride, aosCodes.data(), Count);
+
+    std::vector<T> soaDecoded[Fields];
+    std::vector<T> aosDecoded(Count * Stride);
+    for (auto& field : soaDecoded) {
+        field.resize(Count);
+    }
+
+    MortonND::DecodeBatch(soaCodes.data(), Count, {{ soaDecoded[i].data()... }});
+    MortonND::DecodeBatch(aosCodes.data(), Count, aosDecoded.data(), Stride);
+
+    bool ok = true;
+    for (size_t n = 0; n < Count; n++) {
+        const T correct = MortonND::Encode(soa[i][n]...);
+        if (soaCodes[n] != correct || aosCodes[n] != correct) {
+            std::cout << "  Mismatch when batch encoding point " << n << std::endl;
+            std::cout << "    Correct: " << correct << " Computed (SoA): " << soaCodes[n] << " Computed (AoS): " << aosCodes[n] << std::endl;
+            ok = false;
+        }
+
+        for (size_t f = 0; f < Fields; f++) {
+            if (soaDecoded[f][n] != soa[f][n] || aosDecoded[n * Stride + f] != soa[f][n]) {
+                std::cout << "  Mismatch when batch decoding field " << f << " of point " << n << std::endl;
+                std::cout << "    Correct field: " << soa[f][n] << " Computed field (SoA): " << soaDecoded[f][n]
+                          << " Computed field (AoS): " << aosDecoded[n * Stride + f] << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    return ok;
+}
+
+template<size_t Fields, typename T>
+bool TestMortonNDBmiBatch() {
+    return TestMortonNDBmiBatch<Fields, T>(std::make_index_sequence<Fields>{});
+}
+
+#if defined(__SIZEOF_INT128__)
+// The control encoder is limited to 64 bits, so wide encodings are checked against a naive bit loop.
+template<size_t Fields, typename T, size_t ...i>
+bool TestMortonNDBmiWide(std::index_sequence<i...>) {
+    using MortonND = mortonnd::MortonNDBmi<Fields, T>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D BMI2 encoders/decoders (Bits/Field = " << MortonND::FieldBits << ")..." << std::endl;
+
+    static const size_t Count = 1027;
+    static const T InputMask = T(~T(0)) >> (std::numeric_limits<T>::digits - MortonND::FieldBits);
+
+    std::mt19937_64 rng(Fields);
+    std::vector<T> soa[Fields];
+    for (auto& field : soa) {
+        field.resize(Count);
+        for (auto& value : field) {
+            value = ((T(rng()) << 64) | T(rng())) & InputMask;
+        }
+    }
+
+    std::vector<T> codes(Count);
+    MortonND::EncodeBatch({{ soa[i].data()... }}, codes.data(), Count);
+
+    bool ok = true;
+    for (size_t n = 0; n < Count; n++) {
+        T correct = 0;
+        for (size_t bit = 0; bit < MortonND::FieldBits; bit++) {
+            for (size_t f = 0; f < Fields; f++) {
+                correct |= ((soa[f][n] >> bit) & 1) << (bit * Fields + f);
+            }
+        }
+
+        const T computed = MortonND::Encode(soa[i][n]...);
+        if (computed != correct || codes[n] != correct) {
+            std::cout << "  Mismatch when encoding point " << n << std::endl;
+            ok = false;
+        }
+
+        const T decoded[] = { std::get<i>(MortonND::Decode(correct))... };
+        for (size_t f = 0; f < Fields; f++) {
+            if (decoded[f] != soa[f][n]) {
+                std::cout << "  Mismatch when decoding field " << f << " of point " << n << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    return ok;
+}
+
+template<size_t Fields, typename T>
+bool TestMortonNDBmiWide() {
+    return TestMortonNDBmiWide<Fields, T>(std::make_index_sequence<Fields>{});
+}
+#endif
+
 bool mortonnd_bmi2::TestEncode() {
     return Reduce(std::logical_and<bool>{},
         TestMortonNDBmiEncoder<1, uint64_t>(),
@@ -84,4 +208,34 @@ bool mortonnd_bmi2::TestDecode() {
 
         TestMortonNDBmiDecoder<64, uint64_t>()
     );
-}
\ No newline at end of file
+}
+
+bool mortonnd_bmi2::TestBatch() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDBmiBatch<1, uint64_t>(),
+        TestMortonNDBmiBatch<2, uint64_t>(),
+        TestMortonNDBmiBatch<2, uint32_t>(),
+        TestMortonNDBmiBatch<3, uint64_t>(),
+        TestMortonNDBmiBatch<3, uint32_t>(),
+        TestMortonNDBmiBatch<4, uint64_t>(),
+        TestMortonNDBmiBatch<5, uint32_t>(),
+        TestMortonNDBmiBatch<8, uint64_t>()
+    );
+}
+bool mortonnd_bmi2::TestWide() {
+#if defined(__SIZEOF_INT128__)
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDBmiWide<1, __uint128_t>(),
+        TestMortonNDBmiWide<2, __uint128_t>(),
+        TestMortonNDBmiWide<3, __uint128_t>(),
+        TestMortonNDBmiWide<4, __uint128_t>(),
+        TestMortonNDBmiWide<5, __uint128_t>(),
+        TestMortonNDBmiWide<7, __uint128_t>(),
+        TestMortonNDBmiWide<16, __uint128_t>(),
+        TestMortonNDBmiWide<65, __uint128_t>()
+    );
+#else
+    std::cout << "Skipping wide BMI2 tests ('__uint128_t' is not supported by this compiler)." << std::endl;
+    return true;
+#endif
+}
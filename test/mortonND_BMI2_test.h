@@ -3,4 +3,6 @@
 namespace mortonnd_bmi2 {
 bool TestEncode();
 bool TestDecode();
+bool TestBatch();
+bool TestWide();
 }
\ No newline at end of file
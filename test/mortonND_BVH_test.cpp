@@ -0,0 +1,243 @@
+#include "mortonND_BVH_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_BVH.h>
+#include <morton-nd/mortonND_LUT.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Random boxes, with a few exact duplicates (equal codes) and, if 'degenerate', all with the
+// same centroid.
+template<typename Box>
+static std::vector<Box> RandomBoxes(size_t count, bool degenerate, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> position(-100.0, 100.0), size(0.0, 5.0);
+
+    std::vector<Box> boxes(count);
+    for (size_t i = 0; i < count; i++) {
+        if (i % 10 == 9) {
+            boxes[i] = boxes[rng() % i];
+            continue;
+        }
+
+        for (size_t d = 0; d < boxes[i].min.size(); d++) {
+            const auto center = degenerate ? 1.0 : position(rng);
+            const auto extent = size(rng);
+            boxes[i].min[d] = typename decltype(Box::min)::value_type(center - extent);
+            boxes[i].max[d] = typename decltype(Box::min)::value_type(center + extent);
+        }
+    }
+
+    return boxes;
+}
+
+// The length of the common prefix of the sorted codes at 'i' and 'j', extended by position.
+template<typename T>
+static int Delta(const std::vector<T>& codes, size_t i, size_t j, size_t codeBits) {
+    const T diff = codes[i] ^ codes[j];
+    for (int bit = int(codeBits) - 1; bit >= 0; bit--) {
+        if ((diff >> bit & 1) != 0) {
+            return int(codeBits) - 1 - bit;
+        }
+    }
+
+    return int(codeBits) + __builtin_clz(uint32_t(i ^ j));
+}
+
+// Checks codes, links, leaf ranges and splits, and boxes. Returns the range of sorted codes
+// covered by node 'i' in 'first' / 'last'.
+template<typename Bvh, typename Box>
+static bool CheckNode(const Bvh& bvh, const std::vector<Box>& boxes, size_t codeBits, size_t i, size_t& first, size_t& last) {
+    const auto& node = bvh[i];
+    const auto count = bvh.Codes().size();
+
+    if (bvh.IsLeaf(i)) {
+        first = last = i - (count - 1);
+        const auto primitive = bvh.Primitives()[first];
+        if (node.left != primitive || node.right != primitive || node.box.min != boxes[primitive].min || node.box.max != boxes[primitive].max) {
+            std::cout << "  Bad leaf " << i << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    size_t leftFirst, leftLast, rightFirst, rightLast;
+    if (bvh[node.left].parent != i || bvh[node.right].parent != i
+            || !CheckNode(bvh, boxes, codeBits, node.left, leftFirst, leftLast)
+            || !CheckNode(bvh, boxes, codeBits, node.right, rightFirst, rightLast)) {
+        std::cout << "  Bad children of node " << i << std::endl;
+        return false;
+    }
+
+    first = leftFirst;
+    last = rightLast;
+    if (leftLast + 1 != rightFirst) {
+        std::cout << "  Children of node " << i << " aren't adjacent" << std::endl;
+        return false;
+    }
+
+    // A binary radix tree splits each range where its codes first differ.
+    int minDelta = std::numeric_limits<int>::max();
+    for (auto k = first; k < last; k++) {
+        minDelta = std::min(minDelta, Delta(bvh.Codes(), k, k + 1, codeBits));
+    }
+
+    if (Delta(bvh.Codes(), leftLast, rightFirst, codeBits) != minDelta) {
+        std::cout << "  Bad split for node " << i << std::endl;
+        return false;
+    }
+
+    for (size_t d = 0; d < node.box.min.size(); d++) {
+        if (node.box.min[d] != std::min(bvh[node.left].box.min[d], bvh[node.right].box.min[d])
+                || node.box.max[d] != std::max(bvh[node.left].box.max[d], bvh[node.right].box.max[d])) {
+            std::cout << "  Bad box for node " << i << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<size_t Dimensions, typename Real, typename T, size_t FieldBits, typename Engine>
+static bool TestBuildBvh(const Engine& engine, size_t count, bool degenerate, size_t threads) {
+    using Bvh = mortonnd::MortonNDBvh<Dimensions, Real, T, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Dimensions << "D BVH build (count = " << count
+              << ", Bits/Field = " << FieldBits << ", degenerate = " << degenerate << ", threads = " << threads << ")..." << std::endl;
+
+    const auto boxes = RandomBoxes<typename Bvh::Box>(count, degenerate, count + Dimensions);
+    const Bvh bvh(engine, boxes.data(), count, threads);
+    const Bvh single(engine, boxes.data(), count, 1);
+
+    if (bvh.size() != (count == 0 ? 0 : 2 * count - 1) || single.size() != bvh.size()) {
+        std::cout << "  Unexpected node count " << bvh.size() << std::endl;
+        return false;
+    }
+
+    if (count == 0) {
+        return true;
+    }
+
+    // Codes: each primitive's centroid quantized to the bounds of the centroids, sorted (stably).
+    typename Bvh::Box bounds;
+    bounds.min.fill(std::numeric_limits<Real>::max());
+    bounds.max.fill(std::numeric_limits<Real>::lowest());
+    for (const auto& box : boxes) {
+        for (size_t d = 0; d < Dimensions; d++) {
+            bounds.min[d] = std::min(bounds.min[d], (box.min[d] + box.max[d]) * Real(0.5));
+            bounds.max[d] = std::max(bounds.max[d], (box.min[d] + box.max[d]) * Real(0.5));
+        }
+    }
+
+    const auto quantizer = Bvh::CentroidQuantizer(bounds);
+    std::vector<T> expected(count);
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; i++) {
+        std::array<Real, Dimensions> centroid;
+        std::array<const Real*, Dimensions> fields;
+        for (size_t d = 0; d < Dimensions; d++) {
+            centroid[d] = (boxes[i].min[d] + boxes[i].max[d]) * Real(0.5);
+            fields[d] = &centroid[d];
+        }
+
+        quantizer.EncodeBatch(engine, fields, &expected[i], 1);
+        order[i] = uint32_t(i);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return expected[a] < expected[b]; });
+    for (size_t k = 0; k < count; k++) {
+        if (bvh.Primitives()[k] != order[k] || bvh.Codes()[k] != expected[order[k]]) {
+            std::cout << "  Bad code at position " << k << std::endl;
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < bvh.size(); i++) {
+        if (bvh[i].left != single[i].left || bvh[i].right != single[i].right || bvh[i].box.min != single[i].box.min) {
+            std::cout << "  Node " << i << " differs from single-threaded build" << std::endl;
+            return false;
+        }
+    }
+
+    size_t first, last;
+    if (bvh[0].parent != 0 || !CheckNode(bvh, boxes, Dimensions * FieldBits, 0, first, last) || first != 0 || last != count - 1) {
+        std::cout << "  Bad tree" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+template<size_t Dimensions, typename Real, typename T, size_t FieldBits, typename Engine>
+static bool TestQueryBvh(const Engine& engine, size_t count) {
+    using Bvh = mortonnd::MortonNDBvh<Dimensions, Real, T, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Dimensions << "D BVH query (count = " << count
+              << ", Bits/Field = " << FieldBits << ")..." << std::endl;
+
+    const auto boxes = RandomBoxes<typename Bvh::Box>(count, false, count);
+    const auto queries = RandomBoxes<typename Bvh::Box>(200, false, count + 1);
+    const Bvh bvh(engine, boxes.data(), count);
+
+    for (size_t q = 0; q < queries.size(); q++) {
+        std::vector<size_t> expected, found;
+        for (size_t i = 0; i < count; i++) {
+            bool overlaps = true;
+            for (size_t d = 0; d < Dimensions; d++) {
+                overlaps &= boxes[i].min[d] <= queries[q].max[d] && queries[q].min[d] <= boxes[i].max[d];
+            }
+
+            if (overlaps) {
+                expected.push_back(i);
+            }
+        }
+
+        bvh.Query(queries[q], [&](size_t primitive) { found.push_back(primitive); });
+        std::sort(found.begin(), found.end());
+        if (found != expected) {
+            std::cout << "  Query " << q << " found " << found.size() << " primitives, expected " << expected.size() << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<size_t Dimensions, typename Real, typename T, size_t FieldBits>
+static bool TestBuildEngines(size_t count, bool degenerate, size_t threads) {
+    constexpr auto LutEncoder = mortonnd::MortonNDLutEncoder<Dimensions, FieldBits, 8, T>();
+    const auto bmi = mortonnd::MortonNDStatic<mortonnd::MortonNDBmi<Dimensions, T>>{};
+
+    return Reduce(std::logical_and<bool>{},
+        TestBuildBvh<Dimensions, Real, T, FieldBits>(bmi, count, degenerate, threads),
+        TestBuildBvh<Dimensions, Real, T, FieldBits>(LutEncoder, count, degenerate, threads)
+    );
+}
+
+bool mortonnd_bvh::TestBuild() {
+    return Reduce(std::logical_and<bool>{},
+        TestBuildEngines<3, float, uint64_t, 21>(0, false, 1),
+        TestBuildEngines<3, float, uint64_t, 21>(1, false, 1),
+        TestBuildEngines<3, float, uint64_t, 21>(2, false, 1),
+        TestBuildEngines<3, float, uint64_t, 21>(3, false, 1),
+        TestBuildEngines<3, float, uint64_t, 21>(1000, false, 1),
+        TestBuildEngines<3, float, uint64_t, 21>(1000, true, 2),
+        TestBuildEngines<3, float, uint32_t, 10>(100000, false, 4),
+        TestBuildEngines<3, double, uint64_t, 21>(100000, false, 0),
+        TestBuildEngines<2, float, uint32_t, 16>(50000, false, 3)
+    );
+}
+
+bool mortonnd_bvh::TestQuery() {
+    constexpr auto LutEncoder = mortonnd::MortonNDLutEncoder<3, 21, 8, uint64_t>();
+
+    return Reduce(std::logical_and<bool>{},
+        TestQueryBvh<3, float, uint64_t, 21>(LutEncoder, 1),
+        TestQueryBvh<3, float, uint64_t, 21>(LutEncoder, 5000),
+        TestQueryBvh<2, double, uint64_t, 32>(mortonnd::MortonNDStatic<mortonnd::MortonNDBmi<2, uint64_t>>{}, 5000)
+    );
+}
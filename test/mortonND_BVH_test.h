@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_bvh {
+bool TestBuild();
+bool TestQuery();
+}
@@ -0,0 +1,114 @@
+#include "mortonND_External_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_External.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+// Records are 3 'uint32_t' coordinates (10 bits each) followed by a 'uint32_t' ID.
+using MortonND = mortonnd::MortonNDBmi_3D_32;
+static const size_t RecordFields = 4;
+static const size_t RecordSize = RecordFields * sizeof(uint32_t);
+
+static std::string TempPath(const std::string& name) {
+    return std::string("/tmp/mortonnd-external-test-") + name;
+}
+
+static std::vector<unsigned char> ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Sorts 'count' random records with a budget of 'memoryBytes', and compares against
+// 'std::stable_sort'.
+static bool TestSortRecords(size_t count, size_t memoryBytes, bool writeCodes) {
+    std::cout << "Testing external sort (count = " << count << ", memory = " << memoryBytes
+              << ", codes = " << writeCodes << ")..." << std::endl;
+
+    // Coordinates are drawn from a small range so that many records share a code.
+    std::mt19937_64 rng(count);
+    std::vector<uint32_t> records(count * RecordFields);
+    for (size_t n = 0; n < count; n++) {
+        for (size_t f = 0; f < 3; f++) {
+            records[n * RecordFields + f] = uint32_t(rng() % 50);
+        }
+        records[n * RecordFields + 3] = uint32_t(n);
+    }
+
+    const auto inputPath = TempPath("input");
+    const auto outputPath = TempPath("output");
+    {
+        std::ofstream input(inputPath, std::ios::binary | std::ios::trunc);
+        input.write(reinterpret_cast<const char*>(records.data()), std::streamsize(records.size() * sizeof(uint32_t)));
+    }
+
+    mortonnd::MortonNDExternalSortOptions options;
+    options.memoryBytes = memoryBytes;
+    options.threads = 2;
+    options.keyBits = 30;
+    options.writeCodes = writeCodes;
+
+    const auto stats = mortonnd::SortFileByMorton<uint32_t>(inputPath, outputPath, RecordSize,
+        [](const unsigned char* block, size_t n, size_t recordSize, uint32_t* codes) {
+            MortonND::EncodeBatch(reinterpret_cast<const uint32_t*>(block), recordSize / sizeof(uint32_t), codes, n);
+        }, options);
+
+    const auto output = ReadFile(outputPath);
+    std::remove(inputPath.c_str());
+    std::remove(outputPath.c_str());
+
+    std::vector<uint32_t> codes(count);
+    MortonND::EncodeBatch(records.data(), RecordFields, codes.data(), count);
+
+    std::vector<uint32_t> expected(count);
+    std::iota(expected.begin(), expected.end(), 0);
+    std::stable_sort(expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) { return codes[a] < codes[b]; });
+
+    const auto entrySize = RecordSize + (writeCodes ? sizeof(uint32_t) : 0);
+    if (stats.records != count || output.size() != count * entrySize || stats.merge.bytes != output.size()) {
+        std::cout << "  Unexpected output size " << output.size() << std::endl;
+        return false;
+    }
+
+    if (count > 0 && memoryBytes < count * RecordSize && stats.runs < 2) {
+        std::cout << "  Expected more than 1 run" << std::endl;
+        return false;
+    }
+
+    for (size_t n = 0; n < count; n++) {
+        const auto* entry = output.data() + n * entrySize;
+        uint32_t code = codes[expected[n]];
+        if (writeCodes && std::memcmp(entry, &code, sizeof(code)) != 0) {
+            std::cout << "  Code mismatch at position " << n << std::endl;
+            return false;
+        }
+
+        if (std::memcmp(entry + entrySize - RecordSize, &records[expected[n] * RecordFields], RecordSize) != 0) {
+            std::cout << "  Record mismatch at position " << n << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool mortonnd_external::TestSortFile() {
+    return Reduce(std::logical_and<bool>{},
+        TestSortRecords(0, 1 << 20, false),
+        TestSortRecords(1, 1 << 20, false),
+        TestSortRecords(10000, 1 << 20, false),
+        TestSortRecords(10000, 1 << 20, true),
+        TestSortRecords(100003, 1 << 16, false),
+        TestSortRecords(300007, 1 << 22, true)
+    );
+}
@@ -0,0 +1,153 @@
+#include "mortonND_Hilbert_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_Hilbert.h>
+#include <morton-nd/mortonND_Magic.h>
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Encoding and decoding must be usable in constant expressions.
+static_assert(mortonnd::HilbertND_2D_32::Encode(0, 0) == 0, "Unexpected constexpr encoding.");
+static_assert(mortonnd::HilbertND_2D_32::Encode(0, 1) == 1 || mortonnd::HilbertND_2D_32::Encode(1, 0) == 1, "Unexpected constexpr encoding.");
+static_assert(std::get<2>(mortonnd::HilbertND_3D_32::Decode(mortonnd::HilbertND_3D_32::Encode(9, 5, 1))) == 1, "Unexpected constexpr decoding.");
+
+// Returns the Manhattan distance between the points with Morton codes 'a' and 'b'.
+template<size_t Fields, typename T, size_t FieldBits>
+static T Distance(T a, T b) {
+    using Magic = mortonnd::MortonNDMagic<Fields, T, FieldBits>;
+
+    T distance = 0;
+    for (size_t f = 0; f < Fields; f++) {
+        const T x = Magic::Compact(a >> f);
+        const T y = Magic::Compact(b >> f);
+        distance += x > y ? x - y : y - x;
+    }
+
+    return distance;
+}
+
+// Checks that every index of a small universe maps to a unique point, that consecutive indices
+// are adjacent, and that the LUT and computed transforms agree.
+template<size_t Fields, typename T, size_t FieldBits>
+static bool TestHilbertNDCurve() {
+    using Hilbert = mortonnd::HilbertND<Fields, T, FieldBits>;
+    using HilbertLut = mortonnd::HilbertND<Fields, T, FieldBits, (Fields <= 5)>;
+    using HilbertComputed = mortonnd::HilbertND<Fields, T, FieldBits, false>;
+    std::cout << "Testing " << Fields << "D Hilbert curve (Bits/Field = " << FieldBits << ", LUT = " << Hilbert::UsesLut << ", exhaustive)..." << std::endl;
+
+    static const T CodeCount = T(1) << (Fields * FieldBits);
+    std::vector<bool> seen(CodeCount);
+
+    T previous = 0;
+    for (T index = 0; index < CodeCount; index++) {
+        const T morton = Hilbert::ToMorton(index);
+        if (morton >= CodeCount || seen[morton]) {
+            std::cout << "  Index " << uint64_t(index) << " maps to a duplicate point." << std::endl;
+            return false;
+        }
+        seen[morton] = true;
+
+        if (index > 0 && Distance<Fields, T, FieldBits>(previous, morton) != 1) {
+            std::cout << "  Indices " << uint64_t(index - 1) << " and " << uint64_t(index) << " are not adjacent." << std::endl;
+            return false;
+        }
+        previous = morton;
+
+        if (Hilbert::FromMorton(morton) != index || HilbertLut::ToMorton(index) != HilbertComputed::ToMorton(index)
+            || HilbertLut::FromMorton(morton) != HilbertComputed::FromMorton(morton)) {
+            std::cout << "  Mismatch for index " << uint64_t(index) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename Hilbert, typename T, size_t ...i>
+static bool RoundTrip(const std::array<T, sizeof...(i)>& fields, std::index_sequence<i...>) {
+    return Hilbert::Decode(Hilbert::Encode(std::get<i>(fields)...)) == std::make_tuple(std::get<i>(fields)...);
+}
+
+// Checks round trips of random points, and the adjacency of random consecutive indices, for
+// full-size configurations.
+template<size_t Fields, typename T, size_t FieldBits = std::numeric_limits<T>::digits / Fields>
+static bool TestHilbertNDRoundTrip() {
+    using Hilbert = mortonnd::HilbertND<Fields, T, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D Hilbert encoders/decoders (Bits/Field = " << FieldBits
+              << ", LUT = " << Hilbert::UsesLut << ")..." << std::endl;
+
+    const T fieldMask = (T(1) << (FieldBits - 1) << 1) - 1;
+    const T codeMask = (T(1) << (Fields * FieldBits - 1) << 1) - 1;
+    std::mt19937_64 rng(Fields * FieldBits);
+    auto random = [&]() { return (T(rng()) << (std::numeric_limits<T>::digits > 64 ? 64 : 0)) ^ T(rng()); };
+
+    for (size_t n = 0; n < 10000; n++) {
+        std::array<T, Fields> fields;
+        for (auto& field : fields) {
+            field = random() & fieldMask;
+        }
+
+        const T index = random() & codeMask;
+        const T next = (index + 1) & codeMask;
+        if (!RoundTrip<Hilbert>(fields, std::make_index_sequence<Fields>{})
+            || Hilbert::FromMorton(Hilbert::ToMorton(index)) != index
+            || (next != 0 && Distance<Fields, T, FieldBits>(Hilbert::ToMorton(index), Hilbert::ToMorton(next)) != 1)) {
+            std::cout << "  Mismatch for index " << uint64_t(index) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// The fast path: 'MortonNDBmi' followed by 'FromMorton' must match 'Encode'.
+template<size_t Fields, typename T>
+static bool TestHilbertNDBmi() {
+    using Hilbert = mortonnd::HilbertND<Fields, T>;
+    using Bmi = mortonnd::MortonNDBmi<Fields, T>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D Hilbert encoders via BMI2..." << std::endl;
+
+    static const T FieldMask = (T(1) << Bmi::FieldBits) - 1;
+    std::mt19937_64 rng(Fields);
+    for (size_t n = 0; n < 10000; n++) {
+        const T x = T(rng()) & FieldMask, y = T(rng()) & FieldMask, z = T(rng()) & FieldMask;
+        if (Hilbert::FromMorton(Bmi::Encode(x, y, z)) != Hilbert::Encode(x, y, z) || Bmi::Decode(Hilbert::ToMorton(Hilbert::Encode(x, y, z))) != std::make_tuple(x, y, z)) {
+            std::cout << "  Mismatch for " << uint64_t(x) << ", " << uint64_t(y) << ", " << uint64_t(z) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool mortonnd_hilbert::TestCurve() {
+    return Reduce(std::logical_and<bool>{},
+        TestHilbertNDCurve<1, uint32_t, 8>(),
+        TestHilbertNDCurve<2, uint32_t, 6>(),
+        TestHilbertNDCurve<3, uint32_t, 4>(),
+        TestHilbertNDCurve<3, uint32_t, 5>(),
+        TestHilbertNDCurve<4, uint32_t, 3>(),
+        TestHilbertNDCurve<5, uint32_t, 3>(),
+        TestHilbertNDCurve<6, uint64_t, 2>(),
+        TestHilbertNDCurve<8, uint64_t, 2>()
+    );
+}
+
+bool mortonnd_hilbert::TestRoundTrip() {
+    return Reduce(std::logical_and<bool>{},
+        TestHilbertNDRoundTrip<2, uint32_t>(),
+        TestHilbertNDRoundTrip<2, uint64_t>(),
+        TestHilbertNDRoundTrip<3, uint32_t>(),
+        TestHilbertNDRoundTrip<3, uint64_t>(),
+        TestHilbertNDRoundTrip<3, uint64_t, 17>(),
+        TestHilbertNDRoundTrip<3, __uint128_t>(),
+        TestHilbertNDRoundTrip<4, uint64_t>(),
+        TestHilbertNDRoundTrip<5, uint64_t>(),
+        TestHilbertNDRoundTrip<16, uint64_t>(),
+        TestHilbertNDBmi<3, uint32_t>(),
+        TestHilbertNDBmi<3, uint64_t>()
+    );
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_hilbert {
+bool TestCurve();
+bool TestRoundTrip();
+}
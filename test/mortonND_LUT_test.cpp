@@ -3,6 +3,9 @@
 #include "mortonND_test_common.h"
 #include "variadic_placeholder.h"
 
+#include <random>
+#include <vector>
+
 template<size_t FieldBits, typename Ret, typename ...Fields, size_t ...FieldIdx, size_t ...N>
 bool TestEncodeMortonNDLutSet(type_sequence<Fields...>, std::index_sequence<FieldIdx...>, std::index_sequence<N...>) {
     // Generate all LUTs at compile-time
@@ -149,4 +152,90 @@ bool mortonnd_lut::TestDecode() {
         // 64 Dimensions
         TestDecodeMortonNDLutSet<64, 64>()
     );
+}
+
+template<size_t Fields, size_t FieldBits, size_t LutBits, size_t ...i>
+bool TestMortonNDLutBatch(std::index_sequence<i...>) {
+    static constexpr auto encoder = mortonnd::MortonNDLutEncoder<Fields, FieldBits, LutBits>();
+    static constexpr auto decoder = mortonnd::MortonNDLutDecoder<Fields, FieldBits, LutBits>();
+    using T = typename decltype(encoder)::type;
+
+    std::cout << "Testing " << Fields << "D LUT batch encoders/decoders (Bits/Field = " << FieldBits
+              << ", Bits/Lookup = " << LutBits << ", Vector encode = " << encoder.VectorBatch << ")..." << std::endl;
+
+    // Not a multiple of the vector width, so that the remainder loop is covered.
+    static const size_t Count = 1027;
+    static const size_t Stride = Fields + 1;
+
+    std::mt19937_64 rng(Fields * FieldBits);
+    std::vector<T> soa[Fields];
+    std::vector<T> aos(Count * Stride);
+    for (auto& field : soa) {
+        field.resize(Count);
+    }
+
+    for (size_t n = 0; n < Count; n++) {
+        for (size_t f = 0; f < Fields; f++) {
+            soa[f][n] = T(rng()) & encoder.InputMask();
+            aos[n * Stride + f] = soa[f][n];
+        }
+    }
+
+    std::vector<T> soaCodes(Count), aosCodes(Count);
+    encoder.EncodeBatch({{ soa[i].data()... }}, soaCodes.data(), Count);
+    encoder.EncodeBatch(aos.data(), Stride, aosCodes.data(), Count);
+
+    std::vector<T> soaDecoded[Fields];
+    std::vector<T> aosDecoded(Count * Stride);
+    for (auto& field : soaDecoded) {
+        field.resize(Count);
+    }
+
+    decoder.DecodeBatch(soaCodes.data(), Count, {{ soaDecoded[i].data()... }});
+    decoder.DecodeBatch(aosCodes.data(), Count, aosDecoded.data(), Stride);
+
+    bool ok = true;
+    for (size_t n = 0; n < Count; n++) {
+        const T correct = encoder.Encode(soa[i][n]...);
+        if (soaCodes[n] != correct || aosCodes[n] != correct) {
+            std::cout << "  Mismatch when batch encoding point " << n << std::endl;
+            std::cout << "    Correct: " << correct << " Computed (SoA): " << soaCodes[n] << " Computed (AoS): " << aosCodes[n] << std::endl;
+            ok = false;
+        }
+
+        for (size_t f = 0; f < Fields; f++) {
+            if (soaDecoded[f][n] != soa[f][n] || aosDecoded[n * Stride + f] != soa[f][n]) {
+                std::cout << "  Mismatch when batch decoding field " << f << " of point " << n << std::endl;
+                std::cout << "    Correct field: " << soa[f][n] << " Computed field (SoA): " << soaDecoded[f][n]
+                          << " Computed field (AoS): " << aosDecoded[n * Stride + f] << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    return ok;
+}
+
+template<size_t Fields, size_t FieldBits, size_t LutBits>
+bool TestMortonNDLutBatch() {
+    return TestMortonNDLutBatch<Fields, FieldBits, LutBits>(std::make_index_sequence<Fields>{});
+}
+
+bool mortonnd_lut::TestBatch() {
+    return Reduce(
+        std::logical_and<bool>{},
+
+        // 1, 2, 4 and 8 byte LUT values.
+        TestMortonNDLutBatch<1, 40, 8>(),
+        TestMortonNDLutBatch<2, 16, 8>(),
+        TestMortonNDLutBatch<2, 32, 11>(),
+        TestMortonNDLutBatch<3, 10, 10>(),
+        TestMortonNDLutBatch<3, 21, 11>(),
+        TestMortonNDLutBatch<3, 21, 7>(),
+        TestMortonNDLutBatch<4, 16, 4>(),
+        TestMortonNDLutBatch<5, 12, 12>(),
+
+        // Tables too small for the vector path.
+        TestMortonNDLutBatch<1, 16, 1>()
+    );
 }
\ No newline at end of file
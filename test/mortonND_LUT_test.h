@@ -3,4 +3,5 @@
 namespace mortonnd_lut {
 bool TestEncode();
 bool TestDecode();
+bool TestBatch();
 }
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "mortonND_LocCode_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_LocCode.h>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+using LocCode3D = mortonnd::MortonNDLocCode<3, uint64_t, true>;
+static_assert(LocCode3D::MaxLevel == 21, "Sentinel codes reserve a bit.");
+static_assert(LocCode3D::Root() == 1, "The root is the sentinel alone.");
+static_assert(LocCode3D::Child(LocCode3D::Child(LocCode3D::Root(), 5), 2) == 0x6A, "Children append their index.");
+static_assert(LocCode3D::Level(0x6A) == 2 && LocCode3D::Parent(0x6A) == 0xD && LocCode3D::ChildIndex(0x6A) == 2, "");
+static_assert(LocCode3D::CommonAncestor(0x6A, 0x69) == 0xD && LocCode3D::CommonAncestor(0x6A, 0x1) == 0x1, "");
+static_assert(LocCode3D::DescendantRange(0xD).first == uint64_t(5) << 60, "");
+static_assert(mortonnd::MortonNDLocCode<3, uint64_t>::MaxLevel == 21, "");
+static_assert(mortonnd::MortonNDLocCode<2, uint32_t>::CommonAncestor({ 0x80000000u, 1 }, { 0xA0000000u, 16 }).level == 1, "");
+
+template<size_t Dimensions, typename T>
+using Fields = std::array<uint64_t, Dimensions>;
+
+// Reference (de)interleaving, a bit at a time.
+template<size_t Dimensions, typename T>
+static Fields<Dimensions, T> Decode(T code, size_t fieldBits) {
+    Fields<Dimensions, T> fields{};
+    for (size_t bit = 0; bit < fieldBits; bit++) {
+        for (size_t f = 0; f < Dimensions; f++) {
+            fields[f] |= uint64_t(code >> (bit * Dimensions + f) & 1) << bit;
+        }
+    }
+
+    return fields;
+}
+
+template<size_t Dimensions, typename T>
+static T Encode(const Fields<Dimensions, T>& fields, size_t fieldBits) {
+    T code = 0;
+    for (size_t bit = 0; bit < fieldBits; bit++) {
+        for (size_t f = 0; f < Dimensions; f++) {
+            code |= T(fields[f] >> bit & 1) << (bit * Dimensions + f);
+        }
+    }
+
+    return code;
+}
+
+// The prefix of the cell at 'level' containing 'fields' (the low bits of each field cleared).
+template<size_t Dimensions, typename T>
+static T CellPrefix(Fields<Dimensions, T> fields, size_t level, size_t fieldBits) {
+    for (auto& field : fields) {
+        field = field >> (fieldBits - level) << (fieldBits - level);
+    }
+
+    return Encode<Dimensions, T>(fields, fieldBits);
+}
+
+// The deepest level (at most 'level') at which the cells containing 'a' and 'b' are the same.
+template<size_t Dimensions, typename T>
+static size_t CommonLevel(const Fields<Dimensions, T>& a, const Fields<Dimensions, T>& b, size_t level, size_t fieldBits) {
+    while (CellPrefix<Dimensions, T>(a, level, fieldBits) != CellPrefix<Dimensions, T>(b, level, fieldBits)) {
+        level--;
+    }
+
+    return level;
+}
+
+template<size_t Dimensions, typename T, bool Sentinel, size_t FieldBits>
+static bool TestCellsConfig(size_t count) {
+    using LocCode = mortonnd::MortonNDLocCode<Dimensions, T, Sentinel, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Dimensions << "D locational codes (Bits/Field = "
+              << FieldBits << ", sentinel = " << Sentinel << ")..." << std::endl;
+
+    std::mt19937_64 rng(FieldBits + Dimensions);
+    const auto randomPoint = [&]() {
+        const T code = (T(rng()) << 64 % std::numeric_limits<T>::digits) ^ T(rng());
+        return Dimensions * FieldBits >= size_t(std::numeric_limits<T>::digits) ? code : T(code & ((T(1) << (Dimensions * FieldBits)) - 1));
+    };
+
+    for (size_t n = 0; n < count; n++) {
+        const auto p = randomPoint();
+        const auto q = n % 4 == 0 ? p ^ T(rng() % 64) : randomPoint();
+        const auto pFields = Decode<Dimensions, T>(p, FieldBits);
+        const auto qFields = Decode<Dimensions, T>(q, FieldBits);
+        const auto level = size_t(rng() % (FieldBits + 1));
+        const auto otherLevel = size_t(rng() % (FieldBits + 1));
+
+        const auto cell = LocCode::FromPoint(p, level);
+        const auto other = LocCode::FromPoint(q, otherLevel);
+        const auto prefix = CellPrefix<Dimensions, T>(pFields, level, FieldBits);
+        if (LocCode::Level(cell) != level || LocCode::Prefix(cell) != prefix) {
+            std::cout << "  Bad cell at level " << level << std::endl;
+            return false;
+        }
+
+        const auto range = LocCode::DescendantRange(cell);
+        auto last = pFields;
+        for (auto& field : last) {
+            field |= (uint64_t(1) << (FieldBits - level)) - 1;
+        }
+
+        if (range.first != prefix || range.second != Encode<Dimensions, T>(last, FieldBits) || p < range.first || p > range.second) {
+            std::cout << "  Bad descendant range at level " << level << std::endl;
+            return false;
+        }
+
+        const auto common = LocCode::CommonAncestor(cell, other);
+        const auto expectedLevel = CommonLevel<Dimensions, T>(pFields, qFields, std::min(level, otherLevel), FieldBits);
+        if (LocCode::Level(common) != expectedLevel || LocCode::Prefix(common) != CellPrefix<Dimensions, T>(pFields, expectedLevel, FieldBits)
+                || LocCode::Prefix(LocCode::CommonAncestor(other, cell)) != LocCode::Prefix(common)) {
+            std::cout << "  Bad common ancestor of levels " << level << " and " << otherLevel << std::endl;
+            return false;
+        }
+
+        if (!LocCode::Contains(common, cell) || !LocCode::Contains(common, other)
+                || LocCode::Contains(cell, other) != (expectedLevel == level)) {
+            std::cout << "  Bad containment at level " << level << std::endl;
+            return false;
+        }
+
+        if (level > 0) {
+            const auto parent = LocCode::Parent(cell);
+            size_t index = 0;
+            for (size_t f = 0; f < Dimensions; f++) {
+                index |= size_t(pFields[f] >> (FieldBits - level) & 1) << f;
+            }
+
+            if (LocCode::Level(parent) != level - 1 || LocCode::Prefix(parent) != CellPrefix<Dimensions, T>(pFields, level - 1, FieldBits)
+                    || LocCode::ChildIndex(cell) != index || LocCode::Prefix(LocCode::Child(parent, index)) != prefix) {
+                std::cout << "  Bad parent at level " << level << std::endl;
+                return false;
+            }
+
+            for (size_t i = 0; i < LocCode::Children; i++) {
+                const auto sibling = LocCode::Sibling(cell, i);
+                auto siblingFields = pFields;
+                for (size_t f = 0; f < Dimensions; f++) {
+                    const auto bit = uint64_t(1) << (FieldBits - level);
+                    siblingFields[f] = (siblingFields[f] & ~bit) | ((i >> f & 1) != 0 ? bit : 0);
+                }
+
+                if (LocCode::Level(sibling) != level || LocCode::ChildIndex(sibling) != i
+                        || LocCode::Prefix(sibling) != CellPrefix<Dimensions, T>(siblingFields, level, FieldBits)) {
+                    std::cout << "  Bad sibling " << i << " at level " << level << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+// Every cell of a small grid: cells are distinct, and each point is in exactly the cells on its
+// path from the root.
+template<size_t Dimensions, typename T, bool Sentinel, size_t FieldBits>
+static bool TestExhaustiveConfig() {
+    using LocCode = mortonnd::MortonNDLocCode<Dimensions, T, Sentinel, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Dimensions << "D locational codes exhaustively (Bits/Field = "
+              << FieldBits << ", sentinel = " << Sentinel << ")..." << std::endl;
+
+    // Breadth-first, from the root.
+    std::vector<typename LocCode::Cell> cells(1, LocCode::Root());
+    for (size_t i = 0; i < cells.size(); i++) {
+        if (LocCode::Level(cells[i]) < FieldBits) {
+            for (size_t child = 0; child < LocCode::Children; child++) {
+                cells.push_back(LocCode::Child(cells[i], child));
+            }
+        }
+    }
+
+    std::set<std::pair<T, size_t>> distinct;
+    for (const auto& cell : cells) {
+        distinct.emplace(LocCode::Prefix(cell), LocCode::Level(cell));
+    }
+
+    if (distinct.size() != cells.size()) {
+        std::cout << "  Cells aren't distinct" << std::endl;
+        return false;
+    }
+
+    const T points = T(1) << (Dimensions * FieldBits);
+    for (T p = 0; p < points; p++) {
+        size_t containing = 0;
+        for (const auto& cell : cells) {
+            const auto range = LocCode::DescendantRange(cell);
+            const bool inRange = range.first <= p && p <= range.second;
+            if (inRange != LocCode::Contains(cell, LocCode::FromPoint(p, FieldBits))) {
+                std::cout << "  Range and containment disagree for point " << uint64_t(p) << std::endl;
+                return false;
+            }
+
+            containing += inRange;
+        }
+
+        if (containing != FieldBits + 1) {
+            std::cout << "  Point " << uint64_t(p) << " is in " << containing << " cells" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool mortonnd_loccode::TestCells() {
+    return Reduce(std::logical_and<bool>{},
+        TestCellsConfig<2, uint32_t, false, 16>(10000),
+        TestCellsConfig<2, uint32_t, true, 15>(10000),
+        TestCellsConfig<3, uint64_t, false, 21>(10000),
+        TestCellsConfig<3, uint64_t, true, 21>(10000),
+        TestCellsConfig<3, uint64_t, false, 10>(10000),
+        TestCellsConfig<4, __uint128_t, true, 31>(10000),
+        TestCellsConfig<5, uint32_t, false, 6>(10000),
+        TestCellsConfig<1, uint64_t, true, 63>(10000)
+    );
+}
+
+bool mortonnd_loccode::TestExhaustive() {
+    return Reduce(std::logical_and<bool>{},
+        TestExhaustiveConfig<2, uint32_t, false, 4>(),
+        TestExhaustiveConfig<2, uint32_t, true, 4>(),
+        TestExhaustiveConfig<3, uint64_t, true, 3>()
+    );
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_loccode {
+bool TestCells();
+bool TestExhaustive();
+}
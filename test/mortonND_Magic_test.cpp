@@ -0,0 +1,84 @@
+#include "mortonND_Magic_test.h"
+#include "mortonND_test_util.h"
+#include "mortonND_test_common.h"
+
+#include <morton-nd/mortonND_Magic.h>
+
+// Encoding and decoding must be usable in constant expressions.
+static_assert(mortonnd::MortonNDMagic_3D_32::Encode(9, 5, 1) == 0x287, "Unexpected constexpr encoding.");
+static_assert(std::get<1>(mortonnd::MortonNDMagic_3D_32::Decode(0x287)) == 5, "Unexpected constexpr decoding.");
+
+template<size_t FieldBits, typename Ret, typename ...Fields>
+bool TestMortonNDMagicEncoder(type_sequence<Fields...>) {
+    static const auto func = std::function<Ret(Fields...)>([](Fields... fields) {
+        return mortonnd::MortonNDMagic<sizeof...(Fields), Ret, FieldBits>::Encode(fields...);
+    });
+    return TestEncodeFunction<FieldBits>(func);
+}
+
+template<size_t Fields, typename T, size_t FieldBits = std::numeric_limits<T>::digits / Fields>
+bool TestMortonNDMagicEncoder() {
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D magic bits encoders (Bits/Field = " << FieldBits << ")...";
+    return TestMortonNDMagicEncoder<FieldBits, T>(make_type_sequence<Fields, T>());
+}
+
+template<size_t FieldBits, typename Ret, typename ...Fields>
+bool TestMortonNDMagicDecoder(type_sequence<Fields...>) {
+    static const auto func = std::function<std::tuple<Fields...>(Ret)>([](Ret encoding) {
+        return mortonnd::MortonNDMagic<sizeof...(Fields), Ret, FieldBits>::Decode(encoding);
+    });
+    return TestDecodeFunction<FieldBits>(func);
+}
+
+template<size_t Fields, typename T, size_t FieldBits = std::numeric_limits<T>::digits / Fields>
+bool TestMortonNDMagicDecoder() {
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D magic bits decoders (Bits/Field = " << FieldBits << ")..." << std::endl;
+    return TestMortonNDMagicDecoder<FieldBits, T>(make_type_sequence<Fields, T>());
+}
+
+bool mortonnd_magic::TestEncode() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDMagicEncoder<1, uint64_t>(),
+        TestMortonNDMagicEncoder<1, uint32_t>(),
+
+        TestMortonNDMagicEncoder<2, uint64_t>(),
+        TestMortonNDMagicEncoder<2, uint32_t>(),
+        TestMortonNDMagicEncoder<2, uint64_t, 19>(),
+
+        TestMortonNDMagicEncoder<3, uint64_t>(),
+        TestMortonNDMagicEncoder<3, uint32_t>(),
+        TestMortonNDMagicEncoder<3, uint64_t, 17>(),
+
+        TestMortonNDMagicEncoder<4, uint64_t>(),
+        TestMortonNDMagicEncoder<4, uint32_t>(),
+
+        TestMortonNDMagicEncoder<5, uint64_t>(),
+        TestMortonNDMagicEncoder<5, uint32_t>(),
+
+        TestMortonNDMagicEncoder<8, uint64_t>(),
+        TestMortonNDMagicEncoder<16, uint64_t>()
+    );
+}
+
+bool mortonnd_magic::TestDecode() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDMagicDecoder<1, uint32_t>(),
+
+        TestMortonNDMagicDecoder<2, uint64_t>(),
+        TestMortonNDMagicDecoder<2, uint32_t>(),
+        TestMortonNDMagicDecoder<2, uint64_t, 19>(),
+
+        TestMortonNDMagicDecoder<3, uint64_t>(),
+        TestMortonNDMagicDecoder<3, uint32_t>(),
+        TestMortonNDMagicDecoder<3, uint64_t, 17>(),
+
+        TestMortonNDMagicDecoder<4, uint64_t>(),
+        TestMortonNDMagicDecoder<4, uint32_t>(),
+
+        TestMortonNDMagicDecoder<5, uint64_t>(),
+        TestMortonNDMagicDecoder<5, uint32_t>(),
+
+        TestMortonNDMagicDecoder<8, uint64_t>(),
+        TestMortonNDMagicDecoder<16, uint64_t>()
+    );
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_magic {
+bool TestEncode();
+bool TestDecode();
+}
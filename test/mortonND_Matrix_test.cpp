@@ -0,0 +1,152 @@
+#include "mortonND_Matrix_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_Matrix.h>
+
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+template<typename T>
+static std::vector<T> RandomMatrix(size_t rows, size_t cols, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<T> values(rows * cols);
+    for (auto& value : values) {
+        value = T(rng() % 1000) - T(500);
+    }
+
+    return values;
+}
+
+template<typename T, size_t TileBits>
+static bool TestLayoutMatrix(size_t rows, size_t cols, size_t pad) {
+    using Matrix = mortonnd::MortonNDMatrix<T, TileBits>;
+    std::cout << "Testing matrix layout (" << rows << " x " << cols << ", tile size = " << Matrix::TileSize
+              << ", pitch = " << cols + pad << ")..." << std::endl;
+
+    const size_t pitch = cols + pad;
+    const auto source = RandomMatrix<T>(rows, pitch, rows * cols);
+    const auto matrix = Matrix::FromRowMajor(source.data(), rows, cols, pitch);
+
+    if (matrix.Rows() != rows || matrix.Cols() != cols || matrix.size() % Matrix::TileElements != 0) {
+        std::cout << "  Unexpected dimensions" << std::endl;
+        return false;
+    }
+
+    for (size_t row = 0; row < rows; row++) {
+        for (size_t col = 0; col < cols; col++) {
+            // Reference: the tile's (column, row) bits interleaved, above the row-major offset.
+            uint64_t tile = 0;
+            for (size_t bit = 0; bit < 32; bit++) {
+                tile |= uint64_t(((col >> TileBits) >> bit) & 1) << (2 * bit);
+                tile |= uint64_t(((row >> TileBits) >> bit) & 1) << (2 * bit + 1);
+            }
+
+            const size_t index = tile * Matrix::TileElements + (row % Matrix::TileSize) * Matrix::TileSize + col % Matrix::TileSize;
+            if (Matrix::IndexOf(row, col) != index || matrix.at(row, col) != source[row * pitch + col]
+                    || &matrix(row, col) != matrix.data() + index) {
+                std::cout << "  Mismatch at (" << row << ", " << col << ")" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    // The padding of 'restored' is left untouched.
+    std::vector<T> restored(source.size(), T(7));
+    matrix.ToRowMajor(restored.data(), pitch);
+    for (size_t n = 0; n < source.size(); n++) {
+        if (restored[n] != (n % pitch < cols ? source[n] : T(7))) {
+            std::cout << "  Round trip mismatch at " << n << std::endl;
+            return false;
+        }
+    }
+
+    try {
+        matrix.at(rows, 0);
+        std::cout << "  Expected std::out_of_range" << std::endl;
+        return false;
+    } catch (const std::out_of_range&) {
+    }
+
+    return true;
+}
+
+template<typename T, size_t TileBits>
+static bool TestKernelsMatrix(size_t m, size_t k, size_t n) {
+    using Matrix = mortonnd::MortonNDMatrix<T, TileBits>;
+    std::cout << "Testing matrix transpose / multiply (" << m << " x " << k << " * " << k << " x " << n
+              << ", tile size = " << Matrix::TileSize << ")..." << std::endl;
+
+    const auto a = RandomMatrix<T>(m, k, m + k);
+    const auto b = RandomMatrix<T>(k, n, k + n);
+    const auto c = RandomMatrix<T>(m, n, m + n);
+
+    // Transpose.
+    Matrix transposed;
+    mortonnd::Transpose(Matrix::FromRowMajor(a.data(), m, k), transposed);
+    if (transposed.Rows() != k || transposed.Cols() != m) {
+        std::cout << "  Unexpected transpose dimensions" << std::endl;
+        return false;
+    }
+
+    for (size_t row = 0; row < m; row++) {
+        for (size_t col = 0; col < k; col++) {
+            if (transposed(col, row) != a[row * k + col]) {
+                std::cout << "  Transpose mismatch at (" << row << ", " << col << ")" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    // c += a * b.
+    auto product = Matrix::FromRowMajor(c.data(), m, n);
+    mortonnd::MultiplyAdd(Matrix::FromRowMajor(a.data(), m, k), Matrix::FromRowMajor(b.data(), k, n), product);
+
+    std::vector<T> expected = c;
+    for (size_t row = 0; row < m; row++) {
+        for (size_t inner = 0; inner < k; inner++) {
+            for (size_t col = 0; col < n; col++) {
+                expected[row * n + col] += a[row * k + inner] * b[inner * n + col];
+            }
+        }
+    }
+
+    std::vector<T> actual(m * n);
+    product.ToRowMajor(actual.data());
+    if (actual != expected) {
+        std::cout << "  Multiply mismatch" << std::endl;
+        return false;
+    }
+
+    try {
+        mortonnd::MultiplyAdd(Matrix(m, k + 1), Matrix(k, n), product);
+        std::cout << "  Expected std::invalid_argument" << std::endl;
+        return false;
+    } catch (const std::invalid_argument&) {
+    }
+
+    return true;
+}
+
+bool mortonnd_matrix::TestLayout() {
+    bool ok = true;
+    ok &= TestLayoutMatrix<int32_t, 2>(16, 16, 0);
+    ok &= TestLayoutMatrix<int32_t, 2>(37, 53, 3);
+    ok &= TestLayoutMatrix<float, 5>(100, 300, 0);
+    ok &= TestLayoutMatrix<double, 3>(129, 7, 1);
+    ok &= TestLayoutMatrix<int64_t, 4>(1, 1, 0);
+    ok &= TestLayoutMatrix<int64_t, 4>(0, 5, 0);
+    return ok;
+}
+
+bool mortonnd_matrix::TestKernels() {
+    bool ok = true;
+    ok &= TestKernelsMatrix<int64_t, 2>(16, 16, 16);
+    ok &= TestKernelsMatrix<int64_t, 2>(30, 17, 45);
+    ok &= TestKernelsMatrix<int32_t, 3>(64, 128, 32);
+    ok &= TestKernelsMatrix<int32_t, 5>(100, 70, 130);
+    ok &= TestKernelsMatrix<double, 4>(97, 33, 65);
+    ok &= TestKernelsMatrix<int64_t, 1>(5, 9, 3);
+    return ok;
+}
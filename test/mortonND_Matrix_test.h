@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_matrix {
+bool TestLayout();
+bool TestKernels();
+}
@@ -0,0 +1,135 @@
+#include "mortonND_Mixed_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_LUT.h>
+#include <morton-nd/mortonND_Mixed.h>
+
+#include <array>
+#include <iostream>
+#include <random>
+
+// Encoding and decoding with the LUT must be usable in constant expressions.
+static constexpr auto LutEncoder_5_3 = mortonnd::MortonNDLutMixedEncoder<uint32_t, 2, 5, 3>();
+static constexpr auto LutDecoder_5_3 = mortonnd::MortonNDLutMixedDecoder<uint32_t, 3, 5, 3>();
+static_assert(LutEncoder_5_3.Encode(0x1F, 0) == 0xD5, "Unexpected constexpr encoding.");
+static_assert(std::get<1>(LutDecoder_5_3.Decode(LutEncoder_5_3.Encode(9, 5))) == 5, "Unexpected constexpr decoding.");
+
+// Chunks with the same spacing share a LUT.
+static_assert(mortonnd::MortonNDLutMixedEncoder<uint64_t, 8, 20, 20, 12, 12>::TableCount == 4, "Unexpected LUT count.");
+static_assert(mortonnd::MortonNDLutMixedDecoder<uint64_t, 8, 20, 20, 12, 12>::TableCount == 2, "Unexpected LUT count.");
+static_assert(mortonnd::MortonNDLutMixedDecoder<uint64_t, 8, 16, 16, 16, 16>::TableCount == 1, "Unexpected LUT count.");
+
+// Interleaves 'fields' one bit at a time, skipping fields which have run out of bits.
+template<typename T, size_t Fields>
+static T ReferenceEncode(const std::array<T, Fields>& fields, const std::array<size_t, Fields>& widths) {
+    T encoding = 0;
+    size_t offset = 0;
+    for (size_t bit = 0; bit < std::numeric_limits<T>::digits; bit++) {
+        for (size_t f = 0; f < Fields; f++) {
+            if (bit < widths[f]) {
+                encoding |= T((fields[f] >> bit) & 1U) << offset++;
+            }
+        }
+    }
+
+    return encoding;
+}
+
+template<typename Engine, typename T, size_t ...i>
+static T Encode(const Engine& engine, const std::array<T, sizeof...(i)>& fields, std::index_sequence<i...>) {
+    return engine.Encode(std::get<i>(fields)...);
+}
+
+template<typename T, size_t ...i>
+static auto MakeTuple(const std::array<T, sizeof...(i)>& fields, std::index_sequence<i...>) {
+    return std::make_tuple(std::get<i>(fields)...);
+}
+
+// Checks the BMI2 and LUT engines against the reference interleaving for random points.
+template<typename T, size_t LutBits, size_t ...FieldBits>
+static bool TestMixedEncodeDecode() {
+    static constexpr size_t Fields = sizeof...(FieldBits);
+    using Bmi = mortonnd::MortonNDBmiMixed<T, FieldBits...>;
+    constexpr auto LutEncoder = mortonnd::MortonNDLutMixedEncoder<T, LutBits, FieldBits...>();
+    constexpr auto LutDecoder = mortonnd::MortonNDLutMixedDecoder<T, LutBits, FieldBits...>();
+    const std::array<size_t, Fields> widths = {{ FieldBits... }};
+
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit mixed encoders/decoders (Bits/Field =";
+    for (auto width : widths) {
+        std::cout << " " << width;
+    }
+    std::cout << ", LUT bits = " << LutBits << ")..." << std::endl;
+
+    std::mt19937_64 rng(Fields * LutBits);
+    auto random = [&]() { return (T(rng()) << (std::numeric_limits<T>::digits > 64 ? 64 : 0)) ^ T(rng()); };
+
+    for (size_t n = 0; n < 10000; n++) {
+        std::array<T, Fields> fields;
+        for (size_t f = 0; f < Fields; f++) {
+            // Include each field's minimum and maximum values.
+            const T mask = (T(1) << (widths[f] - 1) << 1) - 1;
+            fields[f] = n == 0 ? 0 : n == 1 ? mask : random() & mask;
+        }
+
+        const T expected = ReferenceEncode(fields, widths);
+        const T bmi = Encode(Bmi{}, fields, std::make_index_sequence<Fields>{});
+        const T lut = Encode(LutEncoder, fields, std::make_index_sequence<Fields>{});
+        const auto tuple = MakeTuple(fields, std::make_index_sequence<Fields>{});
+
+        if (bmi != expected || lut != expected || Bmi::Decode(expected) != tuple || LutDecoder.Decode(expected) != tuple) {
+            std::cout << "  Mismatch for code " << uint64_t(expected) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// With a single width, the layout must match the other engines'.
+template<size_t Fields, typename T, typename Bmi, size_t ...i>
+static bool TestMixedUniform(std::index_sequence<i...>) {
+    static constexpr size_t FieldBits = std::numeric_limits<T>::digits / Fields;
+    using BmiMixed = mortonnd::MortonNDBmiMixed<T, (void(i), FieldBits)...>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D mixed encoders with a single width..." << std::endl;
+
+    std::mt19937_64 rng(Fields);
+    for (size_t n = 0; n < 10000; n++) {
+        std::array<T, Fields> fields;
+        for (auto& field : fields) {
+            field = T(rng()) & ((T(1) << FieldBits) - 1);
+        }
+
+        const T expected = Bmi::Encode(std::get<i>(fields)...);
+        if (BmiMixed::Encode(std::get<i>(fields)...) != expected
+            || BmiMixed::Decode(expected) != MakeTuple(fields, std::make_index_sequence<Fields>{})) {
+            std::cout << "  Mismatch for code " << uint64_t(expected) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool mortonnd_mixed::TestEncodeDecode() {
+    return Reduce(std::logical_and<bool>{},
+        TestMixedEncodeDecode<uint32_t, 2, 5, 3>(),
+        TestMixedEncodeDecode<uint32_t, 3, 1, 7, 2>(),
+        TestMixedEncodeDecode<uint32_t, 8, 16, 10, 6>(),
+        TestMixedEncodeDecode<uint64_t, 8, 20, 20, 12, 12>(),
+        TestMixedEncodeDecode<uint64_t, 11, 20, 20, 12, 12>(),
+        TestMixedEncodeDecode<uint64_t, 5, 3, 30, 1, 17, 9>(),
+        TestMixedEncodeDecode<uint64_t, 8, 64>(),
+        TestMixedEncodeDecode<__uint128_t, 8, 40, 40, 30, 10>(),
+        TestMixedEncodeDecode<__uint128_t, 10, 64, 64>()
+    );
+}
+
+bool mortonnd_mixed::TestUniform() {
+    return Reduce(std::logical_and<bool>{},
+        TestMixedUniform<2, uint32_t, mortonnd::MortonNDBmi_2D_32>(std::make_index_sequence<2>{}),
+        TestMixedUniform<3, uint64_t, mortonnd::MortonNDBmi_3D_64>(std::make_index_sequence<3>{}),
+        TestMixedUniform<5, uint64_t, mortonnd::MortonNDBmi<5, uint64_t>>(std::make_index_sequence<5>{}),
+        TestMixedUniform<3, __uint128_t, mortonnd::MortonNDBmi_3D_128>(std::make_index_sequence<3>{})
+    );
+}
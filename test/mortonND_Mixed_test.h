@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_mixed {
+bool TestEncodeDecode();
+bool TestUniform();
+}
@@ -0,0 +1,152 @@
+#include "mortonND_Nearest_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_Nearest.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+template<typename T>
+static T RandomCode(std::mt19937_64& rng, size_t codeBits) {
+    const T code = (T(rng()) << 64 % std::numeric_limits<T>::digits) ^ T(rng());
+    return codeBits >= size_t(std::numeric_limits<T>::digits) ? code : T(code & ((T(1) << codeBits) - 1));
+}
+
+// Sorted random codes: half uniform, half in a few clusters, with duplicates.
+template<typename T>
+static std::vector<T> RandomCodes(size_t count, size_t codeBits, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<T> codes(count);
+    for (size_t n = 0; n < count; n++) {
+        codes[n] = n % 2 == 0 || n < 8 ? RandomCode<T>(rng, codeBits) : n % 5 == 1 ? codes[rng() % n]
+            : codes[rng() % 8] ^ (RandomCode<T>(rng, codeBits) & T(0xFFFF));
+    }
+
+    std::sort(codes.begin(), codes.end());
+    return codes;
+}
+
+// The reference: every code's distance, sorted by (distance, index).
+template<typename Nearest, size_t Dimensions, size_t FieldBits, typename T>
+static std::vector<std::pair<typename Nearest::Distance, size_t>> BruteForce(const std::vector<T>& codes, T query) {
+    using Distance = typename Nearest::Distance;
+
+    std::vector<std::pair<Distance, size_t>> all(codes.size());
+    for (size_t i = 0; i < codes.size(); i++) {
+        Distance distance = 0;
+        for (size_t f = 0; f < Dimensions; f++) {
+            uint64_t a = 0, b = 0;
+            for (size_t bit = 0; bit < FieldBits; bit++) {
+                a |= uint64_t(codes[i] >> (bit * Dimensions + f) & 1) << bit;
+                b |= uint64_t(query >> (bit * Dimensions + f) & 1) << bit;
+            }
+
+            const auto diff = Distance(a > b ? a - b : b - a);
+            distance += diff * diff;
+        }
+
+        all[i] = { distance, i };
+    }
+
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+template<typename Nearest, size_t Dimensions, size_t FieldBits, typename T>
+static bool CheckResult(const std::vector<T>& codes, T query, size_t k, size_t found,
+        const size_t* indices, const typename Nearest::Distance* distances) {
+    const auto expected = BruteForce<Nearest, Dimensions, FieldBits>(codes, query);
+    if (found != std::min(k, codes.size())) {
+        std::cout << "  Found " << found << " neighbors, expected " << std::min(k, codes.size()) << std::endl;
+        return false;
+    }
+
+    for (size_t n = 0; n < found; n++) {
+        if (indices[n] != expected[n].second || distances[n] != expected[n].first) {
+            std::cout << "  Neighbor " << n << " is " << indices[n] << ", expected " << expected[n].second << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<size_t Dimensions, typename T, size_t FieldBits>
+static bool TestNearestConfig(size_t count, size_t k) {
+    using Nearest = mortonnd::MortonNDNearest<Dimensions, T, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Dimensions << "D kNN (count = " << count
+              << ", Bits/Field = " << FieldBits << ", k = " << k << ")..." << std::endl;
+
+    const auto codes = RandomCodes<T>(count, Dimensions * FieldBits, count + k);
+    std::mt19937_64 rng(count);
+
+    std::vector<size_t> indices(k);
+    std::vector<typename Nearest::Distance> distances(k);
+    for (size_t q = 0; q < 100; q++) {
+        // Some queries are points of the array (or near them), the rest are anywhere.
+        const auto query = q % 3 == 0 && count > 0 ? codes[rng() % count] ^ T(q % 2) : RandomCode<T>(rng, Dimensions * FieldBits);
+        const auto found = Nearest::Nearest(codes.data(), count, query, k, indices.data(), distances.data());
+        if (!CheckResult<Nearest, Dimensions, FieldBits>(codes, query, k, found, indices.data(), distances.data())) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<size_t Dimensions, typename T, size_t FieldBits>
+static bool TestBatchConfig(size_t count, size_t queryCount, size_t k) {
+    using Nearest = mortonnd::MortonNDNearest<Dimensions, T, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Dimensions << "D batched kNN (count = " << count
+              << ", queries = " << queryCount << ", Bits/Field = " << FieldBits << ", k = " << k << ")..." << std::endl;
+
+    const auto codes = RandomCodes<T>(count, Dimensions * FieldBits, count);
+
+    // Unsorted queries, clustered like the points.
+    auto queries = RandomCodes<T>(queryCount, Dimensions * FieldBits, count + 1);
+    std::shuffle(queries.begin(), queries.end(), std::mt19937_64(queryCount));
+
+    std::vector<size_t> indices(queryCount * k);
+    std::vector<typename Nearest::Distance> distances(queryCount * k);
+    Nearest::NearestBatch(codes.data(), count, queries.data(), queryCount, k, indices.data(), distances.data());
+
+    for (size_t q = 0; q < queryCount; q++) {
+        if (!CheckResult<Nearest, Dimensions, FieldBits>(codes, queries[q], k, std::min(k, count), &indices[q * k], &distances[q * k])) {
+            std::cout << "  (query " << q << ")" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool mortonnd_nearest::TestNearest() {
+    return Reduce(std::logical_and<bool>{},
+        TestNearestConfig<2, uint32_t, 16>(0, 4),
+        TestNearestConfig<2, uint32_t, 16>(1, 4),
+        TestNearestConfig<2, uint32_t, 16>(3000, 0),
+        TestNearestConfig<2, uint32_t, 16>(3000, 1),
+        TestNearestConfig<2, uint32_t, 16>(3000, 8),
+        TestNearestConfig<2, uint64_t, 32>(3000, 5),
+        TestNearestConfig<3, uint64_t, 21>(5000, 1),
+        TestNearestConfig<3, uint64_t, 21>(5000, 16),
+        TestNearestConfig<3, uint32_t, 4>(2000, 10),
+        TestNearestConfig<4, __uint128_t, 32>(2000, 6),
+        TestNearestConfig<5, uint64_t, 12>(2000, 3),
+        TestNearestConfig<3, uint64_t, 21>(50, 64)
+    );
+}
+
+bool mortonnd_nearest::TestBatch() {
+    return Reduce(std::logical_and<bool>{},
+        TestBatchConfig<2, uint32_t, 16>(0, 10, 3),
+        TestBatchConfig<2, uint32_t, 16>(2000, 300, 1),
+        TestBatchConfig<3, uint64_t, 21>(5000, 300, 8),
+        TestBatchConfig<3, uint32_t, 4>(1000, 300, 12),
+        TestBatchConfig<3, uint64_t, 21>(20, 50, 32)
+    );
+}
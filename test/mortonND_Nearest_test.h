@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_nearest {
+bool TestNearest();
+bool TestBatch();
+}
@@ -0,0 +1,136 @@
+#include "mortonND_Neighbors_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_LUT.h>
+#include <morton-nd/mortonND_Magic.h>
+#include <morton-nd/mortonND_Neighbors.h>
+
+#include <array>
+#include <iostream>
+#include <random>
+#include <vector>
+
+template<size_t Fields, typename T>
+using Point = std::array<T, Fields>;
+
+template<typename T, size_t...i>
+static auto CallWith(std::index_sequence<i...>, const T& point) {
+    return [&](auto encode) { return encode(std::get<i>(point)...); };
+}
+
+// Encodes with the given engine ('Encoder' provides 'Encode(fields...)').
+template<size_t Fields, typename T, typename Encoder>
+static T EncodePoint(const Encoder& encoder, const Point<Fields, T>& point) {
+    return CallWith(std::make_index_sequence<Fields>{}, point)([&](auto... fields) { return encoder.Encode(fields...); });
+}
+
+// Checks 'FaceNeighbors' and 'AllNeighbors' for codes produced by 'encoder', against
+// decode / offset / encode with 'MortonNDMagic'.
+template<size_t Fields, typename T, size_t FieldBits, typename Encoder>
+static bool TestMortonNDNeighbors(const char* engine, const Encoder& encoder, bool all) {
+    using Neighbors = mortonnd::MortonNDNeighbors<Fields, T, FieldBits>;
+    using Magic = mortonnd::MortonNDMagic<Fields, T, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D " << (all ? "all" : "face") << " neighbors of "
+              << engine << " codes (Bits/Field = " << FieldBits << ", Vector = " << Neighbors::VectorBatch << ")..." << std::endl;
+
+    static const T FieldMax = (T(1) << FieldBits) - 1;
+    static const size_t Count = 1003;
+    static const T Fill = 0xDEAD;
+    const size_t neighborCount = all ? Neighbors::AllCount : Neighbors::FaceCount;
+
+    std::mt19937_64 rng(Fields * FieldBits);
+    std::vector<Point<Fields, T>> points(Count);
+    std::vector<T> codes(Count);
+    for (size_t i = 0; i < Count; i++) {
+        for (auto& field : points[i]) {
+            // Favor the edges of the grid.
+            const auto choice = rng() % 4;
+            field = choice == 0 ? 0 : choice == 1 ? FieldMax : T(rng()) & FieldMax;
+        }
+        codes[i] = EncodePoint<Fields, T>(encoder, points[i]);
+    }
+
+    for (auto boundary : { mortonnd::MortonNDBoundary::Wrap, mortonnd::MortonNDBoundary::Fill }) {
+        std::vector<T> neighbors(neighborCount * Count);
+        if (all) {
+            Neighbors::AllNeighbors(codes.data(), Count, neighbors.data(), boundary, Fill);
+        } else {
+            Neighbors::FaceNeighbors(codes.data(), Count, neighbors.data(), boundary, Fill);
+        }
+
+        for (size_t k = 0; k < neighborCount; k++) {
+            for (size_t i = 0; i < Count; i++) {
+                bool outside = false;
+                Point<Fields, T> neighbor;
+                for (size_t d = 0; d < Fields; d++) {
+                    const int offset = all ? Neighbors::AllOffset(k, d) : Neighbors::FaceOffset(k, d);
+                    outside |= (offset < 0 && points[i][d] == 0) || (offset > 0 && points[i][d] == FieldMax);
+                    neighbor[d] = (points[i][d] + T(offset)) & FieldMax;
+                }
+
+                T expected = 0;
+                for (size_t d = 0; d < Fields; d++) {
+                    expected |= Magic::Dilate(neighbor[d]) << d;
+                }
+
+                if (boundary == mortonnd::MortonNDBoundary::Fill && outside) {
+                    expected = Fill;
+                }
+
+                if (neighbors[k * Count + i] != expected) {
+                    std::cout << "  Mismatch for neighbor " << k << " of code " << uint64_t(codes[i]) << ": expected "
+                              << uint64_t(expected) << ", found " << uint64_t(neighbors[k * Count + i]) << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+// Adapts an engine with a static 'Encode' (e.g. 'MortonNDBmi').
+template<typename Engine>
+struct StaticEncoder {
+    template<typename...Args>
+    auto Encode(Args... fields) const { return Engine::Encode(fields...); }
+};
+
+// Codes from 'MortonNDBmi' (fields span the whole code).
+template<size_t Fields, typename T>
+static bool TestMortonNDNeighborsBmi(bool all) {
+    return TestMortonNDNeighbors<Fields, T, std::numeric_limits<T>::digits / Fields>("BMI2", StaticEncoder<mortonnd::MortonNDBmi<Fields, T>>(), all);
+}
+
+// Codes from 'MortonNDLutEncoder' (fields may leave upper bits of the code unused).
+template<size_t Fields, typename T, size_t FieldBits, size_t LutBits>
+static bool TestMortonNDNeighborsLut(bool all) {
+    return TestMortonNDNeighbors<Fields, T, FieldBits>("LUT", mortonnd::MortonNDLutEncoder<Fields, FieldBits, LutBits, T>(), all);
+}
+
+bool mortonnd_neighbors::TestFace() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDNeighborsBmi<2, uint64_t>(false),
+        TestMortonNDNeighborsBmi<3, uint64_t>(false),
+        TestMortonNDNeighborsBmi<4, uint64_t>(false),
+        TestMortonNDNeighborsBmi<3, uint32_t>(false),
+        TestMortonNDNeighborsLut<2, uint64_t, 16, 8>(false),
+        TestMortonNDNeighborsLut<3, uint64_t, 10, 5>(false),
+        TestMortonNDNeighborsLut<4, uint64_t, 12, 6>(false),
+        TestMortonNDNeighborsLut<3, uint32_t, 10, 10>(false)
+    );
+}
+
+bool mortonnd_neighbors::TestAll() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDNeighborsBmi<2, uint64_t>(true),
+        TestMortonNDNeighborsBmi<3, uint64_t>(true),
+        TestMortonNDNeighborsBmi<4, uint64_t>(true),
+        TestMortonNDNeighborsBmi<3, uint32_t>(true),
+        TestMortonNDNeighborsLut<2, uint64_t, 16, 8>(true),
+        TestMortonNDNeighborsLut<3, uint64_t, 10, 5>(true),
+        TestMortonNDNeighborsLut<4, uint64_t, 12, 6>(true),
+        TestMortonNDNeighborsLut<3, uint32_t, 10, 10>(true)
+    );
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_neighbors {
+bool TestFace();
+bool TestAll();
+}
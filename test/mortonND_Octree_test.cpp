@@ -0,0 +1,270 @@
+#include "mortonND_Octree_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_Octree.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+template<typename T>
+static T LowBits(size_t bits) {
+    return bits >= size_t(std::numeric_limits<T>::digits) ? T(~T(0)) : T((T(1) << bits) - 1);
+}
+
+// Sorted random codes of 'codeBits' bits, half of them packed into a few small clusters (so that
+// the tree is deep in places), with duplicates.
+template<typename T>
+static std::vector<T> RandomCodes(size_t count, size_t codeBits, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    const auto random = [&]() { return ((T(rng()) << 64 % std::numeric_limits<T>::digits) ^ T(rng())) & LowBits<T>(codeBits); };
+
+    std::vector<T> clusters(8);
+    for (auto& cluster : clusters) {
+        cluster = random();
+    }
+
+    std::vector<T> codes(count);
+    for (size_t n = 0; n < count; n++) {
+        const auto& cluster = clusters[rng() % clusters.size()];
+        codes[n] = n % 2 == 0 ? random() : n % 7 == 1 ? cluster : cluster ^ (random() & LowBits<T>(codeBits / 3));
+    }
+
+    std::sort(codes.begin(), codes.end());
+    return codes;
+}
+
+// Checks the structure of 'tree' against the codes, by binary search for each node's cell.
+template<typename Octree, typename T>
+static bool CheckTree(const Octree& tree, const std::vector<T>& codes, size_t maxLeafPoints, bool balanced) {
+    const size_t Dimensions = __builtin_ctz(Octree::Children);
+    if (tree.size() == 0 || tree[0].level != 0 || tree[0].first != 0 || tree[0].count != codes.size()) {
+        std::cout << "  Bad root" << std::endl;
+        return false;
+    }
+
+    std::vector<size_t> references(tree.size());
+    for (size_t i = 0; i < tree.size(); i++) {
+        const auto& node = tree[i];
+        const auto cellBits = Dimensions * (Octree::MaxLevel - node.level);
+        const auto first = std::lower_bound(codes.begin(), codes.end(), node.prefix);
+        const T end = node.level == 0 ? T(0) : T(node.prefix + (T(1) << cellBits));
+        const auto last = end == 0 ? codes.end() : std::lower_bound(first, codes.end(), end);
+
+        if (Octree::Prefix(node.prefix, node.level) != node.prefix || node.first != size_t(first - codes.begin())
+                || node.count != size_t(last - first)) {
+            std::cout << "  Bad range for node " << i << std::endl;
+            return false;
+        }
+
+        const bool leaf = node.childMask == 0;
+        const bool mustSplit = node.count > maxLeafPoints && node.level < Octree::MaxLevel;
+        if ((leaf && mustSplit) || (!leaf && !mustSplit && !balanced)) {
+            std::cout << "  Bad split for node " << i << std::endl;
+            return false;
+        }
+
+        size_t children = 0, points = 0;
+        for (size_t octant = 0; octant < Octree::Children && !leaf; octant++) {
+            if ((node.childMask >> octant & 1) == 0) {
+                continue;
+            }
+
+            const auto c = node.firstChild + children++;
+            const auto& child = tree[c];
+            if (c >= tree.size() || child.parent != i || child.level != node.level + 1 || child.count == 0
+                    || child.prefix != (node.prefix | T(T(octant) << (cellBits - Dimensions)))) {
+                std::cout << "  Bad child " << octant << " of node " << i << std::endl;
+                return false;
+            }
+
+            references[c]++;
+            points += child.count;
+        }
+
+        if (!leaf && points != node.count) {
+            std::cout << "  Children of node " << i << " don't cover its points" << std::endl;
+            return false;
+        }
+    }
+
+    for (size_t i = 1; i < tree.size(); i++) {
+        if (references[i] != 1) {
+            std::cout << "  Node " << i << " is referenced " << references[i] << " times" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// The value of field 'field' of 'code'.
+template<typename T>
+static uint64_t Field(T code, size_t field, size_t dimensions, size_t fieldBits) {
+    uint64_t value = 0;
+    for (size_t bit = 0; bit < fieldBits; bit++) {
+        value |= uint64_t(code >> (bit * dimensions + field) & 1) << bit;
+    }
+
+    return value;
+}
+
+// Checks that no two leaves with points which share a face differ by more than one level.
+template<typename Octree, typename T>
+static bool CheckBalanced(const Octree& tree) {
+    const size_t Dimensions = __builtin_ctz(Octree::Children);
+
+    std::vector<size_t> leaves;
+    for (size_t i = 0; i < tree.size(); i++) {
+        if (tree[i].childMask == 0 && tree[i].count > 0) {
+            leaves.push_back(i);
+        }
+    }
+
+    for (auto a : leaves) {
+        for (auto b : leaves) {
+            const auto& small = tree[a];
+            const auto& large = tree[b];
+            if (large.level + 1 >= small.level) {
+                continue;
+            }
+
+            // Face neighbors touch along one field, and overlap along the others.
+            size_t touching = 0, overlapping = 0;
+            for (size_t field = 0; field < Dimensions; field++) {
+                const auto smallLo = Field(small.prefix, field, Dimensions, Octree::MaxLevel);
+                const auto largeLo = Field(large.prefix, field, Dimensions, Octree::MaxLevel);
+                const auto smallHi = smallLo + (uint64_t(1) << (Octree::MaxLevel - small.level));
+                const auto largeHi = largeLo + (uint64_t(1) << (Octree::MaxLevel - large.level));
+
+                touching += smallHi == largeLo || largeHi == smallLo;
+                overlapping += smallLo < largeHi && largeLo < smallHi;
+            }
+
+            if (touching == 1 && overlapping == Dimensions - 1) {
+                std::cout << "  Leaves " << a << " (level " << small.level << ") and " << b
+                          << " (level " << large.level << ") are unbalanced" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template<size_t Dimensions, typename T, size_t FieldBits>
+static bool TestBuildTree(size_t count, size_t maxLeafPoints, size_t threads) {
+    using Octree = mortonnd::MortonNDOctree<Dimensions, T, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Dimensions << "D octree build (count = " << count
+              << ", Bits/Field = " << FieldBits << ", max leaf points = " << maxLeafPoints << ", threads = " << threads << ")..." << std::endl;
+
+    const auto codes = RandomCodes<T>(count, Dimensions * FieldBits, count + Dimensions);
+    const Octree tree(codes.data(), count, maxLeafPoints, threads);
+    const Octree single(codes.data(), count, maxLeafPoints, 1);
+
+    for (size_t i = 0; i < tree.size() || i < single.size(); i++) {
+        if (tree.size() != single.size() || tree[i].prefix != single[i].prefix || tree[i].firstChild != single[i].firstChild
+                || tree[i].childMask != single[i].childMask) {
+            std::cout << "  Tree differs from single-threaded build at node " << i << std::endl;
+            return false;
+        }
+    }
+
+    return CheckTree(tree, codes, maxLeafPoints, false);
+}
+
+template<size_t Dimensions, typename T, size_t FieldBits>
+static bool TestBalanceTree(size_t count, size_t maxLeafPoints, size_t threads) {
+    using Octree = mortonnd::MortonNDOctree<Dimensions, T, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Dimensions << "D octree balance (count = " << count
+              << ", Bits/Field = " << FieldBits << ", max leaf points = " << maxLeafPoints << ", threads = " << threads << ")..." << std::endl;
+
+    const auto codes = RandomCodes<T>(count, Dimensions * FieldBits, count * 3 + Dimensions);
+    Octree tree(codes.data(), count, maxLeafPoints, threads);
+    const auto built = tree.size();
+    tree.Balance(codes.data(), threads);
+
+    if (tree.size() == built && count > 100) {
+        std::cout << "  Balance didn't refine the tree" << std::endl;
+        return false;
+    }
+
+    return CheckTree(tree, codes, maxLeafPoints, true) && CheckBalanced<Octree, T>(tree);
+}
+
+template<size_t Dimensions, typename T, size_t FieldBits>
+static bool TestLocateTree(size_t count, size_t maxLeafPoints, bool balance) {
+    using Octree = mortonnd::MortonNDOctree<Dimensions, T, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Dimensions << "D octree locate (count = " << count
+              << ", Bits/Field = " << FieldBits << ", balanced = " << balance << ")..." << std::endl;
+
+    const auto codes = RandomCodes<T>(count, Dimensions * FieldBits, count + 1);
+    Octree tree(codes.data(), count, maxLeafPoints);
+    if (balance) {
+        tree.Balance(codes.data());
+    }
+
+    // Queries: every code (in order, hinted by the previous result), and random codes.
+    auto queries = codes;
+    const auto random = RandomCodes<T>(count, Dimensions * FieldBits, count + 2);
+    queries.insert(queries.end(), random.begin(), random.end());
+
+    std::mt19937_64 rng(count);
+    size_t previous = 0;
+    for (size_t q = 0; q < queries.size(); q++) {
+        const auto code = queries[q];
+
+        size_t expected = 0;
+        for (size_t i = 0; i < tree.size(); i++) {
+            if (Octree::Prefix(code, tree[i].level) == tree[i].prefix && tree[i].level >= tree[expected].level) {
+                expected = i;
+            }
+        }
+
+        const auto hint = q < count ? previous : size_t(rng() % tree.size());
+        const auto located = tree.Locate(code);
+        previous = tree.Locate(code, hint);
+        if (located != expected || previous != expected) {
+            std::cout << "  Query " << q << " located node " << located << " / " << previous << " (hinted), expected " << expected << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool mortonnd_octree::TestBuild() {
+    return Reduce(std::logical_and<bool>{},
+        TestBuildTree<2, uint32_t, 16>(0, 1, 1),
+        TestBuildTree<2, uint32_t, 16>(1, 1, 1),
+        TestBuildTree<2, uint32_t, 16>(1000, 1, 1),
+        TestBuildTree<2, uint32_t, 12>(50000, 4, 2),
+        TestBuildTree<3, uint64_t, 21>(200000, 1, 4),
+        TestBuildTree<3, uint64_t, 21>(200000, 16, 0),
+        TestBuildTree<3, uint64_t, 8>(100000, 2, 3),
+        TestBuildTree<4, __uint128_t, 32>(50000, 8, 4),
+        TestBuildTree<5, uint64_t, 12>(100000, 1, 4)
+    );
+}
+
+bool mortonnd_octree::TestBalance() {
+    return Reduce(std::logical_and<bool>{},
+        TestBalanceTree<2, uint32_t, 16>(1, 1, 1),
+        TestBalanceTree<2, uint32_t, 16>(2000, 1, 1),
+        TestBalanceTree<2, uint64_t, 32>(2000, 2, 4),
+        TestBalanceTree<3, uint64_t, 21>(1000, 1, 2),
+        TestBalanceTree<3, uint32_t, 10>(3000, 4, 0),
+        TestBalanceTree<4, uint64_t, 16>(500, 1, 4)
+    );
+}
+
+bool mortonnd_octree::TestLocate() {
+    return Reduce(std::logical_and<bool>{},
+        TestLocateTree<2, uint32_t, 16>(2000, 1, false),
+        TestLocateTree<3, uint64_t, 21>(2000, 2, false),
+        TestLocateTree<3, uint64_t, 21>(1000, 1, true),
+        TestLocateTree<4, __uint128_t, 32>(1000, 4, false)
+    );
+}
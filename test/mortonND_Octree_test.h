@@ -0,0 +1,7 @@
+#pragma once
+
+namespace mortonnd_octree {
+bool TestBuild();
+bool TestBalance();
+bool TestLocate();
+}
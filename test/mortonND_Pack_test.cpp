@@ -0,0 +1,149 @@
+#include "mortonND_Pack_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_Pack.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+static_assert(mortonnd::MortonNDCodeTraits<mortonnd::MortonNDLutEncoder<3, 21, 8>>::Bits == 63, "Unexpected code bits.");
+static_assert(mortonnd::MortonNDCodeTraits<mortonnd::MortonNDStatic<mortonnd::MortonNDBmi_3D_64>>::Bits == 63, "Unexpected code bits.");
+static_assert(mortonnd::MortonNDCodeTraits<mortonnd::MortonNDBmiMixed<uint32_t, 10, 10, 5>>::Bits == 25, "Unexpected code bits.");
+static_assert(std::is_same<mortonnd::MortonNDDeltaPackFor<mortonnd::MortonNDLutEncoder<3, 21, 8>>,
+    mortonnd::MortonNDDeltaPack<uint64_t, 63>>::value, "Unexpected pack type.");
+static_assert(std::is_same<mortonnd::MortonNDDeltaPackFor<mortonnd::MortonNDAuto<2, 10>>,
+    mortonnd::MortonNDDeltaPack<uint32_t, 20>>::value, "Unexpected pack type.");
+
+// Returns 'count' sorted codes of 'CodeBits' bits. Gaps are mostly below 2^'gapBits', with an
+// occasional jump of up to the full code width (so some blocks are wide).
+template<typename T, size_t CodeBits>
+static std::vector<T> SortedCodes(size_t count, size_t gapBits, bool jumps) {
+    std::mt19937_64 rng(count + gapBits);
+    const auto random = [&]() { return (T(rng()) << 64 % std::numeric_limits<T>::digits) ^ T(rng()); };
+    const T mask = CodeBits == size_t(std::numeric_limits<T>::digits) ? ~T(0) : (T(1) << CodeBits) - 1;
+
+    std::vector<T> codes(count);
+    for (auto& code : codes) {
+        code = jumps && rng() % 1000 == 0 ? random() & mask : random() & ((T(1) << gapBits) - 1);
+    }
+
+    // Codes are prefix sums of the gaps, clamped to 'mask'.
+    T sum = 0;
+    for (auto& code : codes) {
+        sum = mask - sum < code ? mask : sum + code;
+        code = sum;
+    }
+
+    return codes;
+}
+
+template<typename T, size_t CodeBits>
+static bool TestPackRoundTrip(size_t count, size_t gapBits, bool jumps) {
+    using Pack = mortonnd::MortonNDDeltaPack<T, CodeBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit delta pack (code bits = " << CodeBits
+              << ", count = " << count << ", gap bits = " << gapBits << ", jumps = " << jumps
+              << ", vector = " << Pack::VectorDecode << ")..." << std::endl;
+
+    const auto codes = SortedCodes<T, CodeBits>(count, gapBits, jumps);
+    const Pack pack(codes.data(), codes.size());
+
+    if (pack.Size() != count || pack.BlockCount() != (count + Pack::BlockSize - 1) / Pack::BlockSize) {
+        std::cout << "  Unexpected size" << std::endl;
+        return false;
+    }
+
+    std::vector<T> decoded(count);
+    pack.Decode(decoded.data());
+    if (decoded != codes) {
+        std::cout << "  Decode mismatch" << std::endl;
+        return false;
+    }
+
+    for (size_t n = 0; n < count; n++) {
+        if (pack.At(n) != codes[n]) {
+            std::cout << "  At mismatch at " << n << std::endl;
+            return false;
+        }
+    }
+
+    std::mt19937_64 rng(count);
+    for (size_t query = 0; query < 1000 && count > 0; query++) {
+        const T code = query % 2 ? codes[rng() % count] + T(query % 4 == 1) : T(rng()) & codes.back();
+        const auto expected = size_t(std::lower_bound(codes.begin(), codes.end(), code) - codes.begin());
+        if (pack.LowerBound(code) != expected) {
+            std::cout << "  LowerBound mismatch" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool TestPackRejectsUnsorted() {
+    std::cout << "Testing delta pack rejects unsorted / oversized codes..." << std::endl;
+    const std::vector<uint64_t> unsorted = { 1, 2, 3, 2 };
+    const std::vector<uint64_t> oversized = { 1, 2, uint64_t(1) << 63 };
+
+    try {
+        mortonnd::MortonNDDeltaPack<uint64_t, 63>(unsorted.data(), unsorted.size());
+        return false;
+    } catch (const std::invalid_argument&) {
+    }
+
+    try {
+        mortonnd::MortonNDDeltaPack<uint64_t, 63>(oversized.data(), oversized.size());
+        return false;
+    } catch (const std::invalid_argument&) {
+    }
+
+    return true;
+}
+
+bool mortonnd_pack::TestRoundTrip() {
+    return Reduce(std::logical_and<bool>{},
+        TestPackRoundTrip<uint32_t, 30>(0, 4, false),
+        TestPackRoundTrip<uint32_t, 30>(1, 4, false),
+        TestPackRoundTrip<uint32_t, 30>(100000, 0, false),
+        TestPackRoundTrip<uint32_t, 30>(100000, 5, false),
+        TestPackRoundTrip<uint32_t, 32>(100001, 12, true),
+        TestPackRoundTrip<uint64_t, 63>(100000, 9, false),
+        TestPackRoundTrip<uint64_t, 63>(100003, 31, true),
+        TestPackRoundTrip<uint64_t, 64>(10007, 32, true),
+        TestPackRoundTrip<__uint128_t, 126>(10007, 20, true),
+        TestPackRejectsUnsorted()
+    );
+}
+
+// Every width must round trip, since each has its own unpacker.
+template<typename T>
+static bool TestPackWidths() {
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit delta pack widths..." << std::endl;
+    for (size_t width = 0; width <= size_t(std::numeric_limits<T>::digits); width++) {
+        std::vector<T> codes(512);
+        T code = 0;
+        for (size_t n = 0; n < codes.size(); n++) {
+            code += n == 300 && width > 0 ? T(1) << (width - 1) : T(n % 2 && width > 0);
+            codes[n] = code;
+        }
+
+        const mortonnd::MortonNDDeltaPack<T> pack(codes.data(), codes.size());
+        std::vector<T> decoded(codes.size());
+        pack.Decode(decoded.data());
+        if (decoded != codes || pack.BlockWidth(1) != width) {
+            std::cout << "  Mismatch at width " << width << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool mortonnd_pack::TestWidths() {
+    return Reduce(std::logical_and<bool>{},
+        TestPackWidths<uint32_t>(),
+        TestPackWidths<uint64_t>()
+    );
+}
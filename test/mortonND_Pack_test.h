@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_pack {
+bool TestRoundTrip();
+bool TestWidths();
+}
@@ -0,0 +1,123 @@
+#include "mortonND_Pattern_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_Mixed.h>
+#include <morton-nd/mortonND_Pattern.h>
+
+#include <array>
+#include <iostream>
+#include <random>
+
+// The layout of a pattern must be derived from its field indices.
+using Tiled = mortonnd::MortonNDPattern<0, 1, 0, 1, 2, 2, 2>;
+static_assert(Tiled::Dimensions == 3 && Tiled::CodeBits() == 7, "Unexpected pattern size.");
+static_assert(Tiled::Width(0) == 2 && Tiled::Width(2) == 3, "Unexpected pattern field width.");
+static_assert(Tiled::Offset(1, 1) == 3 && Tiled::Offset(2, 0) == 4, "Unexpected pattern offset.");
+static_assert(Tiled::Selector<uint32_t>(2) == 0x70, "Unexpected pattern selector.");
+
+// Encoding and decoding with the LUT must be usable in constant expressions.
+static constexpr auto LutEncoder_Tiled = mortonnd::MortonNDLutPatternEncoder<uint32_t, 3, 0, 1, 0, 1, 2, 2, 2>();
+static constexpr auto LutDecoder_Tiled = mortonnd::MortonNDLutPatternDecoder<uint32_t, 3, 0, 1, 0, 1, 2, 2, 2>();
+static_assert(LutEncoder_Tiled.Encode(3, 0, 5) == 0x55, "Unexpected constexpr encoding.");
+static_assert(std::get<2>(LutDecoder_Tiled.Decode(0x55)) == 5, "Unexpected constexpr decoding.");
+
+// Places each field's bits at the offsets listed in 'pattern', in order.
+template<typename T, size_t Fields, size_t Bits>
+static T ReferenceEncode(const std::array<T, Fields>& fields, const std::array<size_t, Bits>& pattern) {
+    T encoding = 0;
+    std::array<size_t, Fields> next = {};
+    for (size_t offset = 0; offset < Bits; offset++) {
+        const auto f = pattern[offset];
+        encoding |= T((fields[f] >> next[f]++) & 1U) << offset;
+    }
+
+    return encoding;
+}
+
+template<typename Engine, typename T, size_t ...i>
+static T Encode(const Engine& engine, const std::array<T, sizeof...(i)>& fields, std::index_sequence<i...>) {
+    return engine.Encode(std::get<i>(fields)...);
+}
+
+template<typename T, size_t ...i>
+static auto MakeTuple(const std::array<T, sizeof...(i)>& fields, std::index_sequence<i...>) {
+    return std::make_tuple(std::get<i>(fields)...);
+}
+
+// Checks the BMI2 and LUT engines against the reference placement for random points.
+template<typename T, size_t LutBits, size_t ...Pattern>
+static bool TestPatternEncodeDecode() {
+    using Layout = mortonnd::MortonNDPattern<Pattern...>;
+    static constexpr size_t Fields = Layout::Dimensions;
+    using Bmi = mortonnd::MortonNDBmiPattern<T, Pattern...>;
+    constexpr auto LutEncoder = mortonnd::MortonNDLutPatternEncoder<T, LutBits, Pattern...>();
+    constexpr auto LutDecoder = mortonnd::MortonNDLutPatternDecoder<T, LutBits, Pattern...>();
+    const std::array<size_t, sizeof...(Pattern)> pattern = {{ Pattern... }};
+
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit pattern encoders/decoders (Fields = " << Fields
+        << ", Code bits = " << sizeof...(Pattern) << ", LUT bits = " << LutBits << ")..." << std::endl;
+
+    std::mt19937_64 rng(sizeof...(Pattern) * LutBits);
+    auto random = [&]() { return (T(rng()) << (std::numeric_limits<T>::digits > 64 ? 64 : 0)) ^ T(rng()); };
+
+    for (size_t n = 0; n < 10000; n++) {
+        std::array<T, Fields> fields;
+        for (size_t f = 0; f < Fields; f++) {
+            // Include each field's minimum and maximum values.
+            const T mask = (T(1) << (Layout::Width(f) - 1) << 1) - 1;
+            fields[f] = n == 0 ? 0 : n == 1 ? mask : random() & mask;
+        }
+
+        const T expected = ReferenceEncode(fields, pattern);
+        const T bmi = Encode(Bmi{}, fields, std::make_index_sequence<Fields>{});
+        const T lut = Encode(LutEncoder, fields, std::make_index_sequence<Fields>{});
+        const auto tuple = MakeTuple(fields, std::make_index_sequence<Fields>{});
+
+        if (bmi != expected || lut != expected || Bmi::Decode(expected) != tuple || LutDecoder.Decode(expected) != tuple) {
+            std::cout << "  Mismatch for code " << uint64_t(expected) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// A round-robin pattern must match the mixed layout (and so every other engine).
+template<typename T, size_t ...i>
+static bool TestPatternRoundRobin(std::index_sequence<i...>) {
+    using Pattern = mortonnd::MortonNDBmiPattern<T, (i % 3)...>;
+    using Mixed = mortonnd::MortonNDBmiMixed<T, 21, 21, 21>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit round-robin pattern encoders..." << std::endl;
+
+    std::mt19937_64 rng(3);
+    for (size_t n = 0; n < 10000; n++) {
+        const T x = rng() & 0x1FFFFF, y = rng() & 0x1FFFFF, z = rng() & 0x1FFFFF;
+        const T expected = Mixed::Encode(x, y, z);
+        if (Pattern::Encode(x, y, z) != expected || Pattern::Decode(expected) != std::make_tuple(x, y, z)) {
+            std::cout << "  Mismatch for code " << uint64_t(expected) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool mortonnd_pattern::TestEncodeDecode() {
+    return Reduce(std::logical_and<bool>{},
+        // 2D Morton tiles of (x, y), z-major.
+        TestPatternEncodeDecode<uint32_t, 3, 0, 1, 0, 1, 2, 2, 2>(),
+        // 2 bits of x per bit of z.
+        TestPatternEncodeDecode<uint32_t, 4, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1>(),
+        // 3D Morton, with the top bits of x and y anisotropic.
+        TestPatternEncodeDecode<uint64_t, 8,
+            0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2,
+            0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 2, 2>(),
+        // Fields split over the 64-bit word boundary.
+        TestPatternEncodeDecode<__uint128_t, 6,
+            2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+            0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+            0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+            2, 2>(),
+        TestPatternRoundRobin<uint64_t>(std::make_index_sequence<63>{})
+    );
+}
@@ -0,0 +1,183 @@
+#include "mortonND_PointFile_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_PointFile.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Points are 3 10-bit fields and an ID, sorted by code.
+using MortonND = mortonnd::MortonNDBmi_3D_32;
+using Codec = mortonnd::MortonNDBlockCodec;
+
+struct Point {
+    uint32_t fields[3];
+    uint32_t id;
+};
+
+static const std::string PointFilePath = "/tmp/mortonnd-pointfile-test";
+
+static void SortedPoints(size_t count, std::vector<uint32_t>& codes, std::vector<Point>& points) {
+    std::mt19937_64 rng(count);
+    points.resize(count);
+    for (size_t n = 0; n < count; n++) {
+        // Clustered, so that some codes repeat.
+        for (auto& field : points[n].fields) {
+            field = uint32_t(n % 3 == 0 ? rng() % 16 : rng() % 1024);
+        }
+        points[n].id = uint32_t(n);
+    }
+
+    std::sort(points.begin(), points.end(), [](const Point& a, const Point& b) {
+        return MortonND::Encode(a.fields[0], a.fields[1], a.fields[2]) < MortonND::Encode(b.fields[0], b.fields[1], b.fields[2]);
+    });
+
+    codes.resize(count);
+    for (size_t n = 0; n < count; n++) {
+        codes[n] = MortonND::Encode(points[n].fields[0], points[n].fields[1], points[n].fields[2]);
+    }
+}
+
+static void WritePointFile(const std::vector<uint32_t>& codes, const std::vector<Point>& points, Codec codec, size_t blockRecords) {
+    mortonnd::MortonNDPointFileWriter<uint32_t> writer(PointFilePath, sizeof(Point), codec, blockRecords);
+    writer.Append(codes.data(), points.data(), codes.size());
+    writer.Finish();
+}
+
+static bool TestPointFileRoundTrip(size_t count, Codec codec, size_t blockRecords) {
+    std::cout << "Testing point file round trip (count = " << count << ", codec = " << uint32_t(codec)
+              << ", block = " << blockRecords << ")..." << std::endl;
+
+    std::vector<uint32_t> codes;
+    std::vector<Point> points;
+    SortedPoints(count, codes, points);
+    WritePointFile(codes, points, codec, blockRecords);
+
+    const mortonnd::MortonNDPointFileReader<uint32_t> reader(PointFilePath);
+    if (reader.Records() != count || reader.RecordSize() != sizeof(Point) || reader.Codec() != codec
+        || reader.BlockCount() != (count + blockRecords - 1) / blockRecords) {
+        std::cout << "  Unexpected header" << std::endl;
+        return false;
+    }
+
+    size_t n = 0;
+    bool ok = true;
+    reader.Scan([&](uint32_t code, const unsigned char* record) {
+        ok &= n < count && code == codes[n] && std::memcmp(record, &points[n], sizeof(Point)) == 0;
+        n++;
+    });
+
+    if (!ok || n != count) {
+        std::cout << "  Scan mismatch" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Compares box queries against a scan of all points.
+static bool TestPointFileQuery(size_t count, Codec codec, size_t blockRecords) {
+    std::cout << "Testing point file queries (count = " << count << ", codec = " << uint32_t(codec)
+              << ", block = " << blockRecords << ")..." << std::endl;
+
+    std::vector<uint32_t> codes;
+    std::vector<Point> points;
+    SortedPoints(count, codes, points);
+    WritePointFile(codes, points, codec, blockRecords);
+
+    const mortonnd::MortonNDPointFileReader<uint32_t> reader(PointFilePath);
+    std::mt19937_64 rng(count + blockRecords);
+    for (size_t query = 0; query < 200; query++) {
+        uint32_t lo[3], hi[3];
+        for (size_t f = 0; f < 3; f++) {
+            const auto a = uint32_t(rng() % 1024), b = uint32_t(rng() % (query % 2 ? 1024 : 64));
+            lo[f] = std::min(a, std::min(a + b, 1023u));
+            hi[f] = std::min(a + b, 1023u);
+        }
+
+        std::vector<uint32_t> expected;
+        for (const auto& point : points) {
+            bool inside = true;
+            for (size_t f = 0; f < 3; f++) {
+                inside &= point.fields[f] >= lo[f] && point.fields[f] <= hi[f];
+            }
+            if (inside) {
+                expected.push_back(point.id);
+            }
+        }
+
+        std::vector<uint32_t> found;
+        const auto stats = reader.Query<3, 10>(MortonND::Encode(lo[0], lo[1], lo[2]), MortonND::Encode(hi[0], hi[1], hi[2]),
+            [&](uint32_t, const unsigned char* record) {
+                Point point;
+                std::memcpy(&point, record, sizeof(Point));
+                found.push_back(point.id);
+            }, query % 3 == 0 ? 1 : 64);
+
+        if (found != expected || stats.records != expected.size() || stats.blocks > reader.BlockCount()) {
+            std::cout << "  Query mismatch (" << found.size() << " vs. " << expected.size() << " records)" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool TestPointFileUnfinished() {
+    std::cout << "Testing unfinished point files are rejected..." << std::endl;
+    {
+        mortonnd::MortonNDPointFileWriter<uint32_t> writer(PointFilePath, sizeof(Point), Codec::Raw, 16);
+        const Point point{};
+        for (uint32_t n = 0; n < 100; n++) {
+            writer.Append(n, &point);
+        }
+    }
+
+    try {
+        mortonnd::MortonNDPointFileReader<uint32_t> reader(PointFilePath);
+        std::cout << "  Unfinished file was accepted" << std::endl;
+        return false;
+    } catch (const std::runtime_error&) {
+    }
+
+    WritePointFile({ 1 }, { Point{} }, Codec::Raw, 16);
+    try {
+        mortonnd::MortonNDPointFileReader<uint64_t> reader(PointFilePath);
+        std::cout << "  Code size mismatch was accepted" << std::endl;
+        return false;
+    } catch (const std::runtime_error&) {
+    }
+
+    return true;
+}
+
+bool mortonnd_pointfile::TestRoundTrip() {
+    const auto result = Reduce(std::logical_and<bool>{},
+        TestPointFileRoundTrip(0, Codec::Raw, 64),
+        TestPointFileRoundTrip(1, Codec::DeltaVarint, 64),
+        TestPointFileRoundTrip(10000, Codec::Raw, 64),
+        TestPointFileRoundTrip(10000, Codec::DeltaVarint, 100),
+        TestPointFileRoundTrip(10000, Codec::DeltaVarint, 4096),
+        TestPointFileUnfinished()
+    );
+
+    std::remove(PointFilePath.c_str());
+    return result;
+}
+
+bool mortonnd_pointfile::TestQuery() {
+    const auto result = Reduce(std::logical_and<bool>{},
+        TestPointFileQuery(20000, Codec::Raw, 64),
+        TestPointFileQuery(20000, Codec::DeltaVarint, 1000),
+        TestPointFileQuery(500, Codec::DeltaVarint, 7)
+    );
+
+    std::remove(PointFilePath.c_str());
+    return result;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_pointfile {
+bool TestRoundTrip();
+bool TestQuery();
+}
@@ -0,0 +1,201 @@
+#include "mortonND_Quantize_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_LUT.h>
+#include <morton-nd/mortonND_Quantize.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Integer keys must be usable in constant expressions.
+static_assert(mortonnd::MortonNDOrderedKey<int32_t>::ToKey(-1) == 0x7FFFFFFFu, "Unexpected constexpr key.");
+static_assert(mortonnd::MortonNDOrderedKey<int32_t>::FromKey(0x80000000u) == 0, "Unexpected constexpr key.");
+
+template<typename Input>
+static bool SameBits(Input a, Input b) {
+    return std::memcmp(&a, &b, sizeof(Input)) == 0;
+}
+
+template<typename Input>
+static std::vector<Input> SpecialValues(std::true_type) {
+    using limits = std::numeric_limits<Input>;
+    return { -limits::infinity(), limits::lowest(), Input(-1), -limits::denorm_min(), Input(-0.0),
+             Input(0), limits::denorm_min(), limits::min(), Input(1), limits::max(), limits::infinity() };
+}
+
+template<typename Input>
+static std::vector<Input> SpecialValues(std::false_type) {
+    using limits = std::numeric_limits<Input>;
+    return { limits::min(), Input(limits::min() + 1), Input(0), Input(1), Input(limits::max() - 1), limits::max() };
+}
+
+// Checks that keys sort like their values, and that converting back is lossless.
+template<typename Input>
+static bool TestOrderedKey() {
+    using Ordered = mortonnd::MortonNDOrderedKey<Input>;
+    std::cout << "Testing order-preserving keys (" << (std::is_floating_point<Input>::value ? "float" : "int")
+              << ", " << sizeof(Input) * 8 << " bits)..." << std::endl;
+
+    auto values = SpecialValues<Input>(std::is_floating_point<Input>{});
+    std::mt19937_64 rng(sizeof(Input));
+    for (size_t n = 0; n < 10000; n++) {
+        auto bits = rng();
+        Input value;
+        std::memcpy(&value, &bits, sizeof(Input));
+        if (value == value) {
+            values.push_back(value);
+        }
+    }
+
+    // -0.0 and 0.0 compare equal, but have distinct keys (-0.0 first).
+    std::sort(values.begin(), values.end(), [](Input a, Input b) { return a < b || (a == b && std::signbit(double(a)) && !std::signbit(double(b))); });
+    for (size_t n = 0; n < values.size(); n++) {
+        if (!SameBits(Ordered::FromKey(Ordered::ToKey(values[n])), values[n])) {
+            std::cout << "  Round trip failed for " << values[n] << std::endl;
+            return false;
+        }
+
+        if (n > 0 && Ordered::ToKey(values[n - 1]) > Ordered::ToKey(values[n])) {
+            std::cout << "  Keys out of order for " << values[n - 1] << ", " << values[n] << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<typename Input>
+static Input RandomCoordinate(std::mt19937_64& rng, std::true_type) {
+    // Some coordinates lie outside of the grid ([-100, 100]), to cover clamping.
+    return std::uniform_real_distribution<Input>(Input(-120), Input(120))(rng);
+}
+
+template<typename Input>
+static Input RandomCoordinate(std::mt19937_64& rng, std::false_type) {
+    return Input(rng());
+}
+
+template<typename Quantizer, typename Engine, typename Decoder, typename Reference, size_t ...i>
+static bool TestQuantizerBatch(const Quantizer& quantizer, const Engine& engine, const Decoder& decoder, Reference reference,
+    std::index_sequence<i...>) {
+    using Input = typename std::remove_const<typename std::remove_reference<decltype(quantizer.Dequantize(0, 0))>::type>::type;
+    using T = typename std::remove_reference<decltype(reference(quantizer.Quantize(i, Input(0))...))>::type;
+    static constexpr size_t Fields = sizeof...(i);
+
+    // Not a multiple of 'BlockSize' (or the vector width), so that partial blocks are covered.
+    static const size_t Count = 3 * Quantizer::BlockSize + 13;
+    static const size_t Stride = Fields + 1;
+
+    std::mt19937_64 rng(Fields);
+    std::vector<Input> soa[Fields];
+    std::vector<Input> aos(Count * Stride);
+    for (auto& field : soa) {
+        field.resize(Count);
+    }
+
+    for (size_t n = 0; n < Count; n++) {
+        for (size_t f = 0; f < Fields; f++) {
+            soa[f][n] = n == 0 ? std::numeric_limits<Input>::lowest() : n == 1 ? std::numeric_limits<Input>::max()
+                : RandomCoordinate<Input>(rng, std::is_floating_point<Input>{});
+            aos[n * Stride + f] = soa[f][n];
+        }
+    }
+
+    std::vector<T> soaCodes(Count), aosCodes(Count);
+    quantizer.EncodeBatch(engine, {{ soa[i].data()... }}, soaCodes.data(), Count);
+    quantizer.EncodeBatch(engine, aos.data(), Stride, aosCodes.data(), Count);
+
+    for (size_t n = 0; n < Count; n++) {
+        const T expected = reference(quantizer.Quantize(i, soa[i][n])...);
+        if (soaCodes[n] != expected || aosCodes[n] != expected) {
+            std::cout << "  Encode mismatch at point " << n << std::endl;
+            return false;
+        }
+    }
+
+    std::vector<Input> soaDecoded[Fields];
+    std::vector<Input> aosDecoded(Count * Stride);
+    for (auto& field : soaDecoded) {
+        field.resize(Count);
+    }
+
+    quantizer.DecodeBatch(decoder, soaCodes.data(), Count, {{ soaDecoded[i].data()... }});
+    quantizer.DecodeBatch(decoder, soaCodes.data(), Count, aosDecoded.data(), Stride);
+
+    for (size_t n = 0; n < Count; n++) {
+        for (size_t f = 0; f < Fields; f++) {
+            const Input expected = quantizer.Dequantize(f, quantizer.Quantize(f, soa[f][n]));
+            if (!SameBits(soaDecoded[f][n], expected) || !SameBits(aosDecoded[n * Stride + f], expected)) {
+                std::cout << "  Decode mismatch at point " << n << std::endl;
+                return false;
+            }
+
+            // Decoded coordinates must convert back to the same field.
+            if (quantizer.Quantize(f, expected) != quantizer.Quantize(f, soa[f][n])) {
+                std::cout << "  Round trip mismatch at point " << n << std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template<size_t Fields, typename Input, typename T, size_t FieldBits, size_t ...i>
+static bool TestQuantizer(std::index_sequence<i...> seq) {
+    using Quantizer = mortonnd::MortonNDQuantizer<Fields, Input, T, FieldBits>;
+    using Bmi = mortonnd::MortonNDBmi<Fields, T>;
+    constexpr auto LutEncoder = mortonnd::MortonNDLutEncoder<Fields, FieldBits, 8, T>();
+    constexpr auto LutDecoder = mortonnd::MortonNDLutDecoder<Fields, FieldBits, 8, T>();
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D quantizers ("
+              << (std::is_floating_point<Input>::value ? "float" : std::is_signed<Input>::value ? "int" : "uint") << sizeof(Input) * 8
+              << ", Bits/Field = " << FieldBits << ", vector = " << Quantizer::VectorBatch << ")..." << std::endl;
+
+    const auto bmi = [](decltype(i, T())... f) { return Bmi::Encode(f...); };
+
+    // Integer grids have 1 cell per 2^(input bits - field bits) values, centered on 0.
+    const auto scale = std::is_floating_point<Input>::value ? 20.0 : std::ldexp(1.0, int(FieldBits) - int(sizeof(Input) * 8));
+    const auto origin = std::is_floating_point<Input>::value ? -100.0 : std::is_signed<Input>::value ? -std::ldexp(1.0, int(sizeof(Input) * 8) - 1) : 0.0;
+    using Real = typename Quantizer::Real;
+    const Quantizer affine({{ Real((void(i), origin))... }}, {{ Real((void(i), scale))... }});
+    const Quantizer ordered;
+
+    return Reduce(std::logical_and<bool>{},
+        TestQuantizerBatch(affine, mortonnd::MortonNDStatic<Bmi>{}, mortonnd::MortonNDStatic<Bmi>{}, bmi, seq),
+        TestQuantizerBatch(affine, LutEncoder, LutDecoder, bmi, seq),
+        TestQuantizerBatch(ordered, mortonnd::MortonNDStatic<Bmi>{}, mortonnd::MortonNDStatic<Bmi>{}, bmi, seq),
+        TestQuantizerBatch(ordered, LutEncoder, LutDecoder, bmi, seq)
+    );
+}
+
+template<size_t Fields, typename Input, typename T, size_t FieldBits = std::numeric_limits<T>::digits / Fields>
+static bool TestQuantizer() {
+    return TestQuantizer<Fields, Input, T, FieldBits>(std::make_index_sequence<Fields>{});
+}
+
+bool mortonnd_quantize::TestOrderedKeys() {
+    return Reduce(std::logical_and<bool>{},
+        TestOrderedKey<float>(),
+        TestOrderedKey<double>(),
+        TestOrderedKey<int32_t>(),
+        TestOrderedKey<int64_t>(),
+        TestOrderedKey<uint32_t>()
+    );
+}
+
+bool mortonnd_quantize::TestBatch() {
+    return Reduce(std::logical_and<bool>{},
+        TestQuantizer<2, float, uint32_t>(),
+        TestQuantizer<3, float, uint64_t>(),
+        TestQuantizer<3, double, uint64_t>(),
+        TestQuantizer<3, int32_t, uint64_t>(),
+        TestQuantizer<2, uint32_t, uint64_t, 31>(),
+        TestQuantizer<2, int32_t, uint64_t, 32>(),
+        TestQuantizer<2, int64_t, uint64_t>()
+    );
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_quantize {
+bool TestOrderedKeys();
+bool TestBatch();
+}
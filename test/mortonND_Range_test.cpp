@@ -0,0 +1,270 @@
+#include "mortonND_Range_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_Magic.h>
+#include <morton-nd/mortonND_Range.h>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+template<size_t Fields, typename T, size_t FieldBits>
+static void RandomBox(std::mt19937_64& rng, T& boxMin, T& boxMax) {
+    using Magic = mortonnd::MortonNDMagic<Fields, T, FieldBits>;
+
+    boxMin = 0;
+    boxMax = 0;
+    for (size_t f = 0; f < Fields; f++) {
+        T a = T(rng()) & ((T(1) << FieldBits) - 1);
+        T b = T(rng()) & ((T(1) << FieldBits) - 1);
+        boxMin |= Magic::Dilate(std::min(a, b)) << f;
+        boxMax |= Magic::Dilate(std::max(a, b)) << f;
+    }
+}
+
+// Checks every code of a small universe against a brute-force scan of the box.
+template<size_t Fields, typename T, size_t FieldBits>
+static bool TestMortonNDRangeExhaustive(size_t boxes) {
+    using Range = mortonnd::MortonNDRange<Fields, T, FieldBits>;
+    using Magic = mortonnd::MortonNDMagic<Fields, T, FieldBits>;
+    std::cout << "Testing " << Fields << "D BIGMIN / LITMAX (Bits/Field = " << FieldBits << ", exhaustive)..." << std::endl;
+
+    static const T CodeCount = T(1) << (Fields * FieldBits);
+    std::mt19937_64 rng(Fields * FieldBits);
+
+    bool ok = true;
+    for (size_t n = 0; n < boxes && ok; n++) {
+        T boxMin, boxMax;
+        RandomBox<Fields, T, FieldBits>(rng, boxMin, boxMax);
+
+        // Decoded (brute-force) box membership.
+        std::vector<bool> inBox(CodeCount);
+        for (T code = 0; code < CodeCount; code++) {
+            bool in = true;
+            for (size_t f = 0; f < Fields; f++) {
+                const T value = Magic::Compact(code >> f);
+                in &= value >= Magic::Compact(boxMin >> f) && value <= Magic::Compact(boxMax >> f);
+            }
+            inBox[code] = in;
+
+            if (Range::InBox(code, boxMin, boxMax) != in) {
+                std::cout << "  Mismatch for InBox(" << uint64_t(code) << ")" << std::endl;
+                ok = false;
+            }
+        }
+
+        for (T code = boxMin + 1; code < boxMax; code++) {
+            if (inBox[code]) {
+                continue;
+            }
+
+            T bigMin = code + 1;
+            while (!inBox[bigMin]) bigMin++;
+
+            T litMax = code - 1;
+            while (!inBox[litMax]) litMax--;
+
+            const T computedBigMin = Range::BigMin(code, boxMin, boxMax);
+            const T computedLitMax = Range::LitMax(code, boxMin, boxMax);
+            if (computedBigMin != bigMin || computedLitMax != litMax) {
+                std::cout << "  Mismatch for code " << uint64_t(code) << " in box [" << uint64_t(boxMin) << ", " << uint64_t(boxMax) << "]" << std::endl;
+                std::cout << "    Correct: BIGMIN " << uint64_t(bigMin) << ", LITMAX " << uint64_t(litMax)
+                          << " Computed: BIGMIN " << uint64_t(computedBigMin) << ", LITMAX " << uint64_t(computedLitMax) << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    return ok;
+}
+
+template<size_t Fields, typename T, size_t FieldBits = std::numeric_limits<T>::digits / Fields>
+static bool TestMortonNDRangeQuery() {
+    using Range = mortonnd::MortonNDRange<Fields, T, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D box queries (Bits/Field = " << FieldBits << ")..." << std::endl;
+
+    std::mt19937_64 rng(Fields);
+
+    bool ok = true;
+    size_t found = 0;
+    for (size_t n = 0; n < 50; n++) {
+        // Clustered points, so that boxes contain some of them.
+        std::vector<T> codes(5000);
+        const T base = T(rng()) & ~T(0xFFFFF);
+        for (auto& code : codes) {
+            code = (base | (T(rng()) & T(0xFFFFF))) & (FieldBits * Fields == std::numeric_limits<T>::digits ? ~T(0) : (T(1) << (FieldBits * Fields)) - 1);
+        }
+        std::sort(codes.begin(), codes.end());
+
+        T boxMin, boxMax;
+        RandomBox<Fields, T, FieldBits>(rng, boxMin, boxMax);
+        if (n % 2 == 0) {
+            // A box around a point (clearing / setting its low bits in every dimension).
+            const T center = codes[rng() % codes.size()];
+            boxMin = center & ~T(0x3FFF);
+            boxMax = center | T(0x3FFF);
+        }
+
+        std::vector<T> expected;
+        std::copy_if(codes.begin(), codes.end(), std::back_inserter(expected), [&](T code) {
+            return Range::InBox(code, boxMin, boxMax);
+        });
+
+        std::vector<T> computed;
+        for (auto code : Range::Query(codes.begin(), codes.end(), boxMin, boxMax)) {
+            computed.push_back(code);
+        }
+
+        if (computed != expected) {
+            std::cout << "  Mismatch for query " << n << ": expected " << expected.size() << " codes, found " << computed.size() << std::endl;
+            ok = false;
+        }
+
+        found += computed.size();
+    }
+
+    if (found == 0) {
+        std::cout << "  No queries found any points." << std::endl;
+        ok = false;
+    }
+
+    return ok;
+}
+
+// Checks decompositions of boxes in a small universe against brute-force membership.
+template<size_t Fields, typename T, size_t FieldBits>
+static bool TestMortonNDRangeDecompose(size_t boxes) {
+    using Range = mortonnd::MortonNDRange<Fields, T, FieldBits>;
+    using Interval = typename Range::Interval;
+    std::cout << "Testing " << Fields << "D box decomposition (Bits/Field = " << FieldBits << ", exhaustive)..." << std::endl;
+
+    static const T CodeCount = T(1) << (Fields * FieldBits);
+    std::mt19937_64 rng(Fields * FieldBits + 1);
+
+    const auto covers = [](const std::vector<Interval>& intervals, T code) {
+        return std::any_of(intervals.begin(), intervals.end(), [&](const Interval& interval) {
+            return code >= interval.lo && code <= interval.hi;
+        });
+    };
+
+    bool ok = true;
+    for (size_t n = 0; n < boxes && ok; n++) {
+        T boxMin, boxMax;
+        RandomBox<Fields, T, FieldBits>(rng, boxMin, boxMax);
+
+        // The exact decomposition is the list of maximal runs of codes inside the box.
+        std::vector<Interval> runs;
+        T inBoxCount = 0;
+        for (T code = 0; code < CodeCount; code++) {
+            if (!Range::InBox(code, boxMin, boxMax)) {
+                continue;
+            }
+
+            inBoxCount++;
+            if (!runs.empty() && runs.back().hi + 1 == code) {
+                runs.back().hi = code;
+            } else {
+                runs.push_back(Interval{ code, code });
+            }
+        }
+
+        const auto exact = Range::Decompose(boxMin, boxMax);
+        const bool exactMatches = exact.intervals.size() == runs.size() && std::equal(runs.begin(), runs.end(), exact.intervals.begin(),
+            [](const Interval& a, const Interval& b) { return a.lo == b.lo && a.hi == b.hi; });
+        if (!exactMatches || exact.falsePositives != 0) {
+            std::cout << "  Mismatch for exact decomposition of box [" << uint64_t(boxMin) << ", " << uint64_t(boxMax) << "]: expected "
+                      << runs.size() << " intervals, found " << exact.intervals.size() << std::endl;
+            ok = false;
+        }
+
+        for (size_t maxDepth = 0; maxDepth <= FieldBits; maxDepth++) {
+            const auto unlimited = Range::Decompose(boxMin, boxMax, std::numeric_limits<size_t>::max(), maxDepth);
+
+            // Merging the smallest gaps of the unlimited decomposition is the least over-coverage possible.
+            std::vector<T> gaps;
+            for (size_t i = 1; i < unlimited.intervals.size(); i++) {
+                gaps.push_back(unlimited.intervals[i].lo - unlimited.intervals[i - 1].hi - 1);
+            }
+            std::sort(gaps.begin(), gaps.end());
+
+            for (size_t maxIntervals : { 1, 2, 3, 5, 8, 1000 }) {
+                const auto decomposition = Range::Decompose(boxMin, boxMax, maxIntervals, maxDepth);
+                const auto& intervals = decomposition.intervals;
+
+                T covered = 0;
+                bool valid = !intervals.empty() && intervals.size() <= maxIntervals;
+                for (size_t i = 0; i < intervals.size(); i++) {
+                    valid &= intervals[i].lo <= intervals[i].hi && (i == 0 || intervals[i - 1].hi + 1 < intervals[i].lo);
+                    covered += intervals[i].hi - intervals[i].lo + 1;
+                }
+
+                for (T code = 0; code < CodeCount && valid; code++) {
+                    valid &= !Range::InBox(code, boxMin, boxMax) || covers(intervals, code);
+                }
+
+                T optimal = unlimited.falsePositives;
+                for (size_t i = 0; i + maxIntervals < unlimited.intervals.size(); i++) {
+                    optimal += gaps[i];
+                }
+
+                if (!valid || decomposition.falsePositives != covered - inBoxCount || decomposition.falsePositives != optimal) {
+                    std::cout << "  Invalid decomposition of box [" << uint64_t(boxMin) << ", " << uint64_t(boxMax) << "] (maxIntervals = "
+                              << maxIntervals << ", maxDepth = " << maxDepth << "): " << intervals.size() << " intervals, "
+                              << uint64_t(decomposition.falsePositives) << " false positives (optimal: " << uint64_t(optimal) << ")" << std::endl;
+                    ok = false;
+                }
+            }
+        }
+    }
+
+    return ok;
+}
+
+// Checks that whole-domain and single-code boxes decompose to a single exact interval.
+template<size_t Fields, typename T, size_t FieldBits = std::numeric_limits<T>::digits / Fields>
+static bool TestMortonNDRangeDecomposeFull() {
+    using Range = mortonnd::MortonNDRange<Fields, T, FieldBits>;
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D whole-domain decomposition (Bits/Field = " << FieldBits << ")..." << std::endl;
+
+    const T codeMax = FieldBits * Fields == std::numeric_limits<T>::digits ? ~T(0) : (T(1) << (FieldBits * Fields)) - 1;
+    const T code = T(0x123456789ABCDEFull) & codeMax;
+
+    const auto full = Range::Decompose(0, codeMax, 4, 3);
+    const auto single = Range::Decompose(code, code);
+    return full.intervals.size() == 1 && full.intervals[0].lo == 0 && full.intervals[0].hi == codeMax && full.falsePositives == 0
+        && single.intervals.size() == 1 && single.intervals[0].lo == code && single.intervals[0].hi == code && single.falsePositives == 0;
+}
+
+bool mortonnd_range::TestBigMinLitMax() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDRangeExhaustive<1, uint32_t, 8>(20),
+        TestMortonNDRangeExhaustive<2, uint32_t, 5>(100),
+        TestMortonNDRangeExhaustive<2, uint64_t, 6>(50),
+        TestMortonNDRangeExhaustive<3, uint32_t, 4>(50),
+        TestMortonNDRangeExhaustive<4, uint64_t, 3>(50),
+        TestMortonNDRangeExhaustive<5, uint32_t, 2>(50)
+    );
+}
+
+bool mortonnd_range::TestQuery() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDRangeQuery<2, uint64_t>(),
+        TestMortonNDRangeQuery<3, uint64_t>(),
+        TestMortonNDRangeQuery<3, uint32_t>(),
+        TestMortonNDRangeQuery<4, uint64_t, 12>(),
+        TestMortonNDRangeQuery<3, __uint128_t>()
+    );
+}
+
+bool mortonnd_range::TestDecompose() {
+    return Reduce(std::logical_and<bool>{},
+        TestMortonNDRangeDecompose<1, uint32_t, 8>(10),
+        TestMortonNDRangeDecompose<2, uint32_t, 5>(30),
+        TestMortonNDRangeDecompose<3, uint64_t, 4>(20),
+        TestMortonNDRangeDecompose<4, uint32_t, 3>(20),
+        TestMortonNDRangeDecomposeFull<2, uint64_t>(),
+        TestMortonNDRangeDecomposeFull<3, uint64_t>(),
+        TestMortonNDRangeDecomposeFull<3, __uint128_t>()
+    );
+}
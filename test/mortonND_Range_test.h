@@ -0,0 +1,7 @@
+#pragma once
+
+namespace mortonnd_range {
+bool TestBigMinLitMax();
+bool TestQuery();
+bool TestDecompose();
+}
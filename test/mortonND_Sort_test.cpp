@@ -0,0 +1,132 @@
+#include "mortonND_Sort_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_BMI2.h>
+#include <morton-nd/mortonND_LUT.h>
+#include <morton-nd/mortonND_Sort.h>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// Large enough that 'MortonNDRadixSort' uses several threads.
+static const size_t ThreadedCount = 4 * (size_t(1) << 16) + 77;
+
+// Sorts random keys of 'keyBits' bits (optionally clustered in their high bits) and compares
+// against 'std::stable_sort'.
+template<typename T>
+static bool TestSortKeys(size_t count, size_t keyBits, bool clustered, size_t threads) {
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit radix sort (count = " << count
+              << ", key bits = " << keyBits << ", clustered = " << clustered << ", threads = " << threads << ")..." << std::endl;
+
+    std::mt19937_64 rng(count + keyBits);
+    const T mask = keyBits >= size_t(std::numeric_limits<T>::digits) ? T(~T(0)) : T((T(1) << keyBits) - 1);
+    const T high = T(rng()) << (keyBits > 12 ? keyBits - 12 : 0);
+
+    std::vector<T> keys(count);
+    for (auto& key : keys) {
+        key = (T(rng()) << 64 % std::numeric_limits<T>::digits) ^ T(rng());
+        key = clustered ? ((key & T(0xFFF)) | high) & mask : key & mask;
+    }
+
+    std::vector<uint32_t> payloads(count);
+    std::iota(payloads.begin(), payloads.end(), 0);
+
+    std::vector<uint32_t> expected = payloads;
+    std::stable_sort(expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+    auto sorted = keys;
+    mortonnd::MortonNDRadixSort<T, uint32_t>::Sort(sorted.data(), payloads.data(), count, keyBits, threads);
+
+    for (size_t n = 0; n < count; n++) {
+        if (payloads[n] != expected[n] || sorted[n] != keys[expected[n]]) {
+            std::cout << "  Mismatch at position " << n << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Checks 'SortByMorton' (SoA and AoS) against encoding each point and 'std::stable_sort'.
+template<size_t Fields, typename T, typename Engine, size_t ...i>
+static bool TestSortPoints(const Engine& engine, size_t count, size_t fieldBits, size_t threads, std::index_sequence<i...>) {
+    std::cout << "Testing " << std::numeric_limits<T>::digits << "-bit " << Fields << "D SortByMorton (count = " << count
+              << ", Bits/Field = " << fieldBits << ", threads = " << threads << ")..." << std::endl;
+
+    static const size_t Stride = Fields + 1;
+
+    std::mt19937_64 rng(count + Fields);
+    std::vector<T> soa[Fields];
+    std::vector<T> aos(count * Stride);
+    for (size_t f = 0; f < Fields; f++) {
+        soa[f].resize(count);
+        for (size_t n = 0; n < count; n++) {
+            soa[f][n] = T(rng()) & T((T(1) << fieldBits) - 1);
+            aos[n * Stride + f] = soa[f][n];
+        }
+    }
+
+    const std::array<const T*, Fields> fields = {{ soa[i].data()... }};
+    std::vector<T> codes(count);
+    engine.EncodeBatch(fields, codes.data(), count);
+
+    std::vector<uint32_t> expected(count);
+    std::iota(expected.begin(), expected.end(), 0);
+    std::stable_sort(expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) { return codes[a] < codes[b]; });
+
+    std::vector<T> soaCodes(count), aosCodes(count);
+    std::vector<uint32_t> soaIndices(count), aosIndices(count);
+    mortonnd::SortByMorton<Fields>(engine, fields, count, soaCodes.data(), soaIndices.data(), Fields * fieldBits, threads);
+    mortonnd::SortByMorton<Fields>(engine, aos.data(), Stride, count, aosCodes.data(), aosIndices.data(), Fields * fieldBits, threads);
+
+    for (size_t n = 0; n < count; n++) {
+        const auto code = codes[expected[n]];
+        if (soaIndices[n] != expected[n] || aosIndices[n] != expected[n] || soaCodes[n] != code || aosCodes[n] != code) {
+            std::cout << "  Mismatch at position " << n << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<size_t Fields, typename T, size_t FieldBits>
+static bool TestSortPoints(size_t count, size_t threads) {
+    constexpr auto LutEncoder = mortonnd::MortonNDLutEncoder<Fields, FieldBits, 8, T>();
+    const auto bmi = mortonnd::MortonNDStatic<mortonnd::MortonNDBmi<Fields, T>>{};
+
+    return Reduce(std::logical_and<bool>{},
+        TestSortPoints<Fields, T>(bmi, count, FieldBits, threads, std::make_index_sequence<Fields>{}),
+        TestSortPoints<Fields, T>(LutEncoder, count, FieldBits, threads, std::make_index_sequence<Fields>{})
+    );
+}
+
+bool mortonnd_sort::TestRadixSort() {
+    return Reduce(std::logical_and<bool>{},
+        TestSortKeys<uint32_t>(0, 32, false, 0),
+        TestSortKeys<uint32_t>(1, 32, false, 0),
+        TestSortKeys<uint32_t>(1000, 8, false, 1),
+        TestSortKeys<uint32_t>(1000, 30, false, 1),
+        TestSortKeys<uint32_t>(ThreadedCount, 30, false, 4),
+        TestSortKeys<uint32_t>(ThreadedCount, 30, true, 4),
+        TestSortKeys<uint64_t>(ThreadedCount, 63, false, 3),
+        TestSortKeys<uint64_t>(ThreadedCount, 63, true, 4),
+        TestSortKeys<uint64_t>(5000, 21, false, 0),
+        TestSortKeys<__uint128_t>(ThreadedCount, 128, false, 4),
+        TestSortKeys<__uint128_t>(5000, 96, true, 2)
+    );
+}
+
+bool mortonnd_sort::TestSortByMorton() {
+    return Reduce(std::logical_and<bool>{},
+        TestSortPoints<2, uint32_t, 16>(1000, 1),
+        TestSortPoints<3, uint32_t, 10>(ThreadedCount, 4),
+        TestSortPoints<3, uint64_t, 21>(ThreadedCount, 0),
+        TestSortPoints<3, uint64_t, 8>(ThreadedCount, 4)
+    );
+}
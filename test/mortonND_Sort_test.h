@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_sort {
+bool TestRadixSort();
+bool TestSortByMorton();
+}
@@ -0,0 +1,197 @@
+#include "mortonND_Swizzle_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_Mixed.h>
+#include <morton-nd/mortonND_Swizzle.h>
+
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// An element of 'Size' bytes, filled with pseudo-random bytes.
+template<size_t Size>
+struct Element
+{
+    unsigned char bytes[Size];
+
+    bool operator==(const Element& other) const {
+        return std::memcmp(bytes, other.bytes, Size) == 0;
+    }
+
+    bool operator!=(const Element& other) const {
+        return !(*this == other);
+    }
+};
+
+template<size_t Size>
+static std::vector<Element<Size>> RandomElements(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<Element<Size>> elements(count);
+    for (auto& element : elements) {
+        for (auto& byte : element.bytes) {
+            byte = (unsigned char)rng();
+        }
+    }
+
+    return elements;
+}
+
+static const char* StoresName(mortonnd::MortonNDStores stores) {
+    switch (stores) {
+        case mortonnd::MortonNDStores::Auto: return "auto";
+        case mortonnd::MortonNDStores::Cached: return "cached";
+        case mortonnd::MortonNDStores::Streaming: return "streaming";
+    }
+
+    return "unknown";
+}
+
+// Swizzles a 2^XBits x 2^YBits array with a row pitch of 'pad' extra elements, and compares
+// each element's position against the mixed-width BMI2 encoder.
+template<size_t Size, size_t XBits, size_t YBits>
+static bool TestToMorton2D(size_t pad, mortonnd::MortonNDStores stores) {
+    using Encoder = mortonnd::MortonNDBmiMixed<uint64_t, XBits, YBits>;
+    const size_t width = size_t(1) << XBits, height = size_t(1) << YBits, pitch = width + pad;
+    std::cout << "Testing 2D swizzle (" << width << " x " << height << ", element size = " << Size
+              << ", pitch = " << pitch << ", stores = " << StoresName(stores) << ")..." << std::endl;
+
+    const auto source = RandomElements<Size>(pitch * height, width + height + Size);
+    std::vector<Element<Size>> morton(width * height);
+    mortonnd::ToMorton<2>(source.data(), morton.data(), {{ width, height }}, {{ pitch }}, stores);
+
+    for (size_t y = 0; y < height; y++) {
+        for (size_t x = 0; x < width; x++) {
+            if (morton[Encoder::Encode(x, y)] != source[y * pitch + x]) {
+                std::cout << "  Mismatch at (" << x << ", " << y << ")" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+template<size_t Size, size_t XBits, size_t YBits, size_t ZBits>
+static bool TestToMorton3D(size_t pad, mortonnd::MortonNDStores stores) {
+    using Encoder = mortonnd::MortonNDBmiMixed<uint64_t, XBits, YBits, ZBits>;
+    const size_t width = size_t(1) << XBits, height = size_t(1) << YBits, depth = size_t(1) << ZBits;
+    const size_t rowPitch = width + pad, slicePitch = rowPitch * height + pad;
+    std::cout << "Testing 3D swizzle (" << width << " x " << height << " x " << depth << ", element size = " << Size
+              << ", pitch = " << rowPitch << ", stores = " << StoresName(stores) << ")..." << std::endl;
+
+    const auto source = RandomElements<Size>(slicePitch * depth, width + height + depth + Size);
+    std::vector<Element<Size>> morton(width * height * depth);
+    mortonnd::ToMorton<3>(source.data(), morton.data(), {{ width, height, depth }}, {{ rowPitch, slicePitch }}, stores);
+
+    for (size_t z = 0; z < depth; z++) {
+        for (size_t y = 0; y < height; y++) {
+            for (size_t x = 0; x < width; x++) {
+                if (morton[Encoder::Encode(x, y, z)] != source[z * slicePitch + y * rowPitch + x]) {
+                    std::cout << "  Mismatch at (" << x << ", " << y << ", " << z << ")" << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+template<size_t Size>
+static bool TestToMortonSize() {
+    using mortonnd::MortonNDStores;
+    bool ok = true;
+    ok &= TestToMorton2D<Size, 7, 7>(0, MortonNDStores::Cached);
+    ok &= TestToMorton2D<Size, 9, 6>(3, MortonNDStores::Streaming);
+    ok &= TestToMorton2D<Size, 5, 8>(1, MortonNDStores::Auto);
+    ok &= TestToMorton2D<Size, 1, 4>(0, MortonNDStores::Auto);
+    ok &= TestToMorton2D<Size, 0, 0>(0, MortonNDStores::Auto);
+    ok &= TestToMorton3D<Size, 5, 5, 5>(0, MortonNDStores::Cached);
+    ok &= TestToMorton3D<Size, 6, 4, 5>(5, MortonNDStores::Streaming);
+    ok &= TestToMorton3D<Size, 2, 6, 3>(0, MortonNDStores::Auto);
+    return ok;
+}
+
+// Swizzles and unswizzles a padded array, and checks that the padding is left untouched.
+template<size_t Size>
+static bool TestRoundTripSize(const std::array<size_t, 3>& extents, size_t pad, mortonnd::MortonNDStores stores) {
+    std::cout << "Testing swizzle round trip (" << extents[0] << " x " << extents[1] << " x " << extents[2]
+              << ", element size = " << Size << ", stores = " << StoresName(stores) << ")..." << std::endl;
+
+    const size_t rowPitch = extents[0] + pad, slicePitch = rowPitch * extents[1];
+    const auto source = RandomElements<Size>(slicePitch * extents[2], Size);
+    auto restored = RandomElements<Size>(source.size(), Size + 1);
+    const auto padding = restored;
+    std::vector<Element<Size>> morton(extents[0] * extents[1] * extents[2]);
+
+    if (extents[2] == 1) {
+        mortonnd::ToMorton<2>(source.data(), morton.data(), {{ extents[0], extents[1] }}, {{ rowPitch }}, stores);
+        mortonnd::FromMorton<2>(morton.data(), restored.data(), {{ extents[0], extents[1] }}, {{ rowPitch }}, stores);
+    } else {
+        mortonnd::ToMorton<3>(source.data(), morton.data(), extents, {{ rowPitch, slicePitch }}, stores);
+        mortonnd::FromMorton<3>(morton.data(), restored.data(), extents, {{ rowPitch, slicePitch }}, stores);
+    }
+
+    for (size_t n = 0; n < source.size(); n++) {
+        const bool inside = n % rowPitch < extents[0];
+        if (restored[n] != (inside ? source[n] : padding[n])) {
+            std::cout << "  Mismatch at element " << n << (inside ? "" : " (padding)") << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<size_t Size>
+static bool TestRoundTripSize() {
+    using mortonnd::MortonNDStores;
+    bool ok = true;
+    ok &= TestRoundTripSize<Size>({{ 256, 128, 1 }}, 0, MortonNDStores::Cached);
+    ok &= TestRoundTripSize<Size>({{ 64, 256, 1 }}, 7, MortonNDStores::Streaming);
+    ok &= TestRoundTripSize<Size>({{ 2, 2, 1 }}, 0, MortonNDStores::Auto);
+    ok &= TestRoundTripSize<Size>({{ 32, 32, 32 }}, 0, MortonNDStores::Cached);
+    ok &= TestRoundTripSize<Size>({{ 64, 16, 32 }}, 3, MortonNDStores::Streaming);
+    ok &= TestRoundTripSize<Size>({{ 8, 2, 4 }}, 1, MortonNDStores::Auto);
+    return ok;
+}
+
+bool mortonnd_swizzle::TestToMorton() {
+    bool ok = true;
+    ok &= TestToMortonSize<1>();
+    ok &= TestToMortonSize<2>();
+    ok &= TestToMortonSize<4>();
+    ok &= TestToMortonSize<8>();
+    ok &= TestToMortonSize<16>();
+
+    // Invalid extents and pitches.
+    std::vector<float> source(300 * 8), morton(source.size());
+    try {
+        mortonnd::ToMorton<2>(source.data(), morton.data(), {{ 300, 8 }});
+        std::cout << "  Expected std::invalid_argument for a non-power-of-2 extent" << std::endl;
+        ok = false;
+    } catch (const std::invalid_argument&) {
+    }
+
+    try {
+        mortonnd::ToMorton<2>(source.data(), morton.data(), {{ 256, 8 }}, {{ 255 }});
+        std::cout << "  Expected std::invalid_argument for a short pitch" << std::endl;
+        ok = false;
+    } catch (const std::invalid_argument&) {
+    }
+
+    return ok;
+}
+
+bool mortonnd_swizzle::TestRoundTrip() {
+    bool ok = true;
+    ok &= TestRoundTripSize<1>();
+    ok &= TestRoundTripSize<2>();
+    ok &= TestRoundTripSize<4>();
+    ok &= TestRoundTripSize<8>();
+    ok &= TestRoundTripSize<16>();
+    return ok;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace mortonnd_swizzle {
+bool TestToMorton();
+bool TestRoundTrip();
+}
@@ -0,0 +1,170 @@
+#include "mortonND_UInt_test.h"
+#include "mortonND_test_util.h"
+
+#include <morton-nd/mortonND_UInt.h>
+#include <morton-nd/mortonND_LUT.h>
+#include <morton-nd/mortonND_BMI2.h>
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+using mortonnd::UInt;
+
+// Encoding must be usable in constant expressions.
+static constexpr auto MortonND_8D_256_Enc = mortonnd::MortonNDLutEncoder<8, 32, 8, UInt<256>>();
+static_assert(MortonND_8D_256_Enc.Encode(1, 1, 1, 1, 1, 1, 1, 1) == UInt<256>(0xFF), "Unexpected constexpr encoding.");
+static_assert(MortonND_8D_256_Enc.Encode(0, 0, 0, 0, 0, 0, 0, 1u << 31).Word(3) == (uint64_t(1) << 63), "Unexpected constexpr encoding.");
+
+template<std::size_t Bits>
+static UInt<Bits> RandomUInt(std::mt19937_64& rng, std::size_t bits) {
+    UInt<Bits> value;
+    for (std::size_t w = 0; w < UInt<Bits>::WordCount; w++) {
+        value.SetWord(w, rng());
+    }
+
+    return value & (~UInt<Bits>() >> (Bits - bits));
+}
+
+template<std::size_t Bits>
+static __uint128_t ToNative(const UInt<Bits>& value) {
+    return UInt<Bits>::WordCount == 1 ? value.Word(0) : (__uint128_t(value.Word(1)) << 64) | value.Word(0);
+}
+
+template<std::size_t Bits>
+static bool TestUIntOperators() {
+    std::cout << "Testing " << Bits << "-bit UInt operators..." << std::endl;
+
+    static const __uint128_t Mask = Bits == 128 ? ~__uint128_t(0) : (__uint128_t(1) << Bits) - 1;
+    std::mt19937_64 rng(Bits);
+
+    bool ok = true;
+    const auto check = [&ok](bool result, const char* op) {
+        if (!result) {
+            std::cout << "  Mismatch for operator " << op << std::endl;
+            ok = false;
+        }
+    };
+
+    for (std::size_t n = 0; n < 10000; n++) {
+        const auto a = RandomUInt<Bits>(rng, Bits);
+        const auto b = RandomUInt<Bits>(rng, rng() % (Bits + 1));
+        const auto na = ToNative(a);
+        const auto nb = ToNative(b);
+        const auto shift = std::size_t(rng() % Bits);
+
+        check(ToNative(a | b) == (na | nb), "|");
+        check(ToNative(a & b) == (na & nb), "&");
+        check(ToNative(a ^ b) == (na ^ nb), "^");
+        check(ToNative(~a) == (~na & Mask), "~");
+        check(ToNative(a << shift) == ((na << shift) & Mask), "<<");
+        check(ToNative(a >> shift) == (na >> shift), ">>");
+        check((a < b) == (na < nb) && (a > b) == (na > nb), "<");
+        check((a == b) == (na == nb) && (a == a) && !(a != a), "==");
+        check(std::size_t(a) == std::size_t(na), "std::size_t");
+
+        check(a.template GetBits<60, 10>() == uint64_t((na >> 60) & 0x3FF), "GetBits");
+
+        auto c = b;
+        c.template OrBits<Bits - 7, 7>(0x55);
+        check(ToNative(c) == ((nb | (__uint128_t(0x55) << (Bits - 7))) & Mask), "OrBits");
+    }
+
+    return ok;
+}
+
+// Naive reference, used since the control encoder is limited to 64 bits.
+template<typename T>
+static T ReferenceEncode(const std::vector<T>& fields, std::size_t fieldBits) {
+    T result = 0;
+    for (std::size_t bit = 0; bit < fieldBits; bit++) {
+        for (std::size_t f = 0; f < fields.size(); f++) {
+            if (((fields[f] >> bit) & T(1)) != T(0)) {
+                result |= T(1) << (bit * fields.size() + f);
+            }
+        }
+    }
+
+    return result;
+}
+
+template<std::size_t Fields, std::size_t FieldBits, typename T, typename Encode, typename Decode, std::size_t ...i>
+static bool TestUIntEngine(Encode encode, Decode decode, std::index_sequence<i...>) {
+    std::mt19937_64 rng(Fields * FieldBits);
+
+    bool ok = true;
+    for (std::size_t n = 0; n < 1000; n++) {
+        const std::vector<T> fields = { (void(i), RandomUInt<std::numeric_limits<T>::digits>(rng, FieldBits))... };
+        const T correct = ReferenceEncode(fields, FieldBits);
+
+        const T computed = encode(fields[i]...);
+        if (computed != correct) {
+            std::cout << "  Mismatch when encoding point " << n << std::endl;
+            ok = false;
+        }
+
+        const std::vector<T> decoded = { std::get<i>(decode(correct))... };
+        if (decoded != fields) {
+            std::cout << "  Mismatch when decoding point " << n << std::endl;
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+template<std::size_t Fields, std::size_t FieldBits, std::size_t LutBits, std::size_t Bits>
+static bool TestUIntLut() {
+    using T = UInt<Bits>;
+    std::cout << "Testing " << Bits << "-bit UInt " << Fields << "D LUT encoders/decoders (Bits/Field = " << FieldBits
+              << ", LUT bits = " << LutBits << ")..." << std::endl;
+
+    static constexpr auto encoder = mortonnd::MortonNDLutEncoder<Fields, FieldBits, LutBits, T>();
+    static constexpr auto decoder = mortonnd::MortonNDLutDecoder<Fields, FieldBits, LutBits, T>();
+
+    return TestUIntEngine<Fields, FieldBits, T>(
+        [](auto... fields) { return encoder.Encode(fields...); },
+        [](T encoding) { return decoder.Decode(encoding); },
+        std::make_index_sequence<Fields>{});
+}
+
+template<std::size_t Fields, std::size_t Bits>
+static bool TestUIntBmi() {
+    using MortonND = mortonnd::MortonNDBmi<Fields, UInt<Bits>>;
+    std::cout << "Testing " << Bits << "-bit UInt " << Fields << "D BMI2 encoders/decoders (Bits/Field = " << MortonND::FieldBits << ")..." << std::endl;
+
+    return TestUIntEngine<Fields, MortonND::FieldBits, UInt<Bits>>(
+        [](auto... fields) { return MortonND::Encode(fields...); },
+        [](UInt<Bits> encoding) { return MortonND::Decode(encoding); },
+        std::make_index_sequence<Fields>{});
+}
+
+bool mortonnd_uint::TestOperators() {
+    return Reduce(std::logical_and<bool>{},
+        TestUIntOperators<128>(),
+        TestUIntOperators<100>(),
+        TestUIntOperators<65>()
+    );
+}
+
+bool mortonnd_uint::TestLut() {
+    return Reduce(std::logical_and<bool>{},
+        TestUIntLut<8, 32, 8, 256>(),
+        TestUIntLut<8, 32, 5, 256>(),
+        TestUIntLut<3, 42, 7, 128>(),
+        TestUIntLut<5, 30, 10, 150>(),
+        TestUIntLut<2, 100, 10, 200>(),
+        TestUIntLut<1, 70, 11, 70>()
+    );
+}
+
+bool mortonnd_uint::TestBmi() {
+    return Reduce(std::logical_and<bool>{},
+        TestUIntBmi<8, 256>(),
+        TestUIntBmi<3, 128>(),
+        TestUIntBmi<5, 150>(),
+        TestUIntBmi<2, 200>(),
+        TestUIntBmi<1, 70>(),
+        TestUIntBmi<65, 130>()
+    );
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+namespace mortonnd_uint {
+bool TestOperators();
+bool TestLut();
+bool TestBmi();
+}